@@ -6,11 +6,16 @@
 #include <stdint.h>
 #include <stan/math/prim/meta.hpp>
 #include <cstdlib>
+#include <algorithm>
 #include <cstddef>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 namespace stan {
 namespace math {
 
@@ -32,6 +37,7 @@ bool is_aligned(T* ptr, unsigned int bytes_aligned) {
 
 namespace internal {
 const size_t DEFAULT_INITIAL_NBYTES = 1 << 16;  // 64KB
+const size_t HUGE_PAGE_NBYTES = 1 << 21;        // 2MB
 
 // FIXME: enforce alignment
 // big fun to inline, but only called twice
@@ -50,6 +56,59 @@ inline char* eight_byte_aligned_malloc(size_t size) {
 }
 }  // namespace internal
 
+/**
+ * Settings for the growth and backing of the blocks of a
+ * <code>stack_alloc</code>. The defaults reproduce the classic
+ * behavior of a 64KB initial block which doubles in size with every
+ * new block allocated with <code>malloc</code>.
+ */
+struct stack_alloc_policy {
+  /**
+   * Size of the first block in bytes.
+   */
+  size_t initial_nbytes = internal::DEFAULT_INITIAL_NBYTES;
+
+  /**
+   * Factor by which each new block is larger than the previous one;
+   * must be at least 1.
+   */
+  double growth_factor = 2.0;
+
+  /**
+   * Alignment in bytes of the arrays returned by
+   * <code>alloc_array()</code>; a power of 2 which is at least 8. Use
+   * 64 for arrays which are processed with SIMD instructions.
+   */
+  size_t array_alignment = 8;
+
+  /**
+   * Blocks of at least this many bytes are mapped with
+   * <code>mmap</code> instead of <code>malloc</code>; 0 disables
+   * mapping. Only supported on Linux, elsewhere all blocks use
+   * <code>malloc</code>.
+   */
+  size_t mmap_threshold = 0;
+
+  /**
+   * Request explicit huge pages (<code>MAP_HUGETLB</code>) for mapped
+   * blocks. If none are available the block is mapped with regular
+   * pages.
+   */
+  bool map_hugetlb = false;
+
+  /**
+   * Advise the kernel to back mapped blocks with transparent huge
+   * pages (<code>madvise(MADV_HUGEPAGE)</code>).
+   */
+  bool madvise_hugepage = false;
+
+  /**
+   * Upper bound on the total size of all blocks in bytes; 0 means
+   * unlimited.
+   */
+  size_t max_nbytes = 0;
+};
+
 /**
  * An instance of this class provides a memory pool through
  * which blocks of raw memory may be allocated and then collected
@@ -68,12 +127,21 @@ inline char* eight_byte_aligned_malloc(size_t size) {
  * and after that it's up to the caller.  On 64-bit architectures,
  * all struct values should be padded to 8-byte boundaries if they
  * contain an 8-byte member or a virtual function.
+ *
+ * The initial block size, the growth of the blocks, the alignment of
+ * arrays, the backing of large blocks by (huge) memory pages and an
+ * upper bound on the total size are configured with a
+ * <code>stack_alloc_policy</code>.
  */
 class stack_alloc {
  private:
   std::vector<char*> blocks_;  // storage for blocks,
                                // may be bigger than cur_block_
   std::vector<size_t> sizes_;  // could store initial & shift for others
+  std::vector<bool> mapped_;   // true for blocks allocated with mmap
+  stack_alloc_policy policy_;
+  size_t total_nbytes_;        // sum of sizes_
+  size_t high_water_block_;    // largest cur_block_ since last trim()
   size_t cur_block_;           // index into blocks_ for next alloc
   char* cur_block_end_;        // ptr to cur_block_ptr_ + sizes_[cur_block_]
   char* next_loc_;             // ptr to next available spot in cur
@@ -83,33 +151,123 @@ class stack_alloc {
   std::vector<char*> nested_next_locs_;
   std::vector<char*> nested_cur_block_ends_;
 
+  /**
+   * Allocate a block of the specified size according to the policy.
+   *
+   * @param size Number of bytes of the block.
+   * @param[out] mapped true if the block was mapped with mmap.
+   * @return A pointer to the block or nullptr if allocation failed.
+   */
+  char* allocate_block(size_t size, bool& mapped) const {
+    mapped = false;
+#ifdef __linux__
+    if (policy_.mmap_threshold > 0 && size >= policy_.mmap_threshold) {
+      void* ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+      if (policy_.map_hugetlb) {
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      }
+#endif
+      if (ptr == MAP_FAILED) {
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+        if (ptr != MAP_FAILED && policy_.madvise_hugepage) {
+          madvise(ptr, size, MADV_HUGEPAGE);
+        }
+#endif
+      }
+      if (ptr != MAP_FAILED) {
+        mapped = true;
+        return static_cast<char*>(ptr);
+      }
+    }
+#endif
+    return internal::eight_byte_aligned_malloc(size);
+  }
+
+  /**
+   * Free the block with the specified index.
+   */
+  void free_block(size_t i) {
+    if (!blocks_[i]) {
+      return;
+    }
+#ifdef __linux__
+    if (mapped_[i]) {
+      munmap(blocks_[i], sizes_[i]);
+      return;
+    }
+#endif
+    free(blocks_[i]);
+  }
+
+  /**
+   * Append a new block of the specified size.
+   *
+   * @throw std::runtime_error if the block would exceed the maximal
+   * number of bytes of the policy.
+   * @throw std::bad_alloc if the memory can't be allocated.
+   */
+  void push_block(size_t size) {
+    if (policy_.mmap_threshold > 0 && size >= policy_.mmap_threshold
+        && (policy_.map_hugetlb || policy_.madvise_hugepage)) {
+      size = (size + internal::HUGE_PAGE_NBYTES - 1)
+             / internal::HUGE_PAGE_NBYTES * internal::HUGE_PAGE_NBYTES;
+    }
+    if (policy_.max_nbytes > 0 && total_nbytes_ + size > policy_.max_nbytes) {
+      std::stringstream s;
+      s << "stack_alloc: allocating a block of " << size
+        << " bytes exceeds the limit of " << policy_.max_nbytes
+        << " bytes; " << total_nbytes_ << " bytes are in use";
+      throw std::runtime_error(s.str());
+    }
+    bool mapped;
+    char* block = allocate_block(size, mapped);
+    if (!block) {
+      throw std::bad_alloc();
+    }
+    blocks_.push_back(block);
+    sizes_.push_back(size);
+    mapped_.push_back(mapped);
+    total_nbytes_ += size;
+  }
+
   /**
    * Moves us to the next block of memory, allocating that block
    * if necessary, and allocates len bytes of memory within that
-   * block.
+   * block. If the block can't be allocated, the state of the
+   * allocator is left unchanged.
    *
    * @param size_t $len Number of bytes to allocate.
    * @return A pointer to the allocated memory.
    */
   char* move_to_next_block(size_t len) {
     char* result;
-    ++cur_block_;
+    size_t next_block = cur_block_ + 1;
     // Find the next block (if any) containing at least len bytes.
-    while ((cur_block_ < blocks_.size()) && (sizes_[cur_block_] < len)) {
-      ++cur_block_;
+    while ((next_block < blocks_.size()) && (sizes_[next_block] < len)) {
+      ++next_block;
     }
     // Allocate a new block if necessary.
-    if (unlikely(cur_block_ >= blocks_.size())) {
-      // New block should be max(2*size of last block, len) bytes.
-      size_t newsize = sizes_.back() * 2;
+    if (unlikely(next_block >= blocks_.size())) {
+      // New block should be max(growth * size of last block, len) bytes,
+      // but not more than allowed by the limit unless len requires it.
+      size_t newsize = static_cast<size_t>(sizes_.back()
+                                           * policy_.growth_factor);
+      if (policy_.max_nbytes > 0 && total_nbytes_ < policy_.max_nbytes
+          && newsize > policy_.max_nbytes - total_nbytes_) {
+        newsize = policy_.max_nbytes - total_nbytes_;
+      }
       if (newsize < len) {
         newsize = len;
       }
-      blocks_.push_back(internal::eight_byte_aligned_malloc(newsize));
-      if (!blocks_.back()) {
-        throw std::bad_alloc();
-      }
-      sizes_.push_back(newsize);
+      push_block(newsize);
+    }
+    cur_block_ = next_block;
+    if (cur_block_ > high_water_block_) {
+      high_water_block_ = cur_block_;
     }
     result = blocks_[cur_block_];
     // Get the object's state back in order.
@@ -118,6 +276,31 @@ class stack_alloc {
     return result;
   }
 
+  static stack_alloc_policy make_policy(size_t initial_nbytes) {
+    stack_alloc_policy policy;
+    policy.initial_nbytes = initial_nbytes;
+    return policy;
+  }
+
+  /**
+   * Throw if the policy is not valid.
+   */
+  static void check_policy(const stack_alloc_policy& policy) {
+    if (policy.initial_nbytes == 0) {
+      throw std::invalid_argument(
+          "stack_alloc: initial_nbytes must be positive");
+    }
+    if (!(policy.growth_factor >= 1.0)) {
+      throw std::invalid_argument(
+          "stack_alloc: growth_factor must be at least 1");
+    }
+    if (policy.array_alignment < 8
+        || (policy.array_alignment & (policy.array_alignment - 1)) != 0) {
+      throw std::invalid_argument(
+          "stack_alloc: array_alignment must be a power of 2 of at least 8");
+    }
+  }
+
  public:
   /**
    * Construct a resizable stack allocator initially holding the
@@ -129,14 +312,25 @@ class stack_alloc {
    * aligned.
    */
   explicit stack_alloc(size_t initial_nbytes = internal::DEFAULT_INITIAL_NBYTES)
-      : blocks_(1, internal::eight_byte_aligned_malloc(initial_nbytes)),
-        sizes_(1, initial_nbytes),
-        cur_block_(0),
-        cur_block_end_(blocks_[0] + initial_nbytes),
-        next_loc_(blocks_[0]) {
-    if (!blocks_[0]) {
-      throw std::bad_alloc();  // no msg allowed in bad_alloc ctor
-    }
+      : stack_alloc(make_policy(initial_nbytes)) {}
+
+  /**
+   * Construct a resizable stack allocator with the specified policy.
+   *
+   * @param policy Growth and backing of the blocks.
+   * @throws std::invalid_argument if the policy is not valid.
+   * @throws std::runtime_error if the initial block exceeds the
+   * maximal number of bytes of the policy.
+   */
+  explicit stack_alloc(const stack_alloc_policy& policy)
+      : policy_(policy),
+        total_nbytes_(0),
+        high_water_block_(0),
+        cur_block_(0) {
+    check_policy(policy);
+    push_block(policy.initial_nbytes);
+    cur_block_end_ = blocks_[0] + sizes_[0];
+    next_loc_ = blocks_[0];
   }
 
   /**
@@ -147,13 +341,28 @@ class stack_alloc {
    */
   ~stack_alloc() {
     // free ALL blocks
-    for (auto& block : blocks_) {
-      if (block) {
-        free(block);
-      }
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      free_block(i);
     }
   }
 
+  /**
+   * Return the policy of this allocator.
+   */
+  inline const stack_alloc_policy& policy() const { return policy_; }
+
+  /**
+   * Replace the policy of this allocator. The new policy applies to
+   * blocks allocated from now on; existing blocks are kept.
+   *
+   * @param policy Growth and backing of the blocks.
+   * @throws std::invalid_argument if the policy is not valid.
+   */
+  inline void set_policy(const stack_alloc_policy& policy) {
+    check_policy(policy);
+    policy_ = policy;
+  }
+
   /**
    * Return a newly allocated block of memory of the appropriate
    * size managed by the stack allocator.
@@ -169,11 +378,11 @@ class stack_alloc {
   inline void* alloc(size_t len) {
     // Typically, just return and increment the next location.
     char* result = next_loc_;
-    next_loc_ += len;
     // Occasionally, we have to switch blocks.
-    if (unlikely(next_loc_ >= cur_block_end_)) {
-      result = move_to_next_block(len);
+    if (unlikely(result + len >= cur_block_end_)) {
+      return reinterpret_cast<void*>(move_to_next_block(len));
     }
+    next_loc_ = result + len;
     return reinterpret_cast<void*>(result);
   }
 
@@ -187,9 +396,34 @@ class stack_alloc {
    */
   template <typename T>
   inline T* alloc_array(size_t n) {
+    if (policy_.array_alignment > 8) {
+      return static_cast<T*>(alloc_aligned(n * sizeof(T),
+                                           policy_.array_alignment));
+    }
     return static_cast<T*>(alloc(n * sizeof(T)));
   }
 
+  /**
+   * Return a newly allocated block of memory of the appropriate
+   * size which starts at a multiple of the specified alignment.
+   *
+   * @param len Number of bytes to allocate.
+   * @param alignment Alignment in bytes, a power of 2.
+   * @return A pointer to the allocated memory.
+   */
+  inline void* alloc_aligned(size_t len, size_t alignment) {
+    const uintptr_t mask = alignment - 1;
+    char* result = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(next_loc_) + mask) & ~mask);
+    if (unlikely(result + len >= cur_block_end_)) {
+      char* block = move_to_next_block(len + mask);
+      result = reinterpret_cast<char*>(
+          (reinterpret_cast<uintptr_t>(block) + mask) & ~mask);
+    }
+    next_loc_ = result + len;
+    return reinterpret_cast<void*>(result);
+  }
+
   /**
    * Recover all the memory used by the stack allocator.  The stack
    * of memory blocks allocated so far will be available for further
@@ -238,15 +472,48 @@ class stack_alloc {
   inline void free_all() {
     // frees all BUT the first (index 0) block
     for (size_t i = 1; i < blocks_.size(); ++i) {
-      if (blocks_[i]) {
-        free(blocks_[i]);
-      }
+      free_block(i);
     }
     sizes_.resize(1);
     blocks_.resize(1);
+    mapped_.resize(1);
+    total_nbytes_ = sizes_[0];
+    high_water_block_ = 0;
     recover_all();
   }
 
+  /**
+   * Free the blocks which have not been used since the last call to
+   * <code>trim()</code> (or since construction) back to the system
+   * and start a new high water mark at the block currently in use.
+   *
+   * Calling this function between iterations of an algorithm which
+   * recovers the memory after each iteration keeps the blocks needed
+   * by the largest recent iteration while releasing blocks of earlier
+   * outliers.
+   */
+  inline void trim() {
+    const size_t keep = std::max(high_water_block_, cur_block_) + 1;
+    for (size_t i = keep; i < blocks_.size(); ++i) {
+      free_block(i);
+      total_nbytes_ -= sizes_[i];
+    }
+    if (keep < blocks_.size()) {
+      sizes_.resize(keep);
+      blocks_.resize(keep);
+      mapped_.resize(keep);
+    }
+    high_water_block_ = cur_block_;
+  }
+
+  /**
+   * Return the total number of bytes of all blocks held by this
+   * instance, including blocks which are currently unused.
+   *
+   * @return number of bytes held by this instance
+   */
+  inline size_t bytes_reserved() const { return total_nbytes_; }
+
   /**
    * Return number of bytes allocated to this instance by the heap.
    * This is not the same as the number of bytes allocated through
@@ -265,6 +532,22 @@ class stack_alloc {
     return sum;
   }
 
+  /**
+   * Return the number of bytes between the start of the first block
+   * and the next free location of the current block. Unlike
+   * <code>bytes_allocated()</code> this grows with every allocation;
+   * space left at the end of earlier blocks is counted as used.
+   *
+   * @return number of bytes used by this instance
+   */
+  inline size_t bytes_used() const {
+    size_t sum = next_loc_ - blocks_[cur_block_];
+    for (size_t i = 0; i < cur_block_; ++i) {
+      sum += sizes_[i];
+    }
+    return sum;
+  }
+
   /**
    * Indicates whether the memory in the pointer
    * is in the stack.
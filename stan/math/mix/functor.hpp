@@ -1,6 +1,7 @@
 #ifndef STAN_MATH_MIX_FUNCTOR_HPP
 #define STAN_MATH_MIX_FUNCTOR_HPP
 
+#include <stan/math/mix/functor/coupled_ode_system.hpp>
 #include <stan/math/mix/functor/derivative.hpp>
 #include <stan/math/mix/functor/finite_diff_grad_hessian.hpp>
 #include <stan/math/mix/functor/finite_diff_grad_hessian_auto.hpp>
@@ -8,7 +9,10 @@
 #include <stan/math/mix/functor/grad_tr_mat_times_hessian.hpp>
 #include <stan/math/mix/functor/gradient_dot_vector.hpp>
 #include <stan/math/mix/functor/hessian.hpp>
+#include <stan/math/mix/functor/hessian_sparse.hpp>
+#include <stan/math/mix/functor/hessian_times_matrix.hpp>
 #include <stan/math/mix/functor/hessian_times_vector.hpp>
+#include <stan/math/mix/functor/kinsol_forward_jacobian_vector.hpp>
 #include <stan/math/mix/functor/partial_derivative.hpp>
 
 #endif
@@ -0,0 +1,240 @@
+#ifndef STAN_MATH_MIX_FUNCTOR_COUPLED_ODE_SYSTEM_HPP
+#define STAN_MATH_MIX_FUNCTOR_COUPLED_ODE_SYSTEM_HPP
+
+#include <stan/math/fwd/core.hpp>
+#include <stan/math/prim/functor/coupled_ode_system.hpp>
+#include <stan/math/prim/arr/fun/value_of.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/coupled_ode_system.hpp>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Wrapper of an ode functor which selects forward mode sensitivities
+ * for the coupled ode system. The wrapper is passed to the ode
+ * integrators in place of the functor it wraps and otherwise calls
+ * it unchanged.
+ *
+ * The functor must accept <code>fvar\<double\></code> states and
+ * parameters in addition to the types required by the integrators.
+ *
+ * @tparam F base ode system functor
+ */
+template <typename F>
+struct ode_forward_sensitivity {
+  const F f_;
+
+  explicit ode_forward_sensitivity(const F& f) : f_(f) {}
+
+  template <typename T0, typename T1, typename T2>
+  inline auto operator()(const T0& t, const std::vector<T1>& y,
+                         const std::vector<T2>& theta,
+                         const std::vector<double>& x,
+                         const std::vector<int>& x_int,
+                         std::ostream* msgs) const {
+    return f_(t, y, theta, x, x_int, msgs);
+  }
+};
+
+/**
+ * Return the ode functor wrapped such that the coupled ode system
+ * uses forward mode sensitivities.
+ *
+ * @tparam F base ode system functor
+ * @param f base ode system functor
+ * @return wrapped functor
+ */
+template <typename F>
+inline ode_forward_sensitivity<F> forward_sensitivity(const F& f) {
+  return ode_forward_sensitivity<F>(f);
+}
+
+namespace internal {
+
+/**
+ * Coupled ode system whose sensitivity states are computed with
+ * forward mode autodiff.
+ *
+ * <p>The time derivative of each sensitivity is the directional
+ * derivative of the ode RHS in the direction given by the
+ * sensitivity wrt to the states and the unit vector of the
+ * parameter, if any. Every sensitivity is therefore one evaluation of
+ * the ode RHS with <code>fvar\<double\></code> states and parameters,
+ * and no autodiff tape is recorded. The layout of the coupled state
+ * is the same as for the reverse mode coupled ode systems.
+ *
+ * @tparam F base ode system functor
+ * @tparam T_initial type of initial values
+ * @tparam T_param type of parameters
+ */
+template <typename F, typename T_initial, typename T_param>
+struct forward_coupled_ode_system {
+  const ode_forward_sensitivity<F>& f_;
+  const std::vector<T_initial>& y0_;
+  const std::vector<double> theta_dbl_;
+  const std::vector<double>& x_;
+  const std::vector<int>& x_int_;
+  std::ostream* msgs_;
+  const size_t N_;
+  const size_t M_;
+  const size_t num_y0_sens_;
+  const size_t num_theta_sens_;
+  const size_t size_;
+
+  forward_coupled_ode_system(const ode_forward_sensitivity<F>& f,
+                             const std::vector<T_initial>& y0,
+                             const std::vector<T_param>& theta,
+                             const std::vector<double>& x,
+                             const std::vector<int>& x_int, std::ostream* msgs)
+      : f_(f),
+        y0_(y0),
+        theta_dbl_(value_of(theta)),
+        x_(x),
+        x_int_(x_int),
+        msgs_(msgs),
+        N_(y0.size()),
+        M_(theta.size()),
+        num_y0_sens_(is_var<T_initial>::value ? N_ : 0),
+        num_theta_sens_(is_var<T_param>::value ? M_ : 0),
+        size_(N_ + N_ * (num_y0_sens_ + num_theta_sens_)) {}
+
+  /**
+   * Calculates the derivative of the coupled ode system with respect
+   * to time.
+   *
+   * @param[in] z state of the coupled ode system; this must be size
+   *   <code>size()</code>
+   * @param[out] dz_dt a vector of size <code>size()</code> with the
+   *    derivatives of the coupled system with respect to time
+   * @param[in] t time
+   * @throw exception if the base ode function does not return the
+   *    expected number of derivatives, N.
+   */
+  void operator()(const std::vector<double>& z, std::vector<double>& dz_dt,
+                  double t) const {
+    const size_t num_sens = num_y0_sens_ + num_theta_sens_;
+    if (num_sens == 0) {
+      const std::vector<double> y(z.begin(), z.begin() + N_);
+      const std::vector<double> dy_dt
+          = f_(t, y, theta_dbl_, x_, x_int_, msgs_);
+      check_size_match("coupled_ode_system", "dz_dt", dy_dt.size(), "states",
+                       N_);
+      std::copy(dy_dt.begin(), dy_dt.end(), dz_dt.begin());
+      return;
+    }
+
+    std::vector<fvar<double>> y_fvar(N_);
+    std::vector<fvar<double>> theta_fvar(theta_dbl_.begin(),
+                                         theta_dbl_.end());
+    for (size_t s = 0; s < num_sens; ++s) {
+      const size_t offset = N_ + N_ * s;
+      for (size_t k = 0; k < N_; ++k) {
+        y_fvar[k] = fvar<double>(z[k], z[offset + k]);
+      }
+      const std::vector<fvar<double>> dy_dt
+          = sensitivity_rhs(t, y_fvar, theta_fvar, s);
+      check_size_match("coupled_ode_system", "dz_dt", dy_dt.size(), "states",
+                       N_);
+      for (size_t i = 0; i < N_; ++i) {
+        if (s == 0) {
+          dz_dt[i] = dy_dt[i].val_;
+        }
+        dz_dt[offset + i] = dy_dt[i].d_;
+      }
+    }
+  }
+
+  /**
+   * Returns the size of the coupled system.
+   *
+   * @return size of the coupled system.
+   */
+  size_t size() const { return size_; }
+
+  /**
+   * Returns the initial state of the coupled system, which is the
+   * initial state of the base ode followed by the identity matrix for
+   * the sensitivities wrt to unknown initial values and zeros for the
+   * sensitivities wrt to the parameters.
+   *
+   * @return the initial condition of the coupled system.
+   */
+  std::vector<double> initial_state() const {
+    std::vector<double> initial(size_, 0.0);
+    for (size_t i = 0; i < N_; i++) {
+      initial[i] = value_of(y0_[i]);
+    }
+    for (size_t i = 0; i < num_y0_sens_; i++) {
+      initial[N_ + i * N_ + i] = 1.0;
+    }
+    return initial;
+  }
+
+ private:
+  /**
+   * Evaluate the ode RHS with tangents for sensitivity
+   * <code>s</code>; the parameters carry a unit tangent if
+   * <code>s</code> is a sensitivity wrt to a parameter.
+   */
+  std::vector<fvar<double>> sensitivity_rhs(
+      double t, const std::vector<fvar<double>>& y,
+      std::vector<fvar<double>>& theta, size_t s) const {
+    if (num_theta_sens_ == 0) {
+      return f_(t, y, theta_dbl_, x_, x_int_, msgs_);
+    }
+    for (size_t j = 0; j < M_; ++j) {
+      theta[j].d_ = (s == num_y0_sens_ + j) ? 1.0 : 0.0;
+    }
+    return f_(t, y, theta, x_, x_int_, msgs_);
+  }
+};
+
+}  // namespace internal
+
+/**
+ * The <code>coupled_ode_system</code> template specialization for
+ * forward mode sensitivities wrt to unknown parameters.
+ *
+ * @tparam F base ode system functor
+ */
+template <typename F>
+struct coupled_ode_system<ode_forward_sensitivity<F>, double, var>
+    : public internal::forward_coupled_ode_system<F, double, var> {
+  using base = internal::forward_coupled_ode_system<F, double, var>;
+  using base::base;
+};
+
+/**
+ * The <code>coupled_ode_system</code> template specialization for
+ * forward mode sensitivities wrt to unknown initial values.
+ *
+ * @tparam F base ode system functor
+ */
+template <typename F>
+struct coupled_ode_system<ode_forward_sensitivity<F>, var, double>
+    : public internal::forward_coupled_ode_system<F, var, double> {
+  using base = internal::forward_coupled_ode_system<F, var, double>;
+  using base::base;
+};
+
+/**
+ * The <code>coupled_ode_system</code> template specialization for
+ * forward mode sensitivities wrt to unknown initial values and
+ * parameters.
+ *
+ * @tparam F base ode system functor
+ */
+template <typename F>
+struct coupled_ode_system<ode_forward_sensitivity<F>, var, var>
+    : public internal::forward_coupled_ode_system<F, var, var> {
+  using base = internal::forward_coupled_ode_system<F, var, var>;
+  using base::base;
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,141 @@
+#ifndef STAN_MATH_MIX_FUNCTOR_HESSIAN_SPARSE_HPP
+#define STAN_MATH_MIX_FUNCTOR_HESSIAN_SPARSE_HPP
+
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/mix/functor/hessian_times_matrix.hpp>
+
+#include <Eigen/Sparse>
+
+#include <algorithm>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return the symmetric sparsity pattern of the Hessian with the
+ * specified pattern of nonzeros, including the diagonal.
+ *
+ * @param pattern Matrix whose structural nonzeros are the nonzeros of
+ * the Hessian, either triangle or both
+ * @return Symmetric pattern with unit entries
+ */
+inline Eigen::SparseMatrix<double> hessian_pattern(
+    const Eigen::SparseMatrix<double>& pattern) {
+  std::vector<Eigen::Triplet<double>> entries;
+  entries.reserve(2 * pattern.nonZeros() + pattern.cols());
+  for (int j = 0; j < pattern.outerSize(); ++j) {
+    entries.emplace_back(j, j, 1.0);
+    for (Eigen::SparseMatrix<double>::InnerIterator it(pattern, j); it;
+         ++it) {
+      entries.emplace_back(it.row(), it.col(), 1.0);
+      entries.emplace_back(it.col(), it.row(), 1.0);
+    }
+  }
+  Eigen::SparseMatrix<double> S(pattern.rows(), pattern.cols());
+  S.setFromTriplets(entries.begin(), entries.end(),
+                    [](double a, double b) { return a; });
+  return S;
+}
+
+/**
+ * Return a greedy coloring of the columns of the symmetric sparsity
+ * pattern such that no two columns of the same color have a nonzero
+ * in the same row. The product of the Hessian with the sum of the
+ * unit vectors of one color then holds every entry of those columns
+ * in a row of its own.
+ *
+ * @param S Symmetric pattern including the diagonal
+ * @return Color of each column, numbered from zero
+ */
+inline std::vector<int> hessian_coloring(const Eigen::SparseMatrix<double>& S) {
+  const int N = S.cols();
+  std::vector<int> color(N, -1);
+  std::vector<int> forbidden(N, -1);
+  for (int j = 0; j < N; ++j) {
+    for (Eigen::SparseMatrix<double>::InnerIterator row(S, j); row; ++row) {
+      for (Eigen::SparseMatrix<double>::InnerIterator col(S, row.row()); col;
+           ++col) {
+        if (color[col.row()] >= 0) {
+          forbidden[color[col.row()]] = j;
+        }
+      }
+    }
+    int c = 0;
+    while (forbidden[c] == j) {
+      ++c;
+    }
+    color[j] = c;
+  }
+  return color;
+}
+
+}  // namespace internal
+
+/**
+ * Calculate the value, the gradient, and the Hessian with the
+ * specified sparsity pattern, of the specified function at the
+ * specified argument.
+ *
+ * <p>The columns of the Hessian are grouped by a coloring in which
+ * no two columns of a group have a nonzero in the same row, and the
+ * Hessian is recovered from its product with one direction per
+ * group computed by <code>hessian_times_matrix</code>. For banded or
+ * otherwise sparse Hessians this takes far fewer sweeps than the
+ * size of the argument. Entries outside of the pattern are taken to
+ * be zero and the diagonal is always computed.
+ *
+ * <p>See <code>hessian_times_matrix</code> for the requirements on
+ * the functor and the parallel evaluation of the directions.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[in] pattern Matrix whose structural nonzeros are the
+ * nonzeros of the Hessian, either triangle or both
+ * @param[out] fx Function applied to argument
+ * @param[out] grad gradient of function at argument
+ * @param[out] H Hessian of function at argument
+ * @param[in] grainsize suggested minimal number of directions per
+ * parallel block
+ * @throw std::invalid_argument if the pattern is not square with
+ * the size of x
+ */
+template <typename F>
+void hessian_sparse(const F& f,
+                    const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+                    const Eigen::SparseMatrix<double>& pattern, double& fx,
+                    Eigen::Matrix<double, Eigen::Dynamic, 1>& grad,
+                    Eigen::SparseMatrix<double>& H, int grainsize = 1) {
+  static const char* function = "hessian_sparse";
+  check_size_match(function, "Rows of pattern", pattern.rows(), "size of x",
+                   x.size());
+  check_size_match(function, "Columns of pattern", pattern.cols(),
+                   "size of x", x.size());
+
+  H = internal::hessian_pattern(pattern);
+  const std::vector<int> color = internal::hessian_coloring(H);
+  const int num_colors
+      = color.empty() ? 0 : *std::max_element(color.begin(), color.end()) + 1;
+
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> V
+      = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Zero(
+          x.size(), num_colors);
+  for (int j = 0; j < x.size(); ++j) {
+    V(j, color[j]) = 1;
+  }
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> HV;
+  hessian_times_matrix(f, x, V, fx, grad, HV, grainsize);
+
+  for (int j = 0; j < H.outerSize(); ++j) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(H, j); it; ++it) {
+      it.valueRef() = HV(it.row(), color[j]);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
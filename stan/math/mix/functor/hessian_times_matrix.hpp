@@ -0,0 +1,150 @@
+#ifndef STAN_MATH_MIX_FUNCTOR_HESSIAN_TIMES_MATRIX_HPP
+#define STAN_MATH_MIX_FUNCTOR_HESSIAN_TIMES_MATRIX_HPP
+
+#include <stan/math/fwd/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/core.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <stdexcept>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Calculate the product of the Hessian of the specified function
+ * with the direction <code>v</code> in one forward and one reverse
+ * sweep of <code>fvar\<var\></code> within a nested autodiff region.
+ * Optionally, a second reverse sweep yields the gradient.
+ *
+ * @tparam F Type of function
+ * @tparam T_v Type of direction
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[in] v Direction
+ * @param[out] fx Function applied to argument
+ * @param[out] Hv Product of the Hessian with the direction
+ * @param[out] grad Gradient of function at argument, not computed if
+ * <code>nullptr</code>
+ */
+template <typename F, typename T_v>
+void fvar_hessian_times_vector(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+    const T_v& v, double& fx, Eigen::Matrix<double, Eigen::Dynamic, 1>& Hv,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>* grad) {
+  start_nested();
+  try {
+    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(x.size());
+    for (int j = 0; j < x.size(); ++j) {
+      x_fvar(j) = fvar<var>(x(j), v(j));
+    }
+    fvar<var> fx_fvar = f(x_fvar);
+    fx = fx_fvar.val_.val();
+    stan::math::grad(fx_fvar.d_.vi_);
+    Hv.resize(x.size());
+    for (int j = 0; j < x.size(); ++j) {
+      Hv(j) = x_fvar(j).val_.adj();
+    }
+    if (grad != nullptr) {
+      set_zero_all_adjoints_nested();
+      stan::math::grad(fx_fvar.val_.vi_);
+      grad->resize(x.size());
+      for (int j = 0; j < x.size(); ++j) {
+        (*grad)(j) = x_fvar(j).val_.adj();
+      }
+    }
+  } catch (const std::exception& e) {
+    recover_memory_nested();
+    throw;
+  }
+  recover_memory_nested();
+}
+
+}  // namespace internal
+
+/**
+ * Calculate the value, the gradient, and the product of the Hessian
+ * of the specified function at the specified argument with each
+ * column of the matrix <code>V</code>.
+ *
+ * <p>Every column of <code>V</code> is one forward and one reverse
+ * sweep of <code>fvar\<var\></code> in its own nested autodiff
+ * region, the first of which also yields the value and the
+ * gradient. Whenever <code>STAN_THREADS</code> is defined the columns
+ * are split into blocks of at least <code>grainsize</code> columns
+ * which are evaluated in parallel with
+ * <code>tbb::parallel_for</code>, each on the autodiff tape of the
+ * thread running it. The functor must then be safe to call
+ * concurrently. With <code>V</code> the identity this is the full
+ * Hessian.
+ *
+ * <p>The functor must implement
+ *
+ * <code>
+ * fvar\<var\>
+ * operator()(const
+ * Eigen::Matrix\<fvar\<var\>, Eigen::Dynamic, 1\>&)
+ * </code>
+ *
+ * using only operations that are defined for
+ * <code>fvar</code> and <code>var</code>.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[in] V Matrix of directions, one per column
+ * @param[out] fx Function applied to argument
+ * @param[out] grad gradient of function at argument
+ * @param[out] HV Product of the Hessian at the argument with V
+ * @param[in] grainsize suggested minimal number of columns per block
+ * @throw std::invalid_argument if the number of rows of V does not
+ * match the size of x
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F>
+void hessian_times_matrix(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& V,
+    double& fx, Eigen::Matrix<double, Eigen::Dynamic, 1>& grad,
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& HV,
+    int grainsize = 1) {
+  static const char* function = "hessian_times_matrix";
+  check_size_match(function, "Rows of V", V.rows(), "size of x", x.size());
+  check_positive(function, "grainsize", grainsize);
+
+  HV.resize(x.size(), V.cols());
+  if (V.cols() == 0) {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> Hv;
+    internal::fvar_hessian_times_vector(
+        f, x, Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(x.size()), fx,
+        Hv, &grad);
+    return;
+  }
+
+  // the value and the gradient are taken from the sweep of the first
+  // column
+  auto hessian_times_block = [&](const tbb::blocked_range<Eigen::Index>& r) {
+    double fx_i;
+    Eigen::Matrix<double, Eigen::Dynamic, 1> Hv_i;
+    for (Eigen::Index i = r.begin(); i < r.end(); ++i) {
+      internal::fvar_hessian_times_vector(f, x, V.col(i),
+                                          i == 0 ? fx : fx_i, Hv_i,
+                                          i == 0 ? &grad : nullptr);
+      HV.col(i) = Hv_i;
+    }
+  };
+  const tbb::blocked_range<Eigen::Index> range(0, V.cols(), grainsize);
+#ifdef STAN_THREADS
+  tbb::parallel_for(range, hessian_times_block);
+#else
+  hessian_times_block(range);
+#endif
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,70 @@
+#ifndef STAN_MATH_MIX_FUNCTOR_KINSOL_FORWARD_JACOBIAN_VECTOR_HPP
+#define STAN_MATH_MIX_FUNCTOR_KINSOL_FORWARD_JACOBIAN_VECTOR_HPP
+
+#include <stan/math/fwd/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Products of the Jacobian of an algebraic system with vectors for the
+ * matrix-free GMRES solver of <code>algebra_solver_newton</code>,
+ * computed with forward mode autodiff.
+ *
+ * <p>Each product is the directional derivative of the system in the
+ * direction of the vector and takes one evaluation of the system with
+ * <code>fvar\<double\></code> unknowns, without recording an autodiff
+ * tape. The products are exact, unlike the default difference
+ * quotients of KINSOL.
+ *
+ * <p>The system functor must accept a vector of
+ * <code>fvar\<double\></code> unknowns in addition to the types
+ * required by the solver.
+ */
+struct kinsol_forward_jacobian_vector {
+  /**
+   * Calculate the product of the Jacobian of the system at the
+   * unknowns with a vector.
+   *
+   * @tparam F type of the system functor
+   * @param f system functor
+   * @param x initial guess, which gives the number of unknowns
+   * @param y parameters
+   * @param dat continuous data
+   * @param dat_int integer data
+   * @param msgs stream for messages
+   * @param x_sun unknowns
+   * @param v vector
+   * @param[out] Jv product of the Jacobian with v
+   * @return zero, as required by KINSOL for a successful evaluation
+   */
+  template <typename F>
+  inline int operator()(const F& f, const Eigen::VectorXd& x,
+                        const Eigen::VectorXd& y,
+                        const std::vector<double>& dat,
+                        const std::vector<int>& dat_int, std::ostream* msgs,
+                        const double x_sun[], const double v[],
+                        double Jv[]) const {
+    const int N = x.size();
+    Eigen::Matrix<fvar<double>, Eigen::Dynamic, 1> x_fvar(N);
+    for (int j = 0; j < N; ++j) {
+      x_fvar(j) = fvar<double>(x_sun[j], v[j]);
+    }
+    const Eigen::Matrix<fvar<double>, Eigen::Dynamic, 1> fx
+        = f(x_fvar, y, dat, dat_int, msgs);
+    check_size_match("kinsol_forward_jacobian_vector", "system output",
+                     fx.size(), "unknowns", N);
+    for (int i = 0; i < N; ++i) {
+      Jv[i] = fx(i).d_;
+    }
+    return 0;
+  }
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
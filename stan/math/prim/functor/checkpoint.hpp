@@ -0,0 +1,52 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_CHECKPOINT_HPP
+#define STAN_MATH_PRIM_FUNCTOR_CHECKPOINT_HPP
+
+#include <stan/math/prim/meta.hpp>
+
+#include <ostream>
+#include <type_traits>
+
+namespace stan {
+namespace math {
+
+/**
+ * Return the result of the functor <code>f</code> applied to the
+ * arguments, recomputing the region in the reverse pass instead of
+ * keeping its autodiff tape.
+ *
+ * The functor is called as
+ *
+ * <code>f(msgs, args...)</code>
+ *
+ * and must return a scalar, a <code>std::vector</code> or an Eigen
+ * column vector. It must be templated on the scalar types of the
+ * arguments, depend on autodiff variables only through its
+ * arguments, and return the same values whenever it is called with
+ * the same arguments.
+ *
+ * Without reverse mode autodiff variables among the arguments, this
+ * just returns the result of the functor. In reverse mode the region
+ * is evaluated with the values of the arguments only, such that the
+ * forward pass records a single node on the autodiff tape, and the
+ * region is taped and differentiated on a separate tape once its
+ * adjoint is needed in the reverse pass. This trades a second
+ * evaluation of the region for the memory its tape would use until
+ * the end of the reverse pass.
+ *
+ * @tparam F type of the functor
+ * @tparam Args types of the arguments
+ * @param f functor
+ * @param msgs stream for messages passed to the functor
+ * @param args arguments passed to the functor
+ * @return result of the functor
+ */
+template <typename F, typename... Args,
+          std::enable_if_t<!is_var<return_type_t<Args...>>::value>* = nullptr>
+inline auto checkpoint(const F& f, std::ostream* msgs, const Args&... args) {
+  return f(msgs, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -10,6 +10,69 @@
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * Build the state of the ODE at one output time from the coupled
+ * state, which holds the states followed by the sensitivities wrt to
+ * the initial state and to the parameters in the order of the
+ * coupled_ode_system. The derivative of the states wrt to the output
+ * time is <code>dy_dt</code>, which is empty if the output time is
+ * data. Reverse mode provides a specialization which builds all
+ * states of one output time with a single vari.
+ *
+ * @tparam T1 type of scalars for initial values.
+ * @tparam T2 type of scalars for parameters.
+ * @tparam T_t0 type of scalar of initial time point.
+ * @tparam T_ts type of scalar of the output time.
+ */
+template <typename T1, typename T2, typename T_t0, typename T_ts,
+          typename = void>
+struct ode_output_state {
+  using return_t = return_type_t<T1, T2, T_t0, T_ts>;
+
+  static std::vector<return_t> apply(const std::vector<double>& coupled_state,
+                                     const std::vector<double>& dy_dt,
+                                     const std::vector<T1>& y0,
+                                     const std::vector<T2>& theta,
+                                     const T_t0& t0, const T_ts& t) {
+    const size_t N = y0.size();
+    const size_t M = theta.size();
+    const size_t index_offset_theta = is_constant_all<T1>::value ? 0 : N * N;
+
+    std::vector<return_t> yt;
+    yt.reserve(N);
+
+    operands_and_partials<std::vector<T1>, std::vector<T2>, T_t0, T_ts>
+        ops_partials(y0, theta, t0, t);
+
+    for (size_t j = 0; j < N; j++) {
+      // iterate over parameters for each equation
+      if (!is_constant_all<T1>::value) {
+        for (std::size_t k = 0; k < N; k++) {
+          ops_partials.edge1_.partials_[k] = coupled_state[N + N * k + j];
+        }
+      }
+
+      if (!is_constant_all<T2>::value) {
+        for (std::size_t k = 0; k < M; k++) {
+          ops_partials.edge2_.partials_[k]
+              = coupled_state[N + index_offset_theta + N * k + j];
+        }
+      }
+
+      if (!is_constant_all<T_ts>::value) {
+        ops_partials.edge4_.partials_[0] = dy_dt[j];
+      }
+
+      yt.emplace_back(ops_partials.build(coupled_state[j]));
+    }
+    return yt;
+  }
+};
+
+}  // namespace internal
+
 /**
  * Observer for the coupled states.  Holds a reference to an
  * externally defined vector of vectors passed in at construction time
@@ -29,9 +92,6 @@ template <typename F, typename T1, typename T2, typename T_t0, typename T_ts>
 struct coupled_ode_observer {
   using return_t = return_type_t<T1, T2, T_t0, T_ts>;
 
-  using ops_partials_t
-      = operands_and_partials<std::vector<T1>, std::vector<T2>, T_t0, T_ts>;
-
   const F& f_;
   const std::vector<T1>& y0_;
   const T_t0& t0_;
@@ -103,11 +163,6 @@ struct coupled_ode_observer {
     check_less("coupled_ode_observer", "time-state number", next_ts_index_,
                ts_.size());
 
-    std::vector<return_t> yt;
-    yt.reserve(N_);
-
-    ops_partials_t ops_partials(y0_, theta_, t0_, ts_[next_ts_index_]);
-
     std::vector<double> dy_dt;
     if (!is_constant_all<T_ts>::value) {
       std::vector<double> y_dbl(coupled_state.begin(),
@@ -118,29 +173,8 @@ struct coupled_ode_observer {
                        N_);
     }
 
-    for (size_t j = 0; j < N_; j++) {
-      // iterate over parameters for each equation
-      if (!is_constant_all<T1>::value) {
-        for (std::size_t k = 0; k < N_; k++) {
-          ops_partials.edge1_.partials_[k] = coupled_state[N_ + N_ * k + j];
-        }
-      }
-
-      if (!is_constant_all<T2>::value) {
-        for (std::size_t k = 0; k < M_; k++) {
-          ops_partials.edge2_.partials_[k]
-              = coupled_state[N_ + index_offset_theta_ + N_ * k + j];
-        }
-      }
-
-      if (!is_constant_all<T_ts>::value) {
-        ops_partials.edge4_.partials_[0] = dy_dt[j];
-      }
-
-      yt.emplace_back(ops_partials.build(coupled_state[j]));
-    }
-
-    y_.emplace_back(yt);
+    y_.emplace_back(internal::ode_output_state<T1, T2, T_t0, T_ts>::apply(
+        coupled_state, dy_dt, y0_, theta_, t0_, ts_[next_ts_index_]));
     next_ts_index_++;
   }
 };
@@ -2,12 +2,70 @@
 #define STAN_MATH_PRIM_FUNCTOR_FINITE_DIFF_GRADIENT_AUTO_HPP
 
 #include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
 #include <stan/math/prim/scal/fun/finite_diff_stepsize.hpp>
+#include <tbb/blocked_range.h>
+#ifdef STAN_THREADS
+#include <tbb/parallel_for.h>
+#endif
 #include <cmath>
 
 namespace stan {
 namespace math {
 
+/**
+ * Stencil of the automatic finite differences.
+ *
+ * <code>central</code> selects the high order central differences,
+ * which evaluate the function on both sides of the argument.
+ * <code>forward</code> selects low order differences which step to
+ * one side only and reuse the value of the function at the argument,
+ * for functions which are too expensive for the high order stencil.
+ */
+enum class finite_diff_stencil { central, forward };
+
+namespace internal {
+
+/**
+ * Apply the body to the range of indices [0, n). The range is split
+ * with <code>tbb::parallel_for</code> if requested and
+ * <code>STAN_THREADS</code> is defined and is applied as a whole
+ * otherwise.
+ *
+ * @tparam B type of the body
+ * @param n number of indices
+ * @param parallel whether to split the range in parallel
+ * @param body functor applied to a <code>tbb::blocked_range</code>
+ */
+template <typename B>
+inline void finite_diff_for_each(size_t n, bool parallel, const B& body) {
+  const tbb::blocked_range<size_t> range(0, n);
+#ifdef STAN_THREADS
+  if (parallel) {
+    tbb::parallel_for(range, body);
+    return;
+  }
+#endif
+  body(range);
+}
+
+/**
+ * Return the step of a forward difference at the specified scalar,
+ * <code>sqrt(epsilon) * max(1, abs(u))</code> rounded such that
+ * <code>u + h</code> is exactly <code>h</code> away from
+ * <code>u</code>.
+ *
+ * @param u initial value to increment
+ * @return stepsize away from u
+ */
+inline double finite_diff_forward_stepsize(double u) {
+  static const double sqrt_epsilon = std::sqrt(EPSILON);
+  const double u_h = u + sqrt_epsilon * std::fmax(1, std::fabs(u));
+  return u_h - u;
+}
+
+}  // namespace internal
+
 /**
  * Calculate the value and the gradient of the specified function
  * at the specified argument using finite difference.
@@ -40,46 +98,70 @@ namespace math {
  * differentiated for each dimension in the input, plus one global
  * evaluation.  All evaluations will be for double-precision inputs.
  *
+ * <p>The forward stencil instead evaluates the function once per
+ * dimension at a step of `sqrt(epsilon) * max(1, abs(x(i)))` and
+ * reuses the global evaluation, with an error on the order of the
+ * step.
+ *
+ * <p>If parallel evaluation is requested and `STAN_THREADS` is
+ * defined, the dimensions are split over the threads of the TBB with
+ * `tbb::parallel_for`, such that the functor must be safe to call
+ * concurrently.
+ *
  * @tparam F Type of function
  * @param[in] f function
  * @param[in] x argument to function
  * @param[out] fx function applied to argument
  * @param[out] grad_fx gradient of function at argument
+ * @param[in] stencil finite difference stencil
+ * @param[in] parallel whether to evaluate the dimensions in parallel
  */
 template <typename F>
-void finite_diff_gradient_auto(const F& f, const Eigen::VectorXd& x, double& fx,
-                               Eigen::VectorXd& grad_fx) {
-  Eigen::VectorXd x_temp(x);
+void finite_diff_gradient_auto(
+    const F& f, const Eigen::VectorXd& x, double& fx, Eigen::VectorXd& grad_fx,
+    finite_diff_stencil stencil = finite_diff_stencil::central,
+    bool parallel = false) {
   fx = f(x);
   grad_fx.resize(x.size());
-  for (int i = 0; i < x.size(); ++i) {
-    double h = finite_diff_stepsize(x(i));
+  internal::finite_diff_for_each(
+      x.size(), parallel, [&](const tbb::blocked_range<size_t>& r) {
+        Eigen::VectorXd x_temp(x);
+        for (size_t i = r.begin(); i < r.end(); ++i) {
+          if (stencil == finite_diff_stencil::forward) {
+            const double h = internal::finite_diff_forward_stepsize(x(i));
+            x_temp(i) = x(i) + h;
+            grad_fx(i) = (f(x_temp) - fx) / h;
+            x_temp(i) = x(i);
+            continue;
+          }
+          double h = finite_diff_stepsize(x(i));
 
-    double delta_f = 0;
+          double delta_f = 0;
 
-    x_temp(i) = x(i) + 3 * h;
-    delta_f += f(x_temp);
+          x_temp(i) = x(i) + 3 * h;
+          delta_f += f(x_temp);
 
-    x_temp(i) = x(i) + 2 * h;
-    delta_f -= 9 * f(x_temp);
+          x_temp(i) = x(i) + 2 * h;
+          delta_f -= 9 * f(x_temp);
 
-    x_temp(i) = x(i) + h;
-    delta_f += 45 * f(x_temp);
+          x_temp(i) = x(i) + h;
+          delta_f += 45 * f(x_temp);
 
-    x_temp(i) = x(i) + -3 * h;
-    delta_f -= f(x_temp);
+          x_temp(i) = x(i) + -3 * h;
+          delta_f -= f(x_temp);
 
-    x_temp(i) = x(i) + -2 * h;
-    delta_f += 9 * f(x_temp);
+          x_temp(i) = x(i) + -2 * h;
+          delta_f += 9 * f(x_temp);
 
-    x_temp(i) = x(i) - h;
-    delta_f -= 45 * f(x_temp);
+          x_temp(i) = x(i) - h;
+          delta_f -= 45 * f(x_temp);
 
-    delta_f /= 60 * h;
+          delta_f /= 60 * h;
 
-    x_temp(i) = x(i);
-    grad_fx(i) = delta_f;
-  }
+          x_temp(i) = x(i);
+          grad_fx(i) = delta_f;
+        }
+      });
 }
 
 }  // namespace math
@@ -5,6 +5,7 @@
 #include <stan/math/prim/functor/finite_diff_gradient_auto.hpp>
 #include <stan/math/prim/functor/finite_diff_hessian_helper.hpp>
 #include <stan/math/prim/scal/fun/finite_diff_stepsize.hpp>
+#include <cmath>
 
 namespace stan {
 namespace math {
@@ -31,53 +32,126 @@ namespace math {
  * <p>For each non-diagonal entry in the Hessian, the function is
  * evaluated 16 times; the diagonal entries require 4 function evaluations.
  *
+ * <p>The forward stencil evaluates the function once on both sides of
+ * the argument along each dimension and once per non-diagonal entry.
+ * The gradient and the diagonal are central differences of second
+ * order of these evaluations and the non-diagonal entries are forward
+ * differences which reuse the value at the argument and the
+ * evaluations along the dimensions, with an error on the order of the
+ * step. This takes `1 + 2 * d + d * (d - 1) / 2` evaluations for `d`
+ * dimensions.
+ *
+ * <p>If parallel evaluation is requested and `STAN_THREADS` is
+ * defined, the entries are split over the threads of the TBB with
+ * `tbb::parallel_for`, such that the functor must be safe to call
+ * concurrently.
+ *
  * @tparam F Type of function
  * @param[in] f Function
  * @param[in] x Argument to function
  * @param[out] fx Function applied to argument
  * @param[out] grad_fx Gradient of function at argument
  * @param[out] hess_fx Hessian of function at argument
+ * @param[in] stencil finite difference stencil
+ * @param[in] parallel whether to evaluate the entries in parallel
  */
 template <typename F>
-void finite_diff_hessian_auto(const F& f, const Eigen::VectorXd& x, double& fx,
-                              Eigen::VectorXd& grad_fx,
-                              Eigen::MatrixXd& hess_fx) {
+void finite_diff_hessian_auto(
+    const F& f, const Eigen::VectorXd& x, double& fx, Eigen::VectorXd& grad_fx,
+    Eigen::MatrixXd& hess_fx,
+    finite_diff_stencil stencil = finite_diff_stencil::central,
+    bool parallel = false) {
   int d = x.size();
-
-  Eigen::VectorXd x_temp(x);
   hess_fx.resize(d, d);
 
-  finite_diff_gradient_auto(f, x, fx, grad_fx);
-  double f_diff = 0;
-  for (int i = 0; i < d; ++i) {
-    for (int j = i; j < d; ++j) {
-      double epsilon = finite_diff_stepsize(x(i));
-      x_temp(i) += 2 * epsilon;
-      if (i != j) {
-        f_diff = -finite_diff_hessian_helper(f, x_temp, j, epsilon);
-        x_temp(i) = x(i) + -2 * epsilon;
-        f_diff += finite_diff_hessian_helper(f, x_temp, j, epsilon);
-        x_temp(i) = x(i) + epsilon;
-        f_diff += 8 * finite_diff_hessian_helper(f, x_temp, j, epsilon);
-        x_temp(i) = x(i) + -epsilon;
-        f_diff -= 8 * finite_diff_hessian_helper(f, x_temp, j, epsilon);
-        f_diff /= 12 * epsilon * 12 * epsilon;
-      } else {
-        f_diff = -f(x_temp);
-        f_diff -= 30 * fx;
-        x_temp(i) = x(i) + -2 * epsilon;
-        f_diff -= f(x_temp);
-        x_temp(i) = x(i) + epsilon;
-        f_diff += 16 * f(x_temp);
-        x_temp(i) = x(i) - epsilon;
-        f_diff += 16 * f(x_temp);
-        f_diff /= 12 * epsilon * epsilon;
-      }
-      x_temp(i) = x(i);
-      hess_fx(j, i) = f_diff;
-      hess_fx(i, j) = hess_fx(j, i);
-    }
+  if (stencil == finite_diff_stencil::forward) {
+    fx = f(x);
+    grad_fx.resize(d);
+    Eigen::VectorXd epsilon(d);
+    Eigen::VectorXd f_plus(d);
+    internal::finite_diff_for_each(
+        d, parallel, [&](const tbb::blocked_range<size_t>& r) {
+          Eigen::VectorXd x_temp(x);
+          for (size_t i = r.begin(); i < r.end(); ++i) {
+            // round the step such that it is exact
+            x_temp(i) = x(i) + finite_diff_stepsize(x(i));
+            epsilon(i) = x_temp(i) - x(i);
+            f_plus(i) = f(x_temp);
+            x_temp(i) = x(i) - epsilon(i);
+            const double f_minus = f(x_temp);
+            x_temp(i) = x(i);
+            grad_fx(i) = (f_plus(i) - f_minus) / (2 * epsilon(i));
+            hess_fx(i, i)
+                = (f_plus(i) - 2 * fx + f_minus) / (epsilon(i) * epsilon(i));
+          }
+        });
+    internal::finite_diff_for_each(
+        d * (d - 1) / 2, parallel, [&](const tbb::blocked_range<size_t>& r) {
+          Eigen::VectorXd x_temp(x);
+          for (size_t k = r.begin(); k < r.end(); ++k) {
+            // the k-th entry below the diagonal in row major order
+            int i = static_cast<int>((1 + std::sqrt(1.0 + 8.0 * k)) / 2);
+            while (i * (i - 1) / 2 > static_cast<int>(k)) {
+              --i;
+            }
+            while ((i + 1) * i / 2 <= static_cast<int>(k)) {
+              ++i;
+            }
+            const int j = k - i * (i - 1) / 2;
+            x_temp(i) = x(i) + epsilon(i);
+            x_temp(j) = x(j) + epsilon(j);
+            hess_fx(i, j) = (f(x_temp) - f_plus(i) - f_plus(j) + fx)
+                            / (epsilon(i) * epsilon(j));
+            hess_fx(j, i) = hess_fx(i, j);
+            x_temp(i) = x(i);
+            x_temp(j) = x(j);
+          }
+        });
+    return;
   }
+
+  finite_diff_gradient_auto(f, x, fx, grad_fx, stencil, parallel);
+  internal::finite_diff_for_each(
+      d * (d + 1) / 2, parallel, [&](const tbb::blocked_range<size_t>& r) {
+        Eigen::VectorXd x_temp(x);
+        for (size_t k = r.begin(); k < r.end(); ++k) {
+          // the k-th entry on or above the diagonal in column major order
+          int j = static_cast<int>((std::sqrt(1.0 + 8.0 * k) - 1) / 2);
+          while (j * (j + 1) / 2 > static_cast<int>(k)) {
+            --j;
+          }
+          while ((j + 1) * (j + 2) / 2 <= static_cast<int>(k)) {
+            ++j;
+          }
+          const int i = k - j * (j + 1) / 2;
+          double f_diff = 0;
+          double epsilon = finite_diff_stepsize(x(i));
+          x_temp(i) += 2 * epsilon;
+          if (i != j) {
+            f_diff = -finite_diff_hessian_helper(f, x_temp, j, epsilon);
+            x_temp(i) = x(i) + -2 * epsilon;
+            f_diff += finite_diff_hessian_helper(f, x_temp, j, epsilon);
+            x_temp(i) = x(i) + epsilon;
+            f_diff += 8 * finite_diff_hessian_helper(f, x_temp, j, epsilon);
+            x_temp(i) = x(i) + -epsilon;
+            f_diff -= 8 * finite_diff_hessian_helper(f, x_temp, j, epsilon);
+            f_diff /= 12 * epsilon * 12 * epsilon;
+          } else {
+            f_diff = -f(x_temp);
+            f_diff -= 30 * fx;
+            x_temp(i) = x(i) + -2 * epsilon;
+            f_diff -= f(x_temp);
+            x_temp(i) = x(i) + epsilon;
+            f_diff += 16 * f(x_temp);
+            x_temp(i) = x(i) - epsilon;
+            f_diff += 16 * f(x_temp);
+            f_diff /= 12 * epsilon * epsilon;
+          }
+          x_temp(i) = x(i);
+          hess_fx(j, i) = f_diff;
+          hess_fx(i, j) = hess_fx(j, i);
+        }
+      });
 }
 }  // namespace math
 }  // namespace stan
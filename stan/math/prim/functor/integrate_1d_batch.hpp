@@ -0,0 +1,523 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_INTEGRATE_1D_BATCH_HPP
+#define STAN_MATH_PRIM_FUNCTOR_INTEGRATE_1D_BATCH_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+#include <boost/math/quadrature/gauss.hpp>
+#include <boost/math/quadrature/gauss_kronrod.hpp>
+#include <boost/math/special_functions/legendre.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Quadrature rule of <code>integrate_1d_batch</code>, which evaluates
+ * the integrand at a whole batch of abscissae at once.
+ *
+ * The default is the adaptive 21 point Gauss-Kronrod rule, which
+ * repeatedly bisects the subinterval with the largest error estimate.
+ * Each subinterval is one batch of 21 abscissae. Infinite limits are
+ * mapped to a finite interval by a change of variables.
+ *
+ * The fixed Gauss-Legendre rule over finite limits and the fixed
+ * Gauss-Hermite rule over the real line evaluate the integrand once on
+ * a single batch and provide no error estimate. The Gauss-Hermite
+ * weights include the factor <code>exp(x^2)</code>, such that the rule
+ * approximates the integral of the integrand itself. It is exact for a
+ * Gaussian density times a polynomial of low degree, as for the
+ * marginalization over normal random effects.
+ *
+ * The nodes and weights of the fixed rules are computed when the rule
+ * is constructed, such that a rule which is used for many integrals
+ * should be constructed once.
+ */
+class integrate_1d_rule {
+ public:
+  enum class kind { gauss_kronrod, gauss_legendre, gauss_hermite };
+
+  /**
+   * Construct the adaptive Gauss-Kronrod rule with at most 1000
+   * subintervals.
+   */
+  integrate_1d_rule() : kind_(kind::gauss_kronrod), max_intervals_(1000) {}
+
+  /**
+   * Return the adaptive 21 point Gauss-Kronrod rule.
+   *
+   * @param max_intervals maximal number of subintervals
+   * @throw std::domain_error if the number is not positive
+   */
+  static integrate_1d_rule gauss_kronrod(int max_intervals = 1000) {
+    check_positive("integrate_1d_rule", "maximal number of subintervals",
+                   max_intervals);
+    integrate_1d_rule rule;
+    rule.max_intervals_ = max_intervals;
+    return rule;
+  }
+
+  /**
+   * Return the fixed Gauss-Legendre rule with n nodes over finite
+   * limits, which is exact for polynomials of degree 2n - 1.
+   *
+   * @param n number of nodes
+   * @throw std::domain_error if the number is not positive
+   */
+  static integrate_1d_rule gauss_legendre(int n) {
+    check_positive("integrate_1d_rule", "number of nodes", n);
+    integrate_1d_rule rule;
+    rule.kind_ = kind::gauss_legendre;
+    const std::vector<double> zeros = boost::math::legendre_p_zeros<double>(n);
+    for (double x : zeros) {
+      const double p = boost::math::legendre_p_prime(n, x);
+      const double w = 2 / ((1 - x * x) * p * p);
+      rule.add_node(x, w);
+      if (x > 0) {
+        rule.add_node(-x, w);
+      }
+    }
+    return rule;
+  }
+
+  /**
+   * Return the fixed Gauss-Hermite rule with n nodes over the real
+   * line, which is exact for <code>exp(-x^2)</code> times polynomials of
+   * degree 2n - 1.
+   *
+   * The nodes start from the eigenvalues of the Jacobi matrix and are
+   * refined by Newton iterations on the orthonormal Hermite
+   * polynomials, from which the weights follow.
+   *
+   * @param n number of nodes
+   * @throw std::domain_error if the number is not positive
+   */
+  static integrate_1d_rule gauss_hermite(int n) {
+    check_positive("integrate_1d_rule", "number of nodes", n);
+    integrate_1d_rule rule;
+    rule.kind_ = kind::gauss_hermite;
+    Eigen::MatrixXd jacobi = Eigen::MatrixXd::Zero(n, n);
+    for (int k = 1; k < n; ++k) {
+      jacobi(k, k - 1) = jacobi(k - 1, k) = std::sqrt(0.5 * k);
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(
+        jacobi, Eigen::EigenvaluesOnly);
+    for (int i = 0; i < n; ++i) {
+      double x = solver.eigenvalues()(i);
+      double derivative = 0;
+      for (int iteration = 0; iteration < 10; ++iteration) {
+        // orthonormal Hermite polynomials scaled by exp(-x^2 / 2)
+        double p = std::exp(-0.5 * x * x) / std::sqrt(std::sqrt(pi()));
+        double p_previous = 0;
+        for (int j = 1; j <= n; ++j) {
+          const double p_next = x * std::sqrt(2.0 / j) * p
+                                - std::sqrt((j - 1.0) / j) * p_previous;
+          p_previous = p;
+          p = p_next;
+        }
+        derivative = std::sqrt(2.0 * n) * p_previous;
+        const double step = p / derivative;
+        x -= step;
+        if (std::fabs(step) <= EPSILON * std::fmax(1.0, std::fabs(x))) {
+          break;
+        }
+      }
+      rule.add_node(x, 2 / (derivative * derivative));
+    }
+    return rule;
+  }
+
+  /**
+   * Return the kind of this rule.
+   */
+  kind type() const { return kind_; }
+
+  /**
+   * Return the maximal number of subintervals of the Gauss-Kronrod
+   * rule.
+   */
+  int max_intervals() const { return max_intervals_; }
+
+  /**
+   * Return the nodes of a fixed rule, on [-1, 1] for Gauss-Legendre.
+   */
+  const std::vector<double>& nodes() const { return nodes_; }
+
+  /**
+   * Return the weights of a fixed rule.
+   */
+  const std::vector<double>& weights() const { return weights_; }
+
+ private:
+  void add_node(double x, double w) {
+    nodes_.push_back(x);
+    weights_.push_back(w);
+  }
+
+  kind kind_;
+  int max_intervals_;
+  std::vector<double> nodes_;
+  std::vector<double> weights_;
+};
+
+namespace internal {
+
+/**
+ * Change of variables of <code>integrate_1d_batch</code> from a finite
+ * interval of t to the limits of integration.
+ *
+ * Finite limits are not transformed. A single infinite limit uses
+ * <code>x = a + t / (1 - t)</code> on [0, 1) or
+ * <code>x = b + t / (1 + t)</code> on (-1, 0] and two infinite limits
+ * use <code>x = t / (1 - t^2)</code> on (-1, 1).
+ */
+class batch_substitution {
+ public:
+  batch_substitution(double a, double b) : a_(a), b_(b) {}
+
+  double t_lower() const {
+    return std::isinf(a_) ? -1.0 : std::isinf(b_) ? 0.0 : a_;
+  }
+
+  double t_upper() const {
+    return std::isinf(b_) ? 1.0 : std::isinf(a_) ? 0.0 : b_;
+  }
+
+  /**
+   * Map the node <code>center + half_width * u</code> of the
+   * subinterval [lower, upper] of t.
+   *
+   * @param[out] x abscissa
+   * @param[out] xc distance of the abscissa to the nearest limit,
+   * negative towards a, or NaN if a limit is infinite
+   * @return derivative of x wrt to t
+   */
+  double map(double lower, double upper, double u, double& x,
+             double& xc) const {
+    const double half_width = 0.5 * (upper - lower);
+    const double t = lower + half_width + half_width * u;
+    xc = NOT_A_NUMBER;
+    if (std::isinf(a_) && std::isinf(b_)) {
+      const double s = 1 / (1 - t * t);
+      x = t * s;
+      return (1 + t * t) * s * s;
+    } else if (std::isinf(b_)) {
+      const double s = 1 / (1 - t);
+      x = a_ + t * s;
+      return s * s;
+    } else if (std::isinf(a_)) {
+      const double s = 1 / (1 + t);
+      x = b_ + t * s;
+      return s * s;
+    }
+    x = t;
+    if (x - a_ < b_ - x) {
+      xc = lower == a_ ? -half_width * (1 + u) : a_ - x;
+    } else {
+      xc = upper == b_ ? half_width * (1 - u) : b_ - x;
+    }
+    return 1.0;
+  }
+
+ private:
+  double a_;
+  double b_;
+};
+
+/**
+ * Subinterval of the adaptive Gauss-Kronrod quadrature.
+ */
+struct gauss_kronrod_interval {
+  double lower;
+  double upper;
+  Eigen::VectorXd integral;
+  Eigen::VectorXd norm;
+  double error;
+};
+
+/**
+ * Apply the 21 point Gauss-Kronrod rule to a subinterval of t in a
+ * single batch.
+ *
+ * @tparam G type of the weighted sums of the integrand
+ * @param g weighted sums of the integrand; see
+ * <code>integrate_batch</code>
+ * @param substitution change of variables
+ * @param lower lower limit of the subinterval of t
+ * @param upper upper limit of the subinterval of t
+ * @param size number of components of the integral
+ * @return the subinterval with its integral and error estimate
+ */
+template <typename G>
+gauss_kronrod_interval gauss_kronrod_21(const G& g,
+                                        const batch_substitution& substitution,
+                                        double lower, double upper,
+                                        int size) {
+  using boost::math::quadrature::gauss;
+  using boost::math::quadrature::gauss_kronrod;
+  const auto& abscissa = gauss_kronrod<double, 21>::abscissa();
+  const auto& kronrod_weights = gauss_kronrod<double, 21>::weights();
+  const auto& gauss_weights = gauss<double, 10>::weights();
+  const double half_width = 0.5 * (upper - lower);
+
+  // the center is a Kronrod node and the Gauss nodes are the odd ones
+  Eigen::VectorXd x(21);
+  Eigen::VectorXd xc(21);
+  Eigen::MatrixXd w = Eigen::MatrixXd::Zero(21, 2);
+  for (int i = 0; i < 11; ++i) {
+    for (int sign = (i == 0 ? 1 : -1); sign <= 1; sign += 2) {
+      const int k = i == 0 ? 0 : 2 * i - (sign < 0 ? 1 : 0);
+      const double jacobian = substitution.map(
+          lower, upper, sign * abscissa[i], x(k), xc(k));
+      w(k, 0) = half_width * jacobian * kronrod_weights[i];
+      if (i % 2 == 1) {
+        w(k, 1) = half_width * jacobian * gauss_weights[i / 2];
+      }
+    }
+  }
+  const Eigen::MatrixXd sums = g(x, xc, w);
+  check_size_match("integrate_1d_batch", "rows of weighted sums",
+                   sums.rows(), "size of integral", size);
+
+  gauss_kronrod_interval interval;
+  interval.lower = lower;
+  interval.upper = upper;
+  interval.integral = sums.col(0);
+  interval.norm = sums.col(2);
+  interval.error = std::fmax(
+      (sums.col(0) - sums.col(1)).template lpNorm<Eigen::Infinity>(),
+      2 * EPSILON * sums.col(0).template lpNorm<Eigen::Infinity>());
+  return interval;
+}
+
+/**
+ * Integrate a function from a to b with the adaptive 21 point
+ * Gauss-Kronrod rule, bisecting the subinterval with the largest error
+ * estimate until the sum of the error estimates is within the relative
+ * tolerance of the norm of the integral.
+ *
+ * @tparam G type of the weighted sums of the integrand
+ * @param g weighted sums of the integrand; see
+ * <code>integrate_batch</code>
+ * @param a lower limit of integration
+ * @param b upper limit of integration
+ * @param relative_tolerance relative tolerance
+ * @param size number of components of the integral
+ * @param max_intervals maximal number of subintervals
+ * @return integral
+ * @throw std::domain_error if the tolerance is not met with the maximal
+ * number of subintervals or the integral is not finite
+ */
+template <typename G>
+Eigen::VectorXd gauss_kronrod_batch(const G& g, double a, double b,
+                                    double relative_tolerance, int size,
+                                    int max_intervals) {
+  static const char* function = "integrate_1d_batch";
+  const batch_substitution substitution(a, b);
+  std::vector<gauss_kronrod_interval> intervals;
+  intervals.push_back(gauss_kronrod_21(g, substitution, substitution.t_lower(),
+                                       substitution.t_upper(), size));
+  while (true) {
+    Eigen::VectorXd integral = Eigen::VectorXd::Zero(size);
+    Eigen::VectorXd norm = Eigen::VectorXd::Zero(size);
+    double error = 0;
+    size_t worst = 0;
+    for (size_t i = 0; i < intervals.size(); ++i) {
+      integral += intervals[i].integral;
+      norm += intervals[i].norm;
+      error += intervals[i].error;
+      if (intervals[i].error > intervals[worst].error) {
+        worst = i;
+      }
+    }
+    if (!integral.allFinite()) {
+      throw_domain_error(function, "integral", error, "",
+                         " is not finite; the integrand was evaluated at a "
+                         "singular point");
+    }
+    if (error <= relative_tolerance * norm.template lpNorm<Eigen::Infinity>()) {
+      return integral;
+    }
+
+    const double lower = intervals[worst].lower;
+    const double upper = intervals[worst].upper;
+    const double middle = lower + 0.5 * (upper - lower);
+    if (static_cast<int>(intervals.size()) >= max_intervals
+        || !(lower < middle && middle < upper)) {
+      throw_domain_error(function, "error estimate of integral", error, "",
+                         " exceeds the given relative tolerance times norm of "
+                         "integral after the maximal number of subintervals");
+    }
+    intervals[worst] = gauss_kronrod_21(g, substitution, lower, middle, size);
+    intervals.push_back(gauss_kronrod_21(g, substitution, middle, upper, size));
+  }
+}
+
+/**
+ * Integrate a function from a to b with a batched quadrature rule.
+ *
+ * The integrand enters only through weighted sums of its values over a
+ * batch of abscissae, which are computed by g with the signature
+ *
+ *   Eigen::MatrixXd g(const Eigen::VectorXd& x, const Eigen::VectorXd& xc,
+ *                     const Eigen::MatrixXd& w)
+ *
+ * For the values f(x_i) of the integrand at the abscissae x with the
+ * complements xc, column j of the result holds the sums of
+ * <code>w(i, j) * f(x_i)</code> over the batch for every component of
+ * the integrand and the last column holds an estimate of the norm of
+ * the integral over the batch, usually the sums of
+ * <code>|w(i, 0) * f(x_i)|</code>.
+ *
+ * @tparam G type of the weighted sums of the integrand
+ * @param g weighted sums of the integrand
+ * @param a lower limit of integration
+ * @param b upper limit of integration
+ * @param relative_tolerance relative tolerance of the Gauss-Kronrod
+ * rule
+ * @param size number of components of the integral
+ * @param rule quadrature rule
+ * @return integral
+ * @throw std::invalid_argument if the limits do not suit a fixed rule
+ * @throw std::domain_error if the Gauss-Kronrod rule fails to meet the
+ * tolerance or the integral is not finite
+ */
+template <typename G>
+Eigen::VectorXd integrate_batch(const G& g, double a, double b,
+                                double relative_tolerance, int size,
+                                const integrate_1d_rule& rule) {
+  static const char* function = "integrate_1d_batch";
+  if (rule.type() == integrate_1d_rule::kind::gauss_kronrod) {
+    return gauss_kronrod_batch(g, a, b, relative_tolerance, size,
+                               rule.max_intervals());
+  }
+
+  const size_t n = rule.nodes().size();
+  Eigen::VectorXd x(n);
+  Eigen::VectorXd xc(n);
+  Eigen::MatrixXd w(n, 1);
+  if (rule.type() == integrate_1d_rule::kind::gauss_legendre) {
+    if (std::isinf(a) || std::isinf(b)) {
+      invalid_argument(function, "limits of the Gauss-Legendre rule", "", "",
+                       " must be finite");
+    }
+    const batch_substitution substitution(a, b);
+    for (size_t i = 0; i < n; ++i) {
+      substitution.map(a, b, rule.nodes()[i], x(i), xc(i));
+      w(i, 0) = 0.5 * (b - a) * rule.weights()[i];
+    }
+  } else {
+    if (!(std::isinf(a) && std::isinf(b))) {
+      invalid_argument(function, "limits of the Gauss-Hermite rule", "", "",
+                       " must both be infinite");
+    }
+    for (size_t i = 0; i < n; ++i) {
+      x(i) = rule.nodes()[i];
+      xc(i) = NOT_A_NUMBER;
+      w(i, 0) = rule.weights()[i];
+    }
+  }
+  const Eigen::MatrixXd sums = g(x, xc, w);
+  check_size_match(function, "rows of weighted sums", sums.rows(),
+                   "size of integral", size);
+  const Eigen::VectorXd integral = sums.col(0);
+  if (!integral.allFinite()) {
+    throw_domain_error(function, "integral", integral(0), "",
+                       " is not finite; the integrand was evaluated at a "
+                       "singular point");
+  }
+  return integral;
+}
+
+}  // namespace internal
+
+/**
+ * Calculate the weighted sums of the values of a batched integrand
+ * f(x, xc, theta, x_r, x_i, msgs) over a batch of abscissae, followed
+ * by the weighted sum of their absolute values with the first column
+ * of weights.
+ */
+template <typename F>
+inline Eigen::MatrixXd weighted_values_of_f(
+    const F& f, const Eigen::VectorXd& x, const Eigen::VectorXd& xc,
+    const Eigen::MatrixXd& w, const std::vector<double>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    std::ostream* msgs) {
+  const Eigen::VectorXd fx = f(x, xc, theta, x_r, x_i, msgs);
+  check_size_match("integrate_1d_batch", "values of integrand", fx.size(),
+                   "abscissae", x.size());
+  Eigen::MatrixXd sums(1, w.cols() + 1);
+  sums.leftCols(w.cols()) = fx.transpose() * w;
+  sums(0, w.cols()) = fx.cwiseAbs().dot(w.col(0).cwiseAbs());
+  return sums;
+}
+
+/**
+ * Compute the integral of the single variable function f from a to b
+ * with a quadrature rule which evaluates f at a whole batch of
+ * abscissae at once. a and b can be finite or infinite, as supported
+ * by the rule.
+ *
+ * The signature for f should be:
+ *   Eigen::VectorXd f(const Eigen::VectorXd& x, const Eigen::VectorXd& xc,
+ *     const std::vector<double>& theta, const std::vector<double>& x_r,
+ *     const std::vector<int>& x_i, std::ostream* msgs)
+ *
+ * It should return the values of the function evaluated at each of the
+ * abscissae x. Any errors should be printed to the msgs stream.
+ *
+ * For finite limits, xc holds the distances of the abscissae to the
+ * nearest limit, a - x for x closer to a and b - x for x closer to b,
+ * computed without the precision loss of computing them manually. If
+ * either limit is infinite, xc is NaN.
+ *
+ * The default adaptive Gauss-Kronrod rule terminates when the sum of
+ * the error estimates of its subintervals is below the relative
+ * tolerance times the norm of the integral. The fixed rules ignore the
+ * relative tolerance; see <code>integrate_1d_rule</code>.
+ *
+ * @tparam F Type of f
+ * @param f the function to be integrated
+ * @param a lower limit of integration
+ * @param b upper limit of integration
+ * @param theta additional parameters to be passed to f
+ * @param x_r additional data to be passed to f
+ * @param x_i additional integer data to be passed to f
+ * @param[in, out] msgs the print stream for warning messages
+ * @param relative_tolerance target relative tolerance
+ * @param rule quadrature rule
+ * @return numeric integral of function f
+ */
+template <typename F>
+inline double integrate_1d_batch(
+    const F& f, const double a, const double b,
+    const std::vector<double>& theta, const std::vector<double>& x_r,
+    const std::vector<int>& x_i, std::ostream* msgs,
+    const double relative_tolerance = std::sqrt(EPSILON),
+    const integrate_1d_rule& rule = integrate_1d_rule()) {
+  static const char* function = "integrate_1d_batch";
+  check_less_or_equal(function, "lower limit", a, b);
+
+  if (a == b) {
+    if (std::isinf(a)) {
+      throw_domain_error(function, "Integration endpoints are both", a, "", "");
+    }
+    return 0.0;
+  }
+  return internal::integrate_batch(
+      [&](const Eigen::VectorXd& x, const Eigen::VectorXd& xc,
+          const Eigen::MatrixXd& w) {
+        return weighted_values_of_f(f, x, xc, w, theta, x_r, x_i, msgs);
+      },
+      a, b, relative_tolerance, 1, rule)(0);
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
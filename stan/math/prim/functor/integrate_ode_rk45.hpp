@@ -12,14 +12,135 @@
 #endif
 #include <boost/numeric/odeint.hpp>
 #include <algorithm>
+#include <cmath>
 #include <ostream>
 #include <functional>
-#include <iterator>
+#include <limits>
 #include <vector>
 
 namespace stan {
 namespace math {
 
+/**
+ * Options of the Runge-Kutta 45 integrator.
+ */
+struct ode_rk45_options {
+  /**
+   * Size of the first step. A non-positive size selects the first
+   * step from the ODE RHS at the initial state.
+   */
+  double initial_step_size = 0;
+
+  /**
+   * Whether the error control is restricted to the states of the ODE
+   * and ignores the sensitivities of the coupled ode system.
+   */
+  bool error_control_states_only = false;
+};
+
+namespace internal {
+
+/**
+ * Error checker of the step size control of the Runge-Kutta 45
+ * integrator, which applies the error measure of odeint's
+ * <code>default_error_checker</code> to the leading elements of the
+ * state only.
+ */
+class rk45_error_checker {
+  double eps_abs_;
+  double eps_rel_;
+  size_t size_;
+
+ public:
+  /**
+   * @param[in] eps_abs absolute tolerance
+   * @param[in] eps_rel relative tolerance
+   * @param[in] size number of leading elements of the state subject
+   * to the error control
+   */
+  rk45_error_checker(double eps_abs, double eps_rel, size_t size)
+      : eps_abs_(eps_abs), eps_rel_(eps_rel), size_(size) {}
+
+  template <typename Algebra, typename State, typename Deriv, typename Err,
+            typename Time>
+  double error(Algebra& algebra, const State& x_old, const Deriv& dxdt_old,
+               Err& x_err, Time dt) const {
+    using std::abs;
+    double max_err = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      const double scale
+          = eps_abs_ + eps_rel_ * (abs(x_old[i]) + abs(dt) * abs(dxdt_old[i]));
+      max_err = std::max(max_err, abs(x_err[i]) / scale);
+    }
+    return max_err;
+  }
+};
+
+/**
+ * Return the size of the first step of an explicit method of order
+ * five for the specified system, computed with the algorithm of
+ * Hairer, Norsett and Wanner (Solving Ordinary Differential
+ * Equations I, section II.4) from two evaluations of the RHS. The
+ * norms are taken over the leading <code>size</code> elements of the
+ * state.
+ *
+ * @tparam System type of the ode system
+ * @param[in] system ode system
+ * @param[in] z0 initial state
+ * @param[in] t0 initial time
+ * @param[in] t_end last time of the integration
+ * @param[in] size number of leading elements of the state subject to
+ * the error control
+ * @param[in] absolute_tolerance absolute tolerance
+ * @param[in] relative_tolerance relative tolerance
+ * @return size of the first step
+ */
+template <typename System>
+double rk45_initial_step_size(const System& system,
+                              const std::vector<double>& z0, double t0,
+                              double t_end, size_t size,
+                              double absolute_tolerance,
+                              double relative_tolerance) {
+  using std::abs;
+  using std::pow;
+  using std::sqrt;
+  std::vector<double> dz0(z0.size());
+  system(z0, dz0, t0);
+
+  double d0 = 0;
+  double d1 = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const double scale = absolute_tolerance + relative_tolerance * abs(z0[i]);
+    d0 += (z0[i] / scale) * (z0[i] / scale);
+    d1 += (dz0[i] / scale) * (dz0[i] / scale);
+  }
+  d0 = sqrt(d0 / size);
+  d1 = sqrt(d1 / size);
+  double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+  h0 = std::min(h0, t_end - t0);
+
+  std::vector<double> z1(z0.size());
+  for (size_t i = 0; i < z0.size(); ++i) {
+    z1[i] = z0[i] + h0 * dz0[i];
+  }
+  std::vector<double> dz1(z0.size());
+  system(z1, dz1, t0 + h0);
+
+  double d2 = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const double scale = absolute_tolerance + relative_tolerance * abs(z0[i]);
+    d2 += ((dz1[i] - dz0[i]) / scale) * ((dz1[i] - dz0[i]) / scale);
+  }
+  d2 = sqrt(d2 / size) / h0;
+
+  const double d = std::max(d1, d2);
+  const double h1 = d <= 1e-15 ? std::max(1e-6, h0 * 1e-3)
+                               : pow(0.01 / d, 1.0 / 5.0);
+  return std::min({100 * h0, h1, t_end - t0});
+}
+
+}  // namespace internal
+
 /**
  * Return the solutions for the specified system of ordinary
  * differential equations given the specified initial state,
@@ -42,6 +163,10 @@ namespace math {
  * href="http://en.wikipedia.org/wiki/Dormand–Prince_method">Dormand-Prince
  * method</a> as implemented in Boost's <code>
  * boost::numeric::odeint::runge_kutta_dopri5</code> integrator.
+ * The solutions at the output times are interpolated by the dense
+ * output of the integrator. The size of the first step and whether
+ * the error control includes the sensitivities are set with
+ * <code>options</code>.
  *
  * @tparam F type of ODE system function.
  * @tparam T1 type of scalars for initial values.
@@ -63,6 +188,7 @@ namespace math {
  *   for Boost's ode solver. Defaults to 1e-6.
  * @param[in] max_num_steps maximum number of steps to take within
  *   the Boost ode solver.
+ * @param[in] options size of the first step and error control.
  * @return a vector of states, each state being a vector of the
  * same size as the state variable, corresponding to a time in ts.
  */
@@ -71,12 +197,18 @@ std::vector<std::vector<return_type_t<T1, T2, T_t0, T_ts>>> integrate_ode_rk45(
     const F& f, const std::vector<T1>& y0, const T_t0& t0,
     const std::vector<T_ts>& ts, const std::vector<T2>& theta,
     const std::vector<double>& x, const std::vector<int>& x_int,
-    std::ostream* msgs = nullptr, double relative_tolerance = 1e-6,
-    double absolute_tolerance = 1e-6, int max_num_steps = 1E6) {
-  using boost::numeric::odeint::integrate_times;
-  using boost::numeric::odeint::make_dense_output;
+    std::ostream* msgs, double relative_tolerance, double absolute_tolerance,
+    int max_num_steps, const ode_rk45_options& options) {
+  using boost::numeric::odeint::controlled_runge_kutta;
+  using boost::numeric::odeint::default_step_adjuster;
+  using boost::numeric::odeint::dense_output_runge_kutta;
   using boost::numeric::odeint::max_step_checker;
   using boost::numeric::odeint::runge_kutta_dopri5;
+  using stepper_t = runge_kutta_dopri5<std::vector<double>, double,
+                                       std::vector<double>, double>;
+  using controller_t
+      = controlled_runge_kutta<stepper_t, internal::rk45_error_checker,
+                               default_step_adjuster<double, double>>;
 
   const double t0_dbl = value_of(t0);
   const std::vector<double> ts_dbl = value_of(ts);
@@ -108,42 +240,87 @@ std::vector<std::vector<return_type_t<T1, T2, T_t0, T_ts>>> integrate_ode_rk45(
   // creates basic or coupled system by template specializations
   coupled_ode_system<F, T1, T2> coupled_system(f, y0, theta, x, x_int, msgs);
 
-  // first time in the vector must be time of initial state
-  std::vector<double> ts_vec(ts.size() + 1);
-  ts_vec[0] = t0_dbl;
-  std::copy(ts_dbl.begin(), ts_dbl.end(), ts_vec.begin() + 1);
-
   std::vector<std::vector<return_type_t<T1, T2, T_t0, T_ts>>> y;
   coupled_ode_observer<F, T1, T2, T_t0, T_ts> observer(f, y0, theta, t0, ts, x,
                                                        x_int, msgs, y);
-  bool observer_initial_recorded = false;
-
-  // avoid recording of the initial state which is included by the
-  // conventions of odeint in the output
-  auto filtered_observer
-      = [&](const std::vector<double>& coupled_state, double t) -> void {
-    if (!observer_initial_recorded) {
-      observer_initial_recorded = true;
-      return;
-    }
-    observer(coupled_state, t);
-  };
 
   // the coupled system creates the coupled initial state
-  std::vector<double> initial_coupled_state = coupled_system.initial_state();
+  std::vector<double> coupled_state = coupled_system.initial_state();
+  const size_t error_size = options.error_control_states_only
+                                ? y0.size()
+                                : coupled_state.size();
+  const double t_last = ts_dbl.back();
+  const double step_size
+      = options.initial_step_size > 0
+            ? options.initial_step_size
+            : internal::rk45_initial_step_size(
+                  coupled_system, coupled_state, t0_dbl, t_last, error_size,
+                  absolute_tolerance, relative_tolerance);
+
+  dense_output_runge_kutta<controller_t> stepper(controller_t(
+      internal::rk45_error_checker(absolute_tolerance, relative_tolerance,
+                                   error_size),
+      default_step_adjuster<double, double>(), stepper_t()));
+  max_step_checker checker(max_num_steps);
 
-  const double step_size = 0.1;
-  integrate_times(
-      make_dense_output(absolute_tolerance, relative_tolerance,
-                        runge_kutta_dopri5<std::vector<double>, double,
-                                           std::vector<double>, double>()),
-      std::ref(coupled_system), initial_coupled_state, std::begin(ts_vec),
-      std::end(ts_vec), step_size, filtered_observer,
-      max_step_checker(max_num_steps));
+  // steps as odeint's integrate_times, with the solutions at the
+  // output times interpolated by the dense output of the stepper
+  stepper.initialize(coupled_state, t0_dbl, step_size);
+  // t1 <= t2 in the direction of integration, up to rounding
+  auto less_eq_with_sign = [](double t1, double t2, double dt) {
+    const double eps = std::numeric_limits<double>::epsilon();
+    return dt > 0 ? t1 - t2 <= eps : t2 - t1 <= eps;
+  };
+
+  size_t n = 0;
+  while (n < ts_dbl.size()) {
+    while (n < ts_dbl.size()
+           && less_eq_with_sign(ts_dbl[n], stepper.current_time(),
+                                stepper.current_time_step())) {
+      stepper.calc_state(ts_dbl[n], coupled_state);
+      observer(coupled_state, ts_dbl[n]);
+      checker.reset();
+      ++n;
+    }
+    if (less_eq_with_sign(
+            stepper.current_time() + stepper.current_time_step(), t_last,
+            stepper.current_time_step())) {
+      checker();
+      stepper.do_step(std::ref(coupled_system));
+    } else if (n < ts_dbl.size()) {
+      // do the last step ending exactly on the last output time
+      stepper.initialize(stepper.current_state(), stepper.current_time(),
+                         t_last - stepper.current_time());
+      checker();
+      stepper.do_step(std::ref(coupled_system));
+    }
+  }
 
   return y;
 }
 
+/**
+ * Return the solutions for the specified system of ordinary
+ * differential equations with the Runge-Kutta 45 integrator using a
+ * first step of size 0.1 and the error control on all states of the
+ * coupled ode system.
+ *
+ * @see integrate_ode_rk45 with <code>ode_rk45_options</code>
+ */
+template <typename F, typename T1, typename T2, typename T_t0, typename T_ts>
+std::vector<std::vector<return_type_t<T1, T2, T_t0, T_ts>>> integrate_ode_rk45(
+    const F& f, const std::vector<T1>& y0, const T_t0& t0,
+    const std::vector<T_ts>& ts, const std::vector<T2>& theta,
+    const std::vector<double>& x, const std::vector<int>& x_int,
+    std::ostream* msgs = nullptr, double relative_tolerance = 1e-6,
+    double absolute_tolerance = 1e-6, int max_num_steps = 1E6) {
+  ode_rk45_options options;
+  options.initial_step_size = 0.1;
+  return integrate_ode_rk45(f, y0, t0, ts, theta, x, x_int, msgs,
+                            relative_tolerance, absolute_tolerance,
+                            max_num_steps, options);
+}
+
 }  // namespace math
 
 }  // namespace stan
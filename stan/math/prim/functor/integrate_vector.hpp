@@ -0,0 +1,339 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_INTEGRATE_VECTOR_HPP
+#define STAN_MATH_PRIM_FUNCTOR_INTEGRATE_VECTOR_HPP
+
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+#include <cmath>
+#include <limits>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+// The rules and the refinement below follow the double exponential
+// quadratures of Boost 1.72 in boost/math/quadrature/detail, which
+// integrate() uses for scalar integrands: the same substitutions,
+// ranges of t, numbers of levels, tail truncation and detection of
+// thrashing. They are repeated here as Boost's integrators only take
+// scalar integrands, whose values they pass to abs() and compare,
+// while integrating every component with its own integrator would
+// evaluate the integrand on different nodes for every component.
+
+/**
+ * The tanh_sinh substitution over a finite interval [a, b]. The nodes
+ * are symmetric in t and their distance to the nearest limit is
+ * computed without cancellation.
+ */
+class tanh_sinh_rule {
+ public:
+  tanh_sinh_rule(double a, double b, bool pass_xc)
+      : a_(a), b_(b), half_width_(0.5 * (b - a)), pass_xc_(pass_xc) {}
+
+  static bool symmetric() { return true; }
+  static bool infinite() { return false; }
+  static double s_max() { return 7.0; }
+  static size_t max_levels() { return 15; }
+
+  /**
+   * Compute the node at t. The distance of the node to the nearest
+   * limit is negative towards a and positive towards b.
+   *
+   * @return false if the node can not be told apart from a limit
+   */
+  bool node(double t, double& x, double& xc, double& w) const {
+    const double u = 0.5 * pi() * std::sinh(std::fabs(t));
+    const double cosh_u = std::cosh(u);
+    const double complement = std::exp(-u) / cosh_u;
+    if (!(complement >= 4 * std::numeric_limits<double>::min())) {
+      return false;
+    }
+    const double distance = half_width_ * complement;
+    x = t < 0 ? a_ + distance : b_ - distance;
+    xc = !pass_xc_ ? NOT_A_NUMBER : (t < 0 ? -distance : distance);
+    w = half_width_ * 0.5 * pi() * std::cosh(t) / (cosh_u * cosh_u);
+    return true;
+  }
+
+ private:
+  double a_;
+  double b_;
+  double half_width_;
+  bool pass_xc_;
+};
+
+/**
+ * The exp_sinh substitution over [0, inf), with the node mapped to
+ * <code>offset + sign * x</code>.
+ */
+class exp_sinh_rule {
+ public:
+  exp_sinh_rule(double offset, double sign)
+      : offset_(offset),
+        sign_(sign),
+        t_min_(std::asinh(
+            (std::log(std::numeric_limits<double>::min()) + LOG_EPSILON)
+            / pi())) {}
+
+  static bool symmetric() { return false; }
+  static bool infinite() { return true; }
+  double s_max() const { return t_max() - t_min_; }
+  static size_t max_levels() { return 8; }
+
+  bool node(double s, double& x, double& xc, double& w) const {
+    const double t = t_min_ + s;
+    const double y = std::exp(0.5 * pi() * std::sinh(t));
+    x = offset_ + sign_ * y;
+    xc = NOT_A_NUMBER;
+    w = 0.5 * pi() * std::cosh(t) * y;
+    return std::isfinite(w);
+  }
+
+  /**
+   * Return the largest t of the exp_sinh and sinh_sinh substitutions,
+   * at which the derivative of the substitution is about the square
+   * root of the largest double.
+   */
+  static double t_max() {
+    return std::log(
+        4 / pi()
+        * std::log(4 / pi() * std::sqrt(std::numeric_limits<double>::max())));
+  }
+
+ private:
+  double offset_;
+  double sign_;
+  double t_min_;
+};
+
+/**
+ * The sinh_sinh substitution over the real line.
+ */
+class sinh_sinh_rule {
+ public:
+  static bool symmetric() { return true; }
+  static bool infinite() { return true; }
+  static double s_max() { return exp_sinh_rule::t_max(); }
+  static size_t max_levels() { return 9; }
+
+  bool node(double t, double& x, double& xc, double& w) const {
+    const double u = 0.5 * pi() * std::sinh(t);
+    x = std::sinh(u);
+    xc = NOT_A_NUMBER;
+    w = 0.5 * pi() * std::cosh(t) * std::cosh(u);
+    return std::isfinite(w);
+  }
+};
+
+/**
+ * Integrate a vector valued function with a double exponential rule.
+ *
+ * The trapezoidal rule in t is refined by halving its step until the
+ * change of the estimate between two levels is within the relative
+ * tolerance of the estimate of the integral of the absolute value.
+ * Both are measured in the maximum norm over the components, such
+ * that every component is integrated on the same nodes. Once the
+ * terms of a level become negligible far in an infinite tail, the
+ * remaining nodes of the tail are skipped.
+ *
+ * @tparam F type of the function, returning an Eigen vector for
+ * arguments <code>(double x, double xc)</code>
+ * @tparam Rule type of the substitution
+ * @param f function
+ * @param rule substitution
+ * @param size size of the vector returned by f
+ * @param relative_tolerance relative tolerance
+ * @param[out] error estimated error
+ * @param[out] L1 estimated integral of the absolute value
+ * @return integral of f
+ * @throw std::domain_error if the integral is not finite
+ */
+template <typename F, typename Rule>
+Eigen::VectorXd double_exponential_vector(const F& f, const Rule& rule,
+                                          int size, double relative_tolerance,
+                                          double& error, double& L1) {
+  const double s_max = rule.s_max();
+  Eigen::VectorXd I1 = Eigen::VectorXd::Zero(size);
+  Eigen::VectorXd I0;
+  double L1_I1 = 0;
+  double err = 0;
+  unsigned thrash_count = 0;
+
+  for (size_t k = 0; k < rule.max_levels(); ++k) {
+    const double h = std::ldexp(1.0, -static_cast<int>(k));
+    const double eps = EPSILON * 0.5 * L1_I1;
+    Eigen::VectorXd sum = Eigen::VectorXd::Zero(size);
+    double absum = 0;
+    double previous_term = 1;
+    for (double s = k == 0 ? 0 : h; k == 0 ? s <= s_max : s < s_max;
+         s += k == 0 ? h : 2 * h) {
+      double term = 0;
+      double x, xc, w;
+      double x_max = 0;
+      if (rule.node(s, x, xc, w) && w > 0) {
+        const Eigen::VectorXd y = f(x, xc);
+        sum += w * y;
+        term += w * y.template lpNorm<Eigen::Infinity>();
+        x_max = std::fabs(x);
+      }
+      if (rule.symmetric() && s > 0 && rule.node(-s, x, xc, w) && w > 0) {
+        const Eigen::VectorXd y = f(x, xc);
+        sum += w * y;
+        term += w * y.template lpNorm<Eigen::Infinity>();
+        x_max = std::fmax(x_max, std::fabs(x));
+      }
+      absum += term;
+      if (rule.infinite() && k > 1 && x_max > 100 && term < eps
+          && previous_term < eps) {
+        break;
+      }
+      previous_term = term;
+    }
+
+    I0 = I1;
+    const double L1_I0 = L1_I1;
+    if (k == 0) {
+      I1 = sum;
+      L1_I1 = absum;
+      continue;
+    }
+    I1 = 0.5 * I0 + h * sum;
+    L1_I1 = 0.5 * L1_I0 + h * absum;
+    const double last_err = err;
+    err = (I1 - I0).template lpNorm<Eigen::Infinity>();
+
+    if (!std::isfinite(L1_I1) || !I1.allFinite()) {
+      throw_domain_error("integrate", "integral", L1_I1, "",
+                         " is not finite; the integrand was evaluated at a "
+                         "singular point");
+    }
+    if (!rule.infinite() && err > last_err && k > 4 && ++thrash_count > 1) {
+      I1 = I0;
+      L1_I1 = L1_I0;
+      err = last_err;
+      break;
+    }
+    if (err <= relative_tolerance * L1_I1) {
+      break;
+    }
+  }
+  error = err;
+  L1 = L1_I1;
+  return I1;
+}
+
+}  // namespace internal
+
+/**
+ * Integrate a vector valued function f of a single variable from a to
+ * b to within a specified relative tolerance. This function assumes a
+ * is less than b.
+ *
+ * The signature for f should be:
+ *   Eigen::VectorXd f(double x, double xc)
+ *
+ * and every call must return a vector of the given size.
+ *
+ * All components are integrated together on the same adaptive set of
+ * nodes of the double exponential rules also used by
+ * <code>integrate()</code>, with the same treatment of infinite
+ * limits, of integrals which cross zero and of xc. The error control
+ * is on the combined vector: refinement stops once the change of the
+ * integral in the maximum norm is within the relative tolerance of the
+ * maximum norm of the integral of the absolute value. Every component
+ * is therefore accurate relative to the largest component.
+ *
+ * @tparam F Type of f
+ * @param f the function to be integrated
+ * @param a lower limit of integration
+ * @param b upper limit of integration
+ * @param relative_tolerance target relative tolerance
+ * @param size size of the vector returned by f
+ * @return numeric integral of function f
+ * @throw std::domain_error if the estimated error exceeds the
+ * tolerance or the integral is not finite
+ */
+template <typename F>
+inline Eigen::VectorXd integrate_vector(const F& f, double a, double b,
+                                        double relative_tolerance, int size) {
+  double error1 = 0.0;
+  double error2 = 0.0;
+  double L1 = 0.0;
+  double L2 = 0.0;
+  bool used_two_integrals = false;
+  Eigen::VectorXd Q;
+  if (std::isinf(a) && std::isinf(b)) {
+    Q = internal::double_exponential_vector(f, internal::sinh_sinh_rule(), size,
+                                            relative_tolerance, error1, L1);
+  } else if (std::isinf(a)) {
+    if (b <= 0.0) {
+      Q = internal::double_exponential_vector(
+          f, internal::exp_sinh_rule(b, -1), size, relative_tolerance, error1,
+          L1);
+    } else {
+      Q = internal::double_exponential_vector(
+              f, internal::exp_sinh_rule(0, -1), size, relative_tolerance,
+              error1, L1)
+          + internal::double_exponential_vector(
+              f, internal::tanh_sinh_rule(0, b, false), size,
+              relative_tolerance, error2, L2);
+      used_two_integrals = true;
+    }
+  } else if (std::isinf(b)) {
+    if (a >= 0.0) {
+      Q = internal::double_exponential_vector(
+          f, internal::exp_sinh_rule(a, 1), size, relative_tolerance, error1,
+          L1);
+    } else {
+      Q = internal::double_exponential_vector(
+              f, internal::tanh_sinh_rule(a, 0, false), size,
+              relative_tolerance, error1, L1)
+          + internal::double_exponential_vector(
+              f, internal::exp_sinh_rule(0, 1), size, relative_tolerance,
+              error2, L2);
+      used_two_integrals = true;
+    }
+  } else {
+    if (a < 0.0 && b > 0.0) {
+      Q = internal::double_exponential_vector(
+              f, internal::tanh_sinh_rule(a, 0.0, true), size,
+              relative_tolerance, error1, L1)
+          + internal::double_exponential_vector(
+              f, internal::tanh_sinh_rule(0.0, b, true), size,
+              relative_tolerance, error2, L2);
+      used_two_integrals = true;
+    } else {
+      Q = internal::double_exponential_vector(
+          f, internal::tanh_sinh_rule(a, b, true), size, relative_tolerance,
+          error1, L1);
+    }
+  }
+
+  static const char* function = "integrate";
+  if (used_two_integrals) {
+    if (error1 > relative_tolerance * L1) {
+      throw_domain_error(function, "error estimate of integral below zero",
+                         error1, "",
+                         " exceeds the given relative tolerance times norm of "
+                         "integral below zero");
+    }
+    if (error2 > relative_tolerance * L2) {
+      throw_domain_error(function, "error estimate of integral above zero",
+                         error2, "",
+                         " exceeds the given relative tolerance times norm of "
+                         "integral above zero");
+    }
+  } else {
+    if (error1 > relative_tolerance * L1) {
+      throw_domain_error(
+          function, "error estimate of integral", error1, "",
+          " exceeds the given relative tolerance times norm of integral");
+    }
+  }
+  return Q;
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
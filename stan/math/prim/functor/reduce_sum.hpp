@@ -0,0 +1,159 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_REDUCE_SUM_HPP
+#define STAN_MATH_PRIM_FUNCTOR_REDUCE_SUM_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Whether partial sums of the type may be computed on other threads,
+ * which holds for arithmetic types and forward mode types of those.
+ * The vars of any other partial sum would be created on the autodiff
+ * tapes of the worker threads, where the reverse pass of the caller
+ * never reaches them.
+ */
+template <typename T, typename = void>
+struct reduce_sum_threadable : std::is_arithmetic<T> {};
+
+template <typename T>
+struct reduce_sum_threadable<T, require_fvar_t<T>>
+    : reduce_sum_threadable<partials_type_t<T>> {};
+
+/**
+ * Implementation of <code>reduce_sum</code>, specialized on the
+ * return type. The primary template handles arithmetic and forward
+ * mode return types, the latter in serial if they hold vars; the
+ * reverse mode specialization is defined in
+ * <code>stan/math/rev/functor/reduce_sum.hpp</code>.
+ *
+ * @tparam F type of the reducer functor
+ * @tparam ReturnType return type of the reduction
+ * @tparam T type of the elements of the sliced container
+ * @tparam Args types of the shared arguments
+ */
+template <typename F, typename ReturnType, typename T, typename... Args>
+struct reduce_sum_impl {
+  /**
+   * Body of <code>tbb::parallel_reduce</code> which sums the partial
+   * sums of the slices it is called on.
+   */
+  struct recursive_reducer {
+    const F& f_;
+    const std::vector<T>& sliced_;
+    std::ostream* msgs_;
+    std::tuple<const Args&...> args_tuple_;
+    ReturnType sum_;
+
+    recursive_reducer(const F& f, const std::vector<T>& sliced,
+                      std::ostream* msgs, const Args&... args)
+        : f_(f),
+          sliced_(sliced),
+          msgs_(msgs),
+          args_tuple_(args...),
+          sum_(ReturnType(0)) {}
+
+    recursive_reducer(recursive_reducer& other, tbb::split)
+        : f_(other.f_),
+          sliced_(other.sliced_),
+          msgs_(other.msgs_),
+          args_tuple_(other.args_tuple_),
+          sum_(ReturnType(0)) {}
+
+    void operator()(const tbb::blocked_range<size_t>& r) {
+      if (r.empty()) {
+        return;
+      }
+      const std::vector<T> sub_slice(sliced_.begin() + r.begin(),
+                                     sliced_.begin() + r.end());
+      sum_ += index_apply<sizeof...(Args)>([&](auto... Is) {
+        return f_(sub_slice, r.begin(), r.end(), msgs_,
+                  std::get<Is>(args_tuple_)...);
+      });
+    }
+
+    void join(const recursive_reducer& rhs) { sum_ += rhs.sum_; }
+  };
+
+  ReturnType operator()(const F& f, const std::vector<T>& sliced,
+                        int grainsize, std::ostream* msgs,
+                        const Args&... args) const {
+    recursive_reducer worker(f, sliced, msgs, args...);
+    const tbb::blocked_range<size_t> range(0, sliced.size(), grainsize);
+#ifdef STAN_THREADS
+    if (reduce_sum_threadable<ReturnType>::value) {
+      tbb::parallel_reduce(range, worker);
+    } else {
+      worker(range);
+    }
+#else
+    worker(range);
+#endif
+    return worker.sum_;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Return the sum of the partial sums computed by the functor
+ * <code>f</code> over slices of <code>sliced</code>.
+ *
+ * The container is split into slices of at least
+ * <code>grainsize</code> elements which are handed to the functor as
+ *
+ * <code>f(slice, start, end, msgs, args...)</code>
+ *
+ * where <code>slice</code> holds the elements
+ * <code>sliced[start]</code> up to (excluding)
+ * <code>sliced[end]</code>. The functor must return the partial sum
+ * of the slice such that the partial sums add up to the total sum
+ * regardless of how the container is split.
+ *
+ * Whenever <code>STAN_THREADS</code> is defined the slices are
+ * evaluated in parallel with <code>tbb::parallel_reduce</code>; the
+ * functor must then be safe to call concurrently. Otherwise, and for
+ * forward mode return types holding vars, the whole container is
+ * handed to the functor as one slice.
+ *
+ * In reverse mode every slice is evaluated on the thread local
+ * autodiff tape of the worker with copies of its operands, and its
+ * gradient is computed with a single reverse sweep. The result is a
+ * single <code>var</code> with precomputed gradients wrt to all
+ * operands.
+ *
+ * @tparam F type of the reducer functor
+ * @tparam T type of the elements of the sliced container
+ * @tparam Args types of the shared arguments
+ * @param f reducer functor
+ * @param sliced container to split into slices
+ * @param grainsize suggested minimal number of elements per slice
+ * @param msgs stream for messages passed to the functor
+ * @param args shared arguments passed to every call of the functor
+ * @return sum of the partial sums
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F, typename T, typename... Args>
+inline return_type_t<T, Args...> reduce_sum(const F& f,
+                                            const std::vector<T>& sliced,
+                                            int grainsize, std::ostream* msgs,
+                                            const Args&... args) {
+  check_positive("reduce_sum", "grainsize", grainsize);
+  return internal::reduce_sum_impl<F, return_type_t<T, Args...>, T, Args...>()(
+      f, sliced, grainsize, msgs, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -129,6 +129,7 @@
 #include <stan/math/prim/mat/fun/gp_matern52_cov.hpp>
 #include <stan/math/prim/mat/fun/gp_periodic_cov.hpp>
 #include <stan/math/prim/mat/fun/head.hpp>
+#include <stan/math/prim/mat/fun/hmm_marginal.hpp>
 #include <stan/math/prim/mat/fun/initialize.hpp>
 #include <stan/math/prim/mat/fun/inv.hpp>
 #include <stan/math/prim/mat/fun/inv_Phi.hpp>
@@ -254,6 +255,7 @@
 #include <stan/math/prim/mat/fun/welford_covar_estimator.hpp>
 #include <stan/math/prim/mat/fun/welford_var_estimator.hpp>
 
+#include <stan/math/prim/functor/checkpoint.hpp>
 #include <stan/math/prim/functor/finite_diff_gradient.hpp>
 #include <stan/math/prim/functor/finite_diff_gradient_auto.hpp>
 #include <stan/math/prim/functor/finite_diff_hessian.hpp>
@@ -263,6 +265,7 @@
 #include <stan/math/prim/functor/map_rect_combine.hpp>
 #include <stan/math/prim/functor/map_rect_concurrent.hpp>
 #include <stan/math/prim/functor/map_rect_reduce.hpp>
+#include <stan/math/prim/functor/reduce_sum.hpp>
 #include <stan/math/prim/prob/bernoulli_logit_glm_log.hpp>
 #include <stan/math/prim/prob/bernoulli_logit_glm_lpmf.hpp>
 #include <stan/math/prim/prob/bernoulli_logit_glm_rng.hpp>
@@ -280,6 +283,7 @@
 #include <stan/math/prim/prob/gaussian_dlm_obs_log.hpp>
 #include <stan/math/prim/prob/gaussian_dlm_obs_lpdf.hpp>
 #include <stan/math/prim/prob/gaussian_dlm_obs_rng.hpp>
+#include <stan/math/prim/prob/hmm_latent_rng.hpp>
 #include <stan/math/prim/prob/inv_wishart_log.hpp>
 #include <stan/math/prim/prob/inv_wishart_lpdf.hpp>
 #include <stan/math/prim/prob/inv_wishart_rng.hpp>
@@ -0,0 +1,204 @@
+#ifndef STAN_MATH_PRIM_MAT_FUN_HMM_MARGINAL_HPP
+#define STAN_MATH_PRIM_MAT_FUN_HMM_MARGINAL_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/log.hpp>
+#include <stan/math/prim/mat/fun/sum.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Check the arguments of a hidden Markov model: the rows of the
+ * transition matrix and the initial distribution are simplexes over
+ * the states of the rows of the log densities, which must not be NaN
+ * or positive infinity.
+ */
+template <typename T_omega, typename T_Gamma, typename T_rho>
+inline void hmm_check(
+    const char* function,
+    const Eigen::Matrix<T_omega, Eigen::Dynamic, Eigen::Dynamic>& log_omegas,
+    const Eigen::Matrix<T_Gamma, Eigen::Dynamic, Eigen::Dynamic>& Gamma,
+    const Eigen::Matrix<T_rho, Eigen::Dynamic, 1>& rho) {
+  check_nonzero_size(function, "log_omegas", log_omegas);
+  check_not_nan(function, "log_omegas", log_omegas);
+  check_less(function, "log_omegas", log_omegas, INFTY);
+  check_square(function, "Gamma", Gamma);
+  check_size_match(function, "rows of Gamma", Gamma.rows(),
+                   "rows of log_omegas", log_omegas.rows());
+  check_size_match(function, "size of rho", rho.size(), "rows of log_omegas",
+                   log_omegas.rows());
+  for (int i = 0; i < Gamma.rows(); ++i) {
+    check_simplex(function, "Gamma[i, ]",
+                  Eigen::Matrix<T_Gamma, Eigen::Dynamic, 1>(
+                      Gamma.row(i).transpose()));
+  }
+  check_simplex(function, "rho", rho);
+}
+
+/**
+ * Run the forward algorithm of a hidden Markov model with scaling and
+ * return the log marginal density of the observations.
+ *
+ * The densities of every observation are scaled by their maximum over
+ * the states, such that omegas holds exp(log_omegas) relative to that
+ * maximum. Column n of alphas holds the distribution of the state of
+ * observation n given the observations up to n, and norms(n) its
+ * normalizing constant, such that the forward variables never under-
+ * or overflow on long series. The log marginal density is the sum of
+ * the logs of the normalizing constants and the maxima, or negative
+ * infinity if the observations are impossible, in which case the
+ * remaining columns are left unset.
+ *
+ * @param log_omegas log densities of the observations (columns) under
+ * each state (rows)
+ * @param Gamma transition matrix, with the probability of moving from
+ * state i to state j in row i and column j
+ * @param rho distribution of the state of the first observation
+ * @param[out] omegas scaled densities of the observations
+ * @param[out] alphas filtered distributions of the states
+ * @param[out] norms normalizing constants of the filtered
+ * distributions
+ * @return log marginal density
+ */
+template <typename T>
+inline T hmm_forward(
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& log_omegas,
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& Gamma,
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& rho,
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& omegas,
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& alphas,
+    Eigen::Matrix<T, Eigen::Dynamic, 1>& norms) {
+  const int N = log_omegas.cols();
+  const Eigen::Matrix<T, 1, Eigen::Dynamic> log_omega_max
+      = log_omegas.colwise().maxCoeff();
+  if (!(log_omega_max.array() > NEGATIVE_INFTY).all()) {
+    return NEGATIVE_INFTY;
+  }
+  omegas = (log_omegas.rowwise() - log_omega_max).array().exp().matrix();
+  alphas.resize(log_omegas.rows(), N);
+  norms.resize(N);
+
+  alphas.col(0) = omegas.col(0).cwiseProduct(rho);
+  for (int n = 0; n < N; ++n) {
+    if (n > 0) {
+      alphas.col(n)
+          = omegas.col(n).cwiseProduct(Gamma.transpose() * alphas.col(n - 1));
+    }
+    norms(n) = alphas.col(n).sum();
+    if (!(norms(n) > 0)) {
+      return NEGATIVE_INFTY;
+    }
+    alphas.col(n) /= norms(n);
+  }
+  return sum(log(norms)) + log_omega_max.sum();
+}
+
+}  // namespace internal
+
+/**
+ * Return the log marginal density of the observations of a hidden
+ * Markov model, with the hidden states summed out,
+ *
+ * \f[
+ * \log \sum_{z_1, \ldots, z_N} \rho_{z_1} \omega_{z_1, 1}
+ * \prod_{n = 2}^N \Gamma_{z_{n - 1}, z_n} \omega_{z_n, n}.
+ * \f]
+ *
+ * The forward algorithm runs in the partials type with scaling, see
+ * <code>internal::hmm_forward</code>. The gradients follow from a
+ * backward pass over the scaled backward variables
+ * \f$\hat\beta_n\f$: the gradient wrt the log density of observation
+ * n is the posterior distribution of its state
+ * \f$\hat\alpha_n \circ \hat\beta_n\f$, the gradient wrt the transition
+ * matrix sums \f$\hat\alpha_{n - 1} (\hat\omega_n \circ
+ * \hat\beta_n)^\top / c_n\f$ over the observations and the gradient wrt
+ * the initial distribution is \f$\hat\omega_1 \circ \hat\beta_1 / c_1\f$.
+ * The gradients wrt Gamma and rho are those of the expression above,
+ * without the simplex constraints.
+ *
+ * @tparam T_omega type of the log densities
+ * @tparam T_Gamma type of the transition matrix
+ * @tparam T_rho type of the initial distribution
+ * @param log_omegas K x N matrix of the log densities of the N
+ * observations under each of the K states
+ * @param Gamma K x K transition matrix, with the probability of moving
+ * from state i to state j in row i and column j
+ * @param rho size K distribution of the state of the first observation
+ * @return log marginal density of the observations
+ * @throw std::invalid_argument if the sizes do not match or there are
+ * no observations or states
+ * @throw std::domain_error if the rows of Gamma or rho are not
+ * simplexes or any log density is NaN or positive infinity
+ */
+template <typename T_omega, typename T_Gamma, typename T_rho>
+inline return_type_t<T_omega, T_Gamma, T_rho> hmm_marginal(
+    const Eigen::Matrix<T_omega, Eigen::Dynamic, Eigen::Dynamic>& log_omegas,
+    const Eigen::Matrix<T_Gamma, Eigen::Dynamic, Eigen::Dynamic>& Gamma,
+    const Eigen::Matrix<T_rho, Eigen::Dynamic, 1>& rho) {
+  static const char* function = "hmm_marginal";
+  using T_partials_return = partials_return_t<T_omega, T_Gamma, T_rho>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
+  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
+
+  internal::hmm_check(function, log_omegas, Gamma, rho);
+  const int N = log_omegas.cols();
+
+  operands_and_partials<
+      Eigen::Matrix<T_omega, Eigen::Dynamic, Eigen::Dynamic>,
+      Eigen::Matrix<T_Gamma, Eigen::Dynamic, Eigen::Dynamic>,
+      Eigen::Matrix<T_rho, Eigen::Dynamic, 1>>
+      ops_partials(log_omegas, Gamma, rho);
+
+  const matrix_partials_t log_omegas_val
+      = value_of(log_omegas).template cast<T_partials_return>();
+  const matrix_partials_t Gamma_val
+      = value_of(Gamma).template cast<T_partials_return>();
+  const vector_partials_t rho_val
+      = value_of(rho).template cast<T_partials_return>();
+  matrix_partials_t omegas;
+  matrix_partials_t alphas;
+  vector_partials_t norms;
+  const T_partials_return logp = internal::hmm_forward(
+      log_omegas_val, Gamma_val, rho_val, omegas, alphas, norms);
+  if (logp == NEGATIVE_INFTY
+      || is_constant_all<T_omega, T_Gamma, T_rho>::value) {
+    return ops_partials.build(logp);
+  }
+
+  matrix_partials_t d_log_omegas(rho.size(), N);
+  matrix_partials_t d_Gamma = matrix_partials_t::Zero(rho.size(), rho.size());
+  vector_partials_t beta = vector_partials_t::Ones(rho.size());
+  for (int n = N - 1; n > 0; --n) {
+    d_log_omegas.col(n) = alphas.col(n).cwiseProduct(beta);
+    const vector_partials_t omega_beta
+        = omegas.col(n).cwiseProduct(beta) / norms(n);
+    if (!is_constant_all<T_Gamma>::value) {
+      d_Gamma += alphas.col(n - 1) * omega_beta.transpose();
+    }
+    beta = Gamma_val * omega_beta;
+  }
+
+  d_log_omegas.col(0) = alphas.col(0).cwiseProduct(beta);
+  if (!is_constant_all<T_omega>::value) {
+    ops_partials.edge1_.partials_ = d_log_omegas;
+  }
+  if (!is_constant_all<T_Gamma>::value) {
+    ops_partials.edge2_.partials_ = d_Gamma;
+  }
+  if (!is_constant_all<T_rho>::value) {
+    ops_partials.edge3_.partials_
+        = omegas.col(0).cwiseProduct(beta) / norms(0);
+  }
+  return ops_partials.build(logp);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
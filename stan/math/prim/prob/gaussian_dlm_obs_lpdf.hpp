@@ -3,20 +3,13 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/mat/fun/add.hpp>
-#include <stan/math/prim/mat/fun/dot_product.hpp>
-#include <stan/math/prim/mat/fun/inverse_spd.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <stan/math/prim/mat/fun/log.hpp>
-#include <stan/math/prim/mat/fun/log_determinant_spd.hpp>
-#include <stan/math/prim/mat/fun/multiply.hpp>
-#include <stan/math/prim/mat/fun/quad_form.hpp>
-#include <stan/math/prim/mat/fun/quad_form_sym.hpp>
-#include <stan/math/prim/mat/fun/subtract.hpp>
-#include <stan/math/prim/mat/fun/tcrossprod.hpp>
-#include <stan/math/prim/mat/fun/trace_quad_form.hpp>
-#include <stan/math/prim/mat/fun/transpose.hpp>
+#include <stan/math/prim/mat/fun/sum.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
 #include <cmath>
+#include <vector>
 
 /*
   TODO: time-varying system matrices
@@ -26,6 +19,369 @@
 */
 namespace stan {
 namespace math {
+namespace internal {
+
+/**
+ * Kalman filter of a Gaussian dynamic linear model together with its
+ * adjoint, in the scalar type of the partials of the density.
+ *
+ * The observations of a time step are processed in blocks, either all
+ * of them at once with the observation covariance matrix V or one at a
+ * time with the observation variances V for sequential processing. The
+ * forward pass records the filtered mean and covariance entering each
+ * time step. The backward pass recomputes the updates of a time step
+ * from them and propagates the adjoints of the filtered mean and
+ * covariance back to y, F, G, V, W, m0 and C0, such that the gradient
+ * takes one pass over the series instead of a taped recursion. The
+ * gradients wrt to the covariance matrices are symmetric.
+ *
+ * If the steady state tolerance is positive, the covariance recursion
+ * stops once the maximum absolute change of the filtered covariance
+ * over a time step is below the tolerance relative to its maximum
+ * absolute value. The covariance updates of that time step are then
+ * reused for all remaining time steps. Their adjoints are summed over
+ * these steps and propagated once.
+ *
+ * @tparam T scalar type of the partials
+ */
+template <typename T>
+class gaussian_dlm_obs_filter {
+  using matrix_t = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+  using vector_t = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+  /**
+   * Covariance part of the measurement update of one block of
+   * observations, which does not depend on the observations.
+   */
+  struct block_update {
+    matrix_t R;                    // state covariance before the update
+    matrix_t K;                    // R F
+    Eigen::LDLT<matrix_t> ldlt_Q;  // covariance of the observations
+    matrix_t C;                    // state covariance after the update
+  };
+
+  const matrix_t y_;
+  const matrix_t F_;
+  const matrix_t G_;
+  const matrix_t V_;
+  const matrix_t W_;
+  const vector_t m0_;
+  const matrix_t C0_;
+  const bool sequential_;
+  const double steady_state_tol_;
+  int steady_state_step_;
+  std::vector<block_update> steady_state_updates_;
+  std::vector<vector_t> m_prev_;
+  std::vector<matrix_t> C_prev_;
+
+  int num_blocks() const { return sequential_ ? y_.rows() : 1; }
+  int block_start(int b) const { return sequential_ ? b : 0; }
+  int block_size() const { return sequential_ ? 1 : y_.rows(); }
+
+  matrix_t predict_covariance(const matrix_t& C) const {
+    const matrix_t R = G_ * C * G_.transpose() + W_;
+    return 0.5 * (R + R.transpose());
+  }
+
+  std::vector<block_update> update_covariance(const matrix_t& C) const {
+    std::vector<block_update> updates(num_blocks());
+    matrix_t R = predict_covariance(C);
+    for (int b = 0; b < num_blocks(); ++b) {
+      block_update& u = updates[b];
+      const auto F_b = F_.middleCols(block_start(b), block_size());
+      u.R = R;
+      u.K = R * F_b;
+      if (sequential_) {
+        u.ldlt_Q.compute(F_b.transpose() * u.K + V_.block(b, 0, 1, 1));
+      } else {
+        u.ldlt_Q.compute(F_b.transpose() * u.K + V_);
+      }
+      check_pos_definite("gaussian_dlm_obs_lpdf", "Q", u.ldlt_Q);
+      const matrix_t C_b = R - u.K * u.ldlt_Q.solve(u.K.transpose());
+      u.C = 0.5 * (C_b + C_b.transpose());
+      R = u.C;
+    }
+    return updates;
+  }
+
+  /**
+   * Return the log density of the observations of block b at time t
+   * given the state mean a before the update, which is replaced by
+   * the updated mean. Stores Q^-1 e, with e the residuals, in v.
+   */
+  T update_mean(int b, int t, const block_update& u, vector_t& a,
+                vector_t& v) const {
+    const auto F_b = F_.middleCols(block_start(b), block_size());
+    const vector_t e = y_.block(block_start(b), t, block_size(), 1)
+                       - F_b.transpose() * a;
+    v = u.ldlt_Q.solve(e);
+    a += u.K * v;
+    return -0.5 * (sum(log(u.ldlt_Q.vectorD())) + e.dot(v));
+  }
+
+  /**
+   * Propagate the adjoint of the mean after the update of block b back
+   * to the mean before the update, adding the contributions to the
+   * adjoints of y and F and accumulating the adjoints of K and Q.
+   */
+  void adjoint_mean(int b, int t, const block_update& u, const vector_t& a,
+                    const vector_t& v, vector_t& m_adj, matrix_t& K_adj,
+                    matrix_t& Q_adj, matrix_t& d_y, matrix_t& d_F) const {
+    const auto F_b = F_.middleCols(block_start(b), block_size());
+    const vector_t Qinv_u = u.ldlt_Q.solve(u.K.transpose() * m_adj);
+    const vector_t e_adj = Qinv_u - v;
+    d_y.block(block_start(b), t, block_size(), 1) += e_adj;
+    d_F.middleCols(block_start(b), block_size()) -= a * e_adj.transpose();
+    K_adj += m_adj * v.transpose();
+    Q_adj += (0.5 * v - Qinv_u) * v.transpose();
+    m_adj -= F_b * e_adj;
+  }
+
+  /**
+   * Return the adjoint of the state covariance before the update of
+   * block b given the adjoint of the covariance after the update and
+   * the accumulated adjoints of K and Q over count log densities,
+   * adding the contributions to the adjoints of F and V.
+   */
+  matrix_t adjoint_covariance(int b, const block_update& u,
+                              const matrix_t& C_adj, matrix_t& K_adj,
+                              matrix_t& Q_adj, int count, matrix_t& d_F,
+                              matrix_t& d_V) const {
+    const auto F_b = F_.middleCols(block_start(b), block_size());
+    const matrix_t Qinv_KT = u.ldlt_Q.solve(u.K.transpose());
+    K_adj -= 2 * C_adj * Qinv_KT.transpose();
+    Q_adj += Qinv_KT * C_adj * Qinv_KT.transpose()
+             - 0.5 * count
+                   * u.ldlt_Q.solve(
+                       matrix_t::Identity(block_size(), block_size()));
+    const matrix_t Q_adj_sym = 0.5 * (Q_adj + Q_adj.transpose());
+    d_F.middleCols(block_start(b), block_size())
+        += u.R * K_adj + 2 * u.K * Q_adj_sym;
+    if (sequential_) {
+      d_V(b, 0) += Q_adj_sym(0, 0);
+    } else {
+      d_V += Q_adj_sym;
+    }
+    const matrix_t R_adj = C_adj + K_adj * F_b.transpose()
+                           + F_b * Q_adj_sym * F_b.transpose();
+    return 0.5 * (R_adj + R_adj.transpose());
+  }
+
+ public:
+  /**
+   * @param y observations
+   * @param F design matrix
+   * @param G transition matrix
+   * @param V observation covariance matrix, or observation variances
+   * as a column if the observations are processed sequentially
+   * @param W state covariance matrix
+   * @param m0 mean of the initial state
+   * @param C0 covariance of the initial state
+   * @param sequential whether the observations are processed one at a
+   * time
+   * @param steady_state_tol relative tolerance of the steady state of
+   * the filtered covariance, or zero to update it at all time steps
+   */
+  gaussian_dlm_obs_filter(const matrix_t& y, const matrix_t& F,
+                          const matrix_t& G, const matrix_t& V,
+                          const matrix_t& W, const vector_t& m0,
+                          const matrix_t& C0, bool sequential,
+                          double steady_state_tol)
+      : y_(y),
+        F_(F),
+        G_(G),
+        V_(V),
+        W_(W),
+        m0_(m0),
+        C0_(C0),
+        sequential_(sequential),
+        steady_state_tol_(steady_state_tol),
+        steady_state_step_(y.cols()) {}
+
+  /**
+   * Return the log density of the observations, without the constant
+   * term, recording the filtered states if the gradients are needed.
+   *
+   * @param record whether to record the filtered states for
+   * <code>gradients()</code>
+   * @return log density
+   */
+  T log_density(bool record) {
+    T lp(0);
+    vector_t m = m0_;
+    matrix_t C = C0_;
+    std::vector<block_update> updates;
+    vector_t v;
+    for (int t = 0; t < y_.cols(); ++t) {
+      if (record) {
+        m_prev_.push_back(m);
+      }
+      if (t <= steady_state_step_) {
+        if (record) {
+          C_prev_.push_back(C);
+        }
+        updates = update_covariance(C);
+        const matrix_t& C_next = updates.back().C;
+        if (steady_state_tol_ > 0 && t < steady_state_step_
+            && (C_next - C).cwiseAbs().maxCoeff()
+                   <= steady_state_tol_ * C.cwiseAbs().maxCoeff()) {
+          steady_state_step_ = t;
+          steady_state_updates_ = updates;
+        }
+        C = C_next;
+      }
+      vector_t a = G_ * m;
+      for (int b = 0; b < num_blocks(); ++b) {
+        lp += update_mean(b, t, updates[b], a, v);
+      }
+      m = a;
+    }
+    return lp;
+  }
+
+  /**
+   * Compute the gradients of the log density with the adjoint of the
+   * filter. Requires a preceding call to <code>log_density(true)</code>.
+   */
+  void gradients(matrix_t& d_y, matrix_t& d_F, matrix_t& d_G, matrix_t& d_V,
+                 matrix_t& d_W, vector_t& d_m0, matrix_t& d_C0) const {
+    const int n = G_.rows();
+    d_y.setZero(y_.rows(), y_.cols());
+    d_F.setZero(F_.rows(), F_.cols());
+    d_G.setZero(n, n);
+    d_V.setZero(V_.rows(), V_.cols());
+    d_W.setZero(n, n);
+
+    vector_t m_adj = vector_t::Zero(n);
+    matrix_t C_adj = matrix_t::Zero(n, n);
+    std::vector<matrix_t> K_adj(num_blocks(),
+                                matrix_t::Zero(n, block_size()));
+    std::vector<matrix_t> Q_adj(num_blocks(),
+                                matrix_t::Zero(block_size(), block_size()));
+    int count = 0;
+    std::vector<vector_t> a(num_blocks() + 1);
+    std::vector<vector_t> v(num_blocks());
+    for (int t = y_.cols() - 1; t >= 0; --t) {
+      const std::vector<block_update> updates
+          = t < steady_state_step_ ? update_covariance(C_prev_[t])
+                                   : steady_state_updates_;
+      a[0] = G_ * m_prev_[t];
+      for (int b = 0; b < num_blocks(); ++b) {
+        a[b + 1] = a[b];
+        update_mean(b, t, updates[b], a[b + 1], v[b]);
+      }
+      for (int b = num_blocks() - 1; b >= 0; --b) {
+        adjoint_mean(b, t, updates[b], a[b], v[b], m_adj, K_adj[b],
+                     Q_adj[b], d_y, d_F);
+      }
+      ++count;
+
+      if (t <= steady_state_step_) {
+        for (int b = num_blocks() - 1; b >= 0; --b) {
+          C_adj = adjoint_covariance(b, updates[b], C_adj, K_adj[b],
+                                     Q_adj[b], count, d_F, d_V);
+          K_adj[b].setZero();
+          Q_adj[b].setZero();
+        }
+        count = 0;
+        d_G += 2 * C_adj * G_ * C_prev_[t];
+        d_W += C_adj;
+        C_adj = G_.transpose() * C_adj * G_;
+      }
+      d_G += m_adj * m_prev_[t].transpose();
+      m_adj = G_.transpose() * m_adj;
+    }
+    d_m0 = m_adj;
+    d_C0 = C_adj;
+  }
+};
+
+/**
+ * Return the log of a Gaussian dynamic linear model with the gradients
+ * of the adjoint Kalman filter, once the arguments are checked.
+ *
+ * @tparam Vmat type of observation covariance matrix or variances
+ */
+template <bool propto, typename T_y, typename T_F, typename T_G,
+          typename Vmat, typename T_W, typename T_m0, typename T_C0>
+inline return_type_t<T_y, return_type_t<T_F, T_G, value_type_t<Vmat>, T_W,
+                                         T_m0, T_C0>>
+gaussian_dlm_obs_lpdf(
+    const Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>& y,
+    const Eigen::Matrix<T_F, Eigen::Dynamic, Eigen::Dynamic>& F,
+    const Eigen::Matrix<T_G, Eigen::Dynamic, Eigen::Dynamic>& G,
+    const Vmat& V, const Eigen::Matrix<T_W, Eigen::Dynamic, Eigen::Dynamic>& W,
+    const Eigen::Matrix<T_m0, Eigen::Dynamic, 1>& m0,
+    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0,
+    bool sequential, double steady_state_tol) {
+  using T_V = value_type_t<Vmat>;
+  using T_partials_return
+      = partials_return_t<T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
+  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
+
+  operands_and_partials<Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>,
+                        Eigen::Matrix<T_F, Eigen::Dynamic, Eigen::Dynamic>,
+                        Eigen::Matrix<T_G, Eigen::Dynamic, Eigen::Dynamic>,
+                        Vmat>
+      ops_obs(y, F, G, V);
+  operands_and_partials<Eigen::Matrix<T_W, Eigen::Dynamic, Eigen::Dynamic>,
+                        Eigen::Matrix<T_m0, Eigen::Dynamic, 1>,
+                        Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>>
+      ops_state(W, m0, C0);
+
+  T_partials_return lp(0);
+  if (include_summand<propto>::value) {
+    lp += 0.5 * NEG_LOG_TWO_PI * y.rows() * y.cols();
+  }
+
+  if (include_summand<propto, T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>::value) {
+    internal::gaussian_dlm_obs_filter<T_partials_return> filter(
+        value_of(y).template cast<T_partials_return>(),
+        value_of(F).template cast<T_partials_return>(),
+        value_of(G).template cast<T_partials_return>(),
+        value_of(V).template cast<T_partials_return>(),
+        value_of(W).template cast<T_partials_return>(),
+        value_of(m0).template cast<T_partials_return>(),
+        value_of(C0).template cast<T_partials_return>(), sequential,
+        steady_state_tol);
+    const bool need_gradients
+        = !is_constant_all<T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>::value;
+    lp += filter.log_density(need_gradients);
+
+    if (need_gradients) {
+      matrix_partials_t d_y, d_F, d_G, d_V, d_W, d_C0;
+      vector_partials_t d_m0;
+      filter.gradients(d_y, d_F, d_G, d_V, d_W, d_m0, d_C0);
+      if (!is_constant_all<T_y>::value) {
+        ops_obs.edge1_.partials_ += d_y;
+      }
+      if (!is_constant_all<T_F>::value) {
+        ops_obs.edge2_.partials_ += d_F;
+      }
+      if (!is_constant_all<T_G>::value) {
+        ops_obs.edge3_.partials_ += d_G;
+      }
+      if (!is_constant_all<T_V>::value) {
+        ops_obs.edge4_.partials_ += d_V;
+      }
+      if (!is_constant_all<T_W>::value) {
+        ops_state.edge1_.partials_ += d_W;
+      }
+      if (!is_constant_all<T_m0>::value) {
+        ops_state.edge2_.partials_ += d_m0;
+      }
+      if (!is_constant_all<T_C0>::value) {
+        ops_state.edge3_.partials_ += d_C0;
+      }
+    }
+  }
+  return ops_obs.build(lp) + ops_state.build(0.0);
+}
+
+}  // namespace internal
+
 /** \ingroup multivar_dists
  * The log of a Gaussian dynamic linear model (GDLM).
  * This distribution is equivalent to, for \f$t = 1:T\f$,
@@ -48,6 +404,9 @@ namespace math {
  * of the initial state.
  * @param C0 A n x n matrix. The covariance matrix of the
  * distribution of the initial state.
+ * @param steady_state_tol Relative tolerance of the steady state
+ * of the filtered state covariance, after which it is no longer
+ * updated, or zero to update it at every time step.
  * @return The log of the joint density of the GDLM.
  * @throw std::domain_error if a matrix in the Kalman filter is
  * not positive semi-definite.
@@ -69,15 +428,9 @@ gaussian_dlm_obs_lpdf(
     const Eigen::Matrix<T_V, Eigen::Dynamic, Eigen::Dynamic>& V,
     const Eigen::Matrix<T_W, Eigen::Dynamic, Eigen::Dynamic>& W,
     const Eigen::Matrix<T_m0, Eigen::Dynamic, 1>& m0,
-    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0) {
+    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0,
+    double steady_state_tol = 0) {
   static const char* function = "gaussian_dlm_obs_lpdf";
-  using T_lp
-      = return_type_t<T_y, return_type_t<T_F, T_G, T_V, T_W, T_m0, T_C0>>;
-  int r = y.rows();  // number of variables
-  int T = y.cols();  // number of observations
-  int n = G.rows();  // number of states
-  using std::pow;
-
   check_finite(function, "y", y);
   check_not_nan(function, "y", y);
   check_size_match(function, "columns of F", F.cols(), "rows of y", y.rows());
@@ -99,64 +452,14 @@ gaussian_dlm_obs_lpdf(
   check_pos_definite(function, "C0", C0);
   check_finite(function, "C0", C0);
 
+  check_nonnegative(function, "steady_state_tol", steady_state_tol);
+
   if (size_zero(y)) {
     return 0;
   }
 
-  T_lp lp(0);
-  if (include_summand<propto>::value) {
-    lp -= 0.5 * LOG_TWO_PI * r * T;
-  }
-
-  if (include_summand<propto, T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>::value) {
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> m(n);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, Eigen::Dynamic> C(n, n);
-
-    // TODO(anyone): how to recast matrices
-    for (int i = 0; i < m0.size(); i++) {
-      m(i) = m0(i);
-    }
-    for (int i = 0; i < C0.rows(); i++) {
-      for (int j = 0; j < C0.cols(); j++) {
-        C(i, j) = C0(i, j);
-      }
-    }
-
-    Eigen::Matrix<return_type_t<T_y>, Eigen::Dynamic, 1> yi(r);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> a(n);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, Eigen::Dynamic> R(n, n);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> f(r);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, Eigen::Dynamic> Q(r, r);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, Eigen::Dynamic> Q_inv(r, r);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> e(r);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, Eigen::Dynamic> A(n, r);
-
-    for (int i = 0; i < y.cols(); i++) {
-      yi = y.col(i);
-      // // Predict state
-      // a_t = G_t m_{t-1}
-      a = multiply(G, m);
-      // R_t = G_t C_{t-1} G_t' + W_t
-      R = add(quad_form_sym(C, transpose(G)), W);
-      // // predict observation
-      // f_t = F_t' a_t
-      f = multiply(transpose(F), a);
-      // Q_t = F'_t R_t F_t + V_t
-      Q = add(quad_form_sym(R, F), V);
-      Q_inv = inverse_spd(Q);
-      // // filtered state
-      // e_t = y_t - f_t
-      e = subtract(yi, f);
-      // A_t = R_t F_t Q^{-1}_t
-      A = multiply(multiply(R, F), Q_inv);
-      // m_t = a_t + A_t e_t
-      m = add(a, multiply(A, e));
-      // C = R_t - A_t Q_t A_t'
-      C = subtract(R, quad_form_sym(Q, transpose(A)));
-      lp -= 0.5 * (log_determinant_spd(Q) + trace_quad_form(Q_inv, e));
-    }
-  }
-  return lp;
+  return internal::gaussian_dlm_obs_lpdf<propto>(y, F, G, V, W, m0, C0, false,
+                                                 steady_state_tol);
 }
 
 template <typename T_y, typename T_F, typename T_G, typename T_V, typename T_W,
@@ -169,8 +472,10 @@ gaussian_dlm_obs_lpdf(
     const Eigen::Matrix<T_V, Eigen::Dynamic, Eigen::Dynamic>& V,
     const Eigen::Matrix<T_W, Eigen::Dynamic, Eigen::Dynamic>& W,
     const Eigen::Matrix<T_m0, Eigen::Dynamic, 1>& m0,
-    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0) {
-  return gaussian_dlm_obs_lpdf<false>(y, F, G, V, W, m0, C0);
+    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0,
+    double steady_state_tol = 0) {
+  return gaussian_dlm_obs_lpdf<false>(y, F, G, V, W, m0, C0,
+                                      steady_state_tol);
 }
 
 /** \ingroup multivar_dists
@@ -197,6 +502,9 @@ gaussian_dlm_obs_lpdf(
  * of the initial state.
  * @param C0 A n x n matrix. The covariance matrix of the
  * distribution of the initial state.
+ * @param steady_state_tol Relative tolerance of the steady state
+ * of the filtered state covariance, after which it is no longer
+ * updated, or zero to update it at every time step.
  * @return The log of the joint density of the GDLM.
  * @throw std::domain_error if a matrix in the Kalman filter is
  * not semi-positive definite.
@@ -218,16 +526,9 @@ gaussian_dlm_obs_lpdf(
     const Eigen::Matrix<T_V, Eigen::Dynamic, 1>& V,
     const Eigen::Matrix<T_W, Eigen::Dynamic, Eigen::Dynamic>& W,
     const Eigen::Matrix<T_m0, Eigen::Dynamic, 1>& m0,
-    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0) {
+    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0,
+    double steady_state_tol = 0) {
   static const char* function = "gaussian_dlm_obs_lpdf";
-  using T_lp
-      = return_type_t<T_y, return_type_t<T_F, T_G, T_V, T_W, T_m0, T_C0>>;
-  using std::log;
-
-  int r = y.rows();  // number of variables
-  int T = y.cols();  // number of observations
-  int n = G.rows();  // number of states
-
   check_finite(function, "y", y);
   check_not_nan(function, "y", y);
   check_size_match(function, "columns of F", F.cols(), "rows of y", y.rows());
@@ -253,68 +554,14 @@ gaussian_dlm_obs_lpdf(
   check_size_match(function, "rows of C0", C0.rows(), "rows of G", G.rows());
   check_finite(function, "C0", C0);
 
+  check_nonnegative(function, "steady_state_tol", steady_state_tol);
+
   if (y.cols() == 0 || y.rows() == 0) {
     return 0;
   }
 
-  T_lp lp(0);
-  if (include_summand<propto>::value) {
-    lp += 0.5 * NEG_LOG_TWO_PI * r * T;
-  }
-
-  if (include_summand<propto, T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>::value) {
-    T_lp f;
-    T_lp Q;
-    T_lp Q_inv;
-    T_lp e;
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> A(n);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> Fj(n);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, 1> m(n);
-    Eigen::Matrix<T_lp, Eigen::Dynamic, Eigen::Dynamic> C(n, n);
-
-    // TODO(anyone): how to recast matrices
-    for (int i = 0; i < m0.size(); i++) {
-      m(i) = m0(i);
-    }
-    for (int i = 0; i < C0.rows(); i++) {
-      for (int j = 0; j < C0.cols(); j++) {
-        C(i, j) = C0(i, j);
-      }
-    }
-
-    for (int i = 0; i < y.cols(); i++) {
-      // Predict state
-      // reuse m and C instead of using a and R
-      m = multiply(G, m);
-      C = add(quad_form_sym(C, transpose(G)), W);
-      for (int j = 0; j < y.rows(); ++j) {
-        // predict observation
-        T_lp yij(y(j, i));
-        // dim Fj = (n, 1)
-        for (int k = 0; k < F.rows(); ++k) {
-          Fj(k) = F(k, j);
-        }
-        // f_{t, i} = F_{t, i}' m_{t, i-1}
-        f = dot_product(Fj, m);
-        Q = trace_quad_form(C, Fj) + V(j);
-        Q_inv = 1.0 / Q;
-        // filtered observation
-        // e_{t, i} = y_{t, i} - f_{t, i}
-        e = yij - f;
-        // A_{t, i} = C_{t, i-1} F_{t, i} Q_{t, i}^{-1}
-        A = multiply(multiply(C, Fj), Q_inv);
-        // m_{t, i} = m_{t, i-1} + A_{t, i} e_{t, i}
-        m += multiply(A, e);
-        // c_{t, i} = C_{t, i-1} - Q_{t, i} A_{t, i} A_{t, i}'
-        // tcrossprod throws an error (ambiguous)
-        // C = subtract(C, multiply(Q, tcrossprod(A)));
-        C -= multiply(Q, multiply(A, transpose(A)));
-        C = 0.5 * add(C, transpose(C));
-        lp -= 0.5 * (log(Q) + pow(e, 2) * Q_inv);
-      }
-    }
-  }
-  return lp;
+  return internal::gaussian_dlm_obs_lpdf<propto>(y, F, G, V, W, m0, C0, true,
+                                                 steady_state_tol);
 }
 
 template <typename T_y, typename T_F, typename T_G, typename T_V, typename T_W,
@@ -327,8 +574,10 @@ gaussian_dlm_obs_lpdf(
     const Eigen::Matrix<T_V, Eigen::Dynamic, 1>& V,
     const Eigen::Matrix<T_W, Eigen::Dynamic, Eigen::Dynamic>& W,
     const Eigen::Matrix<T_m0, Eigen::Dynamic, 1>& m0,
-    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0) {
-  return gaussian_dlm_obs_lpdf<false>(y, F, G, V, W, m0, C0);
+    const Eigen::Matrix<T_C0, Eigen::Dynamic, Eigen::Dynamic>& C0,
+    double steady_state_tol = 0) {
+  return gaussian_dlm_obs_lpdf<false>(y, F, G, V, W, m0, C0,
+                                      steady_state_tol);
 }
 
 }  // namespace math
@@ -0,0 +1,67 @@
+#ifndef STAN_MATH_PRIM_PROB_HMM_LATENT_RNG_HPP
+#define STAN_MATH_PRIM_PROB_HMM_LATENT_RNG_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/hmm_marginal.hpp>
+#include <stan/math/prim/prob/categorical_rng.hpp>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Return a draw of the hidden states of a hidden Markov model from
+ * their joint posterior distribution given the observations.
+ *
+ * The states are drawn by forward filtering and backward sampling: the
+ * state of the last observation is drawn from its filtered
+ * distribution, and the state of every preceding observation from its
+ * filtered distribution times the probability of the transition to the
+ * state drawn after it.
+ *
+ * @tparam RNG type of random number generator
+ * @param log_omegas K x N matrix of the log densities of the N
+ * observations under each of the K states
+ * @param Gamma K x K transition matrix, with the probability of moving
+ * from state i to state j in row i and column j
+ * @param rho size K distribution of the state of the first observation
+ * @param rng random number generator
+ * @return size N array of the states, from 1 to K
+ * @throw std::invalid_argument if the sizes do not match or there are
+ * no observations or states
+ * @throw std::domain_error if the rows of Gamma or rho are not
+ * simplexes, any log density is NaN or positive infinity or the
+ * observations are impossible
+ */
+template <class RNG>
+inline std::vector<int> hmm_latent_rng(
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& log_omegas,
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& Gamma,
+    const Eigen::Matrix<double, Eigen::Dynamic, 1>& rho, RNG& rng) {
+  static const char* function = "hmm_latent_rng";
+  internal::hmm_check(function, log_omegas, Gamma, rho);
+  const int N = log_omegas.cols();
+
+  Eigen::MatrixXd omegas;
+  Eigen::MatrixXd alphas;
+  Eigen::VectorXd norms;
+  const double logp
+      = internal::hmm_forward(log_omegas, Gamma, rho, omegas, alphas, norms);
+  check_not_nan(function, "log marginal density", logp);
+  check_finite(function, "log marginal density", logp);
+
+  std::vector<int> states(N);
+  states[N - 1] = categorical_rng(Eigen::VectorXd(alphas.col(N - 1)), rng);
+  for (int n = N - 2; n >= 0; --n) {
+    Eigen::VectorXd probs
+        = alphas.col(n).cwiseProduct(Gamma.col(states[n + 1] - 1));
+    probs /= probs.sum();
+    states[n] = categorical_rng(probs, rng);
+  }
+  return states;
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -5,22 +5,25 @@
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/mat/fun/make_nu.hpp>
 #include <stan/math/prim/prob/lkj_corr_log.hpp>
-#include <stan/math/prim/mat/fun/log.hpp>
-#include <stan/math/prim/mat/fun/multiply.hpp>
+#include <stan/math/prim/scal/fun/log.hpp>
+#include <stan/math/prim/scal/fun/value_of.hpp>
 
 namespace stan {
 namespace math {
 
 // LKJ_Corr(L|eta) [ L Cholesky factor of correlation matrix
 //                  eta > 0; eta == 1 <-> uniform]
+// The density only depends on the diagonal of L, for which the
+// gradients are computed in closed form.
 template <bool propto, typename T_covar, typename T_shape>
 return_type_t<T_covar, T_shape> lkj_corr_cholesky_lpdf(
     const Eigen::Matrix<T_covar, Eigen::Dynamic, Eigen::Dynamic>& L,
     const T_shape& eta) {
   static const char* function = "lkj_corr_cholesky_lpdf";
+  using T_partials_return = partials_return_t<T_covar, T_shape>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
 
-  using lp_ret = return_type_t<T_covar, T_shape>;
-  lp_ret lp(0.0);
   check_positive(function, "Shape parameter", eta);
   check_lower_triangular(function, "Random variable", L);
 
@@ -29,26 +32,42 @@ return_type_t<T_covar, T_shape> lkj_corr_cholesky_lpdf(
     return 0.0;
   }
 
+  const T_partials_return eta_dbl = value_of(eta);
+  T_partials_return logp(0);
+  operands_and_partials<Eigen::Matrix<T_covar, Eigen::Dynamic, Eigen::Dynamic>,
+                        T_shape>
+      ops_partials(L, eta);
+
   if (include_summand<propto, T_shape>::value) {
-    lp += do_lkj_constant(eta, K);
+    logp += do_lkj_constant(eta_dbl, K);
+    if (!is_constant_all<T_shape>::value) {
+      ops_partials.edge2_.partials_[0] += do_lkj_constant_deriv(eta_dbl, K);
+    }
   }
   if (include_summand<propto, T_covar, T_shape>::value) {
     const int Km1 = K - 1;
-    Eigen::Matrix<T_covar, Eigen::Dynamic, 1> log_diagonals
-        = log(L.diagonal().tail(Km1).array());
-    Eigen::Matrix<lp_ret, Eigen::Dynamic, 1> values(Km1);
-    for (int k = 0; k < Km1; k++) {
-      values(k) = (Km1 - k - 1) * log_diagonals(k);
+    matrix_partials_t d_L;
+    if (!is_constant_all<T_covar>::value) {
+      d_L.setZero(K, K);
+    }
+    for (int k = 1; k <= Km1; k++) {
+      const T_partials_return L_kk = value_of(L(k, k));
+      const T_partials_return log_L_kk = log(L_kk);
+      const T_partials_return coeff = Km1 - k + 2.0 * eta_dbl - 2.0;
+      logp += coeff * log_L_kk;
+      if (!is_constant_all<T_covar>::value) {
+        d_L(k, k) = coeff / L_kk;
+      }
+      if (!is_constant_all<T_shape>::value) {
+        ops_partials.edge2_.partials_[0] += 2.0 * log_L_kk;
+      }
     }
-    if (eta == 1.0 && is_constant_all<scalar_type<T_shape>>::value) {
-      lp += sum(values);
-      return (lp);
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge1_.partials_ += d_L;
     }
-    values += multiply(2.0 * eta - 2.0, log_diagonals);
-    lp += sum(values);
   }
 
-  return lp;
+  return ops_partials.build(logp);
 }
 
 template <typename T_covar, typename T_shape>
@@ -4,9 +4,13 @@
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
+#include <stan/math/prim/scal/fun/digamma.hpp>
 #include <stan/math/prim/scal/fun/lgamma.hpp>
+#include <stan/math/prim/scal/fun/value_of.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <stan/math/prim/mat/fun/log.hpp>
 #include <stan/math/prim/mat/fun/sum.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 
 namespace stan {
 namespace math {
@@ -42,15 +46,40 @@ return_type_t<double, T_shape> do_lkj_constant(const T_shape& eta,
   return constant;
 }
 
+/**
+ * Return the derivative of the log normalizing constant of the LKJ
+ * density, <code>do_lkj_constant(eta, K)</code>, with respect to the
+ * shape parameter.
+ *
+ * @tparam T_shape type of shape parameter
+ * @param eta shape parameter
+ * @param K dimension of the correlation matrix
+ * @return derivative of the log normalizing constant
+ */
+template <typename T_shape>
+return_type_t<double, T_shape> do_lkj_constant_deriv(const T_shape& eta,
+                                                     const unsigned int& K) {
+  const int Km1 = K - 1;
+  return_type_t<double, T_shape> deriv = Km1 * digamma(eta + 0.5 * Km1);
+  for (int k = 1; k <= Km1; k++) {
+    deriv -= digamma(eta + 0.5 * (Km1 - k));
+  }
+  return deriv;
+}
+
 // LKJ_Corr(y|eta) [ y correlation matrix (not covariance matrix)
 //                  eta > 0; eta == 1 <-> uniform]
+// The gradients are computed in closed form on an LDLT factorization of
+// the value of y, (eta - 1) y^-1 wrt to y folded onto its lower triangle.
 template <bool propto, typename T_y, typename T_shape>
 return_type_t<T_y, T_shape> lkj_corr_lpdf(
     const Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>& y,
     const T_shape& eta) {
   static const char* function = "lkj_corr_lpdf";
+  using T_partials_return = partials_return_t<T_y, T_shape>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
 
-  return_type_t<T_y, T_shape> lp(0.0);
   check_positive(function, "Shape parameter", eta);
   check_corr_matrix(function, "Correlation matrix", y);
 
@@ -59,21 +88,42 @@ return_type_t<T_y, T_shape> lkj_corr_lpdf(
     return 0.0;
   }
 
+  const T_partials_return eta_dbl = value_of(eta);
+  T_partials_return logp(0);
+  operands_and_partials<Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>,
+                        T_shape>
+      ops_partials(y, eta);
+
   if (include_summand<propto, T_shape>::value) {
-    lp += do_lkj_constant(eta, K);
+    logp += do_lkj_constant(eta_dbl, K);
+    if (!is_constant_all<T_shape>::value) {
+      ops_partials.edge2_.partials_[0] += do_lkj_constant_deriv(eta_dbl, K);
+    }
   }
 
   if (eta == 1.0 && is_constant_all<scalar_type<T_shape>>::value) {
-    return lp;
+    return ops_partials.build(logp);
   }
 
   if (!include_summand<propto, T_y, T_shape>::value) {
-    return lp;
+    return ops_partials.build(logp);
   }
 
-  T_y sum_values = sum(log(y.ldlt().vectorD()));
-  lp += (eta - 1.0) * sum_values;
-  return lp;
+  const matrix_partials_t y_dbl = value_of(y);
+  Eigen::LDLT<matrix_partials_t> ldlt_y(y_dbl);
+  const T_partials_return log_det_y = sum(log(ldlt_y.vectorD()));
+  logp += (eta_dbl - 1.0) * log_det_y;
+  if (!is_constant_all<T_shape>::value) {
+    ops_partials.edge2_.partials_[0] += log_det_y;
+  }
+  if (!is_constant_all<T_y>::value) {
+    matrix_partials_t d_y
+        = (eta_dbl - 1.0) * ldlt_y.solve(matrix_partials_t::Identity(K, K));
+    d_y.template triangularView<Eigen::StrictlyLower>() *= 2.0;
+    d_y.template triangularView<Eigen::StrictlyUpper>().setZero();
+    ops_partials.edge1_.partials_ += d_y;
+  }
+  return ops_partials.build(logp);
 }
 
 template <typename T_y, typename T_shape>
@@ -3,12 +3,146 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/prob/lognormal_lpdf.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/log.hpp>
+#include <stan/math/prim/mat/fun/sum.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 #include <stan/math/prim/prob/lkj_corr_lpdf.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+#include <stan/math/prim/scal/fun/log.hpp>
+#include <stan/math/prim/scal/fun/value_of.hpp>
 
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * Return the log of the LKJ density of the covariance matrix y with
+ * lognormal priors on its standard deviations, for a location and
+ * scale that are either scalars or vectors with one entry per standard
+ * deviation.
+ *
+ * The correlation matrix D y D, with D the diagonal matrix of inverse
+ * standard deviations, is not formed. Its log determinant is
+ * log det(y) - sum(log(diag(y))), such that the gradients are computed
+ * in closed form on one LDLT factorization of the value of y and folded
+ * onto its lower triangle.
+ *
+ * @tparam propto Carry out calculations up to a proportion
+ * @param y covariance matrix
+ * @param mu location of the lognormal prior on the standard deviations
+ * @param sigma scale of the lognormal prior on the standard deviations
+ * @param eta shape parameter
+ * @return log of the LKJ density of y
+ */
+template <bool propto, typename T_y, typename T_loc, typename T_scale,
+          typename T_shape>
+return_type_t<T_y, T_loc, T_scale, T_shape> lkj_cov_lpdf(
+    const Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>& y,
+    const T_loc& mu, const T_scale& sigma, const T_shape& eta) {
+  static const char* function = "lkj_cov_lpdf";
+  using T_partials_return = partials_return_t<T_y, T_loc, T_scale, T_shape>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
+  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
+
+  check_positive(function, "Shape parameter", eta);
+  check_finite(function, "Location parameter", mu);
+  check_finite(function, "Scale parameter", sigma);
+  check_positive(function, "Scale parameter", sigma);
+  check_finite(function, "Covariance matrix", y);
+  check_symmetric(function, "Covariance matrix", y);
+
+  const unsigned int K = y.rows();
+  if (K == 0) {
+    return 0.0;
+  }
+
+  const matrix_partials_t y_dbl = value_of(y);
+  Eigen::LDLT<matrix_partials_t> ldlt_y(y_dbl);
+  check_pos_definite(function, "Covariance matrix", ldlt_y);
+
+  scalar_seq_view<T_loc> mu_vec(mu);
+  scalar_seq_view<T_scale> sigma_vec(sigma);
+  const T_partials_return eta_dbl = value_of(eta);
+  T_partials_return logp(0);
+  operands_and_partials<Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>,
+                        T_loc, T_scale, T_shape>
+      ops_partials(y, mu, sigma, eta);
+
+  // lognormal priors on the standard deviations sqrt(y(k, k))
+  vector_partials_t log_diag(K);
+  vector_partials_t d_diag = vector_partials_t::Zero(K);
+  for (unsigned int k = 0; k < K; k++) {
+    log_diag(k) = log(y_dbl(k, k));
+    const T_partials_return mu_dbl = value_of(mu_vec[k]);
+    const T_partials_return inv_sigma = 1 / value_of(sigma_vec[k]);
+    const T_partials_return logy_m_mu = 0.5 * log_diag(k) - mu_dbl;
+    const T_partials_return logy_m_mu_div_sigma
+        = logy_m_mu * inv_sigma * inv_sigma;
+
+    if (include_summand<propto>::value) {
+      logp += NEG_LOG_SQRT_TWO_PI;
+    }
+    if (include_summand<propto, T_scale>::value) {
+      logp += log(inv_sigma);
+    }
+    if (include_summand<propto, T_y>::value) {
+      logp -= 0.5 * log_diag(k);
+    }
+    if (include_summand<propto, T_y, T_loc, T_scale>::value) {
+      logp -= 0.5 * logy_m_mu * logy_m_mu_div_sigma;
+    }
+
+    if (!is_constant_all<T_y>::value) {
+      d_diag(k) -= 0.5 * (1 + logy_m_mu_div_sigma) / y_dbl(k, k);
+    }
+    if (!is_constant_all<T_loc>::value) {
+      ops_partials.edge2_.partials_[k] += logy_m_mu_div_sigma;
+    }
+    if (!is_constant_all<T_scale>::value) {
+      ops_partials.edge3_.partials_[k]
+          += (logy_m_mu_div_sigma * logy_m_mu - 1) * inv_sigma;
+    }
+  }
+
+  // LKJ density of the correlation matrix D y D
+  matrix_partials_t d_y;
+  if (!is_constant_all<T_y>::value) {
+    d_y.setZero(K, K);
+  }
+  if (include_summand<propto, T_shape>::value) {
+    logp += do_lkj_constant(eta_dbl, K);
+    if (!is_constant_all<T_shape>::value) {
+      ops_partials.edge4_.partials_[0] += do_lkj_constant_deriv(eta_dbl, K);
+    }
+  }
+  if (!(eta == 1.0 && is_constant_all<scalar_type<T_shape>>::value)
+      && include_summand<propto, T_y, T_shape>::value) {
+    const T_partials_return log_det_corr
+        = sum(log(ldlt_y.vectorD())) - log_diag.sum();
+    logp += (eta_dbl - 1.0) * log_det_corr;
+    if (!is_constant_all<T_shape>::value) {
+      ops_partials.edge4_.partials_[0] += log_det_corr;
+    }
+    if (!is_constant_all<T_y>::value) {
+      d_y = (eta_dbl - 1.0) * ldlt_y.solve(matrix_partials_t::Identity(K, K));
+      d_diag.array() -= (eta_dbl - 1.0) / y_dbl.diagonal().array();
+    }
+  }
+
+  if (!is_constant_all<T_y>::value) {
+    d_y.diagonal() += d_diag;
+    d_y.template triangularView<Eigen::StrictlyLower>() *= 2.0;
+    d_y.template triangularView<Eigen::StrictlyUpper>().setZero();
+    ops_partials.edge1_.partials_ += d_y;
+  }
+  return ops_partials.build(logp);
+}
+
+}  // namespace internal
+
 // LKJ_cov(y|mu, sigma, eta) [ y covariance matrix (not correlation matrix)
 //                         mu vector, sigma > 0 vector, eta > 0 ]
 template <bool propto, typename T_y, typename T_loc, typename T_scale,
@@ -20,32 +154,12 @@ return_type_t<T_y, T_loc, T_scale, T_shape> lkj_cov_lpdf(
     const T_shape& eta) {
   static const char* function = "lkj_cov_lpdf";
 
-  return_type_t<T_y, T_loc, T_scale, T_shape> lp(0.0);
   check_size_match(function, "Rows of location parameter", mu.rows(),
                    "columns of scale parameter", sigma.rows());
   check_square(function, "random variable", y);
   check_size_match(function, "Rows of random variable", y.rows(),
                    "rows of location parameter", mu.rows());
-  check_positive(function, "Shape parameter", eta);
-  check_finite(function, "Location parameter", mu);
-  check_finite(function, "Scale parameter", sigma);
-  check_finite(function, "Covariance matrix", y);
-
-  const unsigned int K = y.rows();
-  const Eigen::Array<T_y, Eigen::Dynamic, 1> sds = y.diagonal().array().sqrt();
-  for (unsigned int k = 0; k < K; k++) {
-    lp += lognormal_lpdf<propto>(sds(k), mu(k), sigma(k));
-  }
-  if (stan::is_constant_all<typename stan::scalar_type<T_shape> >::value
-      && eta == 1.0) {
-    // no need to rescale y into a correlation matrix
-    lp += lkj_corr_lpdf<propto, T_y, T_shape>(y, eta);
-    return lp;
-  }
-  Eigen::DiagonalMatrix<T_y, Eigen::Dynamic> D(K);
-  D.diagonal() = sds.inverse();
-  lp += lkj_corr_lpdf<propto, T_y, T_shape>(D * y * D, eta);
-  return lp;
+  return internal::lkj_cov_lpdf<propto>(y, mu, sigma, eta);
 }
 
 template <typename T_y, typename T_loc, typename T_scale, typename T_shape>
@@ -64,29 +178,7 @@ template <bool propto, typename T_y, typename T_loc, typename T_scale,
 return_type_t<T_y, T_loc, T_scale, T_shape> lkj_cov_lpdf(
     const Eigen::Matrix<T_y, Eigen::Dynamic, Eigen::Dynamic>& y,
     const T_loc& mu, const T_scale& sigma, const T_shape& eta) {
-  static const char* function = "lkj_cov_lpdf";
-
-  return_type_t<T_y, T_loc, T_scale, T_shape> lp(0.0);
-  check_positive(function, "Shape parameter", eta);
-  check_finite(function, "Location parameter", mu);
-  check_finite(function, "Scale parameter", sigma);
-  check_finite(function, "Covariance matrix", y);
-
-  const unsigned int K = y.rows();
-  const Eigen::Array<T_y, Eigen::Dynamic, 1> sds = y.diagonal().array().sqrt();
-  for (unsigned int k = 0; k < K; k++) {
-    lp += lognormal_lpdf<propto>(sds(k), mu, sigma);
-  }
-  if (stan::is_constant_all<typename stan::scalar_type<T_shape> >::value
-      && eta == 1.0) {
-    // no need to rescale y into a correlation matrix
-    lp += lkj_corr_lpdf<propto>(y, eta);
-    return lp;
-  }
-  Eigen::DiagonalMatrix<T_y, Eigen::Dynamic> D(K);
-  D.diagonal() = sds.inverse();
-  lp += lkj_corr_lpdf<propto, T_y, T_shape>(D * y * D, eta);
-  return lp;
+  return internal::lkj_cov_lpdf<propto>(y, mu, sigma, eta);
 }
 
 template <typename T_y, typename T_loc, typename T_scale, typename T_shape>
@@ -3,11 +3,10 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/mat/fun/dot_self.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <stan/math/prim/mat/fun/log.hpp>
 #include <stan/math/prim/mat/fun/sum.hpp>
-#include <stan/math/prim/mat/fun/mdivide_left_tri.hpp>
-#include <stan/math/prim/mat/fun/transpose.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
 
 namespace stan {
@@ -23,7 +22,11 @@ namespace math {
  * written by Jason D. M. Rennie.
  *
  * All expressions are adapted to avoid (most) inversions and maximal
- * reuse of intermediates.
+ * reuse of intermediates. The residuals of all observations are
+ * stacked into one matrix, such that the quadratic form takes two
+ * blocked triangular solves and the gradient wrt to L a single matrix
+ * product. The inverse of L is only formed for the gradient of the log
+ * determinant if L is not data.
  *
  * @param y A scalar vector
  * @param mu The mean vector of the multivariate normal distribution.
@@ -45,9 +48,6 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_cholesky_lpdf(
   using T_partials_return = partials_return_t<T_y, T_loc, T_covar>;
   using matrix_partials_t
       = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
-  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
-  using row_vector_partials_t
-      = Eigen::Matrix<T_partials_return, 1, Eigen::Dynamic>;
 
   check_consistent_sizes_mvt(function, "y", y, "mu", mu);
   size_t number_of_y = size_mvt(y);
@@ -113,45 +113,52 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_cholesky_lpdf(
     logp += NEG_LOG_SQRT_TWO_PI * size_y * size_vec;
   }
 
-  const matrix_partials_t inv_L_dbl
-      = mdivide_left_tri<Eigen::Lower>(value_of(L));
+  const matrix_partials_t L_dbl = value_of(L);
 
   if (include_summand<propto, T_y, T_loc, T_covar_elem>::value) {
+    matrix_partials_t y_minus_mu_dbl(size_y, size_vec);
     for (size_t i = 0; i < size_vec; i++) {
-      vector_partials_t y_minus_mu_dbl(size_y);
       for (int j = 0; j < size_y; j++) {
-        y_minus_mu_dbl(j) = value_of(y_vec[i](j)) - value_of(mu_vec[i](j));
+        y_minus_mu_dbl(j, i) = value_of(y_vec[i](j)) - value_of(mu_vec[i](j));
       }
+    }
 
-      const row_vector_partials_t half
-          = (inv_L_dbl.template triangularView<Eigen::Lower>() * y_minus_mu_dbl)
-                .transpose();
-      const vector_partials_t scaled_diff
-          = (half * inv_L_dbl.template triangularView<Eigen::Lower>())
-                .transpose();
+    // one blocked solve for all observations: half = L^-1 (y - mu) and
+    // scaled_diff = L'^-1 half = Sigma^-1 (y - mu)
+    const matrix_partials_t half
+        = L_dbl.template triangularView<Eigen::Lower>().solve(y_minus_mu_dbl);
+    const matrix_partials_t scaled_diff
+        = L_dbl.template triangularView<Eigen::Lower>().transpose().solve(half);
 
-      logp -= 0.5 * dot_self(half);
+    logp -= 0.5 * half.squaredNorm();
 
-      if (!is_constant_all<T_y>::value) {
+    if (!is_constant_all<T_y>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
         for (int j = 0; j < size_y; j++) {
-          ops_partials.edge1_.partials_vec_[i](j) -= scaled_diff(j);
+          ops_partials.edge1_.partials_vec_[i](j) -= scaled_diff(j, i);
         }
       }
-      if (!is_constant_all<T_loc>::value) {
+    }
+    if (!is_constant_all<T_loc>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
         for (int j = 0; j < size_y; j++) {
-          ops_partials.edge2_.partials_vec_[i](j) += scaled_diff(j);
+          ops_partials.edge2_.partials_vec_[i](j) += scaled_diff(j, i);
         }
       }
-      if (!is_constant_all<T_covar>::value) {
-        ops_partials.edge3_.partials_ += scaled_diff * half;
-      }
+    }
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge3_.partials_ += scaled_diff * half.transpose();
     }
   }
 
   if (include_summand<propto, T_covar_elem>::value) {
-    logp += sum(log(inv_L_dbl.diagonal())) * size_vec;
+    logp -= sum(log(L_dbl.diagonal())) * size_vec;
     if (!is_constant_all<T_covar>::value) {
-      ops_partials.edge3_.partials_ -= size_vec * inv_L_dbl.transpose();
+      ops_partials.edge3_.partials_
+          -= size_vec
+             * L_dbl.template triangularView<Eigen::Lower>()
+                   .transpose()
+                   .solve(matrix_partials_t::Identity(size_y, size_y));
     }
   }
 
@@ -3,26 +3,53 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/mat/fun/log_determinant_ldlt.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/log.hpp>
 #include <stan/math/prim/mat/fun/sum.hpp>
-#include <stan/math/prim/mat/fun/trace_quad_form.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
 
 namespace stan {
 namespace math {
 
+/** \ingroup multivar_dists
+ * The log of the multivariate normal density for the given y, mu, and
+ * precision matrix Sigma.
+ *
+ * The gradients are computed in closed form. With the residuals
+ * r_i = y_i - mu_i collected in the columns of R and Z = Sigma R,
+ * obtained with one product for all observations, the partials are
+ * -z_i wrt to y_i, z_i wrt to mu_i and
+ * (n Sigma^-1 - R R') / 2 wrt to Sigma, where the inverse is taken
+ * from the LDLT factorization used for the log determinant.
+ *
+ * @param y A scalar vector or an array of vectors
+ * @param mu The mean vector of the multivariate normal distribution
+ * or an array of mean vectors
+ * @param Sigma The precision matrix of the multivariate normal
+ * distribution
+ * @return The log of the multivariate normal density.
+ * @throw std::domain_error if Sigma is not square, not symmetric,
+ * or not positive definite.
+ * @tparam T_y Type of scalar.
+ * @tparam T_loc Type of location.
+ * @tparam T_covar Type of precision.
+ */
 template <bool propto, typename T_y, typename T_loc, typename T_covar>
 return_type_t<T_y, T_loc, T_covar> multi_normal_prec_lpdf(
     const T_y& y, const T_loc& mu, const T_covar& Sigma) {
   static const char* function = "multi_normal_prec_lpdf";
   using T_covar_elem = typename scalar_type<T_covar>::type;
-  using lp_type = return_type_t<T_y, T_loc, T_covar>;
+  using T_partials_return = partials_return_t<T_y, T_loc, T_covar>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
 
   check_positive(function, "Precision matrix rows", Sigma.rows());
   check_symmetric(function, "Precision matrix", Sigma);
 
-  LDLT_factor<T_covar_elem, Eigen::Dynamic, Eigen::Dynamic> ldlt_Sigma(Sigma);
-  check_ldlt_factor(function, "LDLT_Factor of precision parameter", ldlt_Sigma);
+  const matrix_partials_t Sigma_dbl = value_of(Sigma);
+  Eigen::LDLT<matrix_partials_t> ldlt_Sigma(Sigma_dbl);
+  check_pos_definite(function, "Precision matrix", ldlt_Sigma);
 
   using Eigen::Matrix;
   using std::vector;
@@ -34,7 +61,6 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_prec_lpdf(
   }
   check_consistent_sizes_mvt(function, "y", y, "mu", mu);
 
-  lp_type lp(0);
   vector_seq_view<T_y> y_vec(y);
   vector_seq_view<T_loc> mu_vec(mu);
   size_t size_vec = max_size_mvt(y, mu);
@@ -87,30 +113,57 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_prec_lpdf(
   }
 
   if (size_y == 0) {
-    return lp;
+    return 0;
   }
 
+  T_partials_return logp(0);
+  operands_and_partials<T_y, T_loc, T_covar> ops_partials(y, mu, Sigma);
+
   if (include_summand<propto, T_covar_elem>::value) {
-    lp += 0.5 * log_determinant_ldlt(ldlt_Sigma) * size_vec;
+    logp += 0.5 * sum(log(ldlt_Sigma.vectorD())) * size_vec;
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge3_.partials_
+          += 0.5 * size_vec
+             * ldlt_Sigma.solve(matrix_partials_t::Identity(size_y, size_y));
+    }
   }
 
   if (include_summand<propto>::value) {
-    lp += NEG_LOG_SQRT_TWO_PI * size_y * size_vec;
+    logp += NEG_LOG_SQRT_TWO_PI * size_y * size_vec;
   }
 
   if (include_summand<propto, T_y, T_loc, T_covar_elem>::value) {
-    lp_type sum_lp_vec(0.0);
+    matrix_partials_t y_minus_mu_dbl(size_y, size_vec);
     for (size_t i = 0; i < size_vec; i++) {
-      Eigen::Matrix<return_type_t<T_y, T_loc>, Eigen::Dynamic, 1> y_minus_mu(
-          size_y);
       for (int j = 0; j < size_y; j++) {
-        y_minus_mu(j) = y_vec[i](j) - mu_vec[i](j);
+        y_minus_mu_dbl(j, i) = value_of(y_vec[i](j)) - value_of(mu_vec[i](j));
       }
-      sum_lp_vec += trace_quad_form(Sigma, y_minus_mu);
     }
-    lp -= 0.5 * sum_lp_vec;
+    const matrix_partials_t scaled_diff = Sigma_dbl * y_minus_mu_dbl;
+
+    logp -= 0.5 * y_minus_mu_dbl.cwiseProduct(scaled_diff).sum();
+
+    if (!is_constant_all<T_y>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
+        for (int j = 0; j < size_y; j++) {
+          ops_partials.edge1_.partials_vec_[i](j) -= scaled_diff(j, i);
+        }
+      }
+    }
+    if (!is_constant_all<T_loc>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
+        for (int j = 0; j < size_y; j++) {
+          ops_partials.edge2_.partials_vec_[i](j) += scaled_diff(j, i);
+        }
+      }
+    }
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge3_.partials_
+          -= 0.5 * y_minus_mu_dbl * y_minus_mu_dbl.transpose();
+    }
   }
-  return lp;
+
+  return ops_partials.build(logp);
 }
 
 template <typename T_y, typename T_loc, typename T_covar>
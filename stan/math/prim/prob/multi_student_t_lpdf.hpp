@@ -3,11 +3,17 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/log.hpp>
+#include <stan/math/prim/mat/fun/sum.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 #include <stan/math/prim/prob/multi_normal_log.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
+#include <stan/math/prim/scal/fun/digamma.hpp>
 #include <stan/math/prim/scal/fun/is_inf.hpp>
 #include <stan/math/prim/scal/fun/log1p.hpp>
 #include <stan/math/prim/scal/fun/lgamma.hpp>
+#include <stan/math/prim/scal/fun/value_of.hpp>
 #include <cmath>
 #include <cstdlib>
 
@@ -18,6 +24,13 @@ namespace math {
  * Return the log of the multivariate Student t distribution
  * at the specified arguments.
  *
+ * The gradients are computed in closed form from a single LDLT
+ * factorization of the value of Sigma. With the residuals
+ * r_i = y_i - mu_i, z_i = Sigma^-1 r_i obtained with one solve for all
+ * observations, q_i = r_i' z_i and w_i = (nu + K) / (nu + q_i), the
+ * partials are -w_i z_i wrt to y_i, w_i z_i wrt to mu_i and
+ * (sum_i w_i z_i z_i' - n Sigma^-1) / 2 wrt to Sigma.
+ *
  * @tparam propto Carry out calculations up to a proportion
  */
 template <bool propto, typename T_y, typename T_dof, typename T_loc,
@@ -25,9 +38,11 @@ template <bool propto, typename T_y, typename T_dof, typename T_loc,
 return_type_t<T_y, T_dof, T_loc, T_scale> multi_student_t_lpdf(
     const T_y& y, const T_dof& nu, const T_loc& mu, const T_scale& Sigma) {
   static const char* function = "multi_student_t";
-  using std::log;
   using T_scale_elem = typename scalar_type<T_scale>::type;
-  using lp_type = return_type_t<T_y, T_dof, T_loc, T_scale>;
+  using T_partials_return = partials_return_t<T_y, T_dof, T_loc, T_scale>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
+  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
 
   check_not_nan(function, "Degrees of freedom parameter", nu);
   check_positive(function, "Degrees of freedom parameter", nu);
@@ -95,45 +110,94 @@ return_type_t<T_y, T_dof, T_loc, T_scale> multi_student_t_lpdf(
   }
   check_symmetric(function, "Scale parameter", Sigma);
 
-  LDLT_factor<T_scale_elem, Eigen::Dynamic, Eigen::Dynamic> ldlt_Sigma(Sigma);
-  check_ldlt_factor(function, "LDLT_Factor of scale parameter", ldlt_Sigma);
+  const matrix_partials_t Sigma_dbl = value_of(Sigma);
+  Eigen::LDLT<matrix_partials_t> ldlt_Sigma(Sigma_dbl);
+  check_pos_definite(function, "Scale parameter", ldlt_Sigma);
 
   if (size_y == 0) {
     return 0;
   }
 
-  lp_type lp(0);
+  const T_partials_return nu_dbl = value_of(nu);
+  T_partials_return logp(0);
+  operands_and_partials<T_y, T_dof, T_loc, T_scale> ops_partials(y, nu, mu,
+                                                                Sigma);
 
   if (include_summand<propto, T_dof>::value) {
-    lp += lgamma(0.5 * (nu + size_y)) * size_vec;
-    lp -= lgamma(0.5 * nu) * size_vec;
-    lp -= (0.5 * size_y) * log(nu) * size_vec;
+    logp += lgamma(0.5 * (nu_dbl + size_y)) * size_vec;
+    logp -= lgamma(0.5 * nu_dbl) * size_vec;
+    logp -= (0.5 * size_y) * log(nu_dbl) * size_vec;
+    if (!is_constant_all<T_dof>::value) {
+      ops_partials.edge2_.partials_[0]
+          += 0.5 * size_vec
+             * (digamma(0.5 * (nu_dbl + size_y)) - digamma(0.5 * nu_dbl)
+                - size_y / nu_dbl);
+    }
   }
 
   if (include_summand<propto>::value) {
-    lp -= (0.5 * size_y) * LOG_PI * size_vec;
+    logp -= (0.5 * size_y) * LOG_PI * size_vec;
   }
 
-  using Eigen::Array;
-
   if (include_summand<propto, T_scale_elem>::value) {
-    lp -= 0.5 * log_determinant_ldlt(ldlt_Sigma) * size_vec;
+    logp -= 0.5 * sum(log(ldlt_Sigma.vectorD())) * size_vec;
+    if (!is_constant_all<T_scale>::value) {
+      ops_partials.edge4_.partials_
+          -= 0.5 * size_vec
+             * ldlt_Sigma.solve(matrix_partials_t::Identity(size_y, size_y));
+    }
   }
 
   if (include_summand<propto, T_y, T_dof, T_loc, T_scale_elem>::value) {
-    lp_type sum_lp_vec(0.0);
+    matrix_partials_t y_minus_mu_dbl(size_y, size_vec);
     for (size_t i = 0; i < size_vec; i++) {
-      Eigen::Matrix<return_type_t<T_y, T_loc>, Eigen::Dynamic, 1> y_minus_mu(
-          size_y);
       for (int j = 0; j < size_y; j++) {
-        y_minus_mu(j) = y_vec[i](j) - mu_vec[i](j);
+        y_minus_mu_dbl(j, i) = value_of(y_vec[i](j)) - value_of(mu_vec[i](j));
+      }
+    }
+    const matrix_partials_t scaled_diff = ldlt_Sigma.solve(y_minus_mu_dbl);
+    const vector_partials_t quad
+        = y_minus_mu_dbl.cwiseProduct(scaled_diff).colwise().sum().transpose();
+
+    vector_partials_t weights(size_vec);
+    T_partials_return sum_log1p(0);
+    T_partials_return sum_quad_ratio(0);
+    for (size_t i = 0; i < size_vec; i++) {
+      sum_log1p += log1p(quad(i) / nu_dbl);
+      sum_quad_ratio += quad(i) / (nu_dbl + quad(i));
+      weights(i) = (nu_dbl + size_y) / (nu_dbl + quad(i));
+    }
+    logp -= 0.5 * (nu_dbl + size_y) * sum_log1p;
+
+    if (!is_constant_all<T_dof>::value) {
+      ops_partials.edge2_.partials_[0]
+          += 0.5 * (nu_dbl + size_y) / nu_dbl * sum_quad_ratio
+             - 0.5 * sum_log1p;
+    }
+    if (!is_constant_all<T_y, T_loc, T_scale>::value) {
+      const matrix_partials_t weighted_diff
+          = scaled_diff * weights.asDiagonal();
+      if (!is_constant_all<T_y>::value) {
+        for (size_t i = 0; i < size_vec; i++) {
+          for (int j = 0; j < size_y; j++) {
+            ops_partials.edge1_.partials_vec_[i](j) -= weighted_diff(j, i);
+          }
+        }
+      }
+      if (!is_constant_all<T_loc>::value) {
+        for (size_t i = 0; i < size_vec; i++) {
+          for (int j = 0; j < size_y; j++) {
+            ops_partials.edge3_.partials_vec_[i](j) += weighted_diff(j, i);
+          }
+        }
+      }
+      if (!is_constant_all<T_scale>::value) {
+        ops_partials.edge4_.partials_
+            += 0.5 * weighted_diff * scaled_diff.transpose();
       }
-      sum_lp_vec
-          += log1p(trace_inv_quad_form_ldlt(ldlt_Sigma, y_minus_mu) / nu);
     }
-    lp -= 0.5 * (nu + size_y) * sum_lp_vec;
   }
-  return lp;
+  return ops_partials.build(logp);
 }
 
 template <typename T_y, typename T_dof, typename T_loc, typename T_scale>
@@ -3,11 +3,14 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/scal/fun/lmgamma.hpp>
-#include <stan/math/prim/mat/fun/trace.hpp>
-#include <stan/math/prim/mat/fun/log_determinant_ldlt.hpp>
-#include <stan/math/prim/mat/fun/mdivide_left_ldlt.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/log.hpp>
+#include <stan/math/prim/mat/fun/sum.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
+#include <stan/math/prim/scal/fun/digamma.hpp>
+#include <stan/math/prim/scal/fun/lmgamma.hpp>
+#include <stan/math/prim/scal/fun/value_of.hpp>
 
 namespace stan {
 namespace math {
@@ -31,6 +34,18 @@ namespace math {
  -\frac{\nu}{2} \log(\det(S)) + \frac{\nu-k-1}{2}\log (\det(W)) - \frac{1}{2}
  \mbox{tr} (S^{-1}W) \f}
  *
+ * Only the lower triangles of W and S are used. The gradients are
+ * computed in closed form on LDLT factorizations of the values of W
+ * and S,
+ *
+ * \f{eqnarray*}{
+ \frac{\partial}{\partial W} &=& \frac{\nu - k - 1}{2} W^{-1}
+ - \frac{1}{2} S^{-1} \\
+ \frac{\partial}{\partial S} &=& -\frac{\nu}{2} S^{-1}
+ + \frac{1}{2} S^{-1} W S^{-1} \f}
+ *
+ * and are folded onto the lower triangles.
+ *
  * @param W A scalar matrix
  * @param nu Degrees of freedom
  * @param S The scale matrix
@@ -48,48 +63,108 @@ return_type_t<T_y, T_dof, T_scale> wishart_lpdf(
     const T_dof& nu,
     const Eigen::Matrix<T_scale, Eigen::Dynamic, Eigen::Dynamic>& S) {
   static const char* function = "wishart_lpdf";
+  using T_partials_return = partials_return_t<T_y, T_dof, T_scale>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
 
   using Eigen::Dynamic;
   using Eigen::Lower;
   using Eigen::Matrix;
 
   typename index_type<Matrix<T_scale, Dynamic, Dynamic> >::type k = W.rows();
-  return_type_t<T_y, T_dof, T_scale> lp(0.0);
   check_greater(function, "Degrees of freedom parameter", nu, k - 1);
   check_square(function, "random variable", W);
   check_square(function, "scale parameter", S);
   check_size_match(function, "Rows of random variable", W.rows(),
                    "columns of scale parameter", S.rows());
 
-  LDLT_factor<T_y, Eigen::Dynamic, Eigen::Dynamic> ldlt_W(W);
-  check_ldlt_factor(function, "LDLT_Factor of random variable", ldlt_W);
+  const matrix_partials_t W_lower = value_of(W);
+  const matrix_partials_t W_dbl = W_lower.template selfadjointView<Lower>();
+  Eigen::LDLT<matrix_partials_t> ldlt_W(W_dbl);
+  check_pos_definite(function, "random variable", ldlt_W);
 
-  LDLT_factor<T_scale, Eigen::Dynamic, Eigen::Dynamic> ldlt_S(S);
-  check_ldlt_factor(function, "LDLT_Factor of scale parameter", ldlt_S);
+  const matrix_partials_t S_lower = value_of(S);
+  const matrix_partials_t S_dbl = S_lower.template selfadjointView<Lower>();
+  Eigen::LDLT<matrix_partials_t> ldlt_S(S_dbl);
+  check_pos_definite(function, "scale parameter", ldlt_S);
 
-  if (include_summand<propto, T_dof>::value) {
-    lp += nu * k * NEG_LOG_TWO_OVER_TWO;
+  const T_partials_return nu_dbl = value_of(nu);
+  T_partials_return logp(0);
+  operands_and_partials<Matrix<T_y, Dynamic, Dynamic>, T_dof,
+                        Matrix<T_scale, Dynamic, Dynamic> >
+      ops_partials(W, nu, S);
+
+  matrix_partials_t inv_S;
+  if (!is_constant_all<T_y, T_scale>::value) {
+    inv_S = ldlt_S.solve(matrix_partials_t::Identity(k, k));
+  }
+  matrix_partials_t d_W;
+  if (!is_constant_all<T_y>::value) {
+    d_W.setZero(k, k);
+  }
+  matrix_partials_t d_S;
+  if (!is_constant_all<T_scale>::value) {
+    d_S.setZero(k, k);
   }
 
   if (include_summand<propto, T_dof>::value) {
-    lp -= lmgamma(k, 0.5 * nu);
+    logp += nu_dbl * k * NEG_LOG_TWO_OVER_TWO;
+    logp -= lmgamma(k, 0.5 * nu_dbl);
+    if (!is_constant_all<T_dof>::value) {
+      T_partials_return sum_digamma(0);
+      for (int i = 1; i <= k; i++) {
+        sum_digamma += digamma(0.5 * (nu_dbl + 1 - i));
+      }
+      ops_partials.edge2_.partials_[0]
+          += k * NEG_LOG_TWO_OVER_TWO - 0.5 * sum_digamma;
+    }
   }
 
   if (include_summand<propto, T_dof, T_scale>::value) {
-    lp -= 0.5 * nu * log_determinant_ldlt(ldlt_S);
+    const T_partials_return log_det_S = sum(log(ldlt_S.vectorD()));
+    logp -= 0.5 * nu_dbl * log_det_S;
+    if (!is_constant_all<T_dof>::value) {
+      ops_partials.edge2_.partials_[0] -= 0.5 * log_det_S;
+    }
+    if (!is_constant_all<T_scale>::value) {
+      d_S -= 0.5 * nu_dbl * inv_S;
+    }
   }
 
   if (include_summand<propto, T_scale, T_y>::value) {
-    Matrix<return_type_t<T_y, T_scale>, Dynamic, Dynamic> Sinv_W(
-        mdivide_left_ldlt(ldlt_S, static_cast<Matrix<T_y, Dynamic, Dynamic> >(
-                                      W.template selfadjointView<Lower>())));
-    lp -= 0.5 * trace(Sinv_W);
+    const matrix_partials_t Sinv_W = ldlt_S.solve(W_dbl);
+    logp -= 0.5 * Sinv_W.trace();
+    if (!is_constant_all<T_y>::value) {
+      d_W -= 0.5 * inv_S;
+    }
+    if (!is_constant_all<T_scale>::value) {
+      d_S += 0.5 * Sinv_W * inv_S;
+    }
   }
 
-  if (include_summand<propto, T_y, T_dof>::value && nu != (k + 1)) {
-    lp += 0.5 * (nu - k - 1.0) * log_determinant_ldlt(ldlt_W);
+  if (include_summand<propto, T_y, T_dof>::value) {
+    const T_partials_return log_det_W = sum(log(ldlt_W.vectorD()));
+    logp += 0.5 * (nu_dbl - k - 1.0) * log_det_W;
+    if (!is_constant_all<T_dof>::value) {
+      ops_partials.edge2_.partials_[0] += 0.5 * log_det_W;
+    }
+    if (!is_constant_all<T_y>::value) {
+      d_W += 0.5 * (nu_dbl - k - 1.0)
+             * ldlt_W.solve(matrix_partials_t::Identity(k, k));
+    }
+  }
+
+  if (!is_constant_all<T_y>::value) {
+    d_W.template triangularView<Eigen::StrictlyLower>() *= 2.0;
+    d_W.template triangularView<Eigen::StrictlyUpper>().setZero();
+    ops_partials.edge1_.partials_ += d_W;
+  }
+  if (!is_constant_all<T_scale>::value) {
+    d_S.template triangularView<Eigen::StrictlyLower>() *= 2.0;
+    d_S.template triangularView<Eigen::StrictlyUpper>().setZero();
+    ops_partials.edge3_.partials_ += d_S;
   }
-  return lp;
+  return ops_partials.build(logp);
 }
 
 template <typename T_y, typename T_dof, typename T_scale>
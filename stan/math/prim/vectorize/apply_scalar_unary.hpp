@@ -38,13 +38,17 @@ struct apply_scalar_unary;
 /**
  *
  * Template specialization for vectorized functions applying to
- * Eigen matrix arguments.
+ * Eigen matrix arguments. Matrices of <code>var</code> are
+ * specialized in the reverse mode library.
  *
  * @tparam F Type of function to apply.
  * @tparam T Type of argument to which function is applied.
  */
 template <typename F, typename T>
-struct apply_scalar_unary<F, T, require_eigen_t<T>> {
+struct apply_scalar_unary<
+    F, T,
+    require_t<bool_constant<is_eigen<T>::value
+                            && !is_var<value_type_t<T>>::value>>> {
   /**
    * Type of underlying scalar for the matrix type T.
    */
@@ -0,0 +1,80 @@
+#ifndef STAN_MATH_REV_CORE_ACCUMULATE_ADJOINTS_HPP
+#define STAN_MATH_REV_CORE_ACCUMULATE_ADJOINTS_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/meta/is_var.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Add the adjoints of the vars in the arguments to consecutive
+ * positions starting at <code>dest</code>.
+ *
+ * @return pointer past the last accumulated adjoint
+ */
+inline double* accumulate_adjoints(double* dest) { return dest; }
+
+template <typename T, typename... Pargs,
+          typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+inline double* accumulate_adjoints(double* dest, const T& x,
+                                   const Pargs&... args);
+
+template <typename... Pargs>
+inline double* accumulate_adjoints(double* dest, const var& x,
+                                   const Pargs&... args);
+
+template <typename T, typename... Pargs>
+inline double* accumulate_adjoints(double* dest, const std::vector<T>& x,
+                                   const Pargs&... args);
+
+template <typename T, int R, int C, typename... Pargs>
+inline double* accumulate_adjoints(double* dest,
+                                   const Eigen::Matrix<T, R, C>& x,
+                                   const Pargs&... args);
+
+template <typename T, typename... Pargs, typename>
+inline double* accumulate_adjoints(double* dest, const T& x,
+                                   const Pargs&... args) {
+  return accumulate_adjoints(dest, args...);
+}
+
+template <typename... Pargs>
+inline double* accumulate_adjoints(double* dest, const var& x,
+                                   const Pargs&... args) {
+  *dest += x.adj();
+  return accumulate_adjoints(dest + 1, args...);
+}
+
+template <typename T, typename... Pargs>
+inline double* accumulate_adjoints(double* dest, const std::vector<T>& x,
+                                   const Pargs&... args) {
+  if (is_var<scalar_type_t<T>>::value) {
+    for (const auto& x_i : x) {
+      dest = accumulate_adjoints(dest, x_i);
+    }
+  }
+  return accumulate_adjoints(dest, args...);
+}
+
+template <typename T, int R, int C, typename... Pargs>
+inline double* accumulate_adjoints(double* dest,
+                                   const Eigen::Matrix<T, R, C>& x,
+                                   const Pargs&... args) {
+  if (is_var<T>::value) {
+    for (int i = 0; i < x.size(); ++i) {
+      dest = accumulate_adjoints(dest, x.coeff(i));
+    }
+  }
+  return accumulate_adjoints(dest, args...);
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,64 @@
+#ifndef STAN_MATH_REV_CORE_COUNT_VARS_HPP
+#define STAN_MATH_REV_CORE_COUNT_VARS_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/meta/is_var.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return the number of vars in the arguments.
+ */
+inline size_t count_vars() { return 0; }
+
+template <typename T, typename... Pargs,
+          typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+inline size_t count_vars(const T& x, const Pargs&... args);
+
+template <typename... Pargs>
+inline size_t count_vars(const var& x, const Pargs&... args);
+
+template <typename T, typename... Pargs>
+inline size_t count_vars(const std::vector<T>& x, const Pargs&... args);
+
+template <typename T, int R, int C, typename... Pargs>
+inline size_t count_vars(const Eigen::Matrix<T, R, C>& x,
+                         const Pargs&... args);
+
+template <typename T, typename... Pargs, typename>
+inline size_t count_vars(const T& x, const Pargs&... args) {
+  return count_vars(args...);
+}
+
+template <typename... Pargs>
+inline size_t count_vars(const var& x, const Pargs&... args) {
+  return 1 + count_vars(args...);
+}
+
+template <typename T, typename... Pargs>
+inline size_t count_vars(const std::vector<T>& x, const Pargs&... args) {
+  size_t n = 0;
+  if (is_var<scalar_type_t<T>>::value) {
+    for (const auto& x_i : x) {
+      n += count_vars(x_i);
+    }
+  }
+  return n + count_vars(args...);
+}
+
+template <typename T, int R, int C, typename... Pargs>
+inline size_t count_vars(const Eigen::Matrix<T, R, C>& x,
+                         const Pargs&... args) {
+  return (is_var<T>::value ? x.size() : 0) + count_vars(args...);
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
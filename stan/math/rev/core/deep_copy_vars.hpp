@@ -0,0 +1,52 @@
+#ifndef STAN_MATH_REV_CORE_DEEP_COPY_VARS_HPP
+#define STAN_MATH_REV_CORE_DEEP_COPY_VARS_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/meta/is_var.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return the argument unchanged if it does not contain vars, and a
+ * copy with new independent vars of the same values otherwise. The
+ * new vars are created on the autodiff tape of the calling thread.
+ */
+template <typename T,
+          typename = std::enable_if_t<!is_var<scalar_type_t<T>>::value>>
+inline const T& deep_copy_vars(const T& x) {
+  return x;
+}
+
+inline var deep_copy_vars(const var& x) { return var(x.val()); }
+
+template <typename T,
+          typename = std::enable_if_t<is_var<scalar_type_t<T>>::value>>
+inline std::vector<T> deep_copy_vars(const std::vector<T>& x) {
+  std::vector<T> copy;
+  copy.reserve(x.size());
+  for (const auto& x_i : x) {
+    copy.emplace_back(deep_copy_vars(x_i));
+  }
+  return copy;
+}
+
+template <int R, int C>
+inline Eigen::Matrix<var, R, C> deep_copy_vars(
+    const Eigen::Matrix<var, R, C>& x) {
+  Eigen::Matrix<var, R, C> copy(x.rows(), x.cols());
+  for (int i = 0; i < x.size(); ++i) {
+    copy.coeffRef(i) = var(x.coeff(i).val());
+  }
+  return copy;
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
@@ -2,14 +2,17 @@
 #define STAN_MATH_REV_CORE_INIT_CHAINABLESTACK_HPP
 
 #include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/rev/core/chainable_alloc.hpp>
 
 #include <tbb/task_scheduler_observer.h>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <thread>
-#include <tuple>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -20,42 +23,103 @@ namespace math {
  * hook ensures that each worker thread has an initialized AD tape
  * ready for use.
  *
+ * The AD tapes are owned by the observer and persist across scheduler
+ * entries. Whenever a worker thread leaves the scheduler its tape is
+ * cleared and returned to a pool of idle tapes without releasing the
+ * memory of its arena and stacks. A thread entering the scheduler
+ * takes an idle tape from the pool and only if the pool is empty a
+ * new tape is created. Threads which already have an AD tape when
+ * entering the scheduler, like the main thread, keep it, and so do
+ * master threads when leaving it.
+ *
  * Refer to https://software.intel.com/en-us/node/506314 for details
  * on the observer concept.
  */
 class ad_tape_observer : public tbb::task_scheduler_observer {
-  using stack_ptr = std::unique_ptr<ChainableStack>;
-  using ad_map = std::unordered_map<std::thread::id, stack_ptr>;
+  using tape_t = ChainableStack::AutodiffStackStorage;
+  using tape_ptr = std::unique_ptr<tape_t>;
+  using ad_map = std::unordered_map<std::thread::id, tape_t*>;
 
  public:
-  ad_tape_observer() : tbb::task_scheduler_observer(), thread_tape_map_() {
-    on_scheduler_entry(true);  // register current process
-    observe(true);             // activates the observer
+  ad_tape_observer()
+      : tbb::task_scheduler_observer(),
+        main_stack_(new ChainableStack()),  // register current process
+        thread_tape_map_(),
+        tapes_created_(0),
+        tapes_reused_(0) {
+    observe(true);  // activates the observer
   }
 
   void on_scheduler_entry(bool worker) {
+    if (ChainableStack::instance_ != nullptr) {
+      return;
+    }
     std::lock_guard<std::mutex> thread_tape_map_lock(thread_tape_map_mutex_);
-    const std::thread::id thread_id = std::this_thread::get_id();
-    if (thread_tape_map_.find(thread_id) == thread_tape_map_.end()) {
-      ad_map::iterator insert_elem;
-      bool status = false;
-      std::tie(insert_elem, status)
-          = thread_tape_map_.emplace(ad_map::value_type{thread_id, nullptr});
-      insert_elem->second = stack_ptr(new ChainableStack());
+    tape_t* tape = nullptr;
+    if (idle_tapes_.empty()) {
+      tapes_.emplace_back(new tape_t());
+      tape = tapes_.back().get();
+      ++tapes_created_;
+    } else {
+      tape = idle_tapes_.back();
+      idle_tapes_.pop_back();
+      ++tapes_reused_;
     }
+    ChainableStack::instance_ = tape;
+    thread_tape_map_[std::this_thread::get_id()] = tape;
   }
 
   void on_scheduler_exit(bool worker) {
+    if (!worker) {
+      return;
+    }
     std::lock_guard<std::mutex> thread_tape_map_lock(thread_tape_map_mutex_);
     auto elem = thread_tape_map_.find(std::this_thread::get_id());
-    if (elem != thread_tape_map_.end()) {
-      thread_tape_map_.erase(elem);
+    if (elem == thread_tape_map_.end()
+        || elem->second != ChainableStack::instance_
+        || !elem->second->nested_var_stack_sizes_.empty()) {
+      return;
     }
+    tape_t* tape = elem->second;
+    tape->var_stack_.clear();
+    tape->var_nochain_stack_.clear();
+    for (auto& x : tape->var_alloc_stack_) {
+      delete x;
+    }
+    tape->var_alloc_stack_.clear();
+    tape->memalloc_.recover_all();
+    ChainableStack::instance_ = nullptr;
+    idle_tapes_.push_back(tape);
+    thread_tape_map_.erase(elem);
+  }
+
+  /**
+   * Return the number of AD tapes created by this observer.
+   */
+  size_t tapes_created() const { return tapes_created_; }
+
+  /**
+   * Return the number of times an idle AD tape has been handed to a
+   * thread entering the scheduler instead of creating a new one.
+   */
+  size_t tapes_reused() const { return tapes_reused_; }
+
+  /**
+   * Return the number of AD tapes currently not in use by any thread.
+   */
+  size_t tapes_idle() {
+    std::lock_guard<std::mutex> thread_tape_map_lock(thread_tape_map_mutex_);
+    return idle_tapes_.size();
   }
 
  private:
+  std::unique_ptr<ChainableStack> main_stack_;
   ad_map thread_tape_map_;
+  std::vector<tape_ptr> tapes_;
+  std::vector<tape_t*> idle_tapes_;
   std::mutex thread_tape_map_mutex_;
+  std::atomic<size_t> tapes_created_;
+  std::atomic<size_t> tapes_reused_;
 };
 
 namespace {
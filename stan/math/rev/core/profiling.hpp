@@ -0,0 +1,348 @@
+#ifndef STAN_MATH_REV_CORE_PROFILING_HPP
+#define STAN_MATH_REV_CORE_PROFILING_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/rev/meta/is_var.hpp>
+#include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/vari.hpp>
+
+#include <tbb/concurrent_unordered_map.h>
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace stan {
+namespace math {
+
+/**
+ * Statistics of one profile region on one thread.
+ *
+ * The forward pass of a region is the time between the construction
+ * and destruction of a <code>profile</code> object, the reverse pass
+ * is the time the reverse sweep spends on the varis pushed onto the
+ * stack in between. The tape statistics are the number of varis
+ * pushed onto the chaining and non-chaining stacks and the growth of
+ * the arena as reported by <code>stack_alloc::bytes_used()</code>,
+ * summed over all forward passes with autodiff.
+ */
+class profile_info {
+ private:
+  using clock_t = std::chrono::steady_clock;
+
+  bool active_;
+
+  double fwd_pass_time_;
+  double rev_pass_time_;
+  size_t n_fwd_AD_passes_;
+  size_t n_fwd_no_AD_passes_;
+  size_t n_rev_passes_;
+  size_t chain_stack_size_sum_;
+  size_t nochain_stack_size_sum_;
+  size_t bytes_allocated_sum_;
+
+  clock_t::time_point fwd_pass_tp_;
+  clock_t::time_point rev_pass_tp_;
+  size_t start_chain_stack_size_;
+  size_t start_nochain_stack_size_;
+  size_t start_bytes_allocated_;
+
+ public:
+  profile_info()
+      : active_(false),
+        fwd_pass_time_(0.0),
+        rev_pass_time_(0.0),
+        n_fwd_AD_passes_(0),
+        n_fwd_no_AD_passes_(0),
+        n_rev_passes_(0),
+        chain_stack_size_sum_(0),
+        nochain_stack_size_sum_(0),
+        bytes_allocated_sum_(0),
+        start_chain_stack_size_(0),
+        start_nochain_stack_size_(0),
+        start_bytes_allocated_(0) {}
+
+  bool is_active() const noexcept { return active_; }
+
+  template <typename T>
+  void fwd_pass_start() {
+    if (is_var<T>::value) {
+      start_chain_stack_size_ = ChainableStack::instance_->var_stack_.size();
+      start_nochain_stack_size_
+          = ChainableStack::instance_->var_nochain_stack_.size();
+      start_bytes_allocated_
+          = ChainableStack::instance_->memalloc_.bytes_used();
+    }
+    active_ = true;
+    fwd_pass_tp_ = clock_t::now();
+  }
+
+  template <typename T>
+  void fwd_pass_stop() {
+    fwd_pass_time_
+        += std::chrono::duration<double>(clock_t::now() - fwd_pass_tp_)
+               .count();
+    if (is_var<T>::value) {
+      ++n_fwd_AD_passes_;
+      chain_stack_size_sum_ += ChainableStack::instance_->var_stack_.size()
+                               - start_chain_stack_size_;
+      nochain_stack_size_sum_
+          += ChainableStack::instance_->var_nochain_stack_.size()
+             - start_nochain_stack_size_;
+      const size_t bytes_allocated
+          = ChainableStack::instance_->memalloc_.bytes_used();
+      if (bytes_allocated > start_bytes_allocated_) {
+        bytes_allocated_sum_ += bytes_allocated - start_bytes_allocated_;
+      }
+    } else {
+      ++n_fwd_no_AD_passes_;
+    }
+    active_ = false;
+  }
+
+  void rev_pass_start() { rev_pass_tp_ = clock_t::now(); }
+
+  void rev_pass_stop() {
+    rev_pass_time_
+        += std::chrono::duration<double>(clock_t::now() - rev_pass_tp_)
+               .count();
+    ++n_rev_passes_;
+  }
+
+  /**
+   * Return the total time of the forward passes in seconds.
+   */
+  double get_fwd_time() const noexcept { return fwd_pass_time_; }
+
+  /**
+   * Return the total time of the reverse passes in seconds.
+   */
+  double get_rev_time() const noexcept { return rev_pass_time_; }
+
+  size_t get_num_fwd_passes() const noexcept {
+    return n_fwd_AD_passes_ + n_fwd_no_AD_passes_;
+  }
+
+  size_t get_num_fwd_AD_passes() const noexcept { return n_fwd_AD_passes_; }
+
+  size_t get_num_no_AD_fwd_passes() const noexcept {
+    return n_fwd_no_AD_passes_;
+  }
+
+  size_t get_num_rev_passes() const noexcept { return n_rev_passes_; }
+
+  size_t get_chain_stack_used() const noexcept {
+    return chain_stack_size_sum_;
+  }
+
+  size_t get_nochain_stack_used() const noexcept {
+    return nochain_stack_size_sum_;
+  }
+
+  size_t get_bytes_allocated() const noexcept { return bytes_allocated_sum_; }
+};
+
+using profile_key = std::pair<std::string, std::thread::id>;
+
+namespace internal {
+struct hash_profile_key {
+  std::size_t operator()(const profile_key& key) const {
+    return std::hash<std::string>()(key.first)
+           ^ (std::hash<std::thread::id>()(key.second) << 1);
+  }
+};
+
+/**
+ * Pushed onto the stack when a profile region starts, so that the
+ * reverse sweep reaches it after all varis of the region.
+ */
+class profile_rev_stop_vari : public vari {
+  profile_info* profile_;
+
+ public:
+  explicit profile_rev_stop_vari(profile_info* profile)
+      : vari(0), profile_(profile) {}
+
+  void chain() { profile_->rev_pass_stop(); }
+};
+
+/**
+ * Pushed onto the stack when a profile region ends, so that the
+ * reverse sweep reaches it before all varis of the region.
+ */
+class profile_rev_start_vari : public vari {
+  profile_info* profile_;
+
+ public:
+  explicit profile_rev_start_vari(profile_info* profile)
+      : vari(0), profile_(profile) {}
+
+  void chain() { profile_->rev_pass_start(); }
+};
+}  // namespace internal
+
+/**
+ * Map from the name of a profile region and the id of a thread to
+ * the statistics of the region on that thread. Insertion is safe
+ * from concurrent threads.
+ */
+using profile_map = tbb::concurrent_unordered_map<profile_key, profile_info,
+                                                  internal::hash_profile_key>;
+
+/**
+ * Profiles the code executed during the lifetime of this object.
+ *
+ * Construct a <code>profile</code> at the beginning of a block and
+ * its destructor records the block when it goes out of scope:
+ *
+ * <pre>
+ * {
+ *   profile<var> p("likelihood", profiles);
+ *   lp += normal_lpdf(y, mu, sigma);
+ * }
+ * </pre>
+ *
+ * If <code>T</code> is <code>var</code> the reverse pass and the
+ * tape usage of the block are recorded as well. A region must not be
+ * started again on the same thread before it has ended.
+ *
+ * @tparam T <code>var</code> to profile the reverse pass, otherwise
+ * only the forward pass is timed
+ */
+template <typename T>
+class profile {
+  profile_key key_;
+  profile_info* profile_;
+
+ public:
+  /**
+   * Start the profile region with the specified name.
+   *
+   * @param name name of the region
+   * @param profiles map holding the statistics
+   * @throw std::runtime_error if the region is active on this thread
+   */
+  profile(std::string name, profile_map& profiles)
+      : key_(std::move(name), std::this_thread::get_id()) {
+    profile_map::iterator p = profiles.find(key_);
+    if (p == profiles.end()) {
+      p = profiles.insert(std::make_pair(key_, profile_info())).first;
+    }
+    profile_ = &p->second;
+    if (profile_->is_active()) {
+      std::ostringstream msg;
+      msg << "Profile '" << key_.first << "' already started!";
+      throw std::runtime_error(msg.str());
+    }
+    if (is_var<T>::value) {
+      new internal::profile_rev_stop_vari(profile_);
+    }
+    profile_->fwd_pass_start<T>();
+  }
+
+  profile(const profile&) = delete;
+  profile& operator=(const profile&) = delete;
+
+  ~profile() {
+    profile_->fwd_pass_stop<T>();
+    if (is_var<T>::value) {
+      new internal::profile_rev_start_vari(profile_);
+    }
+  }
+};
+
+/**
+ * Write the statistics of all profile regions as CSV with a header
+ * line. Times are in seconds. The names are quoted as in RFC 4180,
+ * with their double quotes doubled.
+ *
+ * @param out stream to write to
+ * @param profiles statistics of the regions
+ */
+inline void write_profile_csv(std::ostream& out, const profile_map& profiles) {
+  out << "name,thread_id,total_time,forward_time,reverse_time,"
+      << "chain_stack,no_chain_stack,autodiff_calls,no_autodiff_calls,"
+      << "reverse_calls,bytes_allocated\n";
+  for (const auto& p : profiles) {
+    const profile_info& info = p.second;
+    std::string name;
+    for (char c : p.first.first) {
+      if (c == '"') {
+        name += '"';
+      }
+      name += c;
+    }
+    out << "\"" << name << "\"," << p.first.second << ","
+        << info.get_fwd_time() + info.get_rev_time() << ","
+        << info.get_fwd_time() << "," << info.get_rev_time() << ","
+        << info.get_chain_stack_used() << ","
+        << info.get_nochain_stack_used() << ","
+        << info.get_num_fwd_AD_passes() << ","
+        << info.get_num_no_AD_fwd_passes() << ","
+        << info.get_num_rev_passes() << "," << info.get_bytes_allocated()
+        << "\n";
+  }
+}
+
+/**
+ * Write the statistics of all profile regions as a JSON array with
+ * one object per region and thread. Times are in seconds. Double
+ * quotes, backslashes and control characters in the names are
+ * escaped.
+ *
+ * @param out stream to write to
+ * @param profiles statistics of the regions
+ */
+inline void write_profile_json(std::ostream& out,
+                               const profile_map& profiles) {
+  out << "[";
+  bool first = true;
+  for (const auto& p : profiles) {
+    const profile_info& info = p.second;
+    std::ostringstream thread_id;
+    thread_id << p.first.second;
+    std::string name;
+    for (char c : p.first.first) {
+      if (c == '"' || c == '\\') {
+        name += '\\';
+        name += c;
+      } else if (c == '\n') {
+        name += "\\n";
+      } else if (c == '\r') {
+        name += "\\r";
+      } else if (c == '\t') {
+        name += "\\t";
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        static const char hex_digits[] = "0123456789abcdef";
+        name += "\\u00";
+        name += hex_digits[c >> 4];
+        name += hex_digits[c & 0xf];
+      } else {
+        name += c;
+      }
+    }
+    out << (first ? "\n" : ",\n") << "  {\"name\": \"" << name << "\", "
+        << "\"thread_id\": \"" << thread_id.str() << "\", "
+        << "\"total_time\": " << info.get_fwd_time() + info.get_rev_time()
+        << ", \"forward_time\": " << info.get_fwd_time()
+        << ", \"reverse_time\": " << info.get_rev_time()
+        << ", \"chain_stack\": " << info.get_chain_stack_used()
+        << ", \"no_chain_stack\": " << info.get_nochain_stack_used()
+        << ", \"autodiff_calls\": " << info.get_num_fwd_AD_passes()
+        << ", \"no_autodiff_calls\": " << info.get_num_no_AD_fwd_passes()
+        << ", \"reverse_calls\": " << info.get_num_rev_passes()
+        << ", \"bytes_allocated\": " << info.get_bytes_allocated() << "}";
+    first = false;
+  }
+  out << (first ? "]\n" : "\n]\n");
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
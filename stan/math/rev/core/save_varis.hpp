@@ -0,0 +1,75 @@
+#ifndef STAN_MATH_REV_CORE_SAVE_VARIS_HPP
+#define STAN_MATH_REV_CORE_SAVE_VARIS_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/vari.hpp>
+#include <stan/math/rev/meta/is_var.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Store the varis of the vars in the arguments in consecutive
+ * positions starting at <code>dest</code>.
+ *
+ * @return pointer past the last stored vari
+ */
+inline vari** save_varis(vari** dest) { return dest; }
+
+template <typename T, typename... Pargs,
+          typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+inline vari** save_varis(vari** dest, const T& x, const Pargs&... args);
+
+template <typename... Pargs>
+inline vari** save_varis(vari** dest, const var& x, const Pargs&... args);
+
+template <typename T, typename... Pargs>
+inline vari** save_varis(vari** dest, const std::vector<T>& x,
+                         const Pargs&... args);
+
+template <typename T, int R, int C, typename... Pargs>
+inline vari** save_varis(vari** dest, const Eigen::Matrix<T, R, C>& x,
+                         const Pargs&... args);
+
+template <typename T, typename... Pargs, typename>
+inline vari** save_varis(vari** dest, const T& x, const Pargs&... args) {
+  return save_varis(dest, args...);
+}
+
+template <typename... Pargs>
+inline vari** save_varis(vari** dest, const var& x, const Pargs&... args) {
+  *dest = x.vi_;
+  return save_varis(dest + 1, args...);
+}
+
+template <typename T, typename... Pargs>
+inline vari** save_varis(vari** dest, const std::vector<T>& x,
+                         const Pargs&... args) {
+  if (is_var<scalar_type_t<T>>::value) {
+    for (const auto& x_i : x) {
+      dest = save_varis(dest, x_i);
+    }
+  }
+  return save_varis(dest, args...);
+}
+
+template <typename T, int R, int C, typename... Pargs>
+inline vari** save_varis(vari** dest, const Eigen::Matrix<T, R, C>& x,
+                         const Pargs&... args) {
+  if (is_var<T>::value) {
+    for (int i = 0; i < x.size(); ++i) {
+      dest = save_varis(dest, x.coeff(i));
+    }
+  }
+  return save_varis(dest, args...);
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
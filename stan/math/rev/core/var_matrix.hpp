@@ -0,0 +1,288 @@
+#ifndef STAN_MATH_REV_CORE_VAR_MATRIX_HPP
+#define STAN_MATH_REV_CORE_VAR_MATRIX_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/vari.hpp>
+#include <type_traits>
+
+namespace stan {
+namespace math {
+
+/**
+ * The variable implementation for a dense matrix stored as a
+ * struct of arrays.
+ *
+ * Instead of one <code>vari</code> per coefficient, a single
+ * node holds the values of all coefficients in one contiguous
+ * column-major array and their adjoints in a second contiguous
+ * array, both allocated on the autodiff arena.  Reverse mode
+ * functions operating on these nodes can therefore hand the
+ * values and adjoints directly to Eigen as mapped matrices.
+ *
+ * The scalar <code>val_</code> and <code>adj_</code> members
+ * inherited from <code>vari</code> are unused.
+ *
+ * Subclasses representing the result of an operation store their
+ * operands and implement <code>chain()</code> by propagating
+ * <code>adj()</code> to the operands.
+ */
+class var_matrix_vari : public vari {
+ public:
+  /**
+   * Number of rows.
+   */
+  const Eigen::Index rows_;
+
+  /**
+   * Number of columns.
+   */
+  const Eigen::Index cols_;
+
+  /**
+   * Column-major array of values allocated on the arena.
+   */
+  double* vals_;
+
+  /**
+   * Column-major array of adjoints allocated on the arena.
+   */
+  double* adjs_;
+
+  /**
+   * Construct a matrix variable implementation with the specified
+   * values and zero adjoints.
+   *
+   * @tparam EigMat type of the values
+   * @param x values
+   * @param stacked true if the node should be placed on the
+   * chainable stack; false for independent variables whose
+   * <code>chain()</code> method would be a no-op.
+   */
+  template <typename EigMat>
+  explicit var_matrix_vari(const Eigen::MatrixBase<EigMat>& x,
+                           bool stacked = true)
+      : vari(0.0, stacked),
+        rows_(x.rows()),
+        cols_(x.cols()),
+        vals_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            x.size())),
+        adjs_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            x.size())) {
+    val() = x;
+    adj().setZero();
+  }
+
+  /**
+   * Construct a matrix variable implementation of the specified
+   * size with uninitialized values and zero adjoints. The caller is
+   * responsible for filling <code>val()</code>.
+   *
+   * @param rows number of rows
+   * @param cols number of columns
+   * @param stacked true if the node should be placed on the
+   * chainable stack
+   */
+  var_matrix_vari(Eigen::Index rows, Eigen::Index cols, bool stacked = true)
+      : vari(0.0, stacked),
+        rows_(rows),
+        cols_(cols),
+        vals_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            rows * cols)),
+        adjs_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            rows * cols)) {
+    adj().setZero();
+  }
+
+  /**
+   * Return the values as a mapped Eigen matrix.
+   */
+  inline Eigen::Map<Eigen::MatrixXd> val() {
+    return Eigen::Map<Eigen::MatrixXd>(vals_, rows_, cols_);
+  }
+
+  /**
+   * Return the values as a read-only mapped Eigen matrix.
+   */
+  inline Eigen::Map<const Eigen::MatrixXd> val() const {
+    return Eigen::Map<const Eigen::MatrixXd>(vals_, rows_, cols_);
+  }
+
+  /**
+   * Return the adjoints as a mapped Eigen matrix.
+   */
+  inline Eigen::Map<Eigen::MatrixXd> adj() {
+    return Eigen::Map<Eigen::MatrixXd>(adjs_, rows_, cols_);
+  }
+
+  /**
+   * Return the adjoints as a read-only mapped Eigen matrix.
+   */
+  inline Eigen::Map<const Eigen::MatrixXd> adj() const {
+    return Eigen::Map<const Eigen::MatrixXd>(adjs_, rows_, cols_);
+  }
+
+  /**
+   * Return the number of coefficients.
+   */
+  inline Eigen::Index size() const { return rows_ * cols_; }
+
+  /**
+   * Set the adjoints of all coefficients to zero.
+   */
+  void set_zero_adjoint() final {
+    adj_ = 0.0;
+    adj().setZero();
+  }
+};
+
+namespace internal {
+/**
+ * Scalar view of one coefficient of a <code>var_matrix_vari</code>.
+ * The adjoint of the coefficient is added to the matrix adjoints
+ * on the reverse pass.
+ */
+class var_matrix_coeff_vari : public vari {
+ public:
+  var_matrix_vari* m_;
+  Eigen::Index i_;
+
+  var_matrix_coeff_vari(var_matrix_vari* m, Eigen::Index i)
+      : vari(m->vals_[i]), m_(m), i_(i) {}
+
+  virtual void chain() { m_->adjs_[i_] += adj_; }
+};
+
+/**
+ * Copy the values of a matrix of doubles to the arena.
+ *
+ * @tparam EigMat type of the matrix
+ * @param x matrix
+ * @return pointer to column-major copy of the values on the arena
+ */
+template <typename EigMat>
+inline const double* arena_copy(const Eigen::MatrixBase<EigMat>& x) {
+  double* mem = ChainableStack::instance_->memalloc_.alloc_array<double>(
+      x.size());
+  Eigen::Map<Eigen::MatrixXd>(mem, x.rows(), x.cols()) = x;
+  return mem;
+}
+}  // namespace internal
+
+/**
+ * A dense, dynamically sized matrix of autodiff variables stored as
+ * a struct of arrays.
+ *
+ * <code>var_matrix</code> is to <code>var_matrix_vari</code> what
+ * <code>var</code> is to <code>vari</code>: a lightweight handle to
+ * an implementation managed by the arena.  Copying a
+ * <code>var_matrix</code> copies the pointer, not the values.
+ *
+ * Compared to <code>Eigen::Matrix<var, -1, -1></code>, which is an
+ * array of pointers to independently allocated <code>vari</code>,
+ * a <code>var_matrix</code> keeps values and adjoints contiguous and
+ * places a single node on the autodiff stack, so the reverse mode
+ * specializations of matrix functions can use level-3 BLAS on the
+ * values and adjoints without gathering them first.
+ *
+ * Conversions to and from <code>Eigen::Matrix<var, R, C></code> are
+ * provided by <code>to_var_matrix()</code> and
+ * <code>from_var_matrix()</code>.
+ */
+class var_matrix {
+ public:
+  /**
+   * Pointer to the implementation of this matrix.
+   */
+  var_matrix_vari* vi_;
+
+  /**
+   * Construct a matrix variable for later assignment.
+   */
+  var_matrix() : vi_(nullptr) {}
+
+  /**
+   * Construct a matrix variable from a pointer to its
+   * implementation.
+   *
+   * @param vi matrix variable implementation
+   */
+  explicit var_matrix(var_matrix_vari* vi) : vi_(vi) {}
+
+  /**
+   * Construct an independent matrix variable with the specified
+   * values and zero adjoints.
+   *
+   * @tparam EigMat type of the values
+   * @param x values
+   */
+  template <typename EigMat,
+            typename = std::enable_if_t<std::is_arithmetic<
+                typename Eigen::MatrixBase<EigMat>::Scalar>::value>>
+  explicit var_matrix(const Eigen::MatrixBase<EigMat>& x)
+      : vi_(new var_matrix_vari(x, false)) {}
+
+  /**
+   * Return <code>true</code> if this matrix has been declared but
+   * not defined.
+   */
+  inline bool is_uninitialized() const { return vi_ == nullptr; }
+
+  /**
+   * Return the number of rows.
+   */
+  inline Eigen::Index rows() const { return vi_->rows_; }
+
+  /**
+   * Return the number of columns.
+   */
+  inline Eigen::Index cols() const { return vi_->cols_; }
+
+  /**
+   * Return the number of coefficients.
+   */
+  inline Eigen::Index size() const { return vi_->size(); }
+
+  /**
+   * Return the values of this matrix.
+   */
+  inline Eigen::Map<const Eigen::MatrixXd> val() const {
+    return static_cast<const var_matrix_vari*>(vi_)->val();
+  }
+
+  /**
+   * Return the adjoints of this matrix. The adjoints are only
+   * meaningful after a call to <code>grad()</code>.
+   */
+  inline Eigen::Map<Eigen::MatrixXd> adj() const { return vi_->adj(); }
+
+  /**
+   * Return the coefficient at the specified position as a scalar
+   * <code>var</code> whose adjoint flows back into this matrix.
+   *
+   * Each call creates a new scalar node, so this is intended for
+   * occasional access rather than elementwise loops.
+   *
+   * @param i row index
+   * @param j column index
+   * @return coefficient as a scalar variable
+   */
+  inline var operator()(Eigen::Index i, Eigen::Index j) const {
+    return var(new internal::var_matrix_coeff_vari(vi_, i + j * rows()));
+  }
+
+  /**
+   * Return the coefficient at the specified column-major position.
+   *
+   * @param i column-major index
+   * @return coefficient as a scalar variable
+   */
+  inline var operator()(Eigen::Index i) const {
+    return var(new internal::var_matrix_coeff_vari(vi_, i));
+  }
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
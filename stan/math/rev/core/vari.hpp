@@ -97,8 +97,12 @@ class vari {
    * Set the adjoint value of this variable to 0.  This is used to
    * reset adjoints before propagating derivatives again (for
    * example in a Jacobian calculation).
+   *
+   * Implementations holding more than one adjoint, such as
+   * <code>var_matrix_vari</code>, override this to reset all of
+   * their adjoints.
    */
-  void set_zero_adjoint() { adj_ = 0.0; }
+  virtual void set_zero_adjoint() { adj_ = 0.0; }
 
   /**
    * Insertion operator for vari. Prints the current value and
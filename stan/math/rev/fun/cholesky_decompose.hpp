@@ -44,12 +44,80 @@ inline void set_lower_tri_coeff_ref(Eigen::Matrix<var, -1, -1>& L,
   }
   return;
 }
+
+/**
+ * Symbolic adjoint calculation for cholesky factor A
+ *
+ * @param L cholesky factor
+ * @param L_adj matrix of adjoints of L
+ */
+inline void cholesky_symbolic_rev(Eigen::Block<Eigen::MatrixXd>& L,
+                                  Eigen::Block<Eigen::MatrixXd>& L_adj) {
+  using Eigen::Lower;
+  using Eigen::StrictlyUpper;
+  using Eigen::Upper;
+  L.transposeInPlace();
+  L_adj = (L * L_adj.triangularView<Lower>()).eval();
+  L_adj.triangularView<StrictlyUpper>()
+      = L_adj.adjoint().triangularView<StrictlyUpper>();
+  L.triangularView<Upper>().solveInPlace(L_adj);
+  L.triangularView<Upper>().solveInPlace(L_adj.transpose());
+}
+
+/**
+ * Blocked reverse mode differentiation of the Cholesky
+ * decomposition.
+ *
+ * On input <code>L_adj</code> holds the adjoints of the lower
+ * triangle of the Cholesky factor <code>L</code>; on output it holds
+ * the adjoints of the lower triangle of the decomposed matrix.
+ * <code>L</code> is overwritten.
+ *
+ * Reference: Iain Murray, Differentiation of the Cholesky
+ * decomposition, 2016.
+ *
+ * @param L cholesky factor
+ * @param L_adj matrix of adjoints of L
+ * @param block_size size of the diagonal blocks
+ */
+inline void cholesky_block_adjoint(Eigen::MatrixXd& L, Eigen::MatrixXd& L_adj,
+                                   int block_size) {
+  using Block_ = Eigen::Block<Eigen::MatrixXd>;
+  using Eigen::Lower;
+  using Eigen::StrictlyUpper;
+  using Eigen::Upper;
+  const int M = L.rows();
+  for (int k = M; k > 0; k -= block_size) {
+    int j = std::max(0, k - block_size);
+    Block_ R = L.block(j, 0, k - j, j);
+    Block_ D = L.block(j, j, k - j, k - j);
+    Block_ B = L.block(k, 0, M - k, j);
+    Block_ C = L.block(k, j, M - k, k - j);
+    Block_ R_adj = L_adj.block(j, 0, k - j, j);
+    Block_ D_adj = L_adj.block(j, j, k - j, k - j);
+    Block_ B_adj = L_adj.block(k, 0, M - k, j);
+    Block_ C_adj = L_adj.block(k, j, M - k, k - j);
+    if (C_adj.size() > 0) {
+      C_adj = D.transpose()
+                  .triangularView<Upper>()
+                  .solve(C_adj.transpose())
+                  .transpose();
+      B_adj.noalias() -= C_adj * R;
+      D_adj.noalias() -= C_adj.transpose() * C;
+    }
+    cholesky_symbolic_rev(D, D_adj);
+    R_adj.noalias() -= C_adj.transpose() * B;
+    R_adj.noalias() -= D_adj.selfadjointView<Lower>() * R;
+    D_adj.diagonal() *= 0.5;
+    D_adj.triangularView<StrictlyUpper>().setZero();
+  }
+}
 }  // namespace internal
+
 class cholesky_block : public vari {
  public:
   int M_;
   int block_size_;
-  using Block_ = Eigen::Block<Eigen::MatrixXd>;
   vari** vari_ref_A_;
   vari** vari_ref_L_;
 
@@ -89,24 +157,6 @@ class cholesky_block : public vari {
     }
   }
 
-  /**
-   * Symbolic adjoint calculation for cholesky factor A
-   *
-   * @param L cholesky factor
-   * @param L_adj matrix of adjoints of L
-   */
-  inline void symbolic_rev(Block_& L, Block_& L_adj) {
-    using Eigen::Lower;
-    using Eigen::StrictlyUpper;
-    using Eigen::Upper;
-    L.transposeInPlace();
-    L_adj = (L * L_adj.triangularView<Lower>()).eval();
-    L_adj.triangularView<StrictlyUpper>()
-        = L_adj.adjoint().triangularView<StrictlyUpper>();
-    L.triangularView<Upper>().solveInPlace(L_adj);
-    L.triangularView<Upper>().solveInPlace(L_adj.transpose());
-  }
-
   /**
    * Reverse mode differentiation algorithm refernce:
    *
@@ -114,11 +164,6 @@ class cholesky_block : public vari {
    *
    */
   virtual void chain() {
-    using Eigen::Block;
-    using Eigen::Lower;
-    using Eigen::MatrixXd;
-    using Eigen::StrictlyUpper;
-    using Eigen::Upper;
     auto L_adj = Eigen::MatrixXd::Zero(M_, M_).eval();
     auto L = Eigen::MatrixXd::Zero(M_, M_).eval();
     size_t pos = 0;
@@ -130,30 +175,7 @@ class cholesky_block : public vari {
       }
     }
 
-    for (int k = M_; k > 0; k -= block_size_) {
-      int j = std::max(0, k - block_size_);
-      Block_ R = L.block(j, 0, k - j, j);
-      Block_ D = L.block(j, j, k - j, k - j);
-      Block_ B = L.block(k, 0, M_ - k, j);
-      Block_ C = L.block(k, j, M_ - k, k - j);
-      Block_ R_adj = L_adj.block(j, 0, k - j, j);
-      Block_ D_adj = L_adj.block(j, j, k - j, k - j);
-      Block_ B_adj = L_adj.block(k, 0, M_ - k, j);
-      Block_ C_adj = L_adj.block(k, j, M_ - k, k - j);
-      if (C_adj.size() > 0) {
-        C_adj = D.transpose()
-                    .triangularView<Upper>()
-                    .solve(C_adj.transpose())
-                    .transpose();
-        B_adj.noalias() -= C_adj * R;
-        D_adj.noalias() -= C_adj.transpose() * C;
-      }
-      symbolic_rev(D, D_adj);
-      R_adj.noalias() -= C_adj.transpose() * B;
-      R_adj.noalias() -= D_adj.selfadjointView<Lower>() * R;
-      D_adj.diagonal() *= 0.5;
-      D_adj.triangularView<StrictlyUpper>().setZero();
-    }
+    internal::cholesky_block_adjoint(L, L_adj, block_size_);
     pos = 0;
     for (size_type j = 0; j < M_; ++j) {
       for (size_type i = j; i < M_; ++i) {
@@ -423,6 +445,58 @@ inline Eigen::Matrix<var, -1, -1> cholesky_decompose(
 
   return L;
 }
+
+namespace internal {
+/**
+ * This is a subclass of the <code>var_matrix_vari</code> class for the
+ * Cholesky factor of a <code>var_matrix</code>.
+ *
+ * The factor is stored densely with zeros above the diagonal, and
+ * the adjoint of the lower triangle of A is computed with the same
+ * blocked algorithm as <code>cholesky_block</code>.
+ */
+class cholesky_var_matrix_vari : public var_matrix_vari {
+ public:
+  var_matrix_vari* A_;
+  int block_size_;
+
+  cholesky_var_matrix_vari(var_matrix_vari* A, const Eigen::MatrixXd& L_A)
+      : var_matrix_vari(L_A), A_(A) {
+    block_size_ = std::max(static_cast<int>(rows_) / 8, 8);
+    block_size_ = std::min(block_size_, 128);
+  }
+
+  virtual void chain() {
+    using Eigen::Lower;
+    Eigen::MatrixXd L = val();
+    Eigen::MatrixXd L_adj = adj().triangularView<Lower>();
+    cholesky_block_adjoint(L, L_adj, block_size_);
+    A_->adj().triangularView<Lower>() += L_adj;
+  }
+};
+}  // namespace internal
+
+/**
+ * Reverse mode specialization of cholesky decomposition for
+ * struct-of-arrays matrices.
+ *
+ * Only the lower triangle of A receives adjoints, matching the
+ * <code>Eigen::Matrix<var, -1, -1></code> specialization.
+ *
+ * @param A Matrix
+ * @return L cholesky factor of A
+ */
+inline var_matrix cholesky_decompose(const var_matrix& A) {
+  check_size_match("cholesky_decompose", "Rows of A", A.rows(),
+                   "Columns of A", A.cols());
+  Eigen::MatrixXd L_A(A.val());
+  check_symmetric("cholesky_decompose", "A", L_A);
+  Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>, Eigen::Lower> L_factor(L_A);
+  check_pos_definite("cholesky_decompose", "m", L_factor);
+  L_A.triangularView<Eigen::StrictlyUpper>().setZero();
+  return var_matrix(new internal::cholesky_var_matrix_vari(A.vi_, L_A));
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
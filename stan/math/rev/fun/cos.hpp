@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/cos.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -45,6 +47,15 @@ class cos_vari : public op_v_vari {
  */
 inline var cos(const var& a) { return var(new internal::cos_vari(a.vi_)); }
 
+/**
+ * Derivative of the cosine used to apply <code>cos()</code> to
+ * containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<cos_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return -std::sin(x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -5,6 +5,8 @@
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/trigamma.hpp>
 #include <stan/math/prim/scal/fun/digamma.hpp>
+#include <stan/math/prim/mat/fun/digamma.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -21,6 +23,16 @@ inline var digamma(const var& a) {
   return var(new internal::digamma_vari(a.vi_));
 }
 
+/**
+ * Derivative of the digamma function used to apply
+ * <code>digamma()</code> to containers of <code>var</code> with a
+ * single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<digamma_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return trigamma(x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -5,6 +5,8 @@
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
 #include <stan/math/prim/scal/fun/erf.hpp>
+#include <stan/math/prim/mat/fun/erf.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -57,6 +59,17 @@ class erf_vari : public op_v_vari {
  */
 inline var erf(const var& a) { return var(new internal::erf_vari(a.vi_)); }
 
+/**
+ * Derivative of the error function used to apply <code>erf()</code>
+ * to containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<erf_fun> : std::true_type {
+  static inline double apply(double x, double fx) {
+    return TWO_OVER_SQRT_PI * std::exp(-x * x);
+  }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
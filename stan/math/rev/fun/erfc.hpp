@@ -5,6 +5,8 @@
 #include <stan/math/prim/scal/fun/constants.hpp>
 #include <stan/math/prim/scal/fun/erfc.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/erfc.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -58,6 +60,18 @@ class erfc_vari : public op_v_vari {
  */
 inline var erfc(const var& a) { return var(new internal::erfc_vari(a.vi_)); }
 
+/**
+ * Derivative of the complementary error function used to apply
+ * <code>erfc()</code> to containers of <code>var</code> with a single
+ * vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<erfc_fun> : std::true_type {
+  static inline double apply(double x, double fx) {
+    return -TWO_OVER_SQRT_PI * std::exp(-x * x);
+  }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
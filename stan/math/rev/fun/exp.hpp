@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/exp.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -40,6 +42,15 @@ class exp_vari : public op_v_vari {
  */
 inline var exp(const var& a) { return var(new internal::exp_vari(a.vi_)); }
 
+/**
+ * Derivative of the exponentiation used to apply <code>exp()</code>
+ * to containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<exp_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return fx; }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -4,6 +4,8 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/prim/scal/fun/expm1.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/expm1.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -45,6 +47,16 @@ class expm1_vari : public op_v_vari {
  */
 inline var expm1(const var& a) { return var(new internal::expm1_vari(a.vi_)); }
 
+/**
+ * Derivative of the exponentiation minus one used to apply
+ * <code>expm1()</code> to containers of <code>var</code> with a
+ * single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<expm1_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return fx + 1.0; }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
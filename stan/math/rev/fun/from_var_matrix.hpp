@@ -0,0 +1,61 @@
+#ifndef STAN_MATH_REV_FUN_FROM_VAR_MATRIX_HPP
+#define STAN_MATH_REV_FUN_FROM_VAR_MATRIX_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/typedefs.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+/**
+ * Scatters the values of a <code>var_matrix_vari</code> into one
+ * <code>vari</code> per coefficient and gathers their adjoints back
+ * into the matrix adjoints on the reverse pass.
+ *
+ * The coefficient varis are placed on the nochain stack; only this
+ * node is chained.
+ */
+class from_var_matrix_vari : public vari {
+ public:
+  var_matrix_vari* x_;
+  vari** variRefY_;
+
+  explicit from_var_matrix_vari(var_matrix_vari* x)
+      : vari(0.0),
+        x_(x),
+        variRefY_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            x->size())) {
+    for (Eigen::Index i = 0; i < x_->size(); ++i) {
+      variRefY_[i] = new vari(x_->vals_[i], false);
+    }
+  }
+
+  virtual void chain() {
+    x_->adj() += Eigen::Map<matrix_vi>(variRefY_, x_->rows_, x_->cols_).adj();
+  }
+};
+}  // namespace internal
+
+/**
+ * Converts a <code>var_matrix</code> to a matrix of autodiff
+ * variables so that it can be passed to functions which do not have
+ * a <code>var_matrix</code> specialization.
+ *
+ * @param[in] x matrix variable
+ * @return matrix of var with the same values whose adjoints are
+ * propagated back to the argument
+ */
+inline matrix_v from_var_matrix(const var_matrix& x) {
+  internal::from_var_matrix_vari* baseVari
+      = new internal::from_var_matrix_vari(x.vi_);
+  matrix_v y(x.rows(), x.cols());
+  y.vi() = Eigen::Map<matrix_vi>(baseVari->variRefY_, x.rows(), x.cols());
+  return y;
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -4,6 +4,8 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/inv.hpp>
+#include <stan/math/prim/mat/fun/inv.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -37,6 +39,15 @@ class inv_vari : public op_v_vari {
  */
 inline var inv(const var& a) { return var(new internal::inv_vari(a.vi_)); }
 
+/**
+ * Derivative of the inverse used to apply <code>inv()</code> to
+ * containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<inv_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return -1.0 / (x * x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -4,6 +4,8 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/inv_logit.hpp>
+#include <stan/math/prim/mat/fun/inv_logit.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -33,6 +35,16 @@ inline var inv_logit(const var& a) {
   return var(new internal::inv_logit_vari(a.vi_));
 }
 
+/**
+ * Derivative of the inverse logit used to apply
+ * <code>inv_logit()</code> to containers of <code>var</code> with a
+ * single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<inv_logit_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return fx * (1.0 - fx); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
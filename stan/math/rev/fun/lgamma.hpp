@@ -5,6 +5,8 @@
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/digamma.hpp>
 #include <stan/math/prim/scal/fun/lgamma.hpp>
+#include <stan/math/prim/mat/fun/lgamma.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -31,6 +33,16 @@ inline var lgamma(const var& a) {
   return var(new internal::lgamma_vari(lgamma(a.val()), a.vi_));
 }
 
+/**
+ * Derivative of the log gamma function used to apply
+ * <code>lgamma()</code> to containers of <code>var</code> with a
+ * single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<lgamma_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return digamma(x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/log.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -46,6 +48,16 @@ class log_vari : public op_v_vari {
  */
 inline var log(const var& a) { return var(new internal::log_vari(a.vi_)); }
 
+/**
+ * Derivative of the natural logarithm used to apply
+ * <code>log()</code> to containers of <code>var</code> with a single
+ * vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<log_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return 1.0 / x; }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
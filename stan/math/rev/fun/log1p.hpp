@@ -4,6 +4,8 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/log1p.hpp>
+#include <stan/math/prim/mat/fun/log1p.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -28,6 +30,16 @@ class log1p_vari : public op_v_vari {
  */
 inline var log1p(const var& a) { return var(new internal::log1p_vari(a.vi_)); }
 
+/**
+ * Derivative of the log of one plus the argument used to apply
+ * <code>log1p()</code> to containers of <code>var</code> with a
+ * single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<log1p_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return 1.0 / (1.0 + x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
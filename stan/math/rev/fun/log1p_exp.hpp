@@ -5,6 +5,8 @@
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/scal/fun/log1p_exp.hpp>
 #include <stan/math/rev/fun/calculate_chain.hpp>
+#include <stan/math/prim/mat/fun/log1p_exp.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -25,6 +27,16 @@ inline var log1p_exp(const var& a) {
   return var(new internal::log1p_exp_v_vari(a.vi_));
 }
 
+/**
+ * Derivative of the log of one plus the exponential used to apply
+ * <code>log1p_exp()</code> to containers of <code>var</code> with a
+ * single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<log1p_exp_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return inv_logit(x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
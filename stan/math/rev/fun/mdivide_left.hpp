@@ -234,6 +234,130 @@ inline Eigen::Matrix<var, R1, C2> mdivide_left(
   return res;
 }
 
+namespace internal {
+/**
+ * This is a subclass of the <code>var_matrix_vari</code> class for
+ * the solution C of A * C = B where at least one of A and B is a
+ * <code>var_matrix</code>.
+ *
+ * The partial pivoting LU factorization of A computed on the forward
+ * pass is kept on the arena, so the reverse pass only needs one
+ * transposed triangular solve pair and, if A is a
+ * <code>var_matrix</code>, one matrix-matrix product.
+ */
+class mdivide_left_var_matrix_vari : public var_matrix_vari {
+ public:
+  int M_;  // A.rows() = A.cols() = B.rows()
+  int N_;  // B.cols()
+  double *LU_;
+  int *perm_;
+  var_matrix_vari *A_;
+  var_matrix_vari *B_;
+
+  template <typename EigMatA, typename EigMatB>
+  mdivide_left_var_matrix_vari(const Eigen::MatrixBase<EigMatA> &Ad,
+                               const Eigen::MatrixBase<EigMatB> &Bd,
+                               var_matrix_vari *A, var_matrix_vari *B)
+      : var_matrix_vari(Bd.rows(), Bd.cols()),
+        M_(Bd.rows()),
+        N_(Bd.cols()),
+        LU_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            Ad.size())),
+        perm_(ChainableStack::instance_->memalloc_.alloc_array<int>(M_)),
+        A_(A),
+        B_(B) {
+    using Eigen::Map;
+    Eigen::PartialPivLU<matrix_d> lu(Ad);
+    Map<matrix_d>(LU_, M_, M_) = lu.matrixLU();
+    Map<Eigen::VectorXi>(perm_, M_) = lu.permutationP().indices();
+    val() = lu.solve(Bd);
+  }
+
+  virtual void chain() {
+    using Eigen::Map;
+    using Eigen::UnitLower;
+    using Eigen::Upper;
+    Map<matrix_d> LU(LU_, M_, M_);
+    Eigen::PermutationMatrix<Eigen::Dynamic> P(M_);
+    P.indices() = Map<Eigen::VectorXi>(perm_, M_);
+    // A^T = U^T L^T P, so A^{-T} adjC = P^T L^{-T} U^{-T} adjC
+    matrix_d adjB = LU.triangularView<Upper>().transpose().solve(adj());
+    LU.triangularView<UnitLower>().transpose().solveInPlace(adjB);
+    adjB = P.transpose() * adjB;
+    if (A_) {
+      A_->adj().noalias() -= adjB * val().transpose();
+    }
+    if (B_) {
+      B_->adj() += adjB;
+    }
+  }
+};
+}  // namespace internal
+
+/**
+ * Returns the solution of the system A * C = B for struct-of-arrays
+ * matrices.
+ *
+ * @param A square matrix
+ * @param b right hand side
+ * @return A^{-1} * b
+ * @throw std::invalid_argument if A is not square or the rows of b do
+ * not match the size of A
+ */
+inline var_matrix mdivide_left(const var_matrix &A, const var_matrix &b) {
+  check_size_match("mdivide_left", "Rows of A", A.rows(), "Columns of A",
+                   A.cols());
+  check_size_match("mdivide_left", "Columns of A", A.cols(), "Rows of b",
+                   b.rows());
+  return var_matrix(new internal::mdivide_left_var_matrix_vari(
+      A.val(), b.val(), A.vi_, b.vi_));
+}
+
+/**
+ * Returns the solution of the system A * C = B for a struct-of-arrays
+ * matrix A and a right hand side of doubles.
+ *
+ * @tparam R2 number of rows of b, can be Eigen::Dynamic
+ * @tparam C2 number of columns of b, can be Eigen::Dynamic
+ * @param A square matrix
+ * @param b right hand side
+ * @return A^{-1} * b
+ * @throw std::invalid_argument if A is not square or the rows of b do
+ * not match the size of A
+ */
+template <int R2, int C2>
+inline var_matrix mdivide_left(const var_matrix &A,
+                               const Eigen::Matrix<double, R2, C2> &b) {
+  check_size_match("mdivide_left", "Rows of A", A.rows(), "Columns of A",
+                   A.cols());
+  check_size_match("mdivide_left", "Columns of A", A.cols(), "Rows of b",
+                   b.rows());
+  return var_matrix(new internal::mdivide_left_var_matrix_vari(
+      A.val(), b, A.vi_, nullptr));
+}
+
+/**
+ * Returns the solution of the system A * C = B for a matrix of
+ * doubles A and a struct-of-arrays right hand side.
+ *
+ * @tparam R1 number of rows of A, can be Eigen::Dynamic
+ * @tparam C1 number of columns of A, can be Eigen::Dynamic
+ * @param A square matrix
+ * @param b right hand side
+ * @return A^{-1} * b
+ * @throw std::invalid_argument if A is not square or the rows of b do
+ * not match the size of A
+ */
+template <int R1, int C1>
+inline var_matrix mdivide_left(const Eigen::Matrix<double, R1, C1> &A,
+                               const var_matrix &b) {
+  check_square("mdivide_left", "A", A);
+  check_size_match("mdivide_left", "Columns of A", A.cols(), "Rows of b",
+                   b.rows());
+  return var_matrix(new internal::mdivide_left_var_matrix_vari(
+      A, b.val(), nullptr, b.vi_));
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
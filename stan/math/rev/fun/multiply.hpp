@@ -706,6 +706,129 @@ inline var multiply(const Eigen::Matrix<Ta, 1, Ca>& A,
   AB_v.vi_ = baseVari->variRefAB_;
   return AB_v;
 }
+
+namespace internal {
+/**
+ * This is a subclass of the <code>var_matrix_vari</code> class for
+ * matrix multiplication A * B where at least one of A and B is a
+ * <code>var_matrix</code>.
+ *
+ * The values of a <code>var_matrix</code> operand are already
+ * contiguous on the arena and are referenced directly; the values of
+ * a <code>double</code> operand are copied to the arena. The reverse
+ * pass consists of at most two matrix-matrix products.
+ */
+class multiply_var_matrix_vari : public var_matrix_vari {
+ public:
+  int A_rows_;
+  int A_cols_;
+  int B_cols_;
+  const double* Ad_;
+  const double* Bd_;
+  var_matrix_vari* A_;
+  var_matrix_vari* B_;
+
+  /**
+   * Constructor for multiply_var_matrix_vari.
+   *
+   * @param A_rows rows of A
+   * @param A_cols columns of A, rows of B
+   * @param B_cols columns of B
+   * @param Ad values of A allocated on the arena
+   * @param Bd values of B allocated on the arena
+   * @param A implementation of A or <code>nullptr</code> if A is data
+   * @param B implementation of B or <code>nullptr</code> if B is data
+   */
+  multiply_var_matrix_vari(int A_rows, int A_cols, int B_cols,
+                           const double* Ad, const double* Bd,
+                           var_matrix_vari* A, var_matrix_vari* B)
+      : var_matrix_vari(A_rows, B_cols),
+        A_rows_(A_rows),
+        A_cols_(A_cols),
+        B_cols_(B_cols),
+        Ad_(Ad),
+        Bd_(Bd),
+        A_(A),
+        B_(B) {
+    using Eigen::Map;
+    val().noalias() = Map<const matrix_d>(Ad_, A_rows_, A_cols_)
+                      * Map<const matrix_d>(Bd_, A_cols_, B_cols_);
+  }
+
+  virtual void chain() {
+    using Eigen::Map;
+    if (A_) {
+      A_->adj().noalias()
+          += adj() * Map<const matrix_d>(Bd_, A_cols_, B_cols_).transpose();
+    }
+    if (B_) {
+      B_->adj().noalias()
+          += Map<const matrix_d>(Ad_, A_rows_, A_cols_).transpose() * adj();
+    }
+  }
+};
+}  // namespace internal
+
+/**
+ * Return the product of two struct-of-arrays matrices.
+ *
+ * @param[in] A Matrix
+ * @param[in] B Matrix
+ * @return Product of A and B
+ * @throw std::invalid_argument if the columns of A do not match the
+ * rows of B
+ */
+inline var_matrix multiply(const var_matrix& A, const var_matrix& B) {
+  check_size_match("multiply", "Columns of A", A.cols(), "Rows of B",
+                   B.rows());
+  return var_matrix(new internal::multiply_var_matrix_vari(
+      A.rows(), A.cols(), B.cols(), A.vi_->vals_, B.vi_->vals_, A.vi_, B.vi_));
+}
+
+/**
+ * Return the product of a struct-of-arrays matrix and a matrix of
+ * doubles.
+ *
+ * @tparam R Rows of matrix B
+ * @tparam C Columns of matrix B
+ * @param[in] A Matrix
+ * @param[in] B Matrix
+ * @return Product of A and B
+ * @throw std::invalid_argument if the columns of A do not match the
+ * rows of B
+ */
+template <int R, int C>
+inline var_matrix multiply(const var_matrix& A,
+                           const Eigen::Matrix<double, R, C>& B) {
+  check_size_match("multiply", "Columns of A", A.cols(), "Rows of B",
+                   B.rows());
+  return var_matrix(new internal::multiply_var_matrix_vari(
+      A.rows(), A.cols(), B.cols(), A.vi_->vals_, internal::arena_copy(B),
+      A.vi_, nullptr));
+}
+
+/**
+ * Return the product of a matrix of doubles and a struct-of-arrays
+ * matrix.
+ *
+ * @tparam R Rows of matrix A
+ * @tparam C Columns of matrix A
+ * @param[in] A Matrix
+ * @param[in] B Matrix
+ * @return Product of A and B
+ * @throw std::invalid_argument if the columns of A do not match the
+ * rows of B
+ */
+template <int R, int C>
+inline var_matrix multiply(const Eigen::Matrix<double, R, C>& A,
+                           const var_matrix& B) {
+  check_size_match("multiply", "Columns of A", A.cols(), "Rows of B",
+                   B.rows());
+  return var_matrix(new internal::multiply_var_matrix_vari(
+      A.rows(), A.cols(), B.cols(), internal::arena_copy(A), B.vi_->vals_,
+      nullptr, B.vi_));
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/sin.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -45,6 +47,15 @@ class sin_vari : public op_v_vari {
  */
 inline var sin(const var& a) { return var(new internal::sin_vari(a.vi_)); }
 
+/**
+ * Derivative of the sine used to apply <code>sin()</code> to
+ * containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<sin_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return std::cos(x); }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
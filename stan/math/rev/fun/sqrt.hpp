@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/sqrt.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -46,6 +48,15 @@ class sqrt_vari : public op_v_vari {
  */
 inline var sqrt(const var& a) { return var(new internal::sqrt_vari(a.vi_)); }
 
+/**
+ * Derivative of the square root used to apply <code>sqrt()</code> to
+ * containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<sqrt_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return 0.5 / fx; }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/square.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 
 namespace stan {
 namespace math {
@@ -44,6 +46,15 @@ inline var square(const var& x) {
   return var(new internal::square_vari(x.vi_));
 }
 
+/**
+ * Derivative of the square used to apply <code>square()</code> to
+ * containers of <code>var</code> with a single vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<square_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return 2.0 * x; }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
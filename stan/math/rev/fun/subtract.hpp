@@ -0,0 +1,110 @@
+#ifndef STAN_MATH_REV_FUN_SUBTRACT_HPP
+#define STAN_MATH_REV_FUN_SUBTRACT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+/**
+ * This is a subclass of the <code>var_matrix_vari</code> class for
+ * the elementwise difference of two matrices where at least one of them is
+ * a <code>var_matrix</code>.
+ */
+class subtract_var_matrix_vari : public var_matrix_vari {
+ public:
+  var_matrix_vari* A_;
+  var_matrix_vari* B_;
+
+  /**
+   * Constructor for subtract_var_matrix_vari.
+   *
+   * @tparam EigMat type of the result values
+   * @param val values of the result
+   * @param A implementation of A or <code>nullptr</code> if A is data
+   * @param B implementation of B or <code>nullptr</code> if B is data
+   */
+  template <typename EigMat>
+  subtract_var_matrix_vari(const Eigen::MatrixBase<EigMat>& val,
+                           var_matrix_vari* A, var_matrix_vari* B)
+      : var_matrix_vari(val), A_(A), B_(B) {}
+
+  virtual void chain() {
+    if (A_) {
+      A_->adj() += adj();
+    }
+    if (B_) {
+      B_->adj() -= adj();
+    }
+  }
+};
+}  // namespace internal
+
+/**
+ * Return the difference of the specified struct-of-arrays matrices.
+ *
+ * @param A First matrix.
+ * @param B Second matrix.
+ * @return A - B
+ * @throw std::invalid_argument if A and B do not have the same
+ * dimensions.
+ */
+inline var_matrix subtract(const var_matrix& A, const var_matrix& B) {
+  check_size_match("subtract", "Rows of A", A.rows(), "Rows of B", B.rows());
+  check_size_match("subtract", "Columns of A", A.cols(), "Columns of B",
+                   B.cols());
+  return var_matrix(
+      new internal::subtract_var_matrix_vari(A.val() - B.val(), A.vi_, B.vi_));
+}
+
+/**
+ * Return the difference of a struct-of-arrays matrix and a matrix of
+ * doubles.
+ *
+ * @tparam R number of rows, can be Eigen::Dynamic
+ * @tparam C number of columns, can be Eigen::Dynamic
+ * @param A First matrix.
+ * @param B Second matrix.
+ * @return A - B
+ * @throw std::invalid_argument if A and B do not have the same
+ * dimensions.
+ */
+template <int R, int C>
+inline var_matrix subtract(const var_matrix& A,
+                           const Eigen::Matrix<double, R, C>& B) {
+  check_size_match("subtract", "Rows of A", A.rows(), "Rows of B", B.rows());
+  check_size_match("subtract", "Columns of A", A.cols(), "Columns of B",
+                   B.cols());
+  return var_matrix(
+      new internal::subtract_var_matrix_vari(A.val() - B, A.vi_, nullptr));
+}
+
+/**
+ * Return the difference of a matrix of doubles and a struct-of-arrays
+ * matrix.
+ *
+ * @tparam R number of rows, can be Eigen::Dynamic
+ * @tparam C number of columns, can be Eigen::Dynamic
+ * @param A First matrix.
+ * @param B Second matrix.
+ * @return A - B
+ * @throw std::invalid_argument if A and B do not have the same
+ * dimensions.
+ */
+template <int R, int C>
+inline var_matrix subtract(const Eigen::Matrix<double, R, C>& A,
+                           const var_matrix& B) {
+  check_size_match("subtract", "Rows of A", A.rows(), "Rows of B", B.rows());
+  check_size_match("subtract", "Columns of A", A.cols(), "Columns of B",
+                   B.cols());
+  return var_matrix(
+      new internal::subtract_var_matrix_vari(A - B.val(), nullptr, B.vi_));
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -102,6 +102,34 @@ inline var sum(const Eigen::Matrix<var, R, C>& m) {
   return var(new sum_eigen_v_vari(m));
 }
 
+namespace internal {
+/**
+ * Class for the sum of the coefficients of a
+ * <code>var_matrix</code>. The reverse pass adds the adjoint of the
+ * sum to every coefficient adjoint in one vectorized update.
+ */
+class sum_var_matrix_vari : public vari {
+ public:
+  var_matrix_vari* x_;
+
+  explicit sum_var_matrix_vari(var_matrix_vari* x)
+      : vari(x->val().sum()), x_(x) {}
+
+  virtual void chain() { x_->adj().array() += adj_; }
+};
+}  // namespace internal
+
+/**
+ * Returns the sum of the coefficients of the specified
+ * struct-of-arrays matrix.
+ *
+ * @param m Specified matrix.
+ * @return Sum of coefficients of matrix.
+ */
+inline var sum(const var_matrix& m) {
+  return var(new internal::sum_var_matrix_vari(m.vi_));
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/math/prim/mat/fun/tanh.hpp>
+#include <stan/math/rev/vectorize/apply_scalar_unary.hpp>
 #include <cmath>
 
 namespace stan {
@@ -48,6 +50,16 @@ class tanh_vari : public op_v_vari {
  */
 inline var tanh(const var& a) { return var(new internal::tanh_vari(a.vi_)); }
 
+/**
+ * Derivative of the hyperbolic tangent used to apply
+ * <code>tanh()</code> to containers of <code>var</code> with a single
+ * vari.
+ */
+template <>
+struct apply_scalar_unary_derivative<tanh_fun> : std::true_type {
+  static inline double apply(double x, double fx) { return 1.0 - fx * fx; }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
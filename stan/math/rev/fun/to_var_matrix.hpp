@@ -0,0 +1,77 @@
+#ifndef STAN_MATH_REV_FUN_TO_VAR_MATRIX_HPP
+#define STAN_MATH_REV_FUN_TO_VAR_MATRIX_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/typedefs.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+/**
+ * Gathers the values of an array-of-<code>vari</code> matrix into a
+ * <code>var_matrix_vari</code> and scatters the adjoints back to the
+ * original coefficients on the reverse pass.
+ */
+class to_var_matrix_vari : public var_matrix_vari {
+ public:
+  vari** variRefX_;
+
+  template <int R, int C>
+  explicit to_var_matrix_vari(const Eigen::Matrix<var, R, C>& x)
+      : var_matrix_vari(x.val()),
+        variRefX_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(x.size())) {
+    Eigen::Map<matrix_vi>(variRefX_, x.rows(), x.cols()) = x.vi();
+  }
+
+  virtual void chain() {
+    Eigen::Map<matrix_vi>(variRefX_, rows_, cols_).adj() += adj();
+  }
+};
+}  // namespace internal
+
+/**
+ * Converts a matrix of autodiff variables to a
+ * <code>var_matrix</code>.
+ *
+ * The result is a single node on the autodiff stack whose adjoints
+ * are propagated to the coefficients of the argument.
+ *
+ * @tparam R number of rows or Eigen::Dynamic
+ * @tparam C number of columns or Eigen::Dynamic
+ * @param[in] x matrix of var
+ * @return struct-of-arrays matrix variable with the same values
+ */
+template <int R, int C>
+inline var_matrix to_var_matrix(const Eigen::Matrix<var, R, C>& x) {
+  return var_matrix(new internal::to_var_matrix_vari(x));
+}
+
+/**
+ * Converts a matrix of doubles to an independent
+ * <code>var_matrix</code>.
+ *
+ * @tparam R number of rows or Eigen::Dynamic
+ * @tparam C number of columns or Eigen::Dynamic
+ * @param[in] x matrix of double
+ * @return struct-of-arrays matrix variable with the same values
+ */
+template <int R, int C>
+inline var_matrix to_var_matrix(const Eigen::Matrix<double, R, C>& x) {
+  return var_matrix(x);
+}
+
+/**
+ * Specialization of to_var_matrix for <code>var_matrix</code> input.
+ *
+ * @param[in] x matrix variable
+ * @return the argument
+ */
+inline const var_matrix& to_var_matrix(const var_matrix& x) { return x; }
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -22,6 +22,14 @@ namespace math {
  */
 inline double value_of(const var& v) { return v.vi_->val_; }
 
+/**
+ * Return the values of the specified struct-of-arrays matrix.
+ *
+ * @param m Matrix variable.
+ * @return Values of the matrix.
+ */
+inline Eigen::MatrixXd value_of(const var_matrix& m) { return m.val(); }
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -4,16 +4,24 @@
 #include <stan/math/rev/functor/adj_jac_apply.hpp>
 #include <stan/math/rev/functor/algebra_solver_powell.hpp>
 #include <stan/math/rev/functor/algebra_solver_newton.hpp>
+#include <stan/math/rev/functor/checkpoint.hpp>
+#include <stan/math/rev/functor/coupled_ode_observer.hpp>
 #include <stan/math/rev/functor/coupled_ode_system.hpp>
 #include <stan/math/rev/functor/gradient.hpp>
 #include <stan/math/rev/functor/jacobian.hpp>
 #include <stan/math/rev/functor/cvodes_utils.hpp>
 #include <stan/math/rev/functor/cvodes_ode_data.hpp>
+#include <stan/math/rev/functor/cvodes_integrator_adjoint.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
+#include <stan/math/rev/functor/cvodes_session.hpp>
+#include <stan/math/rev/functor/finite_diff_hessian_auto.hpp>
 #include <stan/math/rev/functor/integrate_1d.hpp>
+#include <stan/math/rev/functor/integrate_1d_batch.hpp>
 #include <stan/math/rev/functor/integrate_ode_adams.hpp>
 #include <stan/math/rev/functor/integrate_ode_bdf.hpp>
 #include <stan/math/rev/functor/integrate_dae.hpp>
 #include <stan/math/rev/functor/map_rect_concurrent.hpp>
 #include <stan/math/rev/functor/map_rect_reduce.hpp>
+#include <stan/math/rev/functor/reduce_sum.hpp>
 
 #endif
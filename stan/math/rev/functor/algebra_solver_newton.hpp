@@ -41,6 +41,14 @@ namespace math {
  *            longer making significant progress (i.e. is stuck)
  * @param[in] function_tolerance determines whether roots are acceptable.
  * @param[in] max_num_steps  maximum number of function evaluations.
+ * @param[in] linear_solver linear solver for the Newton steps, which
+ *            is dense by default. Banded or sparse Jacobians, given or
+ *            detected, are computed with fewer reverse sweeps, and the
+ *            matrix-free GMRES solver never forms the Jacobian.
+ * @param[in] jacobian_vector functor for the products of the Jacobian
+ *            with vectors of the GMRES solver. Defaults to difference
+ *            quotients; <code>kinsol_forward_jacobian_vector</code>
+ *            computes them with forward mode autodiff.
  *  * @throw <code>std::invalid_argument</code> if x has size zero.
  * @throw <code>std::invalid_argument</code> if x has non-finite elements.
  * @throw <code>std::invalid_argument</code> if y has non-finite elements.
@@ -54,13 +62,16 @@ namespace math {
  * @throw <code>boost::math::evaluation_error</code> (which is a subclass of
  * <code>std::runtime_error</code>) if solver exceeds max_num_steps.
  */
-template <typename F, typename T>
+template <typename F, typename T,
+          typename F_jv = kinsol_difference_jacobian_vector>
 Eigen::VectorXd algebra_solver_newton(
     const F& f, const Eigen::Matrix<T, Eigen::Dynamic, 1>& x,
     const Eigen::VectorXd& y, const std::vector<double>& dat,
     const std::vector<int>& dat_int, std::ostream* msgs = nullptr,
     double scaling_step_size = 1e-3, double function_tolerance = 1e-6,
-    long int max_num_steps = 200) {  // NOLINT(runtime/int)
+    long int max_num_steps = 200,  // NOLINT(runtime/int)
+    const kinsol_linear_solver& linear_solver = kinsol_linear_solver(),
+    const F_jv& jacobian_vector = F_jv()) {
   algebra_solver_check(x, y, dat, dat_int, function_tolerance, max_num_steps);
   check_nonnegative("algebra_solver", "scaling_step_size", scaling_step_size);
 
@@ -69,7 +80,8 @@ Eigen::VectorXd algebra_solver_newton(
                        "the vector of unknowns, x,", x);
 
   return kinsol_solve(f, value_of(x), y, dat, dat_int, 0, scaling_step_size,
-                      function_tolerance, max_num_steps);
+                      function_tolerance, max_num_steps, 1, kinsol_J_f(), 10,
+                      KIN_LINESEARCH, linear_solver, jacobian_vector);
 }
 
 /**
@@ -102,6 +114,14 @@ Eigen::VectorXd algebra_solver_newton(
  *            longer making significant progress (i.e. is stuck)
  * @param[in] function_tolerance determines whether roots are acceptable.
  * @param[in] max_num_steps  maximum number of function evaluations.
+ * @param[in] linear_solver linear solver for the Newton steps, which
+ *            is dense by default. Banded or sparse Jacobians, given or
+ *            detected, are computed with fewer reverse sweeps, and the
+ *            matrix-free GMRES solver never forms the Jacobian.
+ * @param[in] jacobian_vector functor for the products of the Jacobian
+ *            with vectors of the GMRES solver. Defaults to difference
+ *            quotients; <code>kinsol_forward_jacobian_vector</code>
+ *            computes them with forward mode autodiff.
  * @return theta Vector of solutions to the system of equations.
  * @throw <code>std::invalid_argument</code> if x has size zero.
  * @throw <code>std::invalid_argument</code> if x has non-finite elements.
@@ -116,18 +136,20 @@ Eigen::VectorXd algebra_solver_newton(
  * @throw <code>boost::math::evaluation_error</code> (which is a subclass of
  * <code>std::runtime_error</code>) if solver exceeds max_num_steps.
  */
-template <typename F, typename T1, typename T2>
+template <typename F, typename T1, typename T2,
+          typename F_jv = kinsol_difference_jacobian_vector>
 Eigen::Matrix<T2, Eigen::Dynamic, 1> algebra_solver_newton(
     const F& f, const Eigen::Matrix<T1, Eigen::Dynamic, 1>& x,
     const Eigen::Matrix<T2, Eigen::Dynamic, 1>& y,
     const std::vector<double>& dat, const std::vector<int>& dat_int,
     std::ostream* msgs = nullptr, double scaling_step_size = 1e-3,
     double function_tolerance = 1e-6,
-    long int max_num_steps = 200) {  // NOLINT(runtime/int)
-
+    long int max_num_steps = 200,  // NOLINT(runtime/int)
+    const kinsol_linear_solver& linear_solver = kinsol_linear_solver(),
+    const F_jv& jacobian_vector = F_jv()) {
   Eigen::VectorXd theta_dbl = algebra_solver_newton(
       f, x, value_of(y), dat, dat_int, msgs, scaling_step_size,
-      function_tolerance, max_num_steps);
+      function_tolerance, max_num_steps, linear_solver, jacobian_vector);
 
   typedef system_functor<F, double, double, false> Fy;
   typedef system_functor<F, double, double, true> Fs;
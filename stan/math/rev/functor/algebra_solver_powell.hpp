@@ -4,8 +4,9 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
+#include <stan/math/rev/functor/checkpoint.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/mat/fun/mdivide_left.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <stan/math/prim/mat/fun/value_of.hpp>
 #include <unsupported/Eigen/NonLinearOptimization>
 #include <iostream>
@@ -16,10 +17,42 @@ namespace stan {
 namespace math {
 
 /**
- * The vari class for the algebraic solver. We compute the  Jacobian of
- * the solutions with respect to the parameters using the implicit
- * function theorem. The call to Jacobian() occurs outside the call to
- * chain() -- this prevents malloc issues.
+ * Copies of the algebraic system functor, the solution and the data
+ * of an algebraic solve, kept until the memory of the autodiff tape
+ * is recovered.
+ */
+template <typename F>
+struct algebra_solver_alloc : public chainable_alloc {
+  const F f_;
+  const Eigen::VectorXd theta_dbl_;
+  const std::vector<double> dat_;
+  const std::vector<int> dat_int_;
+  std::ostream* msgs_;
+
+  algebra_solver_alloc(const F& f, const Eigen::VectorXd& theta_dbl,
+                       const std::vector<double>& dat,
+                       const std::vector<int>& dat_int, std::ostream* msgs)
+      : f_(f),
+        theta_dbl_(theta_dbl),
+        dat_(dat),
+        dat_int_(dat_int),
+        msgs_(msgs) {}
+};
+
+/**
+ * The vari class for the algebraic solver. The adjoints of the
+ * solutions are propagated to the parameters with the implicit
+ * function theorem,
+ *
+ * <code>y.adj += -(df/dy)^T (df/dx)^-T x.adj</code>,
+ *
+ * without forming the Jacobian of the solutions wrt to the
+ * parameters. The LU factorization of the Jacobian of the system wrt
+ * to the unknowns at the solution is computed in the forward pass --
+ * this keeps the calls to jacobian() outside of chain(). The chain
+ * method does one transposed solve with the factors and one
+ * vector-Jacobian product of the system wrt to the parameters, which
+ * is a single reverse sweep on a separate autodiff tape.
  */
 template <typename Fs, typename F, typename T, typename Fx>
 struct algebra_solver_vari : public vari {
@@ -31,8 +64,12 @@ struct algebra_solver_vari : public vari {
   int x_size_;
   /** vector of solution */
   vari** theta_;
-  /** Jacobian of the solution w.r.t parameters */
-  double* Jx_y_;
+  /** LU factors of the Jacobian of the system w.r.t unknowns */
+  double* lu_;
+  /** row permutation of the LU factorization */
+  int* perm_;
+  /** functor, solution and data for the vector-Jacobian product */
+  algebra_solver_alloc<F>* alloc_;
 
   algebra_solver_vari(const Fs& fs, const F& f, const Eigen::VectorXd& x,
                       const Eigen::Matrix<T, Eigen::Dynamic, 1>& y,
@@ -46,8 +83,10 @@ struct algebra_solver_vari : public vari {
         x_size_(x.size()),
         theta_(
             ChainableStack::instance_->memalloc_.alloc_array<vari*>(x_size_)),
-        Jx_y_(ChainableStack::instance_->memalloc_.alloc_array<double>(
-            x_size_ * y_size_)) {
+        lu_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            x_size_ * x_size_)),
+        perm_(ChainableStack::instance_->memalloc_.alloc_array<int>(x_size_)),
+        alloc_(new algebra_solver_alloc<F>(f, theta_dbl, dat, dat_int, msgs)) {
     using Eigen::Map;
     using Eigen::MatrixXd;
     for (int i = 0; i < y.size(); ++i) {
@@ -59,20 +98,61 @@ struct algebra_solver_vari : public vari {
       theta_[i] = new vari(theta_dbl(i), false);
     }
 
-    // Compute the Jacobian and store in array, using the
-    // implicit function theorem, i.e. Jx_y = Jf_y / Jf_x
-    using f_y = hybrj_functor_solver<Fs, F, double, double>;
-    Map<MatrixXd>(&Jx_y_[0], x_size_, y_size_)
-        = -mdivide_left(fx.get_jacobian(theta_dbl),
-                        f_y(fs, f, theta_dbl, value_of(y), dat, dat_int, msgs)
-                            .get_jacobian(value_of(y)));
+    // P Jf_x = L U
+    Eigen::PartialPivLU<MatrixXd> lu(fx.get_jacobian(theta_dbl));
+    Map<MatrixXd>(lu_, x_size_, x_size_) = lu.matrixLU();
+    for (int i = 0; i < x_size_; ++i) {
+      perm_[i] = lu.permutationP().indices()(i);
+    }
   }
 
   void chain() {
-    for (int j = 0; j < y_size_; j++) {
-      for (int i = 0; i < x_size_; i++) {
-        y_[j]->adj_ += theta_[i]->adj_ * Jx_y_[j * x_size_ + i];
+    using Eigen::Map;
+    using Eigen::MatrixXd;
+    using Eigen::VectorXd;
+
+    // solve Jf_x^T w = theta.adj, where Jf_x^T = U^T L^T P
+    Map<const MatrixXd> lu(lu_, x_size_, x_size_);
+    VectorXd z(x_size_);
+    for (int i = 0; i < x_size_; ++i) {
+      z(i) = theta_[i]->adj_;
+    }
+    lu.transpose().triangularView<Eigen::Lower>().solveInPlace(z);
+    lu.transpose().triangularView<Eigen::UnitUpper>().solveInPlace(z);
+    VectorXd eta(x_size_);
+    for (int i = 0; i < x_size_; ++i) {
+      eta(i) = -z(perm_[i]);
+    }
+
+    // y.adj += Jf_y^T eta
+    VectorXd y_adj(y_size_);
+    auto* outer = internal::checkpoint_tapes::enter();
+    try {
+      Eigen::Matrix<var, Eigen::Dynamic, 1> y(y_size_);
+      for (int j = 0; j < y_size_; ++j) {
+        y(j) = y_[j]->val_;
+      }
+      Eigen::Matrix<var, Eigen::Dynamic, 1> fy
+          = alloc_->f_(alloc_->theta_dbl_, y, alloc_->dat_, alloc_->dat_int_,
+                       alloc_->msgs_);
+      for (int i = 0; i < x_size_; ++i) {
+        fy(i).vi_->adj_ += eta(i);
       }
+      auto& var_stack = ChainableStack::instance_->var_stack_;
+      for (auto it = var_stack.rbegin(); it != var_stack.rend(); ++it) {
+        (*it)->chain();
+      }
+      for (int j = 0; j < y_size_; ++j) {
+        y_adj(j) = y(j).adj();
+      }
+    } catch (const std::exception& e) {
+      internal::checkpoint_tapes::exit(outer);
+      throw;
+    }
+    internal::checkpoint_tapes::exit(outer);
+
+    for (int j = 0; j < y_size_; ++j) {
+      y_[j]->adj_ += y_adj(j);
     }
   }
 };
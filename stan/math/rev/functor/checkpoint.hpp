@@ -0,0 +1,244 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CHECKPOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_CHECKPOINT_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
+#include <stan/math/prim/arr/fun/value_of.hpp>
+#include <stan/math/prim/functor/checkpoint.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/core/accumulate_adjoints.hpp>
+#include <stan/math/rev/core/count_vars.hpp>
+#include <stan/math/rev/core/deep_copy_vars.hpp>
+#include <stan/math/rev/core/save_varis.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Autodiff tapes on which checkpointed regions are recomputed in the
+ * reverse pass, one per level of nesting of checkpointed regions
+ * within each other. The tapes keep their memory between
+ * recomputations and are local to each thread.
+ */
+class checkpoint_tapes {
+  using tape_t = ChainableStack::AutodiffStackStorage;
+
+ public:
+  /**
+   * Make an empty tape the current autodiff tape of the thread and
+   * return the previous one.
+   */
+  static tape_t* enter() {
+    pool& p = instance();
+    if (p.depth_ == p.tapes_.size()) {
+      p.tapes_.emplace_back(new tape_t());
+    }
+    tape_t* outer = ChainableStack::instance_;
+    ChainableStack::instance_ = p.tapes_[p.depth_++].get();
+    return outer;
+  }
+
+  /**
+   * Clear the current autodiff tape of the thread and make the
+   * specified tape the current one again.
+   *
+   * @param outer tape returned by the matching call to
+   * <code>enter()</code>
+   */
+  static void exit(tape_t* outer) {
+    tape_t* tape = ChainableStack::instance_;
+    tape->var_stack_.clear();
+    tape->var_nochain_stack_.clear();
+    for (auto& x : tape->var_alloc_stack_) {
+      delete x;
+    }
+    tape->var_alloc_stack_.clear();
+    tape->nested_var_stack_sizes_.clear();
+    tape->nested_var_nochain_stack_sizes_.clear();
+    tape->nested_var_alloc_stack_starts_.clear();
+    tape->memalloc_.recover_all();
+    ChainableStack::instance_ = outer;
+    --instance().depth_;
+  }
+
+ private:
+  struct pool {
+    std::vector<std::unique_ptr<tape_t>> tapes_;
+    size_t depth_ = 0;
+  };
+
+  static pool& instance() {
+    static thread_local pool p;
+    return p;
+  }
+};
+
+/**
+ * Return a non-chaining variable with the specified value.
+ */
+inline var checkpoint_result(double x) { return var(new vari(x, false)); }
+
+template <int R, int C>
+inline Eigen::Matrix<var, R, C> checkpoint_result(
+    const Eigen::Matrix<double, R, C>& x) {
+  Eigen::Matrix<var, R, C> result(x.rows(), x.cols());
+  for (int i = 0; i < x.size(); ++i) {
+    result.coeffRef(i) = checkpoint_result(x.coeff(i));
+  }
+  return result;
+}
+
+template <typename T>
+inline std::vector<decltype(checkpoint_result(std::declval<T>()))>
+checkpoint_result(const std::vector<T>& x) {
+  std::vector<decltype(checkpoint_result(std::declval<T>()))> result;
+  result.reserve(x.size());
+  for (const auto& x_i : x) {
+    result.emplace_back(checkpoint_result(x_i));
+  }
+  return result;
+}
+
+/**
+ * Copies of the functor and arguments of a checkpointed region,
+ * kept until the memory of the autodiff tape is recovered.
+ */
+template <typename F, typename... Args>
+struct checkpoint_alloc : public chainable_alloc {
+  const F f_;
+  std::ostream* msgs_;
+  const std::tuple<const Args...> args_tuple_;
+
+  checkpoint_alloc(const F& f, std::ostream* msgs, const Args&... args)
+      : f_(f), msgs_(msgs), args_tuple_(args...) {}
+};
+
+/**
+ * The node on the autodiff tape representing a checkpointed region.
+ *
+ * The results of the region are non-chaining varis. The chain
+ * method tapes the region again on a separate autodiff tape with
+ * copies of the operands, propagates the adjoints of the results
+ * through it with one reverse sweep and adds the adjoints of the
+ * copies to the operands.
+ */
+template <typename F, typename... Args>
+class checkpoint_vari : public vari {
+ public:
+  checkpoint_alloc<F, Args...>* alloc_;
+  size_t num_operands_;
+  vari** operands_;
+  size_t num_results_;
+  vari** results_;
+
+  checkpoint_vari(checkpoint_alloc<F, Args...>* alloc, size_t num_operands,
+                  vari** operands, size_t num_results, vari** results)
+      : vari(0.0),
+        alloc_(alloc),
+        num_operands_(num_operands),
+        operands_(operands),
+        num_results_(num_results),
+        results_(results) {}
+
+  virtual void chain() {
+    std::vector<double> results_adj(num_results_);
+    for (size_t i = 0; i < num_results_; ++i) {
+      results_adj[i] = results_[i]->adj_;
+    }
+    std::vector<double> operands_adj(num_operands_, 0.0);
+
+    auto* outer = checkpoint_tapes::enter();
+    try {
+      std::tuple<decltype(deep_copy_vars(std::declval<const Args&>()))...>
+          args_copy = index_apply<sizeof...(Args)>([&](auto... Is) {
+            return std::tuple<decltype(
+                deep_copy_vars(std::declval<const Args&>()))...>(
+                deep_copy_vars(std::get<Is>(alloc_->args_tuple_))...);
+          });
+      auto result = index_apply<sizeof...(Args)>([&](auto... Is) {
+        return alloc_->f_(alloc_->msgs_, std::get<Is>(args_copy)...);
+      });
+
+      std::vector<vari*> result_vi(num_results_);
+      save_varis(result_vi.data(), result);
+      for (size_t i = 0; i < num_results_; ++i) {
+        result_vi[i]->adj_ += results_adj[i];
+      }
+      auto& var_stack = ChainableStack::instance_->var_stack_;
+      for (auto it = var_stack.rbegin(); it != var_stack.rend(); ++it) {
+        (*it)->chain();
+      }
+
+      index_apply<sizeof...(Args)>([&](auto... Is) {
+        return accumulate_adjoints(operands_adj.data(),
+                                   std::get<Is>(args_copy)...);
+      });
+    } catch (const std::exception& e) {
+      checkpoint_tapes::exit(outer);
+      throw;
+    }
+    checkpoint_tapes::exit(outer);
+
+    for (size_t i = 0; i < num_operands_; ++i) {
+      operands_[i]->adj_ += operands_adj[i];
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Return the result of the functor <code>f</code> applied to the
+ * arguments, recomputing the region in the reverse pass instead of
+ * keeping its autodiff tape.
+ *
+ * The forward pass evaluates the functor with the values of the
+ * arguments and records a single node on the autodiff tape which
+ * keeps copies of the functor and arguments. The autodiff tape of
+ * the region is recorded only in the reverse pass on a separate
+ * tape, which is cleared as soon as the adjoints of the operands
+ * are known. Checkpointed regions may be nested within each other.
+ *
+ * See the primitive version for the requirements on the functor.
+ *
+ * @tparam F type of the functor
+ * @tparam Args types of the arguments
+ * @param f functor
+ * @param msgs stream for messages passed to the functor
+ * @param args arguments passed to the functor
+ * @return result of the functor with autodiff variables
+ */
+template <typename F, typename... Args,
+          std::enable_if_t<is_var<return_type_t<Args...>>::value>* = nullptr>
+inline auto checkpoint(const F& f, std::ostream* msgs, const Args&... args) {
+  auto result = internal::checkpoint_result(f(msgs, value_of(args)...));
+
+  const size_t num_operands = internal::count_vars(args...);
+  vari** operands
+      = ChainableStack::instance_->memalloc_.alloc_array<vari*>(num_operands);
+  internal::save_varis(operands, args...);
+
+  const size_t num_results = internal::count_vars(result);
+  vari** results
+      = ChainableStack::instance_->memalloc_.alloc_array<vari*>(num_results);
+  internal::save_varis(results, result);
+
+  new internal::checkpoint_vari<F, Args...>(
+      new internal::checkpoint_alloc<F, Args...>(f, msgs, args...),
+      num_operands, operands, num_results, results);
+  return result;
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef STAN_MATH_REV_FUNCTOR_COUPLED_ODE_OBSERVER_HPP
+#define STAN_MATH_REV_FUNCTOR_COUPLED_ODE_OBSERVER_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/core/count_vars.hpp>
+#include <stan/math/rev/core/save_varis.hpp>
+#include <stan/math/prim/functor/coupled_ode_observer.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Vari for all states of an ODE at one output time.
+ *
+ * The states are <code>vari</code> which are not on the chainable
+ * stack and only this vari is chained. Its chain rule propagates the
+ * adjoints of all states to the operands with the precomputed
+ * Jacobian of the states wrt to the operands, such that an output
+ * time costs one vari and one Jacobian instead of one vari with its
+ * own operands and gradients per state.
+ */
+class ode_output_vari : public vari {
+ public:
+  const size_t N_;
+  const size_t num_operands_;
+  vari** operands_;
+  double* jacobian_;
+  vari** y_varis_;
+
+  /**
+   * Construct the vari and the varis of the states.
+   *
+   * @param[in] N number of states
+   * @param[in] num_operands number of operands
+   * @param[in] operands varis of the operands, allocated on the arena
+   * @param[in] jacobian N x num_operands Jacobian of the states wrt
+   * to the operands in column major order, allocated on the arena
+   * @param[in] y values of the states
+   */
+  ode_output_vari(size_t N, size_t num_operands, vari** operands,
+                  double* jacobian, const double* y)
+      : vari(0.0),
+        N_(N),
+        num_operands_(num_operands),
+        operands_(operands),
+        jacobian_(jacobian),
+        y_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(N)) {
+    for (size_t j = 0; j < N_; ++j) {
+      y_varis_[j] = new vari(y[j], false);
+    }
+  }
+
+  void chain() {
+    for (size_t k = 0; k < num_operands_; ++k) {
+      const double* jacobian_k = jacobian_ + N_ * k;
+      double adj = 0;
+      for (size_t j = 0; j < N_; ++j) {
+        adj += y_varis_[j]->adj_ * jacobian_k[j];
+      }
+      operands_[k]->adj_ += adj;
+    }
+  }
+};
+
+/**
+ * Build the states of the ODE at one output time with a single
+ * <code>ode_output_vari</code>.
+ *
+ * The initial time does not enter the gradient, as for the
+ * <code>operands_and_partials</code> implementation.
+ */
+template <typename T1, typename T2, typename T_t0, typename T_ts>
+struct ode_output_state<T1, T2, T_t0, T_ts,
+                        require_var_t<return_type_t<T1, T2, T_t0, T_ts>>> {
+  static std::vector<var> apply(const std::vector<double>& coupled_state,
+                                const std::vector<double>& dy_dt,
+                                const std::vector<T1>& y0,
+                                const std::vector<T2>& theta, const T_t0& t0,
+                                const T_ts& t) {
+    const size_t N = y0.size();
+    const size_t num_operands = count_vars(y0, theta, t);
+    vari** operands
+        = ChainableStack::instance_->memalloc_.alloc_array<vari*>(num_operands);
+    save_varis(operands, y0, theta, t);
+
+    // the sensitivities wrt to the initial state and the parameters
+    // follow the states in the coupled state in the same column major
+    // layout as the Jacobian
+    double* jacobian = ChainableStack::instance_->memalloc_.alloc_array<double>(
+        N * num_operands);
+    const size_t num_sens = count_vars(y0, theta);
+    std::copy(coupled_state.begin() + N,
+              coupled_state.begin() + N * (1 + num_sens), jacobian);
+    if (is_var<T_ts>::value) {
+      std::copy(dy_dt.begin(), dy_dt.end(), jacobian + N * num_sens);
+    }
+
+    ode_output_vari* vi = new ode_output_vari(N, num_operands, operands,
+                                              jacobian, coupled_state.data());
+    std::vector<var> yt(N);
+    for (size_t j = 0; j < N; ++j) {
+      yt[j] = var(vi->y_varis_[j]);
+    }
+    return yt;
+  }
+};
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
@@ -4,15 +4,20 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/arr/fun/value_of.hpp>
-#include <stan/math/prim/functor/coupled_ode_observer.hpp>
+#include <stan/math/rev/functor/coupled_ode_observer.hpp>
 #include <stan/math/prim/functor/coupled_ode_system.hpp>
 #include <stan/math/rev/functor/coupled_ode_system.hpp>
 #include <stan/math/rev/functor/cvodes_utils.hpp>
 #include <stan/math/rev/functor/cvodes_ode_data.hpp>
+#include <stan/math/rev/functor/cvodes_integrator_adjoint.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
 #include <cvodes/cvodes.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <algorithm>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
 namespace stan {
@@ -22,11 +27,27 @@ namespace math {
  * Integrator interface for CVODES' ODE solvers (Adams & BDF
  * methods).
  * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
+ * @tparam F_jac type of the functor for the Jacobian of the ODE RHS
+ * wrt to the states or <code>ode_autodiff_jacobian</code>
  */
-template <int Lmm>
+template <int Lmm, typename F_jac = ode_autodiff_jacobian>
 class cvodes_integrator {
+  const ode_jacobian_structure structure_;
+  const F_jac jacobian_;
+
  public:
-  cvodes_integrator() {}
+  /**
+   * Construct an integrator.
+   *
+   * @param[in] structure structure of the Jacobian of the ODE RHS wrt
+   * to the states, which selects a dense or banded linear solver.
+   * @param[in] jacobian functor for the Jacobian of the ODE RHS wrt
+   * to the states; see <code>cvodes_ode_data</code>.
+   */
+  explicit cvodes_integrator(
+      const ode_jacobian_structure& structure = ode_jacobian_structure(),
+      const F_jac& jacobian = F_jac())
+      : structure_(structure), jacobian_(jacobian) {}
 
   /**
    * Return the solutions for the specified system of ordinary
@@ -77,56 +98,236 @@ class cvodes_integrator {
             std::ostream* msgs, double relative_tolerance,
             double absolute_tolerance,
             long int max_num_steps) {  // NOLINT(runtime/int)
-    using initial_var = stan::is_var<T_initial>;
-    using param_var = stan::is_var<T_param>;
+    const double t0_dbl = value_of(t0);
+    const std::vector<double> ts_dbl = value_of(ts);
+
+    check_arguments(y0, t0_dbl, ts_dbl, theta, x, relative_tolerance,
+                    absolute_tolerance, max_num_steps);
+
+    std::vector<std::vector<
+        typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>
+        y;
+    coupled_ode_observer<F, T_initial, T_param, T_t0, T_ts> observer(
+        f, y0, theta, t0, ts, x, x_int, msgs, y);
+
+    integrate_coupled(f, y0, t0_dbl, ts_dbl, theta, x, x_int, msgs,
+                      relative_tolerance, absolute_tolerance, max_num_steps,
+                      observer);
+
+    return y;
+  }
 
+  /**
+   * Return the solutions for the specified system of ordinary
+   * differential equations, computing sensitivities with the adjoint
+   * method instead of forward sensitivities.
+   *
+   * The forward problem is solved once while CVODES stores
+   * checkpoints; the gradients are obtained on the reverse pass by
+   * solving a single backward problem with quadratures for the
+   * parameters. This scales better than the forward sensitivity
+   * method when the number of states and parameters is large.
+   *
+   * If all arguments are data the solution is computed with
+   * <code>integrate()</code>.
+   *
+   * @tparam F type of ODE system function.
+   * @tparam T_initial type of scalars for initial values.
+   * @tparam T_param type of scalars for parameters.
+   * @tparam T_t0 type of scalar of initial time point.
+   * @tparam T_ts type of time-points where ODE solution is returned.
+   * @param[in] f functor for the base ordinary differential equation.
+   * @param[in] y0 initial state.
+   * @param[in] t0 initial time.
+   * @param[in] ts times of the desired solutions, in strictly
+   * increasing order, all greater than the initial time.
+   * @param[in] theta parameter vector for the ODE.
+   * @param[in] x continuous data vector for the ODE.
+   * @param[in] x_int integer data vector for the ODE.
+   * @param[in, out] msgs the print stream for warning messages.
+   * @param[in] relative_tolerance relative tolerance passed to CVODE.
+   * @param[in] absolute_tolerance absolute tolerance passed to CVODE.
+   * @param[in] max_num_steps maximal number of admissable steps
+   * between time-points
+   * @param[in] options tolerances and checkpointing of the backward
+   * problem.
+   * @return a vector of states, each state being a vector of the
+   * same size as the state variable, corresponding to a time in ts.
+   */
+  template <typename F, typename T_initial, typename T_param, typename T_t0,
+            typename T_ts>
+  std::vector<std::vector<
+      typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>
+  integrate_adjoint(const F& f, const std::vector<T_initial>& y0,
+                    const T_t0& t0, const std::vector<T_ts>& ts,
+                    const std::vector<T_param>& theta,
+                    const std::vector<double>& x, const std::vector<int>& x_int,
+                    std::ostream* msgs, double relative_tolerance,
+                    double absolute_tolerance,
+                    long int max_num_steps,  // NOLINT(runtime/int)
+                    const cvodes_adjoint_options& options) {
+    using return_t =
+        typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type;
+    check_arguments(y0, value_of(t0), value_of(ts), theta, x,
+                    relative_tolerance, absolute_tolerance, max_num_steps);
     const char* fun = "integrate_ode_cvodes";
+    check_positive(fun, "relative_tolerance_backward",
+                   options.relative_tolerance_backward);
+    check_positive(fun, "absolute_tolerance_backward",
+                   options.absolute_tolerance_backward);
+    check_positive(fun, "relative_tolerance_quadrature",
+                   options.relative_tolerance_quadrature);
+    check_positive(fun, "absolute_tolerance_quadrature",
+                   options.absolute_tolerance_quadrature);
+    check_positive(fun, "steps_between_checkpoints",
+                   options.steps_between_checkpoints);
+    return integrate_adjoint(std::is_same<return_t, double>(), f, y0, t0, ts,
+                             theta, x, x_int, msgs, relative_tolerance,
+                             absolute_tolerance, max_num_steps, options);
+  }
 
-    const double t0_dbl = value_of(t0);
-    const std::vector<double> ts_dbl = value_of(ts);
+  /**
+   * Return the solutions of an ensemble of independent instances of
+   * the same system of ordinary differential equations, one for each
+   * subject with its own initial state, times of desired solutions
+   * and parameters.
+   *
+   * The subjects are solved with <code>tbb::parallel_for</code>
+   * whenever <code>STAN_THREADS</code> is defined and serially
+   * otherwise. Every subject has its own CVODES memory and the
+   * nested autodiff needed for its sensitivities runs on the autodiff
+   * tape of the thread solving it. Only the states and sensitivities
+   * at the output times are kept, and the autodiff variables of the
+   * result are created on the tape of the calling thread once all
+   * subjects are solved. The ode functor must be safe to call
+   * concurrently.
+   *
+   * @tparam F type of ODE system function.
+   * @tparam T_initial type of scalars for initial values.
+   * @tparam T_param type of scalars for parameters.
+   * @tparam T_t0 type of scalar of initial time point.
+   * @tparam T_ts type of time-points where ODE solution is returned.
+   * @param[in] f functor for the base ordinary differential equation.
+   * @param[in] y0s initial state of each subject.
+   * @param[in] t0 initial time of all subjects.
+   * @param[in] tss times of the desired solutions of each subject, in
+   * strictly increasing order, all greater than the initial time.
+   * @param[in] thetas parameter vector of each subject.
+   * @param[in] x continuous data vector for the ODE.
+   * @param[in] x_int integer data vector for the ODE.
+   * @param[in, out] msgs the print stream for warning messages.
+   * @param[in] relative_tolerance relative tolerance passed to CVODE.
+   * @param[in] absolute_tolerance absolute tolerance passed to CVODE.
+   * @param[in] max_num_steps maximal number of admissable steps
+   * between time-points
+   * @return for each subject a vector of states, each state being a
+   * vector of the same size as the state variable, corresponding to a
+   * time in the times of the subject.
+   * @throw std::invalid_argument if the number of subjects of the
+   * arguments do not match
+   */
+  template <typename F, typename T_initial, typename T_param, typename T_t0,
+            typename T_ts>
+  std::vector<std::vector<std::vector<
+      typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>>
+  integrate_ensemble(const F& f,
+                     const std::vector<std::vector<T_initial>>& y0s,
+                     const T_t0& t0,
+                     const std::vector<std::vector<T_ts>>& tss,
+                     const std::vector<std::vector<T_param>>& thetas,
+                     const std::vector<double>& x,
+                     const std::vector<int>& x_int, std::ostream* msgs,
+                     double relative_tolerance, double absolute_tolerance,
+                     long int max_num_steps) {  // NOLINT(runtime/int)
+    using return_t =
+        typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type;
+    const char* fun = "integrate_ode_cvodes_ensemble";
+    const size_t num_subjects = y0s.size();
+    check_size_match(fun, "number of initial states", num_subjects,
+                     "number of time vectors", tss.size());
+    check_size_match(fun, "number of initial states", num_subjects,
+                     "number of parameter vectors", thetas.size());
 
-    check_finite(fun, "initial state", y0);
-    check_finite(fun, "initial time", t0_dbl);
-    check_finite(fun, "times", ts_dbl);
-    check_finite(fun, "parameter vector", theta);
-    check_finite(fun, "continuous data", x);
-    check_nonzero_size(fun, "times", ts);
-    check_nonzero_size(fun, "initial state", y0);
-    check_ordered(fun, "times", ts_dbl);
-    check_less(fun, "initial time", t0_dbl, ts_dbl[0]);
-    if (relative_tolerance <= 0) {
-      invalid_argument("integrate_ode_cvodes", "relative_tolerance,",
-                       relative_tolerance, "", ", must be greater than 0");
-    }
-    if (absolute_tolerance <= 0) {
-      invalid_argument("integrate_ode_cvodes", "absolute_tolerance,",
-                       absolute_tolerance, "", ", must be greater than 0");
+    const double t0_dbl = value_of(t0);
+    std::vector<std::vector<double>> tss_dbl(num_subjects);
+    for (size_t k = 0; k < num_subjects; ++k) {
+      tss_dbl[k] = value_of(tss[k]);
+      check_arguments(y0s[k], t0_dbl, tss_dbl[k], thetas[k], x,
+                      relative_tolerance, absolute_tolerance, max_num_steps);
     }
-    if (max_num_steps <= 0) {
-      invalid_argument("integrate_ode_cvodes", "max_num_steps,", max_num_steps,
-                       "", ", must be greater than 0");
+
+    std::vector<std::vector<std::vector<double>>> coupled_states(
+        num_subjects);
+    auto solve_subjects = [&](const tbb::blocked_range<size_t>& r) {
+      for (size_t k = r.begin(); k < r.end(); ++k) {
+        auto store_state = [&](const std::vector<double>& coupled_state,
+                               double t) {
+          coupled_states[k].push_back(coupled_state);
+        };
+        start_nested();
+        try {
+          integrate_coupled(f, y0s[k], t0_dbl, tss_dbl[k], thetas[k], x,
+                            x_int, msgs, relative_tolerance,
+                            absolute_tolerance, max_num_steps, store_state);
+        } catch (const std::exception& e) {
+          recover_memory_nested();
+          throw;
+        }
+        recover_memory_nested();
+      }
+    };
+    const tbb::blocked_range<size_t> range(0, num_subjects);
+#ifdef STAN_THREADS
+    tbb::parallel_for(range, solve_subjects);
+#else
+    solve_subjects(range);
+#endif
+
+    std::vector<std::vector<std::vector<return_t>>> ys(num_subjects);
+    for (size_t k = 0; k < num_subjects; ++k) {
+      coupled_ode_observer<F, T_initial, T_param, T_t0, T_ts> observer(
+          f, y0s[k], thetas[k], t0, tss[k], x, x_int, msgs, ys[k]);
+      for (size_t n = 0; n < tss_dbl[k].size(); ++n) {
+        observer(coupled_states[k][n], tss_dbl[k][n]);
+      }
     }
+    return ys;
+  }
+
+ private:
+  /**
+   * Solve the coupled ode system and call <code>observer</code> with
+   * the state of the coupled system at each of the times
+   * <code>ts_dbl</code>. The arguments are assumed to be checked.
+   *
+   * @tparam Observer type of the callback called as
+   * <code>observer(coupled_state, t)</code>
+   */
+  template <typename F, typename T_initial, typename T_param,
+            typename Observer>
+  void integrate_coupled(const F& f, const std::vector<T_initial>& y0,
+                         double t0_dbl, const std::vector<double>& ts_dbl,
+                         const std::vector<T_param>& theta,
+                         const std::vector<double>& x,
+                         const std::vector<int>& x_int, std::ostream* msgs,
+                         double relative_tolerance, double absolute_tolerance,
+                         long int max_num_steps,  // NOLINT(runtime/int)
+                         Observer& observer) const {
+    using initial_var = stan::is_var<T_initial>;
+    using param_var = stan::is_var<T_param>;
 
     const size_t N = y0.size();
     const size_t M = theta.size();
     const size_t S = (initial_var::value ? N : 0) + (param_var::value ? M : 0);
 
-    using ode_data = cvodes_ode_data<F, T_initial, T_param>;
-    ode_data cvodes_data(f, y0, theta, x, x_int, msgs);
+    using ode_data = cvodes_ode_data<F, T_initial, T_param, F_jac>;
+    ode_data cvodes_data(f, y0, theta, x, x_int, msgs, structure_, jacobian_);
 
     void* cvodes_mem = CVodeCreate(Lmm);
     if (cvodes_mem == nullptr) {
       throw std::runtime_error("CVodeCreate failed to allocate memory");
     }
 
-    const size_t coupled_size = cvodes_data.coupled_ode_.size();
-
-    std::vector<std::vector<
-        typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>
-        y;
-    coupled_ode_observer<F, T_initial, T_param, T_t0, T_ts> observer(
-        f, y0, theta, t0, ts, x, x_int, msgs, y);
-
     try {
       check_flag_sundials(CVodeInit(cvodes_mem, &ode_data::cv_rhs, t0_dbl,
                                     cvodes_data.nv_state_),
@@ -163,7 +364,7 @@ class cvodes_integrator {
       }
 
       double t_init = t0_dbl;
-      for (size_t n = 0; n < ts.size(); ++n) {
+      for (size_t n = 0; n < ts_dbl.size(); ++n) {
         double t_final = ts_dbl[n];
         if (t_final != t_init) {
           check_flag_sundials(CVode(cvodes_mem, t_final, cvodes_data.nv_state_,
@@ -184,7 +385,80 @@ class cvodes_integrator {
     }
 
     CVodeFree(&cvodes_mem);
+  }
+
+  /**
+   * Check the arguments shared by the forward and adjoint
+   * sensitivity modes.
+   */
+  template <typename T_initial, typename T_param>
+  static void check_arguments(const std::vector<T_initial>& y0,
+                              double t0_dbl, const std::vector<double>& ts_dbl,
+                              const std::vector<T_param>& theta,
+                              const std::vector<double>& x,
+                              double relative_tolerance,
+                              double absolute_tolerance,
+                              long int max_num_steps) {  // NOLINT(runtime/int)
+    const char* fun = "integrate_ode_cvodes";
+
+    check_finite(fun, "initial state", y0);
+    check_finite(fun, "initial time", t0_dbl);
+    check_finite(fun, "times", ts_dbl);
+    check_finite(fun, "parameter vector", theta);
+    check_finite(fun, "continuous data", x);
+    check_nonzero_size(fun, "times", ts_dbl);
+    check_nonzero_size(fun, "initial state", y0);
+    check_ordered(fun, "times", ts_dbl);
+    check_less(fun, "initial time", t0_dbl, ts_dbl[0]);
+    if (relative_tolerance <= 0) {
+      invalid_argument("integrate_ode_cvodes", "relative_tolerance,",
+                       relative_tolerance, "", ", must be greater than 0");
+    }
+    if (absolute_tolerance <= 0) {
+      invalid_argument("integrate_ode_cvodes", "absolute_tolerance,",
+                       absolute_tolerance, "", ", must be greater than 0");
+    }
+    if (max_num_steps <= 0) {
+      invalid_argument("integrate_ode_cvodes", "max_num_steps,", max_num_steps,
+                       "", ", must be greater than 0");
+    }
+  }
 
+  template <typename F, typename T_initial, typename T_param, typename T_t0,
+            typename T_ts>
+  std::vector<std::vector<double>> integrate_adjoint(
+      std::true_type, const F& f, const std::vector<T_initial>& y0,
+      const T_t0& t0, const std::vector<T_ts>& ts,
+      const std::vector<T_param>& theta, const std::vector<double>& x,
+      const std::vector<int>& x_int, std::ostream* msgs,
+      double relative_tolerance, double absolute_tolerance,
+      long int max_num_steps,  // NOLINT(runtime/int)
+      const cvodes_adjoint_options& options) {
+    return integrate(f, y0, t0, ts, theta, x, x_int, msgs, relative_tolerance,
+                     absolute_tolerance, max_num_steps);
+  }
+
+  template <typename F, typename T_initial, typename T_param, typename T_t0,
+            typename T_ts>
+  std::vector<std::vector<var>> integrate_adjoint(
+      std::false_type, const F& f, const std::vector<T_initial>& y0,
+      const T_t0& t0, const std::vector<T_ts>& ts,
+      const std::vector<T_param>& theta, const std::vector<double>& x,
+      const std::vector<int>& x_int, std::ostream* msgs,
+      double relative_tolerance, double absolute_tolerance,
+      long int max_num_steps,  // NOLINT(runtime/int)
+      const cvodes_adjoint_options& options) {
+    auto* vi = new cvodes_integrator_adjoint_vari<Lmm, F, T_initial, T_param,
+                                                  T_t0, T_ts>(
+        f, y0, t0, ts, theta, x, x_int, msgs, relative_tolerance,
+        absolute_tolerance, max_num_steps, options);
+    const size_t N = y0.size();
+    std::vector<std::vector<var>> y(ts.size(), std::vector<var>(N));
+    for (size_t n = 0; n < ts.size(); ++n) {
+      for (size_t i = 0; i < N; ++i) {
+        y[n][i] = var(vi->y_varis_[n * N + i]);
+      }
+    }
     return y;
   }
 };  // cvodes integrator
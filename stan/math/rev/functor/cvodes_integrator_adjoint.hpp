@@ -0,0 +1,618 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CVODES_INTEGRATOR_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_CVODES_INTEGRATOR_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/arr/fun/value_of.hpp>
+#include <stan/math/rev/functor/checkpoint.hpp>
+#include <stan/math/rev/functor/cvodes_utils.hpp>
+#include <cvodes/cvodes.h>
+#include <nvector/nvector_serial.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunlinsol/sunlinsol_dense.h>
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Options for the adjoint sensitivity mode of the CVODES
+ * integrators.
+ *
+ * In adjoint mode the forward problem is solved without any
+ * sensitivity states while CVODES stores checkpoints of the forward
+ * solution. On the reverse pass a single backward problem of size N
+ * (the number of states) is solved together with quadratures of size
+ * M (the number of parameters), so that the cost of a gradient does
+ * not grow with N * (N + M) as it does for forward sensitivities.
+ */
+struct cvodes_adjoint_options {
+  /**
+   * Relative tolerance of the backward (adjoint) problem.
+   */
+  double relative_tolerance_backward = 1e-10;
+
+  /**
+   * Absolute tolerance of the backward (adjoint) problem.
+   */
+  double absolute_tolerance_backward = 1e-10;
+
+  /**
+   * Relative tolerance of the quadratures for the parameter
+   * gradients.
+   */
+  double relative_tolerance_quadrature = 1e-10;
+
+  /**
+   * Absolute tolerance of the quadratures for the parameter
+   * gradients.
+   */
+  double absolute_tolerance_quadrature = 1e-10;
+
+  /**
+   * Number of integration steps between two consecutive checkpoints
+   * of the forward solution.
+   */
+  long int steps_between_checkpoints = 150;  // NOLINT(runtime/int)
+
+  /**
+   * Interpolation used to evaluate the forward solution between
+   * checkpoints, either <code>CV_HERMITE</code> or
+   * <code>CV_POLYNOMIAL</code>.
+   */
+  int interpolation_polynomial = CV_HERMITE;
+};
+
+/**
+ * Holds the CVODES memory of an adjoint mode ODE solve from the
+ * forward pass until the reverse pass, together with copies of
+ * everything the user functor needs.
+ *
+ * It is derived from <code>chainable_alloc</code> so that the CVODES
+ * resources are released when the autodiff memory is recovered.
+ *
+ * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
+ * @tparam F type of functor for the base ode system.
+ * @tparam T_param type of parameters
+ */
+template <int Lmm, typename F, typename T_param>
+class cvodes_adjoint_memory : public chainable_alloc {
+  using memory_t = cvodes_adjoint_memory<Lmm, F, T_param>;
+  using param_var = stan::is_var<T_param>;
+
+ public:
+  const F f_;
+  const size_t N_;
+  const size_t M_;
+  const std::vector<double> theta_dbl_;
+  const std::vector<double> x_;
+  const std::vector<int> x_int_;
+  std::ostream* msgs_;
+  const cvodes_adjoint_options options_;
+  const long int max_num_steps_;  // NOLINT(runtime/int)
+  std::vector<double> state_;
+  std::vector<double> state_backward_;
+  std::vector<double> quadrature_;
+  void* cvodes_mem_;
+  N_Vector nv_state_;
+  N_Vector nv_state_backward_;
+  N_Vector nv_quadrature_;
+  SUNMatrix A_;
+  SUNLinearSolver LS_;
+  SUNMatrix A_backward_;
+  SUNLinearSolver LS_backward_;
+  int index_backward_;
+  bool backward_is_initialized_;
+
+  cvodes_adjoint_memory(const F& f, const std::vector<double>& y0,
+                        const std::vector<double>& theta_dbl,
+                        const std::vector<double>& x,
+                        const std::vector<int>& x_int, std::ostream* msgs,
+                        const cvodes_adjoint_options& options,
+                        long int max_num_steps)  // NOLINT(runtime/int)
+      : f_(f),
+        N_(y0.size()),
+        M_(theta_dbl.size()),
+        theta_dbl_(theta_dbl),
+        x_(x),
+        x_int_(x_int),
+        msgs_(msgs),
+        options_(options),
+        max_num_steps_(max_num_steps),
+        state_(y0),
+        state_backward_(N_, 0.0),
+        quadrature_(M_, 0.0),
+        cvodes_mem_(CVodeCreate(Lmm)),
+        nv_state_(N_VMake_Serial(N_, &state_[0])),
+        nv_state_backward_(N_VMake_Serial(N_, &state_backward_[0])),
+        nv_quadrature_(nullptr),
+        A_(SUNDenseMatrix(N_, N_)),
+        LS_(SUNDenseLinearSolver(nv_state_, A_)),
+        A_backward_(SUNDenseMatrix(N_, N_)),
+        LS_backward_(SUNDenseLinearSolver(nv_state_backward_, A_backward_)),
+        index_backward_(0),
+        backward_is_initialized_(false) {
+    if (cvodes_mem_ == nullptr) {
+      throw std::runtime_error("CVodeCreate failed to allocate memory");
+    }
+    if (param_var::value && M_ > 0) {
+      nv_quadrature_ = N_VMake_Serial(M_, &quadrature_[0]);
+    }
+  }
+
+  ~cvodes_adjoint_memory() {
+    SUNLinSolFree(LS_backward_);
+    SUNMatDestroy(A_backward_);
+    SUNLinSolFree(LS_);
+    SUNMatDestroy(A_);
+    N_VDestroy_Serial(nv_state_);
+    N_VDestroy_Serial(nv_state_backward_);
+    if (nv_quadrature_ != nullptr) {
+      N_VDestroy_Serial(nv_quadrature_);
+    }
+    CVodeFree(&cvodes_mem_);
+  }
+
+  /**
+   * Implements the function of type CVRhsFn which is the user-defined
+   * ODE RHS passed to CVODES.
+   */
+  static int cv_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data) {
+    const memory_t* memory = static_cast<const memory_t*>(user_data);
+    memory->rhs(t, NV_DATA_S(y), NV_DATA_S(ydot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVRhsFnB which is the RHS of the
+   * backward (adjoint) ODE, -J_y^T lambda.
+   */
+  static int cv_rhs_adj(realtype t, N_Vector y, N_Vector yB, N_Vector yBdot,
+                        void* user_dataB) {
+    const memory_t* memory = static_cast<const memory_t*>(user_dataB);
+    memory->rhs_adj(t, NV_DATA_S(y), NV_DATA_S(yB), NV_DATA_S(yBdot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVQuadRhsFnB which is the RHS of
+   * the quadratures for the parameter gradients, -J_theta^T lambda.
+   */
+  static int cv_quad_rhs_adj(realtype t, N_Vector y, N_Vector yB,
+                             N_Vector qBdot, void* user_dataB) {
+    const memory_t* memory = static_cast<const memory_t*>(user_dataB);
+    memory->quad_rhs_adj(t, NV_DATA_S(y), NV_DATA_S(yB), NV_DATA_S(qBdot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVLsJacFn which is the
+   * user-defined callback for CVODES to calculate the jacobian of the
+   * ode_rhs wrt to the states y. The jacobian is stored in column
+   * major format.
+   */
+  static int cv_jacobian_states(realtype t, N_Vector y, N_Vector fy,
+                                SUNMatrix J, void* user_data, N_Vector tmp1,
+                                N_Vector tmp2, N_Vector tmp3) {
+    const memory_t* memory = static_cast<const memory_t*>(user_data);
+    memory->jacobian_states(t, NV_DATA_S(y), SM_DATA_D(J), false);
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVLsJacFnB which is the
+   * jacobian of the backward ODE RHS wrt to the adjoint states,
+   * -J_y^T.
+   */
+  static int cv_jacobian_adj(realtype t, N_Vector y, N_Vector yB,
+                             N_Vector fyB, SUNMatrix JB, void* user_dataB,
+                             N_Vector tmp1B, N_Vector tmp2B, N_Vector tmp3B) {
+    const memory_t* memory = static_cast<const memory_t*>(user_dataB);
+    memory->jacobian_states(t, NV_DATA_S(y), SM_DATA_D(JB), true);
+    return 0;
+  }
+
+  /**
+   * Calculates the ODE RHS, dy_dt, using the user-supplied functor at
+   * the given time t and state y.
+   */
+  inline void rhs(double t, const double y[], double dy_dt[]) const {
+    const std::vector<double> y_vec(y, y + N_);
+    const std::vector<double>& dy_dt_vec
+        = f_(t, y_vec, theta_dbl_, x_, x_int_, msgs_);
+    check_size_match("cvodes_adjoint_memory", "dz_dt", dy_dt_vec.size(),
+                     "states", N_);
+    std::move(dy_dt_vec.begin(), dy_dt_vec.end(), dy_dt);
+  }
+
+ private:
+  /**
+   * Calculates the vector-Jacobian products lambda^T J_y and, if
+   * requested, lambda^T J_theta with a single nested reverse sweep.
+   *
+   * This is called from <code>chain()</code> while the reverse pass
+   * iterates over the autodiff stack, so the sweep runs on a separate
+   * tape which cannot reallocate the stack under it.
+   */
+  inline void vector_jacobian(double t, const double y[],
+                              const double lambda[], double* lambda_J_y,
+                              double* lambda_J_theta) const {
+    auto* outer = internal::checkpoint_tapes::enter();
+    start_nested();
+    try {
+      const std::vector<var> y_var(y, y + N_);
+      std::vector<var> f_var;
+      std::vector<var> theta_var;
+      if (lambda_J_theta != nullptr) {
+        theta_var.assign(theta_dbl_.begin(), theta_dbl_.end());
+        f_var = f_(t, y_var, theta_var, x_, x_int_, msgs_);
+      } else {
+        f_var = f_(t, y_var, theta_dbl_, x_, x_int_, msgs_);
+      }
+      check_size_match("cvodes_adjoint_memory", "dz_dt", f_var.size(),
+                       "states", N_);
+      var lambda_f = 0;
+      for (size_t i = 0; i < N_; ++i) {
+        lambda_f += lambda[i] * f_var[i];
+      }
+      lambda_f.grad();
+      for (size_t i = 0; i < N_; ++i) {
+        lambda_J_y[i] = y_var[i].adj();
+      }
+      if (lambda_J_theta != nullptr) {
+        for (size_t j = 0; j < M_; ++j) {
+          lambda_J_theta[j] = theta_var[j].adj();
+        }
+      }
+    } catch (const std::exception& e) {
+      recover_memory_nested();
+      internal::checkpoint_tapes::exit(outer);
+      throw;
+    }
+    recover_memory_nested();
+    internal::checkpoint_tapes::exit(outer);
+  }
+
+  /**
+   * Calculates the RHS of the backward problem, -J_y^T lambda.
+   */
+  inline void rhs_adj(double t, const double y[], const double lambda[],
+                      double dlambda_dt[]) const {
+    vector_jacobian(t, y, lambda, dlambda_dt, nullptr);
+    for (size_t i = 0; i < N_; ++i) {
+      dlambda_dt[i] = -dlambda_dt[i];
+    }
+  }
+
+  /**
+   * Calculates the RHS of the quadratures, -J_theta^T lambda.
+   */
+  inline void quad_rhs_adj(double t, const double y[], const double lambda[],
+                           double dq_dt[]) const {
+    std::vector<double> lambda_J_y(N_);
+    vector_jacobian(t, y, lambda, &lambda_J_y[0], dq_dt);
+    for (size_t j = 0; j < M_; ++j) {
+      dq_dt[j] = -dq_dt[j];
+    }
+  }
+
+  /**
+   * Calculates the jacobian of the ODE RHS wrt to its states y at
+   * the given time-point t and state y in column major format. If
+   * <code>adjoint</code> is true, -J_y^T is stored instead. As for
+   * <code>vector_jacobian</code>, the sweeps run on a separate tape.
+   */
+  inline void jacobian_states(double t, const double y[], double J[],
+                              bool adjoint) const {
+    auto* outer = internal::checkpoint_tapes::enter();
+    start_nested();
+    try {
+      const std::vector<var> y_var(y, y + N_);
+      std::vector<var> f_var = f_(t, y_var, theta_dbl_, x_, x_int_, msgs_);
+      check_size_match("cvodes_adjoint_memory", "dz_dt", f_var.size(),
+                       "states", N_);
+      for (size_t i = 0; i < N_; ++i) {
+        if (i > 0) {
+          set_zero_all_adjoints_nested();
+        }
+        f_var[i].grad();
+        for (size_t j = 0; j < N_; ++j) {
+          if (adjoint) {
+            J[i * N_ + j] = -y_var[j].adj();
+          } else {
+            J[j * N_ + i] = y_var[j].adj();
+          }
+        }
+      }
+    } catch (const std::exception& e) {
+      recover_memory_nested();
+      internal::checkpoint_tapes::exit(outer);
+      throw;
+    }
+    recover_memory_nested();
+    internal::checkpoint_tapes::exit(outer);
+  }
+};
+
+/**
+ * The vari for the solution of an ODE in adjoint sensitivity mode.
+ *
+ * The forward pass solves the ODE with CVODES while storing
+ * checkpoints. The states at the output times are returned as
+ * <code>vari</code> which are not on the chainable stack; only this
+ * vari is chained. <code>chain()</code> solves the backward problem
+ * from the last output time to the initial time, adding the
+ * adjoints of the outputs as jumps at the output times.
+ *
+ * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
+ * @tparam F type of functor for the base ode system.
+ * @tparam T_initial type of initial values
+ * @tparam T_param type of parameters
+ * @tparam T_t0 type of the initial time
+ * @tparam T_ts type of the output times
+ */
+template <int Lmm, typename F, typename T_initial, typename T_param,
+          typename T_t0, typename T_ts>
+class cvodes_integrator_adjoint_vari : public vari {
+  using memory_t = cvodes_adjoint_memory<Lmm, F, T_param>;
+  using initial_var = stan::is_var<T_initial>;
+  using param_var = stan::is_var<T_param>;
+  using t0_var = stan::is_var<T_t0>;
+  using ts_var = stan::is_var<T_ts>;
+
+  memory_t* memory_;
+  const size_t N_;
+  const size_t M_;
+  const size_t T_;
+  const double t0_;
+  double* ts_;
+  double* y0_;
+  double* y_;
+  vari** y0_varis_;
+  vari** theta_varis_;
+  vari* t0_vari_;
+  vari** ts_varis_;
+
+ public:
+  vari** y_varis_;
+
+  /**
+   * Solves the forward problem and stores the states at the output
+   * times.
+   *
+   * @param[in] f functor for the base ordinary differential equation.
+   * @param[in] y0 initial state.
+   * @param[in] t0 initial time.
+   * @param[in] ts times of the desired solutions.
+   * @param[in] theta parameter vector for the ODE.
+   * @param[in] x continuous data vector for the ODE.
+   * @param[in] x_int integer data vector for the ODE.
+   * @param[in, out] msgs the print stream for warning messages.
+   * @param[in] relative_tolerance relative tolerance of the forward
+   * problem.
+   * @param[in] absolute_tolerance absolute tolerance of the forward
+   * problem.
+   * @param[in] max_num_steps maximal number of admissable steps
+   * between time-points.
+   * @param[in] options tolerances and checkpointing of the backward
+   * problem.
+   */
+  cvodes_integrator_adjoint_vari(
+      const F& f, const std::vector<T_initial>& y0, const T_t0& t0,
+      const std::vector<T_ts>& ts, const std::vector<T_param>& theta,
+      const std::vector<double>& x, const std::vector<int>& x_int,
+      std::ostream* msgs, double relative_tolerance, double absolute_tolerance,
+      long int max_num_steps,  // NOLINT(runtime/int)
+      const cvodes_adjoint_options& options)
+      : vari(NOT_A_NUMBER),
+        memory_(new memory_t(f, value_of(y0), value_of(theta), x, x_int, msgs,
+                             options, max_num_steps)),
+        N_(y0.size()),
+        M_(theta.size()),
+        T_(ts.size()),
+        t0_(value_of(t0)),
+        ts_(ChainableStack::instance_->memalloc_.alloc_array<double>(T_)),
+        y0_(ChainableStack::instance_->memalloc_.alloc_array<double>(N_)),
+        y_(ChainableStack::instance_->memalloc_.alloc_array<double>(N_ * T_)),
+        y0_varis_(nullptr),
+        theta_varis_(nullptr),
+        t0_vari_(nullptr),
+        ts_varis_(nullptr),
+        y_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            N_ * T_)) {
+    for (size_t n = 0; n < T_; ++n) {
+      ts_[n] = value_of(ts[n]);
+    }
+    for (size_t i = 0; i < N_; ++i) {
+      y0_[i] = value_of(y0[i]);
+    }
+    if (initial_var::value) {
+      y0_varis_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(N_);
+      for (size_t i = 0; i < N_; ++i) {
+        y0_varis_[i] = to_vari(y0[i]);
+      }
+    }
+    if (param_var::value) {
+      theta_varis_
+          = ChainableStack::instance_->memalloc_.alloc_array<vari*>(M_);
+      for (size_t j = 0; j < M_; ++j) {
+        theta_varis_[j] = to_vari(theta[j]);
+      }
+    }
+    if (t0_var::value) {
+      t0_vari_ = to_vari(t0);
+    }
+    if (ts_var::value) {
+      ts_varis_ = ChainableStack::instance_->memalloc_.alloc_array<vari*>(T_);
+      for (size_t n = 0; n < T_; ++n) {
+        ts_varis_[n] = to_vari(ts[n]);
+      }
+    }
+
+    void* mem = memory_->cvodes_mem_;
+    check_flag_sundials(
+        CVodeInit(mem, &memory_t::cv_rhs, t0_, memory_->nv_state_),
+        "CVodeInit");
+    check_flag_sundials(
+        CVodeSetUserData(mem, reinterpret_cast<void*>(memory_)),
+        "CVodeSetUserData");
+    cvodes_set_options(mem, relative_tolerance, absolute_tolerance,
+                       max_num_steps);
+    check_flag_sundials(
+        CVodeSetLinearSolver(mem, memory_->LS_, memory_->A_),
+        "CVodeSetLinearSolver");
+    check_flag_sundials(CVodeSetJacFn(mem, &memory_t::cv_jacobian_states),
+                        "CVodeSetJacFn");
+    check_flag_sundials(CVodeAdjInit(mem, options.steps_between_checkpoints,
+                                     options.interpolation_polynomial),
+                        "CVodeAdjInit");
+
+    double t_init = t0_;
+    for (size_t n = 0; n < T_; ++n) {
+      int ncheck;
+      check_flag_sundials(CVodeF(mem, ts_[n], memory_->nv_state_, &t_init,
+                                 CV_NORMAL, &ncheck),
+                          "CVodeF");
+      for (size_t i = 0; i < N_; ++i) {
+        y_[n * N_ + i] = memory_->state_[i];
+        y_varis_[n * N_ + i] = new vari(memory_->state_[i], false);
+      }
+      t_init = ts_[n];
+    }
+  }
+
+  /**
+   * Solves the backward problem and propagates the adjoints of the
+   * states at the output times to the initial state, the
+   * parameters, the initial time and the output times.
+   */
+  virtual void chain() {
+    void* mem = memory_->cvodes_mem_;
+    const bool quadrature = param_var::value && M_ > 0;
+    std::vector<double>& lambda = memory_->state_backward_;
+    std::vector<double>& q = memory_->quadrature_;
+    std::fill(lambda.begin(), lambda.end(), 0.0);
+    std::fill(q.begin(), q.end(), 0.0);
+
+    for (size_t n = T_; n-- > 0;) {
+      double adj_dot_f = 0;
+      std::vector<double> f_n;
+      if (ts_var::value) {
+        f_n.resize(N_);
+        memory_->rhs(ts_[n], y_ + n * N_, &f_n[0]);
+      }
+      for (size_t i = 0; i < N_; ++i) {
+        const double adj = y_varis_[n * N_ + i]->adj_;
+        lambda[i] += adj;
+        if (ts_var::value) {
+          adj_dot_f += adj * f_n[i];
+        }
+      }
+      if (ts_var::value) {
+        ts_varis_[n]->adj_ += adj_dot_f;
+      }
+
+      const double t_lower = n > 0 ? ts_[n - 1] : t0_;
+      if (t_lower == ts_[n]) {
+        continue;
+      }
+      if (!memory_->backward_is_initialized_) {
+        initialize_backward(ts_[n]);
+      } else {
+        check_flag_sundials(CVodeReInitB(mem, memory_->index_backward_, ts_[n],
+                                         memory_->nv_state_backward_),
+                            "CVodeReInitB");
+        if (quadrature) {
+          check_flag_sundials(CVodeQuadReInitB(mem, memory_->index_backward_,
+                                               memory_->nv_quadrature_),
+                              "CVodeQuadReInitB");
+        }
+      }
+      check_flag_sundials(CVodeB(mem, t_lower, CV_NORMAL), "CVodeB");
+      double t_ret;
+      check_flag_sundials(CVodeGetB(mem, memory_->index_backward_, &t_ret,
+                                    memory_->nv_state_backward_),
+                          "CVodeGetB");
+      if (quadrature) {
+        check_flag_sundials(CVodeGetQuadB(mem, memory_->index_backward_,
+                                          &t_ret, memory_->nv_quadrature_),
+                            "CVodeGetQuadB");
+      }
+    }
+
+    if (initial_var::value) {
+      for (size_t i = 0; i < N_; ++i) {
+        y0_varis_[i]->adj_ += lambda[i];
+      }
+    }
+    if (param_var::value) {
+      for (size_t j = 0; j < M_; ++j) {
+        theta_varis_[j]->adj_ += q[j];
+      }
+    }
+    if (t0_var::value) {
+      std::vector<double> f_0(N_);
+      memory_->rhs(t0_, y0_, &f_0[0]);
+      double lambda_dot_f = 0;
+      for (size_t i = 0; i < N_; ++i) {
+        lambda_dot_f += lambda[i] * f_0[i];
+      }
+      t0_vari_->adj_ -= lambda_dot_f;
+    }
+  }
+
+ private:
+  static inline vari* to_vari(const var& x) { return x.vi_; }
+
+  static inline vari* to_vari(double x) { return nullptr; }
+
+  /**
+   * Creates the backward problem at the last output time. The
+   * backward problem is kept in the CVODES memory and re-initialized
+   * on subsequent reverse passes.
+   */
+  inline void initialize_backward(double t_final) {
+    void* mem = memory_->cvodes_mem_;
+    const cvodes_adjoint_options& options = memory_->options_;
+    int& which = memory_->index_backward_;
+    check_flag_sundials(CVodeCreateB(mem, Lmm, &which), "CVodeCreateB");
+    check_flag_sundials(CVodeInitB(mem, which, &memory_t::cv_rhs_adj, t_final,
+                                   memory_->nv_state_backward_),
+                        "CVodeInitB");
+    check_flag_sundials(
+        CVodeSStolerancesB(mem, which, options.relative_tolerance_backward,
+                           options.absolute_tolerance_backward),
+        "CVodeSStolerancesB");
+    check_flag_sundials(
+        CVodeSetUserDataB(mem, which, reinterpret_cast<void*>(memory_)),
+        "CVodeSetUserDataB");
+    check_flag_sundials(
+        CVodeSetMaxNumStepsB(mem, which, memory_->max_num_steps_),
+        "CVodeSetMaxNumStepsB");
+    check_flag_sundials(CVodeSetLinearSolverB(mem, which, memory_->LS_backward_,
+                                              memory_->A_backward_),
+                        "CVodeSetLinearSolverB");
+    check_flag_sundials(
+        CVodeSetJacFnB(mem, which, &memory_t::cv_jacobian_adj),
+        "CVodeSetJacFnB");
+    if (param_var::value && M_ > 0) {
+      check_flag_sundials(CVodeQuadInitB(mem, which, &memory_t::cv_quad_rhs_adj,
+                                         memory_->nv_quadrature_),
+                          "CVodeQuadInitB");
+      check_flag_sundials(CVodeQuadSStolerancesB(
+                              mem, which, options.relative_tolerance_quadrature,
+                              options.absolute_tolerance_quadrature),
+                          "CVodeQuadSStolerancesB");
+      check_flag_sundials(CVodeSetQuadErrConB(mem, which, SUNTRUE),
+                          "CVodeSetQuadErrConB");
+    }
+    memory_->backward_is_initialized_ = true;
+  }
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,393 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CVODES_JACOBIAN_HPP
+#define STAN_MATH_REV_FUNCTOR_CVODES_JACOBIAN_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <cvodes/cvodes.h>
+#include <nvector/nvector_serial.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunlinsol/sunlinsol_band.h>
+#include <sunlinsol/sunlinsol_dense.h>
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Tag type selecting the autodiff Jacobian of the ODE RHS wrt to the
+ * states. This is the default for the CVODES integrators.
+ */
+struct ode_autodiff_jacobian {};
+
+/**
+ * Structure of the Jacobian of an ODE RHS wrt to the states.
+ *
+ * The structure selects the linear solver used by the stiff CVODES
+ * integrators and how the autodiff Jacobian is computed:
+ *
+ * - dense: one reverse sweep per state, dense linear solver.
+ * - banded: the Jacobian is zero outside of the given lower and
+ *   upper bandwidths. A banded linear solver is used and the
+ *   autodiff Jacobian needs only <code>lower + upper + 1</code>
+ *   reverse sweeps.
+ * - sparse: the nonzero entries are given as (row, column) pairs.
+ *   The rows are colored such that rows of the same color share no
+ *   column, which allows to compute all rows of a color in a single
+ *   reverse sweep. A banded linear solver is used with the bandwidths
+ *   of the pattern whenever the band is narrower than the full
+ *   matrix.
+ */
+class ode_jacobian_structure {
+ public:
+  enum class kind { dense, banded, sparse };
+
+  /**
+   * Construct a dense Jacobian structure.
+   */
+  ode_jacobian_structure() : kind_(kind::dense), lower_(-1), upper_(-1) {}
+
+  /**
+   * Return a banded Jacobian structure.
+   *
+   * @param lower number of nonzero diagonals below the main diagonal
+   * @param upper number of nonzero diagonals above the main diagonal
+   * @throw std::domain_error if a bandwidth is negative
+   */
+  static ode_jacobian_structure banded(int lower, int upper) {
+    check_nonnegative("ode_jacobian_structure", "lower bandwidth", lower);
+    check_nonnegative("ode_jacobian_structure", "upper bandwidth", upper);
+    ode_jacobian_structure structure;
+    structure.kind_ = kind::banded;
+    structure.lower_ = lower;
+    structure.upper_ = upper;
+    return structure;
+  }
+
+  /**
+   * Return a sparse Jacobian structure.
+   *
+   * @param nonzeros zero-based (row, column) indices of the entries
+   * which may be nonzero
+   * @throw std::domain_error if an index is negative
+   */
+  static ode_jacobian_structure sparse(
+      const std::vector<std::pair<int, int>>& nonzeros) {
+    ode_jacobian_structure structure;
+    structure.kind_ = kind::sparse;
+    structure.lower_ = 0;
+    structure.upper_ = 0;
+    for (const auto& nz : nonzeros) {
+      check_nonnegative("ode_jacobian_structure", "row index", nz.first);
+      check_nonnegative("ode_jacobian_structure", "column index", nz.second);
+      structure.lower_ = std::max(structure.lower_, nz.first - nz.second);
+      structure.upper_ = std::max(structure.upper_, nz.second - nz.first);
+    }
+    structure.nonzeros_ = nonzeros;
+    return structure;
+  }
+
+  /**
+   * Return the kind of this structure.
+   */
+  kind type() const { return kind_; }
+
+  /**
+   * Return true if a banded linear solver is used for a system of
+   * the given size.
+   */
+  bool use_band_solver(size_t N) const {
+    return kind_ != kind::dense
+           && static_cast<size_t>(lower_ + upper_ + 1) < N;
+  }
+
+  /**
+   * Return the lower bandwidth for a system of the given size.
+   */
+  int lower_bandwidth(size_t N) const {
+    return kind_ == kind::dense ? N - 1 : std::min<int>(lower_, N - 1);
+  }
+
+  /**
+   * Return the upper bandwidth for a system of the given size.
+   */
+  int upper_bandwidth(size_t N) const {
+    return kind_ == kind::dense ? N - 1 : std::min<int>(upper_, N - 1);
+  }
+
+  /**
+   * Return a coloring of the rows of the Jacobian such that no two
+   * rows of the same color have a nonzero entry in the same column.
+   * Rows are colored greedily in their natural order.
+   *
+   * @param N number of states
+   * @return color of each row, numbered from zero
+   * @throw std::domain_error if an index of the sparsity pattern is
+   * not smaller than N
+   */
+  std::vector<int> row_colors(size_t N) const {
+    std::vector<int> colors(N);
+    if (kind_ == kind::dense) {
+      for (size_t i = 0; i < N; ++i) {
+        colors[i] = i;
+      }
+      return colors;
+    }
+    if (kind_ == kind::banded) {
+      const size_t width = lower_ + upper_ + 1;
+      for (size_t i = 0; i < N; ++i) {
+        colors[i] = i % width;
+      }
+      return colors;
+    }
+    std::vector<std::vector<int>> row_cols(N);
+    std::vector<std::vector<int>> col_rows(N);
+    for (const auto& nz : nonzeros_) {
+      check_less("ode_jacobian_structure", "row index",
+                 static_cast<size_t>(nz.first), N);
+      check_less("ode_jacobian_structure", "column index",
+                 static_cast<size_t>(nz.second), N);
+      row_cols[nz.first].push_back(nz.second);
+      col_rows[nz.second].push_back(nz.first);
+    }
+    std::vector<int> forbidden(N, -1);
+    for (size_t i = 0; i < N; ++i) {
+      for (int j : row_cols[i]) {
+        for (int k : col_rows[j]) {
+          if (static_cast<size_t>(k) < i) {
+            forbidden[colors[k]] = i;
+          }
+        }
+      }
+      int c = 0;
+      while (forbidden[c] == static_cast<int>(i)) {
+        ++c;
+      }
+      colors[i] = c;
+    }
+    return colors;
+  }
+
+  /**
+   * Return for each column the rows which may have a nonzero entry in
+   * it. The list is only stored for sparse structures; for dense and
+   * banded structures an empty vector is returned and the rows are
+   * given by the bandwidths.
+   *
+   * @param N number of states
+   * @return rows of each column or empty vector
+   */
+  std::vector<std::vector<int>> column_rows(size_t N) const {
+    std::vector<std::vector<int>> col_rows;
+    if (kind_ == kind::sparse) {
+      col_rows.resize(N);
+      for (const auto& nz : nonzeros_) {
+        col_rows[nz.second].push_back(nz.first);
+      }
+    }
+    return col_rows;
+  }
+
+ private:
+  kind kind_;
+  int lower_;
+  int upper_;
+  std::vector<std::pair<int, int>> nonzeros_;
+};
+
+namespace internal {
+
+/**
+ * Allocate the matrix for the Newton iterations of CVODES according
+ * to the Jacobian structure.
+ *
+ * @param structure structure of the Jacobian
+ * @param N number of states
+ * @return dense or banded SUNDIALS matrix
+ */
+inline SUNMatrix cvodes_jacobian_matrix(
+    const ode_jacobian_structure& structure, size_t N) {
+  if (structure.use_band_solver(N)) {
+    const int lower = structure.lower_bandwidth(N);
+    const int upper = structure.upper_bandwidth(N);
+    return SUNBandMatrix(N, upper, lower);
+  }
+  return SUNDenseMatrix(N, N);
+}
+
+/**
+ * Allocate the linear solver matching the matrix returned by
+ * <code>cvodes_jacobian_matrix()</code>.
+ *
+ * @param structure structure of the Jacobian
+ * @param y template vector of the states
+ * @param A matrix of the Newton iterations
+ * @return dense or banded SUNDIALS linear solver
+ */
+inline SUNLinearSolver cvodes_linear_solver(
+    const ode_jacobian_structure& structure, N_Vector y, SUNMatrix A) {
+  if (structure.use_band_solver(NV_LENGTH_S(y))) {
+    return SUNBandLinearSolver(y, A);
+  }
+  return SUNDenseLinearSolver(y, A);
+}
+
+/**
+ * Store the coefficients of a Jacobian within the band of the
+ * structure in a dense or banded SUNDIALS matrix.
+ *
+ * @tparam EigMat type of the Jacobian, dense or sparse Eigen matrix
+ * @param structure structure of the Jacobian
+ * @param Jy Jacobian of the ODE RHS wrt to the states
+ * @param[out] J SUNDIALS matrix
+ */
+template <typename EigMat>
+inline void cvodes_store_jacobian(const ode_jacobian_structure& structure,
+                                  const EigMat& Jy, SUNMatrix J) {
+  const int N = Jy.rows();
+  if (SUNMatGetID(J) == SUNMATRIX_BAND) {
+    const int lower = structure.lower_bandwidth(N);
+    const int upper = structure.upper_bandwidth(N);
+    for (int j = 0; j < N; ++j) {
+      const int i_end = std::min(N - 1, j + lower);
+      for (int i = std::max(0, j - upper); i <= i_end; ++i) {
+        SM_ELEMENT_B(J, i, j) = Jy.coeff(i, j);
+      }
+    }
+  } else {
+    Eigen::Map<Eigen::MatrixXd>(SM_DATA_D(J), N, N) = Jy;
+  }
+}
+
+/**
+ * Calculate the Jacobian of a square system of functions with colored
+ * reverse sweeps. All rows of one color are seeded at once and their
+ * entries are recovered from the adjoints of the arguments, since
+ * within a color at most one row may be nonzero in each column.
+ *
+ * @tparam G type of the system, mapping a <code>std::vector\<var\></code>
+ * to a <code>std::vector\<var\></code> of the same size
+ * @param function name of the calling function for error messages
+ * @param g system of functions
+ * @param y argument
+ * @param structure structure of the Jacobian
+ * @param colors row coloring returned by
+ * <code>structure.row_colors(N)</code>
+ * @param col_rows rows of each column returned by
+ * <code>structure.column_rows(N)</code>
+ * @param[out] J SUNDIALS matrix
+ */
+template <typename G>
+inline void colored_autodiff_jacobian(
+    const char* function, const G& g, const std::vector<double>& y,
+    const ode_jacobian_structure& structure, const std::vector<int>& colors,
+    const std::vector<std::vector<int>>& col_rows, SUNMatrix J) {
+  const int N = y.size();
+  const int lower = structure.lower_bandwidth(N);
+  const int upper = structure.upper_bandwidth(N);
+  const int num_colors
+      = N == 0 ? 0 : *std::max_element(colors.begin(), colors.end()) + 1;
+  const bool band = SUNMatGetID(J) == SUNMATRIX_BAND;
+  SUNMatZero(J);
+
+  start_nested();
+  try {
+    const std::vector<var> y_var(y.begin(), y.end());
+    std::vector<var> f_var = g(y_var);
+    check_size_match(function, "dz_dt", f_var.size(), "states", N);
+    for (int c = 0; c < num_colors; ++c) {
+      set_zero_all_adjoints_nested();
+      for (int i = 0; i < N; ++i) {
+        if (colors[i] == c) {
+          f_var[i].vi_->adj_ = 1.0;
+        }
+      }
+      using it_t = std::vector<vari*>::reverse_iterator;
+      it_t begin = ChainableStack::instance_->var_stack_.rbegin();
+      it_t end = begin + nested_size();
+      for (it_t it = begin; it < end; ++it) {
+        (*it)->chain();
+      }
+      for (int j = 0; j < N; ++j) {
+        const double adj = y_var[j].adj();
+        if (adj == 0.0) {
+          continue;
+        }
+        int row = -1;
+        if (col_rows.empty()) {
+          const int i_end = std::min(N - 1, j + lower);
+          for (int i = std::max(0, j - upper); i <= i_end; ++i) {
+            if (colors[i] == c) {
+              row = i;
+              break;
+            }
+          }
+        } else {
+          for (int i : col_rows[j]) {
+            if (colors[i] == c) {
+              row = i;
+              break;
+            }
+          }
+        }
+        if (row < 0) {
+          continue;
+        }
+        if (band) {
+          SM_ELEMENT_B(J, row, j) = adj;
+        } else {
+          SM_ELEMENT_D(J, row, j) = adj;
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    recover_memory_nested();
+    throw;
+  }
+  recover_memory_nested();
+}
+
+/**
+ * Calculate the Jacobian of the ODE RHS wrt to the states with
+ * colored reverse sweeps.
+ *
+ * @tparam F type of the ODE functor
+ * @param f ODE functor
+ * @param t time
+ * @param y states
+ * @param theta parameters
+ * @param x continuous data
+ * @param x_int integer data
+ * @param msgs stream for messages
+ * @param structure structure of the Jacobian
+ * @param colors row coloring returned by
+ * <code>structure.row_colors(N)</code>
+ * @param col_rows rows of each column returned by
+ * <code>structure.column_rows(N)</code>
+ * @param[out] J SUNDIALS matrix
+ * @see colored_autodiff_jacobian
+ */
+template <typename F>
+inline void cvodes_autodiff_jacobian(
+    const F& f, double t, const std::vector<double>& y,
+    const std::vector<double>& theta, const std::vector<double>& x,
+    const std::vector<int>& x_int, std::ostream* msgs,
+    const ode_jacobian_structure& structure, const std::vector<int>& colors,
+    const std::vector<std::vector<int>>& col_rows, SUNMatrix J) {
+  colored_autodiff_jacobian(
+      "cvodes_autodiff_jacobian",
+      [&](const std::vector<var>& y_var) {
+        return f(t, y_var, theta, x, x_int, msgs);
+      },
+      y, structure, colors, col_rows, J);
+}
+
+}  // namespace internal
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -4,6 +4,7 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/prim/functor/coupled_ode_system.hpp>
 #include <stan/math/rev/functor/coupled_ode_system.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
 #include <cvodes/cvodes.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
@@ -21,9 +22,12 @@ namespace math {
  * @tparam F type of functor for the base ode system.
  * @tparam T_initial type of initial values
  * @tparam T_param type of parameters
+ * @tparam F_jac type of the functor for the Jacobian of the base ode
+ * system wrt to the states or <code>ode_autodiff_jacobian</code>
  */
 
-template <typename F, typename T_initial, typename T_param>
+template <typename F, typename T_initial, typename T_param,
+          typename F_jac = ode_autodiff_jacobian>
 class cvodes_ode_data {
   const F& f_;
   const std::vector<T_initial>& y0_;
@@ -35,8 +39,12 @@ class cvodes_ode_data {
   const std::vector<int>& x_int_;
   std::ostream* msgs_;
   const size_t S_;
+  const ode_jacobian_structure structure_;
+  const F_jac jacobian_;
+  const std::vector<int> colors_;
+  const std::vector<std::vector<int>> column_rows_;
 
-  using ode_data = cvodes_ode_data<F, T_initial, T_param>;
+  using ode_data = cvodes_ode_data<F, T_initial, T_param, F_jac>;
   using initial_var = stan::is_var<T_initial>;
   using param_var = stan::is_var<T_param>;
 
@@ -63,17 +71,30 @@ class cvodes_ode_data {
    * handled within Stan using exceptions such that any thrown error
    * leads to the termination of the ODE integration.
    *
+   * The structure of the Jacobian wrt to the states selects a dense or
+   * banded linear solver and the number of reverse sweeps for the
+   * autodiff Jacobian. If <code>F_jac</code> is not
+   * <code>ode_autodiff_jacobian</code> the Jacobian is computed with
+   * <code>jacobian</code>, which is called with the same arguments as
+   * the ode functor for double states and parameters and returns a
+   * dense or sparse Eigen matrix.
+   *
    * @param[in] f ode functor.
    * @param[in] y0 initial state of the base ode.
    * @param[in] theta parameters of the base ode.
    * @param[in] x continuous data vector for the ODE.
    * @param[in] x_int integer data vector for the ODE.
    * @param[in] msgs stream to which messages are printed.
+   * @param[in] structure structure of the Jacobian wrt to the states.
+   * @param[in] jacobian functor for the Jacobian wrt to the states.
    */
   cvodes_ode_data(const F& f, const std::vector<T_initial>& y0,
                   const std::vector<T_param>& theta,
                   const std::vector<double>& x, const std::vector<int>& x_int,
-                  std::ostream* msgs)
+                  std::ostream* msgs,
+                  const ode_jacobian_structure& structure
+                  = ode_jacobian_structure(),
+                  const F_jac& jacobian = F_jac())
       : f_(f),
         y0_(y0),
         theta_(theta),
@@ -84,12 +105,16 @@ class cvodes_ode_data {
         x_int_(x_int),
         msgs_(msgs),
         S_((initial_var::value ? N_ : 0) + (param_var::value ? M_ : 0)),
+        structure_(structure),
+        jacobian_(jacobian),
+        colors_(structure.row_colors(N_)),
+        column_rows_(structure.column_rows(N_)),
         coupled_ode_(f, y0, theta, x, x_int, msgs),
         coupled_state_(coupled_ode_.initial_state()),
         nv_state_(N_VMake_Serial(N_, &coupled_state_[0])),
         nv_state_sens_(nullptr),
-        A_(SUNDenseMatrix(N_, N_)),
-        LS_(SUNDenseLinearSolver(nv_state_, A_)) {
+        A_(internal::cvodes_jacobian_matrix(structure, N_)),
+        LS_(internal::cvodes_linear_solver(structure, nv_state_, A_)) {
     if (S_ > 0) {
       nv_state_sens_ = N_VCloneVectorArrayEmpty_Serial(S_, nv_state_);
       for (std::size_t i = 0; i < S_; i++) {
@@ -159,22 +184,39 @@ class cvodes_ode_data {
   /**
    * Calculates the jacobian of the ODE RHS wrt to its states y at the
    * given time-point t and state y.
-   * Note that the jacobian of the ODE system is the coupled ode system for
-   * varying states evaluated at the state y whenever we choose state
-   * y to be the initial of the coupled ode system.
    */
   inline int jacobian_states(double t, const double y[], SUNMatrix J) const {
-    start_nested();
-    const std::vector<var> y_vec_var(y, y + N_);
-    coupled_ode_system<F, var, double> ode_jacobian(f_, y_vec_var, theta_dbl_,
-                                                    x_, x_int_, msgs_);
-    std::vector<double>&& jacobian_y = std::vector<double>(ode_jacobian.size());
-    ode_jacobian(ode_jacobian.initial_state(), jacobian_y, t);
-    std::move(jacobian_y.begin() + N_, jacobian_y.end(), SM_DATA_D(J));
-    recover_memory_nested();
+    const std::vector<double> y_vec(y, y + N_);
+    jacobian_states(jacobian_, t, y_vec, J);
     return 0;
   }
 
+  /**
+   * Calculates the jacobian with colored reverse sweeps over the ode
+   * functor.
+   */
+  inline void jacobian_states(const ode_autodiff_jacobian&, double t,
+                              const std::vector<double>& y,
+                              SUNMatrix J) const {
+    internal::cvodes_autodiff_jacobian(f_, t, y, theta_dbl_, x_, x_int_, msgs_,
+                                       structure_, colors_, column_rows_, J);
+  }
+
+  /**
+   * Calculates the jacobian with the user supplied jacobian functor.
+   */
+  template <typename G>
+  inline void jacobian_states(const G& jacobian, double t,
+                              const std::vector<double>& y,
+                              SUNMatrix J) const {
+    const auto& Jy = jacobian(t, y, theta_dbl_, x_, x_int_, msgs_);
+    check_size_match("cvodes_ode_data", "rows of jacobian", Jy.rows(),
+                     "states", N_);
+    check_size_match("cvodes_ode_data", "columns of jacobian", Jy.cols(),
+                     "states", N_);
+    internal::cvodes_store_jacobian(structure_, Jy, J);
+  }
+
   /**
    * Calculates the RHS of the sensitivity ODE system which
    * corresponds to the coupled ode system from which the first N
@@ -0,0 +1,322 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CVODES_SESSION_HPP
+#define STAN_MATH_REV_FUNCTOR_CVODES_SESSION_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/arr/fun/value_of.hpp>
+#include <stan/math/rev/functor/coupled_ode_observer.hpp>
+#include <stan/math/rev/functor/coupled_ode_system.hpp>
+#include <stan/math/rev/functor/cvodes_utils.hpp>
+#include <stan/math/rev/functor/cvodes_ode_data.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
+#include <cvodes/cvodes.h>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Persistent CVODES integration of an ODE system over consecutive
+ * segments of time, between which the state may be reset.
+ *
+ * The CVODES memory, the linear solver and the sensitivity vectors
+ * are allocated once when the session is constructed and are reused
+ * for every segment. Consecutive calls to <code>integrate()</code>
+ * continue the integration where the previous call stopped. Once the
+ * state was changed, for example by the bolus dose of a dosing
+ * schedule, the next segment restarts CVODES from the changed state
+ * with <code>CVodeReInit</code> and <code>CVodeSensReInit</code>
+ * instead of allocating a new solver.
+ *
+ * The sensitivities wrt to the initial state and the parameters are
+ * carried across every reset. Adding data to a state leaves its
+ * sensitivities unchanged, replacing a state by data sets them to
+ * zero and adding a parameter to a state adds one to the sensitivity
+ * of that state wrt to the parameter. Doses which depend on autodiff
+ * variables must therefore be passed as parameters. The solutions of
+ * all segments are autodiff variables whenever the initial state or
+ * the parameters are.
+ *
+ * The session keeps copies of its arguments. It can not be copied
+ * and must not be used once <code>integrate()</code> threw.
+ *
+ * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
+ * @tparam F type of ODE system function.
+ * @tparam T_initial type of scalars for initial values.
+ * @tparam T_param type of scalars for parameters.
+ * @tparam F_jac type of the functor for the Jacobian of the ODE RHS
+ * wrt to the states or <code>ode_autodiff_jacobian</code>
+ */
+template <int Lmm, typename F, typename T_initial, typename T_param,
+          typename F_jac = ode_autodiff_jacobian>
+class cvodes_session {
+  using ode_data = cvodes_ode_data<F, T_initial, T_param, F_jac>;
+  using return_t = return_type_t<T_initial, T_param>;
+  using initial_var = stan::is_var<T_initial>;
+  using param_var = stan::is_var<T_param>;
+
+  const F f_;
+  const std::vector<T_initial> y0_;
+  const std::vector<T_param> theta_;
+  const std::vector<double> x_;
+  const std::vector<int> x_int_;
+  std::ostream* msgs_;
+  const size_t N_;
+  const size_t M_;
+  const size_t S_;
+  double t_;
+  bool reinit_;
+  ode_data cvodes_data_;
+  void* cvodes_mem_;
+
+ public:
+  /**
+   * Construct a session starting at the specified initial state and
+   * time and allocate the CVODES memory.
+   *
+   * @param[in] f functor for the base ordinary differential equation.
+   * @param[in] y0 initial state.
+   * @param[in] t0 initial time.
+   * @param[in] theta parameter vector for the ODE.
+   * @param[in] x continuous data vector for the ODE.
+   * @param[in] x_int integer data vector for the ODE.
+   * @param[in, out] msgs the print stream for warning messages.
+   * @param[in] relative_tolerance relative tolerance passed to CVODE.
+   * @param[in] absolute_tolerance absolute tolerance passed to CVODE.
+   * @param[in] max_num_steps maximal number of admissable steps
+   * between time-points
+   * @param[in] structure structure of the Jacobian of the ODE RHS wrt
+   * to the states, which selects a dense or banded linear solver.
+   * @param[in] jacobian functor for the Jacobian of the ODE RHS wrt
+   * to the states; see <code>cvodes_ode_data</code>.
+   */
+  cvodes_session(const F& f, const std::vector<T_initial>& y0, double t0,
+                 const std::vector<T_param>& theta,
+                 const std::vector<double>& x, const std::vector<int>& x_int,
+                 std::ostream* msgs = nullptr,
+                 double relative_tolerance = 1e-10,
+                 double absolute_tolerance = 1e-10,
+                 long int max_num_steps = 1e8,  // NOLINT(runtime/int)
+                 const ode_jacobian_structure& structure
+                 = ode_jacobian_structure(),
+                 const F_jac& jacobian = F_jac())
+      : f_(f),
+        y0_(check_arguments(y0, t0, theta, x, relative_tolerance,
+                            absolute_tolerance, max_num_steps)),
+        theta_(theta),
+        x_(x),
+        x_int_(x_int),
+        msgs_(msgs),
+        N_(y0.size()),
+        M_(theta.size()),
+        S_((initial_var::value ? N_ : 0) + (param_var::value ? M_ : 0)),
+        t_(t0),
+        reinit_(false),
+        cvodes_data_(f_, y0_, theta_, x_, x_int_, msgs_, structure, jacobian),
+        cvodes_mem_(nullptr) {
+    cvodes_mem_ = CVodeCreate(Lmm);
+    if (cvodes_mem_ == nullptr) {
+      throw std::runtime_error("CVodeCreate failed to allocate memory");
+    }
+
+    try {
+      check_flag_sundials(CVodeInit(cvodes_mem_, &ode_data::cv_rhs, t_,
+                                    cvodes_data_.nv_state_),
+                          "CVodeInit");
+      check_flag_sundials(
+          CVodeSetUserData(cvodes_mem_, reinterpret_cast<void*>(&cvodes_data_)),
+          "CVodeSetUserData");
+      cvodes_set_options(cvodes_mem_, relative_tolerance, absolute_tolerance,
+                         max_num_steps);
+      check_flag_sundials(CVodeSetLinearSolver(cvodes_mem_, cvodes_data_.LS_,
+                                               cvodes_data_.A_),
+                          "CVodeSetLinearSolver");
+      check_flag_sundials(
+          CVodeSetJacFn(cvodes_mem_, &ode_data::cv_jacobian_states),
+          "CVodeSetJacFn");
+      if (S_ > 0) {
+        check_flag_sundials(
+            CVodeSensInit(cvodes_mem_, static_cast<int>(S_), CV_STAGGERED,
+                          &ode_data::cv_rhs_sens, cvodes_data_.nv_state_sens_),
+            "CVodeSensInit");
+        check_flag_sundials(CVodeSensEEtolerances(cvodes_mem_),
+                            "CVodeSensEEtolerances");
+      }
+    } catch (const std::exception& e) {
+      CVodeFree(&cvodes_mem_);
+      throw;
+    }
+  }
+
+  cvodes_session(const cvodes_session&) = delete;
+  cvodes_session& operator=(const cvodes_session&) = delete;
+
+  ~cvodes_session() { CVodeFree(&cvodes_mem_); }
+
+  /**
+   * Return the time the session has been integrated to.
+   */
+  double time() const { return t_; }
+
+  /**
+   * Integrate the ODE from the current time of the session and return
+   * the solutions at the specified times, after which the current
+   * time is the last of these times.
+   *
+   * @param[in] ts times of the desired solutions, in strictly
+   * increasing order, all greater than the current time.
+   * @return a vector of states, each state being a vector of the
+   * same size as the state variable, corresponding to a time in ts.
+   */
+  std::vector<std::vector<return_t>> integrate(const std::vector<double>& ts) {
+    const char* fun = "cvodes_session";
+    check_finite(fun, "times", ts);
+    check_nonzero_size(fun, "times", ts);
+    check_ordered(fun, "times", ts);
+    check_less(fun, "current time", t_, ts[0]);
+
+    if (reinit_) {
+      check_flag_sundials(CVodeReInit(cvodes_mem_, t_, cvodes_data_.nv_state_),
+                          "CVodeReInit");
+      if (S_ > 0) {
+        check_flag_sundials(CVodeSensReInit(cvodes_mem_, CV_STAGGERED,
+                                            cvodes_data_.nv_state_sens_),
+                            "CVodeSensReInit");
+      }
+      reinit_ = false;
+    }
+
+    std::vector<std::vector<return_t>> y;
+    const double t_start = t_;
+    coupled_ode_observer<F, T_initial, T_param, double, double> observer(
+        f_, y0_, theta_, t_start, ts, x_, x_int_, msgs_, y);
+    for (size_t n = 0; n < ts.size(); ++n) {
+      double t_final = ts[n];
+      check_flag_sundials(CVode(cvodes_mem_, t_final, cvodes_data_.nv_state_,
+                                &t_, CV_NORMAL),
+                          "CVode");
+      if (S_ > 0) {
+        check_flag_sundials(
+            CVodeGetSens(cvodes_mem_, &t_, cvodes_data_.nv_state_sens_),
+            "CVodeGetSens");
+      }
+      observer(cvodes_data_.coupled_state_, t_final);
+      t_ = t_final;
+    }
+    return y;
+  }
+
+  /**
+   * Add data to a state at the current time, as for a bolus dose.
+   * The sensitivities of the state are unchanged.
+   *
+   * @param[in] i index of the state, starting at zero
+   * @param[in] amount amount added to the state
+   */
+  void add_to_state(size_t i, double amount) {
+    check_state_index(i);
+    check_finite("cvodes_session", "amount", amount);
+    cvodes_data_.coupled_state_[i] += amount;
+    reinit_ = true;
+  }
+
+  /**
+   * Replace a state at the current time by data. The sensitivities of
+   * the state are set to zero.
+   *
+   * @param[in] i index of the state, starting at zero
+   * @param[in] value new value of the state
+   */
+  void set_state(size_t i, double value) {
+    check_state_index(i);
+    check_finite("cvodes_session", "value", value);
+    std::vector<double>& z = cvodes_data_.coupled_state_;
+    z[i] = value;
+    for (size_t s = 0; s < S_; ++s) {
+      z[N_ + N_ * s + i] = 0;
+    }
+    reinit_ = true;
+  }
+
+  /**
+   * Add a multiple of a parameter to a state at the current time, as
+   * for a bolus dose whose amount is a parameter. The sensitivity of
+   * the state wrt to the parameter increases by the multiple.
+   *
+   * @param[in] i index of the state, starting at zero
+   * @param[in] j index of the parameter, starting at zero
+   * @param[in] scale multiple of the parameter added to the state
+   */
+  void add_parameter_to_state(size_t i, size_t j, double scale = 1) {
+    check_state_index(i);
+    check_less("cvodes_session", "parameter index", j, M_);
+    check_finite("cvodes_session", "scale", scale);
+    std::vector<double>& z = cvodes_data_.coupled_state_;
+    z[i] += scale * value_of(theta_[j]);
+    if (param_var::value) {
+      const size_t s = (initial_var::value ? N_ : 0) + j;
+      z[N_ + N_ * s + i] += scale;
+    }
+    reinit_ = true;
+  }
+
+ private:
+  /**
+   * Check the arguments of the constructor and return the initial
+   * state. This runs when the initial state is copied, before
+   * <code>cvodes_data_</code> creates any SUNDIALS object.
+   */
+  static const std::vector<T_initial>& check_arguments(
+      const std::vector<T_initial>& y0, double t0,
+      const std::vector<T_param>& theta, const std::vector<double>& x,
+      double relative_tolerance, double absolute_tolerance,
+      long int max_num_steps) {  // NOLINT(runtime/int)
+    const char* fun = "cvodes_session";
+    check_finite(fun, "initial state", y0);
+    check_finite(fun, "initial time", t0);
+    check_finite(fun, "parameter vector", theta);
+    check_finite(fun, "continuous data", x);
+    check_nonzero_size(fun, "initial state", y0);
+    if (relative_tolerance <= 0) {
+      invalid_argument(fun, "relative_tolerance,", relative_tolerance, "",
+                       ", must be greater than 0");
+    }
+    if (absolute_tolerance <= 0) {
+      invalid_argument(fun, "absolute_tolerance,", absolute_tolerance, "",
+                       ", must be greater than 0");
+    }
+    if (max_num_steps <= 0) {
+      invalid_argument(fun, "max_num_steps,", max_num_steps, "",
+                       ", must be greater than 0");
+    }
+    return y0;
+  }
+
+  void check_state_index(size_t i) const {
+    check_less("cvodes_session", "state index", i, N_);
+  }
+};
+
+/**
+ * Persistent session of the CVODES BDF integrator.
+ *
+ * @see cvodes_session
+ */
+template <typename F, typename T_initial, typename T_param,
+          typename F_jac = ode_autodiff_jacobian>
+using ode_bdf_session = cvodes_session<CV_BDF, F, T_initial, T_param, F_jac>;
+
+/**
+ * Persistent session of the CVODES Adams integrator.
+ *
+ * @see cvodes_session
+ */
+template <typename F, typename T_initial, typename T_param,
+          typename F_jac = ode_autodiff_jacobian>
+using ode_adams_session
+    = cvodes_session<CV_ADAMS, F, T_initial, T_param, F_jac>;
+
+}  // namespace math
+}  // namespace stan
+#endif
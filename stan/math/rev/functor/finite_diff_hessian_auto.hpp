@@ -0,0 +1,110 @@
+#ifndef STAN_MATH_REV_FUNCTOR_FINITE_DIFF_HESSIAN_AUTO_HPP
+#define STAN_MATH_REV_FUNCTOR_FINITE_DIFF_HESSIAN_AUTO_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/gradient.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/functor/finite_diff_gradient_auto.hpp>
+#include <stan/math/prim/scal/fun/finite_diff_stepsize.hpp>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Calculate the value, the gradient and the Hessian of the specified
+ * function at the specified argument using finite differences of
+ * gradients computed with reverse mode autodiff, automatically setting
+ * the stepsize between the gradient evaluations along a dimension.
+ *
+ * <p>The functor must implement
+ *
+ * <code>
+ * var operator()(const Eigen::Matrix<var, Eigen::Dynamic, 1>&)
+ * </code>
+ *
+ * <p>Column `i` of the Hessian is the derivative of the gradient
+ * along dimension `i`, for which the central stencil takes 6 gradients
+ * with the sixth order differences of `finite_diff_gradient_auto` and
+ * the forward stencil takes a single gradient at a step of
+ * `sqrt(epsilon) * max(1, abs(x(i)))` and reuses the gradient at the
+ * argument. The result is symmetrized.
+ *
+ * <p>If parallel evaluation is requested and `STAN_THREADS` is
+ * defined, the columns are split over the threads of the TBB with
+ * `tbb::parallel_for`. Every gradient is then computed in a nested
+ * autodiff region on the tape of the thread computing it, such that
+ * the functor must be safe to call concurrently.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[out] fx Function applied to argument
+ * @param[out] grad_fx Gradient of function at argument
+ * @param[out] hess_fx Hessian of function at argument
+ * @param[in] stencil finite difference stencil
+ * @param[in] parallel whether to evaluate the columns in parallel
+ */
+template <typename F>
+void finite_diff_hessian_auto(
+    const F& f, const Eigen::VectorXd& x, double& fx, Eigen::VectorXd& grad_fx,
+    Eigen::MatrixXd& hess_fx,
+    finite_diff_stencil stencil = finite_diff_stencil::central,
+    bool parallel = false) {
+  int d = x.size();
+  gradient(f, x, fx, grad_fx);
+  hess_fx.resize(d, d);
+
+  finite_diff_for_each(d, parallel, [&](const tbb::blocked_range<size_t>& r) {
+    Eigen::VectorXd x_temp(x);
+    double f_temp;
+    Eigen::VectorXd g_temp(d);
+    for (size_t i = r.begin(); i < r.end(); ++i) {
+      if (stencil == finite_diff_stencil::forward) {
+        const double h = finite_diff_forward_stepsize(x(i));
+        x_temp(i) = x(i) + h;
+        gradient(f, x_temp, f_temp, g_temp);
+        hess_fx.col(i) = (g_temp - grad_fx) / h;
+        x_temp(i) = x(i);
+        continue;
+      }
+      const double h = finite_diff_stepsize(x(i));
+      Eigen::VectorXd delta_g = Eigen::VectorXd::Zero(d);
+
+      x_temp(i) = x(i) + 3 * h;
+      gradient(f, x_temp, f_temp, g_temp);
+      delta_g += g_temp;
+
+      x_temp(i) = x(i) + 2 * h;
+      gradient(f, x_temp, f_temp, g_temp);
+      delta_g -= 9 * g_temp;
+
+      x_temp(i) = x(i) + h;
+      gradient(f, x_temp, f_temp, g_temp);
+      delta_g += 45 * g_temp;
+
+      x_temp(i) = x(i) + -3 * h;
+      gradient(f, x_temp, f_temp, g_temp);
+      delta_g -= g_temp;
+
+      x_temp(i) = x(i) + -2 * h;
+      gradient(f, x_temp, f_temp, g_temp);
+      delta_g += 9 * g_temp;
+
+      x_temp(i) = x(i) - h;
+      gradient(f, x_temp, f_temp, g_temp);
+      delta_g -= 45 * g_temp;
+
+      x_temp(i) = x(i);
+      hess_fx.col(i) = delta_g / (60 * h);
+    }
+  });
+
+  hess_fx = 0.5 * (hess_fx + hess_fx.transpose()).eval();
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
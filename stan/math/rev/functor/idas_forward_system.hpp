@@ -43,14 +43,18 @@ class idas_forward_system : public idas_system<F, Tyy, Typ, Tpar> {
    * @param[in] x_r continuous data vector for the DAE
    * @param[in] x_i integer data vector for the DAE
    * @param[in] msgs stream to which messages are printed
+   * @param[in] structure structure of the iteration matrix
+   * dF/dyy + c_j * dF/dyp, which selects the linear solver
    */
   idas_forward_system(const F& f, const std::vector<int>& eq_id,
                       const std::vector<Tyy>& yy0, const std::vector<Typ>& yp0,
                       const std::vector<Tpar>& theta,
                       const std::vector<double>& x_r,
-                      const std::vector<int>& x_i, std::ostream* msgs)
+                      const std::vector<int>& x_i, std::ostream* msgs,
+                      const ode_jacobian_structure& structure
+                      = ode_jacobian_structure())
       : idas_system<F, Tyy, Typ, Tpar>(f, eq_id, yy0, yp0, theta, x_r, x_i,
-                                       msgs) {
+                                       msgs, structure) {
     if (this->need_sens) {
       nv_yys_ = N_VCloneVectorArray(this->ns_, this->nv_yy_);
       nv_yps_ = N_VCloneVectorArray(this->ns_, this->nv_yp_);
@@ -3,12 +3,13 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/prim/err.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
 #include <stan/math/rev/functor/idas_forward_system.hpp>
+#include <stan/math/rev/functor/idas_integrator_adjoint.hpp>
 #include <idas/idas.h>
-#include <sunmatrix/sunmatrix_dense.h>
-#include <sunlinsol/sunlinsol_dense.h>
 #include <nvector/nvector_serial.h>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 #include <algorithm>
 
@@ -39,13 +40,6 @@ class idas_integrator {
   template <typename F>
   void init_sensitivity(idas_forward_system<F, double, double, double>& dae) {}
 
-  // \cond
-  // template <typename F, typename Tyy, typename Typ, typename Tpar>
-  // void init_sensitivity(idas_adjoint_system<F, Tyy, Typ, Tpar>& dae) {
-  // TODO(yizhang): adjoint sensitivity initialization
-  // }
-  // \endcond
-
   /**
    *  idas adjoint sens calculation requires different initialization
    *
@@ -67,7 +61,55 @@ class idas_integrator {
   void solve(Dae& dae, const double& t0, const std::vector<double>& ts,
              typename Dae::return_type& res_yy);
 
-  // TODO(yizhang): adjoint sensitivity solver
+  /**
+   * Check the initial time and the times of the desired solutions.
+   *
+   * @param[in] t0 initial time.
+   * @param[in] ts times of the desired solutions
+   */
+  static void check_times(double t0, const std::vector<double>& ts) {
+    static const char* caller = "idas_integrator";
+    check_finite(caller, "initial time", t0);
+    check_finite(caller, "times", ts);
+    check_ordered(caller, "times", ts);
+    check_nonzero_size(caller, "times", ts);
+    check_less(caller, "initial time", t0, ts.front());
+  }
+
+  template <typename F>
+  std::vector<std::vector<double> > integrate_adjoint(
+      std::true_type, const F& f, const std::vector<double>& yy0,
+      const std::vector<double>& yp0, double t0,
+      const std::vector<double>& ts, const std::vector<double>& theta,
+      const std::vector<double>& x_r, const std::vector<int>& x_i,
+      std::ostream* msgs, const idas_adjoint_options& options,
+      const ode_jacobian_structure& structure) {
+    const std::vector<int> dummy_eq_id(yy0.size(), 0);
+    idas_forward_system<F, double, double, double> dae{
+        f, dummy_eq_id, yy0, yp0, theta, x_r, x_i, msgs, structure};
+    return integrate(dae, t0, ts);
+  }
+
+  template <typename F>
+  std::vector<std::vector<var> > integrate_adjoint(
+      std::false_type, const F& f, const std::vector<double>& yy0,
+      const std::vector<double>& yp0, double t0,
+      const std::vector<double>& ts, const std::vector<var>& theta,
+      const std::vector<double>& x_r, const std::vector<int>& x_i,
+      std::ostream* msgs, const idas_adjoint_options& options,
+      const ode_jacobian_structure& structure) {
+    auto* vi = new idas_integrator_adjoint_vari<F>(
+        f, yy0, yp0, t0, ts, theta, x_r, x_i, msgs, rtol_, atol_,
+        max_num_steps_, options, structure);
+    const size_t N = yy0.size();
+    std::vector<std::vector<var> > yy(ts.size(), std::vector<var>(N));
+    for (size_t n = 0; n < ts.size(); ++n) {
+      for (size_t i = 0; i < N; ++i) {
+        yy[n][i] = var(vi->yy_varis_[n * N + i]);
+      }
+    }
+    return yy;
+  }
 
  public:
   static constexpr int IDAS_MAX_STEPS = 500;
@@ -121,12 +163,7 @@ class idas_integrator {
     using Eigen::MatrixXd;
     using Eigen::VectorXd;
 
-    static const char* caller = "idas_integrator";
-    check_finite(caller, "initial time", t0);
-    check_finite(caller, "times", ts);
-    check_ordered(caller, "times", ts);
-    check_nonzero_size(caller, "times", ts);
-    check_less(caller, "initial time", t0, ts.front());
+    check_times(t0, ts);
 
     auto mem = dae.mem();
     auto yy = dae.nv_yy();
@@ -136,14 +173,18 @@ class idas_integrator {
     typename Dae::return_type res_yy(
         ts.size(), std::vector<typename Dae::scalar_type>(n, 0));
 
-    auto A = SUNDenseMatrix(n, n);
-    auto LS = SUNDenseLinearSolver(yy, A);
+    const ode_jacobian_structure& structure = dae.jacobian_structure();
+    auto A = internal::cvodes_jacobian_matrix(structure, n);
+    auto LS = internal::cvodes_linear_solver(structure, yy, A);
 
     try {
       CHECK_IDAS_CALL(IDASetUserData(mem, dae.to_user_data()));
 
       CHECK_IDAS_CALL(IDAInit(mem, dae.residual(), t0, yy, yp));
       CHECK_IDAS_CALL(IDASetLinearSolver(mem, LS, A));
+      if (structure.type() != ode_jacobian_structure::kind::dense) {
+        CHECK_IDAS_CALL(IDASetJacFn(mem, dae.jacobian()));
+      }
       CHECK_IDAS_CALL(IDASStolerances(mem, rtol_, atol_));
       CHECK_IDAS_CALL(IDASetMaxNumSteps(mem, max_num_steps_));
 
@@ -161,6 +202,69 @@ class idas_integrator {
 
     return res_yy;
   }
+
+  /**
+   * Return the solutions for the specified DAE computed with the
+   * adjoint sensitivity method, given the initial state, initial
+   * time, times of desired solutions, parameters and data.
+   *
+   * The forward problem is solved with checkpointing and without
+   * sensitivity unknowns. The gradients wrt to the parameters are
+   * computed on the reverse pass by a single backward DAE and M
+   * quadratures, whose cost does not grow with the number of
+   * parameters times the number of unknowns as it does for forward
+   * sensitivities. The residual must be linear in the derivatives
+   * with a constant Jacobian dF/dyp.
+   *
+   * @tparam F type of DAE residual functor
+   * @tparam Tpar scalar type of parameters
+   * @param[in] f DAE residual functor
+   * @param[in] yy0 initial state
+   * @param[in] yp0 initial derivative state
+   * @param[in] t0 initial time
+   * @param[in] ts times of the desired solutions, in strictly
+   * increasing order, all greater than the initial time
+   * @param[in] theta parameters
+   * @param[in] x_r real data
+   * @param[in] x_i int data
+   * @param[in] msgs message stream
+   * @param[in] options tolerances and checkpointing of the backward
+   * problem
+   * @param[in] structure structure of the iteration matrix
+   * dF/dyy + c_j * dF/dyp, which selects the linear solvers
+   * @return a vector of states, each state being a vector of the
+   * same size as the state variable, corresponding to a time in ts.
+   */
+  template <typename F, typename Tpar>
+  std::vector<std::vector<Tpar> > integrate_adjoint(
+      const F& f, const std::vector<double>& yy0,
+      const std::vector<double>& yp0, double t0,
+      const std::vector<double>& ts, const std::vector<Tpar>& theta,
+      const std::vector<double>& x_r, const std::vector<int>& x_i,
+      std::ostream* msgs, const idas_adjoint_options& options,
+      const ode_jacobian_structure& structure = ode_jacobian_structure()) {
+    static const char* caller = "idas_integrator";
+    check_times(t0, ts);
+    check_finite(caller, "initial state", yy0);
+    check_finite(caller, "derivative initial state", yp0);
+    check_finite(caller, "parameter vector", theta);
+    check_finite(caller, "continuous data", x_r);
+    check_nonzero_size(caller, "initial state", yy0);
+    check_consistent_sizes(caller, "initial state", yy0,
+                           "derivative initial state", yp0);
+    check_positive(caller, "relative_tolerance_backward",
+                   options.relative_tolerance_backward);
+    check_positive(caller, "absolute_tolerance_backward",
+                   options.absolute_tolerance_backward);
+    check_positive(caller, "relative_tolerance_quadrature",
+                   options.relative_tolerance_quadrature);
+    check_positive(caller, "absolute_tolerance_quadrature",
+                   options.absolute_tolerance_quadrature);
+    check_positive(caller, "steps_between_checkpoints",
+                   options.steps_between_checkpoints);
+    return integrate_adjoint(std::is_same<Tpar, double>(), f, yy0, yp0, t0,
+                             ts, theta, x_r, x_i, msgs, options, structure);
+  }
 };  // idas integrator
 
 /**
@@ -0,0 +1,690 @@
+#ifndef STAN_MATH_REV_FUNCTOR_IDAS_INTEGRATOR_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_IDAS_INTEGRATOR_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/arr/fun/value_of.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/rev/functor/checkpoint.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
+#include <stan/math/rev/functor/idas_system.hpp>
+#include <idas/idas.h>
+#include <nvector/nvector_serial.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Options for the adjoint sensitivity mode of the IDAS integrator.
+ *
+ * In adjoint mode the forward problem is solved without any
+ * sensitivity states while IDAS stores checkpoints of the forward
+ * solution. On the reverse pass a single backward DAE of size N (the
+ * number of unknowns) is solved together with quadratures of size M
+ * (the number of parameters), instead of the N * M sensitivity
+ * unknowns of the forward mode.
+ */
+struct idas_adjoint_options {
+  /**
+   * Relative tolerance of the backward (adjoint) problem.
+   */
+  double relative_tolerance_backward = 1e-10;
+
+  /**
+   * Absolute tolerance of the backward (adjoint) problem.
+   */
+  double absolute_tolerance_backward = 1e-10;
+
+  /**
+   * Relative tolerance of the quadratures for the parameter
+   * gradients.
+   */
+  double relative_tolerance_quadrature = 1e-10;
+
+  /**
+   * Absolute tolerance of the quadratures for the parameter
+   * gradients.
+   */
+  double absolute_tolerance_quadrature = 1e-10;
+
+  /**
+   * Number of integration steps between two consecutive checkpoints
+   * of the forward solution.
+   */
+  long int steps_between_checkpoints = 150;  // NOLINT(runtime/int)
+
+  /**
+   * Interpolation used to evaluate the forward solution between
+   * checkpoints, either <code>IDA_HERMITE</code> or
+   * <code>IDA_POLYNOMIAL</code>.
+   */
+  int interpolation_polynomial = IDA_HERMITE;
+};
+
+/**
+ * Holds the IDAS memory of an adjoint mode DAE solve from the forward
+ * pass until the reverse pass, together with copies of everything
+ * the user functor needs.
+ *
+ * For the DAE F(t, yy, yp, theta) = 0 the backward problem is
+ *
+ *   dF/dyp^T lambda' - dF/dyy^T lambda = 0
+ *
+ * with quadratures lambda^T dF/dtheta, which assumes that the
+ * residual is linear in yp with a constant matrix dF/dyp, as for
+ * semi-explicit DAEs and method of lines discretizations.
+ *
+ * It is derived from <code>chainable_alloc</code> so that the IDAS
+ * resources are released when the autodiff memory is recovered.
+ *
+ * @tparam F type of functor for DAE residual
+ */
+template <typename F>
+class idas_adjoint_memory : public chainable_alloc {
+  using memory_t = idas_adjoint_memory<F>;
+
+ public:
+  const F f_;
+  const size_t N_;
+  const size_t M_;
+  const std::vector<double> theta_dbl_;
+  const std::vector<double> x_r_;
+  const std::vector<int> x_i_;
+  std::ostream* msgs_;
+  const idas_adjoint_options options_;
+  const long int max_num_steps_;  // NOLINT(runtime/int)
+  const ode_jacobian_structure structure_;
+  const std::vector<int> colors_;
+  const std::vector<std::vector<int>> column_rows_;
+  std::vector<double> yy_;
+  std::vector<double> yp_;
+  std::vector<double> yy_backward_;
+  std::vector<double> yp_backward_;
+  std::vector<double> quadrature_;
+  void* mem_;
+  N_Vector nv_yy_;
+  N_Vector nv_yp_;
+  N_Vector nv_yy_backward_;
+  N_Vector nv_yp_backward_;
+  N_Vector nv_quadrature_;
+  SUNMatrix A_;
+  SUNLinearSolver LS_;
+  SUNMatrix A_backward_;
+  SUNLinearSolver LS_backward_;
+  SUNMatrix J_work_;
+  Eigen::MatrixXd mass_;
+  Eigen::MatrixXd left_null_;
+  Eigen::MatrixXd right_null_;
+  int index_backward_;
+  bool backward_is_initialized_;
+
+  idas_adjoint_memory(const F& f, const std::vector<double>& yy0,
+                      const std::vector<double>& yp0,
+                      const std::vector<double>& theta_dbl,
+                      const std::vector<double>& x_r,
+                      const std::vector<int>& x_i, std::ostream* msgs,
+                      const idas_adjoint_options& options,
+                      long int max_num_steps,  // NOLINT(runtime/int)
+                      const ode_jacobian_structure& structure)
+      : f_(f),
+        N_(yy0.size()),
+        M_(theta_dbl.size()),
+        theta_dbl_(theta_dbl),
+        x_r_(x_r),
+        x_i_(x_i),
+        msgs_(msgs),
+        options_(options),
+        max_num_steps_(max_num_steps),
+        structure_(structure),
+        colors_(structure.row_colors(N_)),
+        column_rows_(structure.column_rows(N_)),
+        yy_(yy0),
+        yp_(yp0),
+        yy_backward_(N_, 0.0),
+        yp_backward_(N_, 0.0),
+        quadrature_(M_, 0.0),
+        mem_(IDACreate()),
+        nv_yy_(N_VMake_Serial(N_, &yy_[0])),
+        nv_yp_(N_VMake_Serial(N_, &yp_[0])),
+        nv_yy_backward_(N_VMake_Serial(N_, &yy_backward_[0])),
+        nv_yp_backward_(N_VMake_Serial(N_, &yp_backward_[0])),
+        nv_quadrature_(nullptr),
+        A_(internal::cvodes_jacobian_matrix(structure, N_)),
+        LS_(internal::cvodes_linear_solver(structure, nv_yy_, A_)),
+        A_backward_(backward_matrix(structure, N_)),
+        LS_backward_(internal::cvodes_linear_solver(
+            structure, nv_yy_backward_, A_backward_)),
+        J_work_(internal::cvodes_jacobian_matrix(structure, N_)),
+        index_backward_(0),
+        backward_is_initialized_(false) {
+    if (mem_ == nullptr) {
+      throw std::runtime_error("IDACreate failed to allocate memory");
+    }
+    if (M_ > 0) {
+      nv_quadrature_ = N_VMake_Serial(M_, &quadrature_[0]);
+    }
+  }
+
+  ~idas_adjoint_memory() {
+    SUNLinSolFree(LS_backward_);
+    SUNMatDestroy(A_backward_);
+    SUNLinSolFree(LS_);
+    SUNMatDestroy(A_);
+    SUNMatDestroy(J_work_);
+    N_VDestroy_Serial(nv_yy_);
+    N_VDestroy_Serial(nv_yp_);
+    N_VDestroy_Serial(nv_yy_backward_);
+    N_VDestroy_Serial(nv_yp_backward_);
+    if (nv_quadrature_ != nullptr) {
+      N_VDestroy_Serial(nv_quadrature_);
+    }
+    IDAFree(&mem_);
+  }
+
+  /**
+   * Implements the function of type IDAResFn which is the
+   * user-defined DAE residual passed to IDAS.
+   */
+  static int ida_residual(realtype t, N_Vector yy, N_Vector yp, N_Vector rr,
+                          void* user_data) {
+    const memory_t* memory = static_cast<const memory_t*>(user_data);
+    memory->residual(t, NV_DATA_S(yy), NV_DATA_S(yp), NV_DATA_S(rr));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type IDAResFnB which is the residual
+   * of the backward (adjoint) DAE, dF/dyp^T ypB - dF/dyy^T yyB.
+   */
+  static int ida_residual_adj(realtype t, N_Vector yy, N_Vector yp,
+                              N_Vector yyB, N_Vector ypB, N_Vector rrB,
+                              void* user_dataB) {
+    const memory_t* memory = static_cast<const memory_t*>(user_dataB);
+    const size_t N = memory->N_;
+    std::vector<double> yyB_J_yy(N);
+    memory->vector_jacobian(t, NV_DATA_S(yy), NV_DATA_S(yp), NV_DATA_S(yyB),
+                            NV_DATA_S(ypB), &yyB_J_yy[0], NV_DATA_S(rrB),
+                            nullptr);
+    for (size_t i = 0; i < N; ++i) {
+      NV_Ith_S(rrB, i) -= yyB_J_yy[i];
+    }
+    return 0;
+  }
+
+  /**
+   * Implements the function of type IDAQuadRhsFnB which is the RHS
+   * of the quadratures for the parameter gradients, yyB^T dF/dtheta.
+   */
+  static int ida_quad_rhs_adj(realtype t, N_Vector yy, N_Vector yp,
+                              N_Vector yyB, N_Vector ypB, N_Vector qBdot,
+                              void* user_dataB) {
+    const memory_t* memory = static_cast<const memory_t*>(user_dataB);
+    std::vector<double> yyB_J_yy(memory->N_);
+    memory->vector_jacobian(t, NV_DATA_S(yy), NV_DATA_S(yp), NV_DATA_S(yyB),
+                            nullptr, &yyB_J_yy[0], nullptr, NV_DATA_S(qBdot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type IDALsJacFn which computes the
+   * iteration matrix dF/dyy + c_j * dF/dyp with colored reverse
+   * sweeps.
+   */
+  static int ida_jacobian(realtype t, realtype cj, N_Vector yy, N_Vector yp,
+                          N_Vector rr, SUNMatrix J, void* user_data,
+                          N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
+    const memory_t* memory = static_cast<const memory_t*>(user_data);
+    memory->jacobian(t, cj, NV_DATA_S(yy), NV_DATA_S(yp), J);
+    return 0;
+  }
+
+  /**
+   * Implements the function of type IDALsJacFnB which computes the
+   * iteration matrix of the backward problem,
+   * -(dF/dyy - c_jB * dF/dyp)^T.
+   */
+  static int ida_jacobian_adj(realtype t, realtype cjB, N_Vector yy,
+                              N_Vector yp, N_Vector yyB, N_Vector ypB,
+                              N_Vector rrB, SUNMatrix JB, void* user_dataB,
+                              N_Vector tmp1B, N_Vector tmp2B,
+                              N_Vector tmp3B) {
+    memory_t* memory = static_cast<memory_t*>(user_dataB);
+    memory->jacobian(t, -cjB, NV_DATA_S(yy), NV_DATA_S(yp), memory->J_work_);
+    memory->store_negative_transpose(memory->J_work_, JB);
+    return 0;
+  }
+
+  /**
+   * Calculates the DAE residual using the user-supplied functor at
+   * the given time t, unknowns yy and derivatives yp.
+   */
+  inline void residual(double t, const double yy[], const double yp[],
+                       double rr[]) const {
+    const std::vector<double> yy_vec(yy, yy + N_);
+    const std::vector<double> yp_vec(yp, yp + N_);
+    const std::vector<double>& rr_vec
+        = f_(t, yy_vec, yp_vec, theta_dbl_, x_r_, x_i_, msgs_);
+    check_size_match("idas_adjoint_memory", "residual", rr_vec.size(),
+                     "states", N_);
+    std::move(rr_vec.begin(), rr_vec.end(), rr);
+  }
+
+  /**
+   * Calculates with a single nested tape the vector-Jacobian products
+   * lambda^T dF/dyy, mu^T dF/dyp and lambda^T dF/dtheta. The latter
+   * two are only calculated if their outputs are not null.
+   *
+   * This and the Jacobians below are called from <code>chain()</code>
+   * while the reverse pass iterates over the autodiff stack, so their
+   * sweeps run on a separate tape which cannot reallocate the stack
+   * under it.
+   */
+  inline void vector_jacobian(double t, const double yy[], const double yp[],
+                              const double lambda[], const double mu[],
+                              double* lambda_J_yy, double* mu_J_yp,
+                              double* lambda_J_theta) const {
+    auto* outer = internal::checkpoint_tapes::enter();
+    start_nested();
+    try {
+      const std::vector<var> yy_var(yy, yy + N_);
+      const std::vector<var> yp_var(yp, yp + N_);
+      std::vector<var> rr_var;
+      std::vector<var> theta_var;
+      if (lambda_J_theta != nullptr) {
+        theta_var.assign(theta_dbl_.begin(), theta_dbl_.end());
+        rr_var = f_(t, yy_var, yp_var, theta_var, x_r_, x_i_, msgs_);
+      } else {
+        rr_var = f_(t, yy_var, yp_var, theta_dbl_, x_r_, x_i_, msgs_);
+      }
+      check_size_match("idas_adjoint_memory", "residual", rr_var.size(),
+                       "states", N_);
+      var lambda_rr = 0;
+      for (size_t i = 0; i < N_; ++i) {
+        lambda_rr += lambda[i] * rr_var[i];
+      }
+      lambda_rr.grad();
+      for (size_t i = 0; i < N_; ++i) {
+        lambda_J_yy[i] = yy_var[i].adj();
+      }
+      if (lambda_J_theta != nullptr) {
+        for (size_t j = 0; j < M_; ++j) {
+          lambda_J_theta[j] = theta_var[j].adj();
+        }
+      }
+      if (mu_J_yp != nullptr) {
+        set_zero_all_adjoints_nested();
+        var mu_rr = 0;
+        for (size_t i = 0; i < N_; ++i) {
+          mu_rr += mu[i] * rr_var[i];
+        }
+        mu_rr.grad();
+        for (size_t i = 0; i < N_; ++i) {
+          mu_J_yp[i] = yp_var[i].adj();
+        }
+      }
+    } catch (const std::exception& e) {
+      recover_memory_nested();
+      internal::checkpoint_tapes::exit(outer);
+      throw;
+    }
+    recover_memory_nested();
+    internal::checkpoint_tapes::exit(outer);
+  }
+
+  /**
+   * Calculates the iteration matrix dF/dyy + c_j * dF/dyp. Dense
+   * structures use the autodiff Jacobian of all rows, structured ones
+   * the colored reverse sweeps.
+   */
+  inline void jacobian(double t, double cj, const double yy[],
+                       const double yp[], SUNMatrix J) const {
+    auto* outer = internal::checkpoint_tapes::enter();
+    try {
+      internal::idas_autodiff_jacobian(
+          f_, t, cj, std::vector<double>(yy, yy + N_),
+          std::vector<double>(yp, yp + N_), theta_dbl_, x_r_, x_i_, msgs_,
+          structure_, colors_, column_rows_, J);
+    } catch (const std::exception& e) {
+      internal::checkpoint_tapes::exit(outer);
+      throw;
+    }
+    internal::checkpoint_tapes::exit(outer);
+  }
+
+  /**
+   * Returns the dense Jacobian of the residual wrt to yp if
+   * <code>wrt_yp</code> is true and wrt to yy otherwise.
+   */
+  inline Eigen::MatrixXd dense_jacobian(double t, const double yy[],
+                                        const double yp[], bool wrt_yp) {
+    const std::vector<double> yy_vec(yy, yy + N_);
+    const std::vector<double> yp_vec(yp, yp + N_);
+    auto* outer = internal::checkpoint_tapes::enter();
+    try {
+      internal::colored_autodiff_jacobian(
+          "idas_adjoint_memory",
+          [&](const std::vector<var>& v) {
+            return wrt_yp ? f_(t, yy_vec, v, theta_dbl_, x_r_, x_i_, msgs_)
+                          : f_(t, v, yp_vec, theta_dbl_, x_r_, x_i_, msgs_);
+          },
+          wrt_yp ? yp_vec : yy_vec, structure_, colors_, column_rows_,
+          J_work_);
+    } catch (const std::exception& e) {
+      internal::checkpoint_tapes::exit(outer);
+      throw;
+    }
+    internal::checkpoint_tapes::exit(outer);
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(N_, N_);
+    if (SUNMatGetID(J_work_) == SUNMATRIX_BAND) {
+      const int N = N_;
+      const int lower = structure_.lower_bandwidth(N);
+      const int upper = structure_.upper_bandwidth(N);
+      for (int j = 0; j < N; ++j) {
+        const int i_end = std::min(N - 1, j + lower);
+        for (int i = std::max(0, j - upper); i <= i_end; ++i) {
+          J(i, j) = SM_ELEMENT_B(J_work_, i, j);
+        }
+      }
+    } else {
+      J = Eigen::Map<Eigen::MatrixXd>(SM_DATA_D(J_work_), N_, N_);
+    }
+    return J;
+  }
+
+ private:
+  /**
+   * Allocates the matrix of the backward problem, whose bandwidths
+   * are those of the transposed iteration matrix.
+   */
+  static SUNMatrix backward_matrix(const ode_jacobian_structure& structure,
+                                   size_t N) {
+    if (structure.use_band_solver(N)) {
+      return SUNBandMatrix(N, structure.lower_bandwidth(N),
+                           structure.upper_bandwidth(N));
+    }
+    return SUNDenseMatrix(N, N);
+  }
+
+  /**
+   * Stores the negative transpose of J in JB.
+   */
+  inline void store_negative_transpose(SUNMatrix J, SUNMatrix JB) const {
+    const int N = N_;
+    if (SUNMatGetID(J) == SUNMATRIX_BAND) {
+      const int lower = structure_.lower_bandwidth(N);
+      const int upper = structure_.upper_bandwidth(N);
+      for (int j = 0; j < N; ++j) {
+        const int i_end = std::min(N - 1, j + lower);
+        for (int i = std::max(0, j - upper); i <= i_end; ++i) {
+          SM_ELEMENT_B(JB, j, i) = -SM_ELEMENT_B(J, i, j);
+        }
+      }
+    } else {
+      Eigen::Map<Eigen::MatrixXd>(SM_DATA_D(JB), N, N)
+          = -Eigen::Map<Eigen::MatrixXd>(SM_DATA_D(J), N, N).transpose();
+    }
+  }
+};
+
+/**
+ * The vari for the solution of a DAE in adjoint sensitivity mode.
+ *
+ * The forward pass solves the DAE with IDAS while storing
+ * checkpoints. The unknowns at the output times are returned as
+ * <code>vari</code> which are not on the chainable stack; only this
+ * vari is chained. <code>chain()</code> solves the backward problem
+ * from the last output time to the initial time.
+ *
+ * The adjoints of the outputs enter the backward problem as jumps at
+ * the output times. With E = dF/dyp, whose left and right null spaces
+ * are spanned by the columns of U and V, the jump (d, nu) for the
+ * adjoints w of the outputs at time t solves
+ *
+ *   E^T d + dF/dyy^T U nu = w,  V^T dF/dyy^T d = 0,
+ *
+ * such that the backward state lambda + d remains consistent and
+ * -nu^T U^T dF/dtheta is added to the parameter gradients. For an
+ * implicit ODE E is regular and the jump is E^{-T} w.
+ *
+ * @tparam F type of functor for DAE residual
+ */
+template <typename F>
+class idas_integrator_adjoint_vari : public vari {
+  using memory_t = idas_adjoint_memory<F>;
+
+  memory_t* memory_;
+  const size_t N_;
+  const size_t M_;
+  const size_t T_;
+  const double t0_;
+  double* ts_;
+  double* yy_;
+  double* yp_;
+  vari** theta_varis_;
+
+ public:
+  vari** yy_varis_;
+
+  /**
+   * Solves the forward problem and stores the unknowns and their
+   * derivatives at the output times.
+   *
+   * @param[in] f DAE residual functor
+   * @param[in] yy0 initial condition
+   * @param[in] yp0 initial condition for derivatives
+   * @param[in] t0 initial time
+   * @param[in] ts times of the desired solutions
+   * @param[in] theta parameters of the DAE
+   * @param[in] x_r continuous data vector for the DAE
+   * @param[in] x_i integer data vector for the DAE
+   * @param[in, out] msgs the print stream for warning messages
+   * @param[in] rtol relative tolerance of the forward problem
+   * @param[in] atol absolute tolerance of the forward problem
+   * @param[in] max_num_steps maximal number of admissable steps
+   * between time-points
+   * @param[in] options tolerances and checkpointing of the backward
+   * problem
+   * @param[in] structure structure of the iteration matrix
+   */
+  idas_integrator_adjoint_vari(
+      const F& f, const std::vector<double>& yy0,
+      const std::vector<double>& yp0, double t0, const std::vector<double>& ts,
+      const std::vector<var>& theta, const std::vector<double>& x_r,
+      const std::vector<int>& x_i, std::ostream* msgs, double rtol,
+      double atol, long int max_num_steps,  // NOLINT(runtime/int)
+      const idas_adjoint_options& options,
+      const ode_jacobian_structure& structure)
+      : vari(NOT_A_NUMBER),
+        memory_(new memory_t(f, yy0, yp0, value_of(theta), x_r, x_i, msgs,
+                             options, max_num_steps, structure)),
+        N_(yy0.size()),
+        M_(theta.size()),
+        T_(ts.size()),
+        t0_(t0),
+        ts_(ChainableStack::instance_->memalloc_.alloc_array<double>(T_)),
+        yy_(ChainableStack::instance_->memalloc_.alloc_array<double>(N_
+                                                                     * T_)),
+        yp_(ChainableStack::instance_->memalloc_.alloc_array<double>(N_
+                                                                     * T_)),
+        theta_varis_(
+            ChainableStack::instance_->memalloc_.alloc_array<vari*>(M_)),
+        yy_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            N_ * T_)) {
+    std::copy(ts.begin(), ts.end(), ts_);
+    for (size_t j = 0; j < M_; ++j) {
+      theta_varis_[j] = theta[j].vi_;
+    }
+    memory_->mass_ = memory_->dense_jacobian(t0_, &yy0[0], &yp0[0], true);
+
+    void* mem = memory_->mem_;
+    CHECK_IDAS_CALL(IDAInit(mem, &memory_t::ida_residual, t0_,
+                            memory_->nv_yy_, memory_->nv_yp_));
+    CHECK_IDAS_CALL(IDASetUserData(mem, reinterpret_cast<void*>(memory_)));
+    CHECK_IDAS_CALL(IDASStolerances(mem, rtol, atol));
+    CHECK_IDAS_CALL(IDASetMaxNumSteps(mem, max_num_steps));
+    CHECK_IDAS_CALL(IDASetLinearSolver(mem, memory_->LS_, memory_->A_));
+    if (structure.type() != ode_jacobian_structure::kind::dense) {
+      CHECK_IDAS_CALL(IDASetJacFn(mem, &memory_t::ida_jacobian));
+    }
+    CHECK_IDAS_CALL(IDAAdjInit(mem, options.steps_between_checkpoints,
+                               options.interpolation_polynomial));
+
+    double t_init = t0_;
+    for (size_t n = 0; n < T_; ++n) {
+      int ncheck;
+      CHECK_IDAS_CALL(IDASolveF(mem, ts_[n], &t_init, memory_->nv_yy_,
+                                memory_->nv_yp_, IDA_NORMAL, &ncheck));
+      for (size_t i = 0; i < N_; ++i) {
+        yy_[n * N_ + i] = memory_->yy_[i];
+        yp_[n * N_ + i] = memory_->yp_[i];
+        yy_varis_[n * N_ + i] = new vari(memory_->yy_[i], false);
+      }
+    }
+  }
+
+  /**
+   * Solves the backward problem and propagates the adjoints of the
+   * unknowns at the output times to the parameters.
+   */
+  virtual void chain() {
+    void* mem = memory_->mem_;
+    const bool quadrature = M_ > 0;
+    std::vector<double>& lambda = memory_->yy_backward_;
+    std::vector<double>& q = memory_->quadrature_;
+    std::fill(lambda.begin(), lambda.end(), 0.0);
+    std::fill(q.begin(), q.end(), 0.0);
+    if (!memory_->backward_is_initialized_) {
+      Eigen::FullPivLU<Eigen::MatrixXd> lu(memory_->mass_);
+      if (lu.dimensionOfKernel() > 0) {
+        memory_->right_null_ = lu.kernel();
+        memory_->left_null_
+            = memory_->mass_.transpose().fullPivLu().kernel();
+      }
+    }
+
+    for (size_t n = T_; n-- > 0;) {
+      add_jump(n);
+
+      const double t_lower = n > 0 ? ts_[n - 1] : t0_;
+      if (!memory_->backward_is_initialized_) {
+        initialize_backward(ts_[n]);
+      } else {
+        CHECK_IDAS_CALL(IDAReInitB(mem, memory_->index_backward_, ts_[n],
+                                   memory_->nv_yy_backward_,
+                                   memory_->nv_yp_backward_));
+        if (quadrature) {
+          // IDAQuadReInitB of SUNDIALS 4.1.0 re-initializes the
+          // quadratures of the forward problem
+          CHECK_IDAS_CALL(IDAQuadReInit(
+              IDAGetAdjIDABmem(mem, memory_->index_backward_),
+              memory_->nv_quadrature_));
+        }
+      }
+      CHECK_IDAS_CALL(IDASolveB(mem, t_lower, IDA_NORMAL));
+      double t_ret;
+      CHECK_IDAS_CALL(IDAGetB(mem, memory_->index_backward_, &t_ret,
+                              memory_->nv_yy_backward_,
+                              memory_->nv_yp_backward_));
+      if (quadrature) {
+        CHECK_IDAS_CALL(IDAGetQuadB(mem, memory_->index_backward_, &t_ret,
+                                    memory_->nv_quadrature_));
+      }
+    }
+
+    for (size_t j = 0; j < M_; ++j) {
+      theta_varis_[j]->adj_ += q[j];
+    }
+  }
+
+ private:
+  /**
+   * Adds the adjoints of the unknowns at output time n to the state
+   * of the backward problem and computes a consistent derivative of
+   * the backward state.
+   */
+  inline void add_jump(size_t n) {
+    const double* yy = yy_ + n * N_;
+    const double* yp = yp_ + n * N_;
+    Eigen::VectorXd w(N_);
+    for (size_t i = 0; i < N_; ++i) {
+      w(i) = yy_varis_[n * N_ + i]->adj_;
+    }
+    const Eigen::MatrixXd& mass = memory_->mass_;
+    const Eigen::MatrixXd& left_null = memory_->left_null_;
+    const Eigen::MatrixXd& right_null = memory_->right_null_;
+    Eigen::Map<Eigen::VectorXd> lambda(&memory_->yy_backward_[0], N_);
+    const Eigen::MatrixXd J_yy = memory_->dense_jacobian(ts_[n], yy, yp, false);
+    const size_t K = right_null.cols();
+    if (K == 0) {
+      lambda += mass.transpose().partialPivLu().solve(w);
+    } else {
+      Eigen::MatrixXd S = Eigen::MatrixXd::Zero(N_ + K, N_ + K);
+      S.topLeftCorner(N_, N_) = mass.transpose();
+      S.topRightCorner(N_, K) = J_yy.transpose() * left_null;
+      S.bottomLeftCorner(K, N_) = right_null.transpose() * J_yy.transpose();
+      Eigen::VectorXd rhs = Eigen::VectorXd::Zero(N_ + K);
+      rhs.head(N_) = w;
+      const Eigen::VectorXd sol = S.partialPivLu().solve(rhs);
+      lambda += sol.head(N_);
+      if (M_ > 0) {
+        const Eigen::VectorXd u = left_null * sol.tail(K);
+        std::vector<double> u_J_yy(N_);
+        std::vector<double> u_J_theta(M_);
+        memory_->vector_jacobian(ts_[n], yy, yp, u.data(), nullptr,
+                                 &u_J_yy[0], nullptr, &u_J_theta[0]);
+        for (size_t j = 0; j < M_; ++j) {
+          memory_->quadrature_[j] -= u_J_theta[j];
+        }
+      }
+    }
+    Eigen::Map<Eigen::VectorXd>(&memory_->yp_backward_[0], N_)
+        = mass.transpose().completeOrthogonalDecomposition().solve(
+            J_yy.transpose() * lambda);
+  }
+
+  /**
+   * Creates the backward problem at the last output time. The
+   * backward problem is kept in the IDAS memory and re-initialized
+   * on subsequent reverse passes.
+   */
+  inline void initialize_backward(double t_final) {
+    void* mem = memory_->mem_;
+    const idas_adjoint_options& options = memory_->options_;
+    int& which = memory_->index_backward_;
+    CHECK_IDAS_CALL(IDACreateB(mem, &which));
+    CHECK_IDAS_CALL(IDAInitB(mem, which, &memory_t::ida_residual_adj,
+                             t_final, memory_->nv_yy_backward_,
+                             memory_->nv_yp_backward_));
+    CHECK_IDAS_CALL(IDASStolerancesB(mem, which,
+                                     options.relative_tolerance_backward,
+                                     options.absolute_tolerance_backward));
+    CHECK_IDAS_CALL(
+        IDASetUserDataB(mem, which, reinterpret_cast<void*>(memory_)));
+    CHECK_IDAS_CALL(IDASetMaxNumStepsB(mem, which, memory_->max_num_steps_));
+    CHECK_IDAS_CALL(IDASetLinearSolverB(mem, which, memory_->LS_backward_,
+                                        memory_->A_backward_));
+    if (memory_->structure_.type() != ode_jacobian_structure::kind::dense) {
+      CHECK_IDAS_CALL(
+          IDASetJacFnB(mem, which, &memory_t::ida_jacobian_adj));
+    }
+    if (M_ > 0) {
+      CHECK_IDAS_CALL(IDAQuadInitB(mem, which, &memory_t::ida_quad_rhs_adj,
+                                   memory_->nv_quadrature_));
+      CHECK_IDAS_CALL(IDAQuadSStolerancesB(
+          mem, which, options.relative_tolerance_quadrature,
+          options.absolute_tolerance_quadrature));
+      CHECK_IDAS_CALL(IDASetQuadErrConB(mem, which, SUNTRUE));
+    }
+    memory_->backward_is_initialized_ = true;
+  }
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -7,6 +7,7 @@
 #include <stan/math/prim/arr/fun/dot_self.hpp>
 #include <stan/math/prim/mat/fun/typedefs.hpp>
 #include <stan/math/rev/fun/typedefs.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
 #include <idas/idas.h>
 #include <nvector/nvector_serial.h>
 #include <ostream>
@@ -72,6 +73,82 @@ inline void matrix_d_to_NVarray(const Eigen::MatrixXd& mat, N_Vector* nv,
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * Check that the DAE residual at the initial time is within the given
+ * tolerance of zero.
+ *
+ * @tparam F type of functor for DAE residual
+ * @param[in] f DAE residual functor
+ * @param[in] t0 initial time
+ * @param[in] yy0 initial condition
+ * @param[in] yp0 initial condition for derivatives
+ * @param[in] theta parameters
+ * @param[in] x_r continuous data
+ * @param[in] x_i integer data
+ * @param[in] msgs stream to which messages are printed
+ * @param[in] tol tolerance of the norm of the residual
+ * @throw std::domain_error if the norm of the residual exceeds tol
+ */
+template <typename F>
+inline void idas_check_ic_consistency(
+    const F& f, double t0, const std::vector<double>& yy0,
+    const std::vector<double>& yp0, const std::vector<double>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    std::ostream* msgs, double tol) {
+  static const char* caller = "idas_integrator";
+  std::vector<double> res(f(t0, yy0, yp0, theta, x_r, x_i, msgs));
+  double res0 = std::sqrt(dot_self(res));
+  check_less_or_equal(caller, "DAE residual at t0", res0, tol);
+}
+
+/**
+ * Calculate the iteration matrix dF/dyy + c_j * dF/dyp of a DAE
+ * residual F with colored reverse sweeps. Along yp + c_j * (v - yy)
+ * the derivative of F wrt to v is the iteration matrix, such that the
+ * colored Jacobian of the ODE integrators applies. The structure must
+ * cover the nonzeros of both dF/dyy and dF/dyp.
+ *
+ * @tparam F type of functor for DAE residual
+ * @param[in] f DAE residual functor
+ * @param[in] t time
+ * @param[in] cj scalar of the derivative part of the iteration matrix
+ * @param[in] yy unknowns
+ * @param[in] yp derivatives of the unknowns
+ * @param[in] theta parameters
+ * @param[in] x_r continuous data
+ * @param[in] x_i integer data
+ * @param[in] msgs stream to which messages are printed
+ * @param[in] structure structure of the iteration matrix
+ * @param[in] colors row coloring returned by
+ * <code>structure.row_colors(N)</code>
+ * @param[in] col_rows rows of each column returned by
+ * <code>structure.column_rows(N)</code>
+ * @param[out] J SUNDIALS matrix
+ */
+template <typename F>
+inline void idas_autodiff_jacobian(
+    const F& f, double t, double cj, const std::vector<double>& yy,
+    const std::vector<double>& yp, const std::vector<double>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    std::ostream* msgs, const ode_jacobian_structure& structure,
+    const std::vector<int>& colors,
+    const std::vector<std::vector<int>>& col_rows, SUNMatrix J) {
+  colored_autodiff_jacobian(
+      "idas_autodiff_jacobian",
+      [&](const std::vector<var>& yy_var) {
+        std::vector<var> yp_var(yp.size());
+        for (size_t i = 0; i < yp.size(); ++i) {
+          yp_var[i] = yp[i] + cj * (yy_var[i] - yy[i]);
+        }
+        return f(t, yy_var, yp_var, theta, x_r, x_i, msgs);
+      },
+      yy, structure, colors, col_rows, J);
+}
+
+}  // namespace internal
+
 /**
  * IDAS DAE system that contains informtion on residual
  * equation functor, sensitivity residual equation functor,
@@ -105,6 +182,9 @@ class idas_system {
   N_Vector id_;
   void* mem_;
   std::ostream* msgs_;
+  const ode_jacobian_structure structure_;
+  const std::vector<int> colors_;
+  const std::vector<std::vector<int>> column_rows_;
 
  public:
   static constexpr bool is_var_yy0 = stan::is_var<Tyy>::value;
@@ -127,11 +207,15 @@ class idas_system {
    * @param[in] x_r continuous data vector for the DAE.
    * @param[in] x_i integer data vector for the DAE.
    * @param[in] msgs stream to which messages are printed.
+   * @param[in] structure structure of the iteration matrix
+   * dF/dyy + c_j * dF/dyp, which selects the linear solver.
    */
   idas_system(const F& f, const std::vector<int>& eq_id,
               const std::vector<Tyy>& yy0, const std::vector<Typ>& yp0,
               const std::vector<Tpar>& theta, const std::vector<double>& x_r,
-              const std::vector<int>& x_i, std::ostream* msgs)
+              const std::vector<int>& x_i, std::ostream* msgs,
+              const ode_jacobian_structure& structure
+              = ode_jacobian_structure())
       : f_(f),
         yy_(yy0),
         yp_(yp0),
@@ -150,7 +234,10 @@ class idas_system {
         nv_rr_(N_VMake_Serial(N_, rr_val_.data())),
         id_(N_VNew_Serial(N_)),
         mem_(IDACreate()),
-        msgs_(msgs) {
+        msgs_(msgs),
+        structure_(structure),
+        colors_(structure.row_colors(N_)),
+        column_rows_(structure.column_rows(N_)) {
     if (nv_yy_ == NULL || nv_yp_ == NULL) {
       throw std::runtime_error("N_VMake_Serial failed to allocate memory");
     }
@@ -305,6 +392,13 @@ class idas_system {
    */
   const F& f() { return f_; }
 
+  /**
+   * return structure of the iteration matrix
+   */
+  const ode_jacobian_structure& jacobian_structure() const {
+    return structure_;
+  }
+
   /**
    * return a closure for IDAS residual callback
    */
@@ -329,19 +423,39 @@ class idas_system {
     };
   }
 
+  /**
+   * return a closure for IDAS iteration matrix callback, which
+   * computes dF/dyy + c_j * dF/dyp with colored reverse sweeps
+   * according to the structure of the system.
+   */
+  IDALsJacFn jacobian() {  // a non-capture lambda
+    return [](double t, double cj, N_Vector yy, N_Vector yp, N_Vector rr,
+              SUNMatrix J, void* user_data, N_Vector temp1, N_Vector temp2,
+              N_Vector temp3) -> int {
+      using DAE = idas_system<F, Tyy, Typ, Tpar>;
+      DAE* dae = static_cast<DAE*>(user_data);
+
+      size_t N = NV_LENGTH_S(yy);
+      auto yy_val = N_VGetArrayPointer(yy);
+      std::vector<double> yy_vec(yy_val, yy_val + N);
+      auto yp_val = N_VGetArrayPointer(yp);
+      std::vector<double> yp_vec(yp_val, yp_val + N);
+      internal::idas_autodiff_jacobian(
+          dae->f_, t, cj, yy_vec, yp_vec, value_of(dae->theta_), dae->x_r_,
+          dae->x_i_, dae->msgs_, dae->structure_, dae->colors_,
+          dae->column_rows_, J);
+
+      return 0;
+    };
+  }
+
   void check_ic_consistency(const double& t0, const double& tol) {
-    const std::vector<double> theta_d(value_of(theta_));
-    const std::vector<double> yy_d(value_of(yy_));
-    const std::vector<double> yp_d(value_of(yp_));
-    static const char* caller = "idas_integrator";
-    std::vector<double> res(f_(t0, yy_d, yp_d, theta_d, x_r_, x_i_, msgs_));
-    double res0 = std::sqrt(dot_self(res));
-    check_less_or_equal(caller, "DAE residual at t0", res0, tol);
+    internal::idas_check_ic_consistency(f_, t0, value_of(yy_), value_of(yp_),
+                                        value_of(theta_), x_r_, x_i_, msgs_,
+                                        tol);
   }
 };
 
-// TODO(yizhang): adjoint system construction
-
 }  // namespace math
 }  // namespace stan
 
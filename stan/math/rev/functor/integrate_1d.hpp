@@ -6,6 +6,7 @@
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/arr/fun/value_of.hpp>
 #include <stan/math/prim/functor/integrate_1d.hpp>
+#include <stan/math/prim/functor/integrate_vector.hpp>
 #include <stan/math/prim/scal/fun/constants.hpp>
 #include <stan/math/rev/fun/is_nan.hpp>
 #include <stan/math/rev/fun/value_of.hpp>
@@ -20,36 +21,37 @@ namespace stan {
 namespace math {
 
 /**
- * Calculate first derivative of f(x, param, std::ostream&)
- * with respect to the nth parameter. Uses nested reverse mode autodiff
+ * Calculate the value of f(x, param, std::ostream&) followed by its
+ * gradient with respect to all parameters in a single nested reverse
+ * sweep.
  *
  * Gradients that evaluate to NaN are set to zero if the function itself
- * evaluates to zero. If the function is not zero and the gradient evaluates to
+ * evaluates to zero. If the function is not zero and a gradient evaluates to
  * NaN, a std::domain_error is thrown
  */
 template <typename F>
-inline double gradient_of_f(const F &f, const double &x, const double &xc,
-                            const std::vector<double> &theta_vals,
-                            const std::vector<double> &x_r,
-                            const std::vector<int> &x_i, size_t n,
-                            std::ostream *msgs) {
-  double gradient = 0.0;
+inline Eigen::VectorXd value_and_gradient_of_f(
+    const F &f, const double &x, const double &xc,
+    const std::vector<double> &theta_vals, const std::vector<double> &x_r,
+    const std::vector<int> &x_i, std::ostream *msgs) {
+  Eigen::VectorXd result(theta_vals.size() + 1);
   start_nested();
-  std::vector<var> theta_var(theta_vals.size());
   try {
-    for (size_t i = 0; i < theta_vals.size(); i++) {
-      theta_var[i] = theta_vals[i];
-    }
+    std::vector<var> theta_var(theta_vals.begin(), theta_vals.end());
     var fx = f(x, xc, theta_var, x_r, x_i, msgs);
     fx.grad();
-    gradient = theta_var[n].adj();
-    if (is_nan(gradient)) {
-      if (fx.val() == 0) {
-        gradient = 0;
-      } else {
-        throw_domain_error("gradient_of_f", "The gradient of f", n,
-                           "is nan for parameter ", "");
+    result(0) = fx.val();
+    for (size_t n = 0; n < theta_vals.size(); ++n) {
+      double gradient = theta_var[n].adj();
+      if (is_nan(gradient)) {
+        if (fx.val() == 0) {
+          gradient = 0;
+        } else {
+          throw_domain_error("value_and_gradient_of_f", "The gradient of f",
+                             n, "is nan for parameter ", "");
+        }
       }
+      result(n + 1) = gradient;
     }
   } catch (const std::exception &e) {
     recover_memory_nested();
@@ -57,7 +59,7 @@ inline double gradient_of_f(const F &f, const double &x, const double &xc,
   }
   recover_memory_nested();
 
-  return gradient;
+  return result;
 }
 
 /**
@@ -95,6 +97,12 @@ inline double gradient_of_f(const F &f, const double &x, const double &xc,
  * split into two. In this case, each integral is separately integrated to the
  * given relative_tolerance.
  *
+ * If any parameter is a var, the integral and its gradient with respect to all
+ * parameters are integrated together as one vector on the same nodes by
+ * integrate_vector, with a single nested reverse sweep per node. The error
+ * control is then on the combined vector, such that the relative tolerance
+ * applies to the largest of the integral and its partials.
+ *
  * Gradients of f that evaluate to NaN when the function evaluates to zero are
  * set to zero themselves. This is due to the autodiff easily overflowing to NaN
  * when evaluating gradients near the maximum and minimum floating point values
@@ -130,26 +138,29 @@ inline return_type_t<T_a, T_b, T_theta> integrate_1d(
     }
     return var(0.0);
   } else {
-    double integral = integrate(
-        std::bind<double>(f, std::placeholders::_1, std::placeholders::_2,
-                          value_of(theta), x_r, x_i, msgs),
-        value_of(a), value_of(b), relative_tolerance);
-
     size_t N_theta_vars = is_var<T_theta>::value ? theta.size() : 0;
     std::vector<double> dintegral_dtheta(N_theta_vars);
     std::vector<var> theta_concat(N_theta_vars);
+    double integral;
 
     if (N_theta_vars > 0) {
       std::vector<double> theta_vals = value_of(theta);
-
+      Eigen::VectorXd integral_and_gradient = integrate_vector(
+          [&](double x, double xc) {
+            return value_and_gradient_of_f(f, x, xc, theta_vals, x_r, x_i,
+                                           msgs);
+          },
+          value_of(a), value_of(b), relative_tolerance, N_theta_vars + 1);
+      integral = integral_and_gradient(0);
       for (size_t n = 0; n < N_theta_vars; ++n) {
-        dintegral_dtheta[n] = integrate(
-            std::bind<double>(gradient_of_f<F>, f, std::placeholders::_1,
-                              std::placeholders::_2, theta_vals, x_r, x_i, n,
-                              msgs),
-            value_of(a), value_of(b), relative_tolerance);
+        dintegral_dtheta[n] = integral_and_gradient(n + 1);
         theta_concat[n] = theta[n];
       }
+    } else {
+      integral = integrate(
+          std::bind<double>(f, std::placeholders::_1, std::placeholders::_2,
+                            value_of(theta), x_r, x_i, msgs),
+          value_of(a), value_of(b), relative_tolerance);
     }
 
     if (!is_inf(a) && is_var<T_a>::value) {
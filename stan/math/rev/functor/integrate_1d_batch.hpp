@@ -0,0 +1,213 @@
+#ifndef STAN_MATH_REV_FUNCTOR_INTEGRATE_1D_BATCH_HPP
+#define STAN_MATH_REV_FUNCTOR_INTEGRATE_1D_BATCH_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/dot_product.hpp>
+#include <stan/math/rev/fun/is_nan.hpp>
+#include <stan/math/rev/fun/value_of.hpp>
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/arr/fun/value_of.hpp>
+#include <stan/math/prim/functor/integrate_1d_batch.hpp>
+#include <stan/math/prim/mat/fun/value_of.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Calculate the weighted sums of the values of a batched integrand
+ * f(x, xc, theta, x_r, x_i, msgs) over a batch of abscissae and of
+ * their gradients with respect to all parameters, followed by the
+ * weighted sum of the absolute values with the first column of weights
+ * and the absolute values of the first sums of the gradients.
+ *
+ * The integrand is recorded on one nested tape for the whole batch. As
+ * a weighted sum of the values is linear, its gradient is the weighted
+ * sum of the gradients and takes a single reverse sweep per column of
+ * weights instead of one per abscissa.
+ *
+ * Gradients that evaluate to NaN are set to zero at abscissae where the
+ * function evaluates to zero, for which the gradients of such a batch
+ * are recomputed one abscissa at a time. If the function is not zero
+ * and a gradient evaluates to NaN, a std::domain_error is thrown
+ */
+template <typename F>
+inline Eigen::MatrixXd weighted_values_and_gradients_of_f(
+    const F &f, const Eigen::VectorXd &x, const Eigen::VectorXd &xc,
+    const Eigen::MatrixXd &w, const std::vector<double> &theta_vals,
+    const std::vector<double> &x_r, const std::vector<int> &x_i,
+    std::ostream *msgs) {
+  const int M = theta_vals.size();
+  const int K = w.cols();
+  Eigen::MatrixXd sums(M + 1, K + 1);
+  start_nested();
+  try {
+    std::vector<var> theta_var(theta_vals.begin(), theta_vals.end());
+    Eigen::Matrix<var, Eigen::Dynamic, 1> fx
+        = f(x, xc, theta_var, x_r, x_i, msgs);
+    check_size_match("integrate_1d_batch", "values of integrand", fx.size(),
+                     "abscissae", x.size());
+    const Eigen::VectorXd fx_val = value_of(fx);
+    sums.block(0, 0, 1, K) = fx_val.transpose() * w;
+    sums(0, K) = fx_val.cwiseAbs().dot(w.col(0).cwiseAbs());
+
+    std::vector<var> weighted_sums(K);
+    for (int k = 0; k < K; ++k) {
+      weighted_sums[k] = dot_product(Eigen::VectorXd(w.col(k)), fx);
+    }
+    bool is_nan_gradient = false;
+    for (int k = 0; k < K; ++k) {
+      set_zero_all_adjoints_nested();
+      weighted_sums[k].grad();
+      for (int n = 0; n < M; ++n) {
+        sums(n + 1, k) = theta_var[n].adj();
+        is_nan_gradient = is_nan_gradient || is_nan(sums(n + 1, k));
+      }
+    }
+
+    if (is_nan_gradient) {
+      sums.block(1, 0, M, K).setZero();
+      for (int i = 0; i < fx.size(); ++i) {
+        set_zero_all_adjoints_nested();
+        fx(i).grad();
+        for (int n = 0; n < M; ++n) {
+          double gradient = theta_var[n].adj();
+          if (is_nan(gradient)) {
+            if (fx_val(i) == 0) {
+              gradient = 0;
+            } else {
+              throw_domain_error("weighted_values_and_gradients_of_f",
+                                 "The gradient of f", n,
+                                 "is nan for parameter ", "");
+            }
+          }
+          sums.block(n + 1, 0, 1, K) += gradient * w.row(i);
+        }
+      }
+    }
+    sums.block(1, K, M, 1) = sums.block(1, 0, M, 1).cwiseAbs();
+  } catch (const std::exception &e) {
+    recover_memory_nested();
+    throw;
+  }
+  recover_memory_nested();
+
+  return sums;
+}
+
+/**
+ * Compute the integral of the single variable function f from a to b
+ * with a quadrature rule which evaluates f at a whole batch of
+ * abscissae at once. a and b can be finite or infinite, as supported
+ * by the rule.
+ *
+ * f should be compatible with reverse mode autodiff and have the
+ * signature:
+ *   Eigen::Matrix<var, Eigen::Dynamic, 1> f(const Eigen::VectorXd& x,
+ *     const Eigen::VectorXd& xc, const std::vector<var>& theta,
+ *     const std::vector<double>& x_r, const std::vector<int>& x_i,
+ *     std::ostream* msgs)
+ *
+ * It should return the values of the function evaluated at each of the
+ * abscissae x. Any errors should be printed to the msgs stream.
+ *
+ * If any parameter is a var, the integral and its gradient with respect
+ * to all parameters are integrated together on the same batches. Each
+ * batch records f once on a nested tape and takes one reverse sweep per
+ * weighted sum of the rule, two for the Gauss-Kronrod rule and one for
+ * the fixed rules. The error control of the Gauss-Kronrod rule is then
+ * on the combined vector, such that the relative tolerance applies to
+ * the largest of the integral and its partials.
+ *
+ * Gradients of f that evaluate to NaN when the function evaluates to
+ * zero are set to zero themselves, as for <code>integrate_1d</code>.
+ *
+ * @tparam F Type of f
+ * @tparam T_a type of first limit
+ * @tparam T_b type of second limit
+ * @tparam T_theta type of parameters
+ * @param f the functor to integrate
+ * @param a lower limit of integration
+ * @param b upper limit of integration
+ * @param theta additional parameters to be passed to f
+ * @param x_r additional data to be passed to f
+ * @param x_i additional integer data to be passed to f
+ * @param[in, out] msgs the print stream for warning messages
+ * @param relative_tolerance target relative tolerance
+ * @param rule quadrature rule
+ * @return numeric integral of function f
+ */
+template <typename F, typename T_a, typename T_b, typename T_theta,
+          typename = require_any_var_t<T_a, T_b, T_theta>>
+inline return_type_t<T_a, T_b, T_theta> integrate_1d_batch(
+    const F &f, const T_a &a, const T_b &b, const std::vector<T_theta> &theta,
+    const std::vector<double> &x_r, const std::vector<int> &x_i,
+    std::ostream *msgs, const double relative_tolerance = std::sqrt(EPSILON),
+    const integrate_1d_rule &rule = integrate_1d_rule()) {
+  static const char *function = "integrate_1d_batch";
+  check_less_or_equal(function, "lower limit", a, b);
+
+  if (value_of(a) == value_of(b)) {
+    if (is_inf(a)) {
+      throw_domain_error(function, "Integration endpoints are both",
+                         value_of(a), "", "");
+    }
+    return var(0.0);
+  }
+
+  size_t N_theta_vars = is_var<T_theta>::value ? theta.size() : 0;
+  std::vector<double> dintegral_dtheta(N_theta_vars);
+  std::vector<var> theta_concat(N_theta_vars);
+  const std::vector<double> theta_vals = value_of(theta);
+  double integral;
+
+  if (N_theta_vars > 0) {
+    Eigen::VectorXd integral_and_gradient = internal::integrate_batch(
+        [&](const Eigen::VectorXd &x, const Eigen::VectorXd &xc,
+            const Eigen::MatrixXd &w) {
+          return weighted_values_and_gradients_of_f(f, x, xc, w, theta_vals,
+                                                    x_r, x_i, msgs);
+        },
+        value_of(a), value_of(b), relative_tolerance, N_theta_vars + 1,
+        rule);
+    integral = integral_and_gradient(0);
+    for (size_t n = 0; n < N_theta_vars; ++n) {
+      dintegral_dtheta[n] = integral_and_gradient(n + 1);
+      theta_concat[n] = theta[n];
+    }
+  } else {
+    integral = internal::integrate_batch(
+        [&](const Eigen::VectorXd &x, const Eigen::VectorXd &xc,
+            const Eigen::MatrixXd &w) {
+          return weighted_values_of_f(f, x, xc, w, theta_vals, x_r, x_i,
+                                      msgs);
+        },
+        value_of(a), value_of(b), relative_tolerance, 1, rule)(0);
+  }
+
+  if (!is_inf(a) && is_var<T_a>::value) {
+    theta_concat.push_back(a);
+    dintegral_dtheta.push_back(
+        -value_of(f(Eigen::VectorXd::Constant(1, value_of(a)),
+                    Eigen::VectorXd::Zero(1), theta, x_r, x_i, msgs)(0)));
+  }
+
+  if (!is_inf(b) && is_var<T_b>::value) {
+    theta_concat.push_back(b);
+    dintegral_dtheta.push_back(
+        value_of(f(Eigen::VectorXd::Constant(1, value_of(b)),
+                   Eigen::VectorXd::Zero(1), theta, x_r, x_i, msgs)(0)));
+  }
+
+  return precomputed_gradients(integral, theta_concat, dintegral_dtheta);
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
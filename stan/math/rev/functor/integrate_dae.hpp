@@ -4,6 +4,7 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/idas_forward_system.hpp>
 #include <stan/math/rev/functor/idas_integrator.hpp>
+#include <stan/math/rev/functor/idas_integrator_adjoint.hpp>
 #include <ostream>
 #include <vector>
 
@@ -53,6 +54,61 @@ std::vector<std::vector<Tpar> > integrate_dae(
 
   return solver.integrate(dae, t0, ts);
 }
+
+/**
+ * Return the solutions for a semi-explicit DAE system using a linear
+ * solver adapted to the structure of the iteration matrix
+ * dF/dyy + c_j * dF/dyp.
+ *
+ * A banded or sparse <code>structure</code>, which must cover the
+ * nonzeros of both dF/dyy and dF/dyp, selects a banded linear solver
+ * and an autodiff iteration matrix with one reverse sweep per color of
+ * its rows instead of IDAS's difference quotients.
+ *
+ * @see integrate_dae
+ */
+template <typename F, typename Tpar>
+std::vector<std::vector<Tpar> > integrate_dae(
+    const F& f, const std::vector<double>& yy0, const std::vector<double>& yp0,
+    double t0, const std::vector<double>& ts, const std::vector<Tpar>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    const double rtol, const double atol, const int64_t max_num_steps,
+    std::ostream* msgs, const ode_jacobian_structure& structure) {
+  const std::vector<int> dummy_eq_id(yy0.size(), 0);
+
+  stan::math::idas_integrator solver(rtol, atol, max_num_steps);
+  stan::math::idas_forward_system<F, double, double, Tpar> dae{
+      f, dummy_eq_id, yy0, yp0, theta, x_r, x_i, msgs, structure};
+
+  dae.check_ic_consistency(t0, atol);
+
+  return solver.integrate(dae, t0, ts);
+}
+
+/**
+ * Return the solutions for a semi-explicit DAE system computed with
+ * the adjoint sensitivity method. The backward problem is solved with
+ * the tolerances and checkpointing given in <code>options</code>, and
+ * the residual must be linear in yp with a constant dF/dyp.
+ *
+ * @see idas_integrator::integrate_adjoint
+ */
+template <typename F, typename Tpar>
+std::vector<std::vector<Tpar> > integrate_dae(
+    const F& f, const std::vector<double>& yy0, const std::vector<double>& yp0,
+    double t0, const std::vector<double>& ts, const std::vector<Tpar>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    const double rtol, const double atol, const int64_t max_num_steps,
+    std::ostream* msgs, const idas_adjoint_options& options,
+    const ode_jacobian_structure& structure = ode_jacobian_structure()) {
+  stan::math::idas_integrator solver(rtol, atol, max_num_steps);
+
+  internal::idas_check_ic_consistency(f, t0, yy0, yp0, value_of(theta), x_r,
+                                      x_i, msgs, atol);
+
+  return solver.integrate_adjoint(f, yy0, yp0, t0, ts, theta, x_r, x_i, msgs,
+                                  options, structure);
+}
 }  // namespace math
 }  // namespace stan
 
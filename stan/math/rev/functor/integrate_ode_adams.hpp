@@ -27,6 +27,57 @@ integrate_ode_adams(const F& f, const std::vector<T_initial>& y0,
                               max_num_steps);
 }
 
+/**
+ * Return the solutions of the ODE system computed with the adjoint
+ * sensitivity method. The backward problem is solved with the
+ * tolerances and checkpointing given in <code>options</code>.
+ *
+ * @see cvodes_integrator::integrate_adjoint
+ */
+template <typename F, typename T_initial, typename T_param, typename T_t0,
+          typename T_ts>
+std::vector<std::vector<
+    typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>
+integrate_ode_adams(const F& f, const std::vector<T_initial>& y0,
+                    const T_t0& t0, const std::vector<T_ts>& ts,
+                    const std::vector<T_param>& theta,
+                    const std::vector<double>& x, const std::vector<int>& x_int,
+                    std::ostream* msgs, double relative_tolerance,
+                    double absolute_tolerance,
+                    long int max_num_steps,  // NOLINT(runtime/int)
+                    const cvodes_adjoint_options& options) {
+  stan::math::cvodes_integrator<CV_ADAMS> integrator;
+  return integrator.integrate_adjoint(f, y0, t0, ts, theta, x, x_int, msgs,
+                                      relative_tolerance, absolute_tolerance,
+                                      max_num_steps, options);
+}
+
+/**
+ * Return the solutions of an ensemble of independent subjects sharing
+ * the same ODE system, each with its own initial state, output times
+ * and parameters. The subjects are solved in parallel whenever
+ * <code>STAN_THREADS</code> is defined.
+ *
+ * @see cvodes_integrator::integrate_ensemble
+ */
+template <typename F, typename T_initial, typename T_param, typename T_t0,
+          typename T_ts>
+std::vector<std::vector<std::vector<
+    typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>>
+integrate_ode_adams_ensemble(
+    const F& f, const std::vector<std::vector<T_initial>>& y0s,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& tss,
+    const std::vector<std::vector<T_param>>& thetas,
+    const std::vector<double>& x, const std::vector<int>& x_int,
+    std::ostream* msgs = nullptr, double relative_tolerance = 1e-10,
+    double absolute_tolerance = 1e-10,
+    long int max_num_steps = 1e8) {  // NOLINT(runtime/int)
+  stan::math::cvodes_integrator<CV_ADAMS> integrator;
+  return integrator.integrate_ensemble(f, y0s, t0, tss, thetas, x, x_int,
+                                       msgs, relative_tolerance,
+                                       absolute_tolerance, max_num_steps);
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
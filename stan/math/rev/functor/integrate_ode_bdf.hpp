@@ -27,6 +27,91 @@ integrate_ode_bdf(const F& f, const std::vector<T_initial>& y0, const T_t0& t0,
                               max_num_steps);
 }
 
+/**
+ * Return the solutions of the ODE system computed with the adjoint
+ * sensitivity method. The backward problem is solved with the
+ * tolerances and checkpointing given in <code>options</code>.
+ *
+ * @see cvodes_integrator::integrate_adjoint
+ */
+template <typename F, typename T_initial, typename T_param, typename T_t0,
+          typename T_ts>
+std::vector<std::vector<
+    typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>
+integrate_ode_bdf(const F& f, const std::vector<T_initial>& y0, const T_t0& t0,
+                  const std::vector<T_ts>& ts,
+                  const std::vector<T_param>& theta,
+                  const std::vector<double>& x, const std::vector<int>& x_int,
+                  std::ostream* msgs, double relative_tolerance,
+                  double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  const cvodes_adjoint_options& options) {
+  stan::math::cvodes_integrator<CV_BDF> integrator;
+  return integrator.integrate_adjoint(f, y0, t0, ts, theta, x, x_int, msgs,
+                                      relative_tolerance, absolute_tolerance,
+                                      max_num_steps, options);
+}
+
+/**
+ * Return the solutions of the ODE system using a linear solver and
+ * Jacobian computation adapted to the structure of the Jacobian of
+ * the ODE RHS wrt to the states.
+ *
+ * A banded or sparse <code>structure</code> selects a banded linear
+ * solver and reduces the number of reverse sweeps needed for the
+ * autodiff Jacobian. If <code>jacobian</code> is given it is used
+ * instead of autodiff; it is called as
+ * <code>jacobian(t, y, theta, x, x_int, msgs)</code> with double
+ * states and parameters and returns the N x N Jacobian as a dense or
+ * sparse Eigen matrix.
+ *
+ * @see cvodes_integrator::integrate
+ */
+template <typename F, typename T_initial, typename T_param, typename T_t0,
+          typename T_ts, typename F_jac = ode_autodiff_jacobian>
+std::vector<std::vector<
+    typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>
+integrate_ode_bdf(const F& f, const std::vector<T_initial>& y0, const T_t0& t0,
+                  const std::vector<T_ts>& ts,
+                  const std::vector<T_param>& theta,
+                  const std::vector<double>& x, const std::vector<int>& x_int,
+                  std::ostream* msgs, double relative_tolerance,
+                  double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  const ode_jacobian_structure& structure,
+                  const F_jac& jacobian = F_jac()) {
+  stan::math::cvodes_integrator<CV_BDF, F_jac> integrator(structure, jacobian);
+  return integrator.integrate(f, y0, t0, ts, theta, x, x_int, msgs,
+                              relative_tolerance, absolute_tolerance,
+                              max_num_steps);
+}
+
+/**
+ * Return the solutions of an ensemble of independent subjects sharing
+ * the same ODE system, each with its own initial state, output times
+ * and parameters. The subjects are solved in parallel whenever
+ * <code>STAN_THREADS</code> is defined.
+ *
+ * @see cvodes_integrator::integrate_ensemble
+ */
+template <typename F, typename T_initial, typename T_param, typename T_t0,
+          typename T_ts>
+std::vector<std::vector<std::vector<
+    typename stan::return_type<T_initial, T_param, T_t0, T_ts>::type>>>
+integrate_ode_bdf_ensemble(
+    const F& f, const std::vector<std::vector<T_initial>>& y0s,
+    const T_t0& t0, const std::vector<std::vector<T_ts>>& tss,
+    const std::vector<std::vector<T_param>>& thetas,
+    const std::vector<double>& x, const std::vector<int>& x_int,
+    std::ostream* msgs = nullptr, double relative_tolerance = 1e-10,
+    double absolute_tolerance = 1e-10,
+    long int max_num_steps = 1e8) {  // NOLINT(runtime/int)
+  stan::math::cvodes_integrator<CV_BDF> integrator;
+  return integrator.integrate_ensemble(f, y0s, t0, tss, thetas, x, x_int,
+                                       msgs, relative_tolerance,
+                                       absolute_tolerance, max_num_steps);
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
@@ -3,14 +3,21 @@
 
 #include <stan/math/prim/mat/fun/to_array_1d.hpp>
 #include <stan/math/prim/mat/fun/to_vector.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+#include <stan/math/rev/core.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
+#include <stan/math/rev/functor/cvodes_jacobian.hpp>
 #include <stan/math/rev/functor/jacobian.hpp>
 
 #include <kinsol/kinsol.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
 #include <nvector/nvector_serial.h>
 
+#include <cmath>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -41,6 +48,160 @@ struct kinsol_J_f {
   }
 };
 
+/**
+ * Tag type selecting the difference quotient approximation of KINSOL
+ * for the products of the Jacobian with vectors required by the
+ * matrix-free linear solver. This is the default.
+ */
+struct kinsol_difference_jacobian_vector {};
+
+/**
+ * Linear solver for the Newton steps of KINSOL.
+ *
+ * - dense: dense Jacobian and dense direct solver. This is the
+ *   default.
+ * - structured: the Jacobian has the given banded or sparse
+ *   structure. The autodiff Jacobian is computed with one reverse
+ *   sweep per color of rows and a banded direct solver is used
+ *   whenever the band is narrower than the system.
+ * - detected: as structured, with the sparsity pattern detected from
+ *   the autodiff tape of the system at the initial guess.
+ * - gmres: matrix-free SPGMR, which only requires products of the
+ *   Jacobian with vectors and never forms the Jacobian.
+ *
+ * A sparse direct solver (KLU) is not available, since SuiteSparse is
+ * not part of the SUNDIALS build.
+ */
+class kinsol_linear_solver {
+ public:
+  enum class kind { dense, structured, detected, gmres };
+
+  /**
+   * Construct the dense linear solver.
+   */
+  kinsol_linear_solver() : kind_(kind::dense), krylov_dim_(0) {}
+
+  /**
+   * Return the direct linear solver for a Jacobian of the given
+   * structure.
+   *
+   * @param structure banded or sparse structure of the Jacobian of the
+   * system wrt to the unknowns
+   */
+  static kinsol_linear_solver structured(
+      const ode_jacobian_structure& structure) {
+    kinsol_linear_solver solver;
+    solver.kind_ = kind::structured;
+    solver.structure_ = structure;
+    return solver;
+  }
+
+  /**
+   * Return the direct linear solver for a Jacobian whose sparsity
+   * pattern is detected at the initial guess.
+   */
+  static kinsol_linear_solver detected() {
+    kinsol_linear_solver solver;
+    solver.kind_ = kind::detected;
+    return solver;
+  }
+
+  /**
+   * Return the matrix-free GMRES linear solver.
+   *
+   * @param krylov_dim maximal dimension of the Krylov subspace; zero
+   * selects the SUNDIALS default of 5
+   * @throw std::domain_error if the dimension is negative
+   */
+  static kinsol_linear_solver gmres(int krylov_dim = 0) {
+    check_nonnegative("kinsol_linear_solver", "Krylov dimension", krylov_dim);
+    kinsol_linear_solver solver;
+    solver.kind_ = kind::gmres;
+    solver.krylov_dim_ = krylov_dim;
+    return solver;
+  }
+
+  /**
+   * Return the kind of this linear solver.
+   */
+  kind type() const { return kind_; }
+
+  /**
+   * Return the structure of the Jacobian of a structured solver.
+   */
+  const ode_jacobian_structure& structure() const { return structure_; }
+
+  /**
+   * Return the maximal dimension of the Krylov subspace of GMRES.
+   */
+  int krylov_dim() const { return krylov_dim_; }
+
+ private:
+  kind kind_;
+  ode_jacobian_structure structure_;
+  int krylov_dim_;
+};
+
+namespace internal {
+
+/**
+ * Return the sparsity pattern of the Jacobian of an algebraic system
+ * wrt to the unknowns, detected from the autodiff tape of the system
+ * at the given unknowns.
+ *
+ * Every row is found in one reverse sweep whose seed is NaN. A NaN
+ * adjoint propagates to every operand of a vari whatever the value of
+ * the partial, such that every unknown the row depends on ends up
+ * with a NaN adjoint, including those whose entry happens to vanish at
+ * the given unknowns.
+ *
+ * @tparam F type of the system functor
+ * @param f system functor
+ * @param x unknowns
+ * @param y parameters
+ * @param dat continuous data
+ * @param dat_int integer data
+ * @param msgs stream for messages
+ * @return sparse structure of the Jacobian
+ */
+template <typename F>
+inline ode_jacobian_structure kinsol_jacobian_sparsity(
+    const F& f, const Eigen::VectorXd& x, const Eigen::VectorXd& y,
+    const std::vector<double>& dat, const std::vector<int>& dat_int,
+    std::ostream* msgs) {
+  const int N = x.size();
+  std::vector<std::pair<int, int>> nonzeros;
+  start_nested();
+  try {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x);
+    Eigen::Matrix<var, Eigen::Dynamic, 1> fx = f(x_var, y, dat, dat_int, msgs);
+    check_size_match("kinsol_jacobian_sparsity", "system output", fx.size(),
+                     "unknowns", N);
+    for (int i = 0; i < N; ++i) {
+      set_zero_all_adjoints_nested();
+      fx(i).vi_->adj_ = NOT_A_NUMBER;
+      using it_t = std::vector<vari*>::reverse_iterator;
+      it_t begin = ChainableStack::instance_->var_stack_.rbegin();
+      it_t end = begin + nested_size();
+      for (it_t it = begin; it < end; ++it) {
+        (*it)->chain();
+      }
+      for (int j = 0; j < N; ++j) {
+        if (std::isnan(x_var(j).adj())) {
+          nonzeros.emplace_back(i, j);
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    recover_memory_nested();
+    throw;
+  }
+  recover_memory_nested();
+  return ode_jacobian_structure::sparse(nonzeros);
+}
+
+}  // namespace internal
+
 /**
  * KINSOL algebraic system data holder.
  * Based on cvodes_ode_data.
@@ -48,19 +209,28 @@ struct kinsol_J_f {
  * @tparam F1 functor type for system function.
  * @tparam F2 functor type for jacobian function. Default is 0.
  *         If 0, use rev mode autodiff to compute the Jacobian.
+ * @tparam F3 functor type for the products of the Jacobian with
+ *         vectors of the matrix-free linear solver, or
+ *         <code>kinsol_difference_jacobian_vector</code>.
  */
-template <typename F1, typename F2>
+template <typename F1, typename F2,
+          typename F3 = kinsol_difference_jacobian_vector>
 class kinsol_system_data {
   const F1& f_;
   const F2& J_f_;
+  const F3& J_v_;
   const Eigen::VectorXd& x_;
   const Eigen::VectorXd& y_;
   const size_t N_;
   const std::vector<double>& dat_;
   const std::vector<int>& dat_int_;
   std::ostream* msgs_;
+  const bool matrix_free_;
+  const ode_jacobian_structure structure_;
+  const std::vector<int> colors_;
+  const std::vector<std::vector<int>> col_rows_;
 
-  typedef kinsol_system_data<F1, F2> system_data;
+  typedef kinsol_system_data<F1, F2, F3> system_data;
 
  public:
   N_Vector nv_x_;
@@ -71,18 +241,31 @@ class kinsol_system_data {
   /* Constructor */
   kinsol_system_data(const F1& f, const F2& J_f, const Eigen::VectorXd& x,
                      const Eigen::VectorXd& y, const std::vector<double>& dat,
-                     const std::vector<int>& dat_int, std::ostream* msgs)
+                     const std::vector<int>& dat_int, std::ostream* msgs,
+                     const kinsol_linear_solver& linear_solver
+                     = kinsol_linear_solver(),
+                     const F3& J_v = F3())
       : f_(f),
         J_f_(J_f),
+        J_v_(J_v),
         x_(x),
         y_(y),
         N_(x.size()),
         dat_(dat),
         dat_int_(dat_int),
         msgs_(msgs),
+        matrix_free_(linear_solver.type()
+                     == kinsol_linear_solver::kind::gmres),
+        structure_(jacobian_structure(linear_solver)),
+        colors_(structure_.row_colors(N_)),
+        col_rows_(structure_.column_rows(N_)),
         nv_x_(N_VMake_Serial(N_, &to_array_1d(x_)[0])),
-        J_(SUNDenseMatrix(N_, N_)),
-        LS_(SUNLinSol_Dense(nv_x_, J_)),
+        J_(matrix_free_ ? nullptr
+                        : internal::cvodes_jacobian_matrix(structure_, N_)),
+        LS_(matrix_free_ ? SUNLinSol_SPGMR(nv_x_, PREC_NONE,
+                                           linear_solver.krylov_dim())
+                         : internal::cvodes_linear_solver(structure_, nv_x_,
+                                                          J_)),
         kinsol_memory_(KINCreate()) {}
 
   ~kinsol_system_data() {
@@ -124,11 +307,83 @@ class kinsol_system_data {
                              void* user_data, N_Vector tmp1, N_Vector tmp2) {
     const system_data* explicit_system
         = static_cast<const system_data*>(user_data);
-    return explicit_system->J_f_(explicit_system->f_, explicit_system->x_,
-                                 explicit_system->y_, explicit_system->dat_,
-                                 explicit_system->dat_int_,
-                                 explicit_system->msgs_, NV_DATA_S(x), J);
+    return explicit_system->jacobian(explicit_system->J_f_, NV_DATA_S(x), J);
+  }
+
+  /**
+   * Implements the function of type KINLsJacTimesVecFn which is the
+   * user-defined callback for the matrix-free linear solver of KINSOL
+   * to calculate the product of the Jacobian at x with v.
+   */
+  static int kinsol_jacobian_vector(N_Vector v, N_Vector Jv, N_Vector x,
+                                    booleantype* new_x, void* user_data) {
+    const system_data* explicit_system
+        = static_cast<const system_data*>(user_data);
+    return explicit_system->J_v_(
+        explicit_system->f_, explicit_system->x_, explicit_system->y_,
+        explicit_system->dat_, explicit_system->dat_int_,
+        explicit_system->msgs_, NV_DATA_S(x), NV_DATA_S(v), NV_DATA_S(Jv));
+  }
+
+  /**
+   * Return true if the linear solver is matrix-free.
+   */
+  bool matrix_free() const { return matrix_free_; }
+
+  /**
+   * Set the callback for the products of the Jacobian with vectors of
+   * the matrix-free linear solver.
+   */
+  void set_jacobian_vector_fn() { set_jacobian_vector_fn(J_v_); }
+
+ private:
+  ode_jacobian_structure jacobian_structure(
+      const kinsol_linear_solver& linear_solver) const {
+    switch (linear_solver.type()) {
+      case kinsol_linear_solver::kind::structured:
+        return linear_solver.structure();
+      case kinsol_linear_solver::kind::detected:
+        return internal::kinsol_jacobian_sparsity(f_, x_, y_, dat_, dat_int_,
+                                                  msgs_);
+      default:
+        return ode_jacobian_structure();
+    }
+  }
+
+  template <typename G>
+  int jacobian(const G& J_f, const double x_sun[], SUNMatrix J) const {
+    return J_f(f_, x_, y_, dat_, dat_int_, msgs_, x_sun, J);
   }
+
+  /**
+   * Calculate the autodiff Jacobian, with colored reverse sweeps
+   * unless it is dense.
+   */
+  int jacobian(const kinsol_J_f& J_f, const double x_sun[],
+               SUNMatrix J) const {
+    if (structure_.type() == ode_jacobian_structure::kind::dense) {
+      return J_f(f_, x_, y_, dat_, dat_int_, msgs_, x_sun, J);
+    }
+    internal::colored_autodiff_jacobian(
+        "kinsol_jacobian",
+        [&](const std::vector<var>& x_var) {
+          Eigen::Matrix<var, Eigen::Dynamic, 1> fx
+              = f_(to_vector(x_var), y_, dat_, dat_int_, msgs_);
+          return std::vector<var>(fx.data(), fx.data() + fx.size());
+        },
+        std::vector<double>(x_sun, x_sun + N_), structure_, colors_,
+        col_rows_, J);
+    return 0;
+  }
+
+  template <typename G>
+  void set_jacobian_vector_fn(const G& J_v) {
+    check_flag_sundials(KINSetJacTimesVecFn(
+                            kinsol_memory_, &system_data::kinsol_jacobian_vector),
+                        "KINSetJacTimesVecFn");
+  }
+
+  void set_jacobian_vector_fn(const kinsol_difference_jacobian_vector& J_v) {}
 };
 
 }  // namespace math
@@ -10,6 +10,7 @@
 #include <kinsol/kinsol.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
 #include <nvector/nvector_serial.h>
 
 #include <vector>
@@ -48,13 +49,19 @@ namespace math {
  *            If equal to 1, the algorithm computes exact Newton steps.
  * @param[in] global_line_search does the solver use a global line search?
  *            If equal to KIN_NONE, no, if KIN_LINESEARCH, yes.
+ * @param[in] linear_solver Linear solver for the Newton steps. Defaults
+ *            to the dense direct solver.
+ * @param[in] J_v A functor that computes the products of the Jacobian
+ *            with vectors for the matrix-free linear solver. Defaults to
+ *            the difference quotients of Kinsol.
  * @return x_solution Vector of solutions to the system of equations.
  * @throw <code>std::invalid_argument</code> if Kinsol returns a negative
  *        flag when setting up the solver.
  * @throw <code>boost::math::evaluation_error</code> if Kinsol returns a
  *        negative flag after attempting to solve the equation.
  */
-template <typename F1, typename F2 = kinsol_J_f>
+template <typename F1, typename F2 = kinsol_J_f,
+          typename F3 = kinsol_difference_jacobian_vector>
 Eigen::VectorXd kinsol_solve(
     const F1& f, const Eigen::VectorXd& x, const Eigen::VectorXd& y,
     const std::vector<double>& dat, const std::vector<int>& dat_int,
@@ -62,10 +69,13 @@ Eigen::VectorXd kinsol_solve(
     double function_tolerance = 1e-6,
     long int max_num_steps = 200,  // NOLINT(runtime/int)
     bool custom_jacobian = 1, const F2& J_f = kinsol_J_f(),
-    int steps_eval_jacobian = 10, int global_line_search = KIN_LINESEARCH) {
+    int steps_eval_jacobian = 10, int global_line_search = KIN_LINESEARCH,
+    const kinsol_linear_solver& linear_solver = kinsol_linear_solver(),
+    const F3& J_v = F3()) {
   int N = x.size();
-  typedef kinsol_system_data<F1, F2> system_data;
-  system_data kinsol_data(f, J_f, x, y, dat, dat_int, msgs);
+  typedef kinsol_system_data<F1, F2, F3> system_data;
+  system_data kinsol_data(f, J_f, x, y, dat, dat_int, msgs, linear_solver,
+                          J_v);
 
   check_flag_sundials(KINInit(kinsol_data.kinsol_memory_,
                               &system_data::kinsol_f_system, kinsol_data.nv_x_),
@@ -105,7 +115,9 @@ Eigen::VectorXd kinsol_solve(
                                          kinsol_data.LS_, kinsol_data.J_),
                       "KINSetLinearSolver");
 
-  if (custom_jacobian)
+  if (kinsol_data.matrix_free())
+    kinsol_data.set_jacobian_vector_fn();
+  else if (custom_jacobian)
     check_flag_sundials(
         KINSetJacFn(kinsol_data.kinsol_memory_, &system_data::kinsol_jacobian),
         "KINSetJacFn");
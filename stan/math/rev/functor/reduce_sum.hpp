@@ -0,0 +1,169 @@
+#ifndef STAN_MATH_REV_FUNCTOR_REDUCE_SUM_HPP
+#define STAN_MATH_REV_FUNCTOR_REDUCE_SUM_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/functor/reduce_sum.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/core/accumulate_adjoints.hpp>
+#include <stan/math/rev/core/count_vars.hpp>
+#include <stan/math/rev/core/deep_copy_vars.hpp>
+#include <stan/math/rev/core/save_varis.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Reverse mode implementation of <code>reduce_sum</code>.
+ *
+ * Every slice is evaluated within a nested autodiff region on the
+ * tape of the worker thread using copies of its operands. A single
+ * reverse sweep per slice yields the partials of the slice wrt to
+ * its elements, which are stored directly, and wrt to the shared
+ * arguments, which are summed up across slices.
+ */
+template <typename F, typename T, typename... Args>
+struct reduce_sum_impl<F, var, T, Args...> {
+  struct recursive_reducer {
+    const F& f_;
+    const std::vector<T>& sliced_;
+    const std::vector<size_t>& sliced_offsets_;
+    double* sliced_partials_;
+    const size_t num_shared_terms_;
+    std::ostream* msgs_;
+    std::tuple<const Args&...> args_tuple_;
+    double sum_;
+    std::vector<double> args_adjoints_;
+
+    recursive_reducer(const F& f, const std::vector<T>& sliced,
+                      const std::vector<size_t>& sliced_offsets,
+                      double* sliced_partials, size_t num_shared_terms,
+                      std::ostream* msgs, const Args&... args)
+        : f_(f),
+          sliced_(sliced),
+          sliced_offsets_(sliced_offsets),
+          sliced_partials_(sliced_partials),
+          num_shared_terms_(num_shared_terms),
+          msgs_(msgs),
+          args_tuple_(args...),
+          sum_(0) {}
+
+    recursive_reducer(recursive_reducer& other, tbb::split)
+        : f_(other.f_),
+          sliced_(other.sliced_),
+          sliced_offsets_(other.sliced_offsets_),
+          sliced_partials_(other.sliced_partials_),
+          num_shared_terms_(other.num_shared_terms_),
+          msgs_(other.msgs_),
+          args_tuple_(other.args_tuple_),
+          sum_(0) {}
+
+    void operator()(const tbb::blocked_range<size_t>& r) {
+      if (r.empty()) {
+        return;
+      }
+      if (args_adjoints_.empty()) {
+        args_adjoints_.assign(num_shared_terms_, 0.0);
+      }
+
+      start_nested();
+      try {
+        std::vector<T> local_sub_slice;
+        local_sub_slice.reserve(r.size());
+        for (size_t i = r.begin(); i < r.end(); ++i) {
+          local_sub_slice.emplace_back(deep_copy_vars(sliced_[i]));
+        }
+
+        std::tuple<decltype(deep_copy_vars(std::declval<const Args&>()))...>
+            args_tuple_local_copy = index_apply<sizeof...(Args)>(
+                [&](auto... Is) {
+                  return std::tuple<decltype(
+                      deep_copy_vars(std::declval<const Args&>()))...>(
+                      deep_copy_vars(std::get<Is>(args_tuple_))...);
+                });
+
+        var sub_sum_v = index_apply<sizeof...(Args)>([&](auto... Is) {
+          return f_(local_sub_slice, r.begin(), r.end(), msgs_,
+                    std::get<Is>(args_tuple_local_copy)...);
+        });
+
+        sub_sum_v.grad();
+        sum_ += sub_sum_v.val();
+
+        accumulate_adjoints(sliced_partials_ + sliced_offsets_[r.begin()],
+                            local_sub_slice);
+        index_apply<sizeof...(Args)>([&](auto... Is) {
+          return accumulate_adjoints(args_adjoints_.data(),
+                                     std::get<Is>(args_tuple_local_copy)...);
+        });
+      } catch (const std::exception& e) {
+        recover_memory_nested();
+        throw;
+      }
+      recover_memory_nested();
+    }
+
+    void join(const recursive_reducer& rhs) {
+      sum_ += rhs.sum_;
+      if (args_adjoints_.empty()) {
+        args_adjoints_ = rhs.args_adjoints_;
+      } else if (!rhs.args_adjoints_.empty()) {
+        for (size_t i = 0; i < num_shared_terms_; ++i) {
+          args_adjoints_[i] += rhs.args_adjoints_[i];
+        }
+      }
+    }
+  };
+
+  var operator()(const F& f, const std::vector<T>& sliced, int grainsize,
+                 std::ostream* msgs, const Args&... args) const {
+    const size_t num_jobs = sliced.size();
+    std::vector<size_t> sliced_offsets(num_jobs + 1, 0);
+    for (size_t i = 0; i < num_jobs; ++i) {
+      sliced_offsets[i + 1] = sliced_offsets[i] + count_vars(sliced[i]);
+    }
+    const size_t num_sliced_terms = sliced_offsets[num_jobs];
+    const size_t num_shared_terms = count_vars(args...);
+    const size_t num_terms = num_sliced_terms + num_shared_terms;
+
+    vari** varis
+        = ChainableStack::instance_->memalloc_.alloc_array<vari*>(num_terms);
+    double* partials
+        = ChainableStack::instance_->memalloc_.alloc_array<double>(num_terms);
+    std::fill(partials, partials + num_terms, 0.0);
+
+    save_varis(varis, sliced);
+    save_varis(varis + num_sliced_terms, args...);
+
+    recursive_reducer worker(f, sliced, sliced_offsets, partials,
+                             num_shared_terms, msgs, args...);
+    const tbb::blocked_range<size_t> range(0, num_jobs, grainsize);
+#ifdef STAN_THREADS
+    tbb::parallel_reduce(range, worker);
+#else
+    worker(range);
+#endif
+
+    std::copy(worker.args_adjoints_.begin(), worker.args_adjoints_.end(),
+              partials + num_sliced_terms);
+
+    return var(new precomputed_gradients_vari(worker.sum_, num_terms, varis,
+                                              partials));
+  }
+};
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+
+#endif
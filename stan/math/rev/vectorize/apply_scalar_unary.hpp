@@ -2,11 +2,125 @@
 #define STAN_MATH_REV_VECTORIZE_APPLY_SCALAR_UNARY_HPP
 
 #include <stan/math/prim/vectorize/apply_scalar_unary.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/rev/core/chainablestack.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/var_matrix.hpp>
+#include <stan/math/rev/core/vari.hpp>
+#include <stan/math/rev/fun/typedefs.hpp>
+#include <type_traits>
+#include <vector>
 
 namespace stan {
 namespace math {
 
+/**
+ * Derivative of the unary scalar function defined by the template
+ * class <code>F</code>.
+ *
+ * <p>Specializations derive from <code>std::true_type</code> and
+ * define a static function <code>apply(x, fx)</code> returning the
+ * derivative of <code>F::fun</code> at the double value
+ * <code>x</code>, where <code>fx = F::fun(x)</code>. The
+ * specializations live next to the reverse mode implementation of
+ * the scalar function.
+ *
+ * <p>Applying a function with a derivative to a container of
+ * <code>var</code> computes all values and derivatives in one pass
+ * and places a single <code>vari</code> on the stack for the whole
+ * container, instead of one per element.
+ *
+ * @tparam F Type of function.
+ */
+template <typename F>
+struct apply_scalar_unary_derivative : std::false_type {};
+
+namespace internal {
+/**
+ * Elementwise application of a unary function to a container of
+ * variables. The derivatives are stored on the arena during the
+ * forward pass and the results are non-chaining varis, so the
+ * reverse pass is one loop over the container.
+ *
+ * @tparam F Type of function with a specialization of
+ * <code>apply_scalar_unary_derivative</code>.
+ */
+template <typename F>
+class apply_scalar_unary_vari : public vari {
+ public:
+  size_t size_;
+  vari** x_vi_;
+  vari** fx_vi_;
+  double* dfx_;
+
+  /**
+   * Construct the results of applying F to the specified operands.
+   *
+   * @param size number of operands
+   * @param x_vi operands allocated on the arena
+   */
+  apply_scalar_unary_vari(size_t size, vari** x_vi)
+      : vari(0.0),
+        size_(size),
+        x_vi_(x_vi),
+        fx_vi_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(size)),
+        dfx_(ChainableStack::instance_->memalloc_.alloc_array<double>(size)) {
+    double* fx = ChainableStack::instance_->memalloc_.alloc_array<double>(size);
+    for (size_t i = 0; i < size_; ++i) {
+      fx[i] = F::fun(x_vi_[i]->val_);
+    }
+    for (size_t i = 0; i < size_; ++i) {
+      dfx_[i] = apply_scalar_unary_derivative<F>::apply(x_vi_[i]->val_, fx[i]);
+    }
+    for (size_t i = 0; i < size_; ++i) {
+      fx_vi_[i] = new vari(fx[i], false);
+    }
+  }
+
+  virtual void chain() {
+    for (size_t i = 0; i < size_; ++i) {
+      x_vi_[i]->adj_ += fx_vi_[i]->adj_ * dfx_[i];
+    }
+  }
+};
+
+/**
+ * Elementwise application of a unary function to a
+ * <code>var_matrix</code>. Values and derivatives are contiguous on
+ * the arena and the reverse pass is a single array update.
+ *
+ * @tparam F Type of function with a specialization of
+ * <code>apply_scalar_unary_derivative</code>.
+ */
+template <typename F>
+class apply_scalar_unary_var_matrix_vari : public var_matrix_vari {
+ public:
+  var_matrix_vari* x_;
+  double* dfx_;
+
+  explicit apply_scalar_unary_var_matrix_vari(var_matrix_vari* x)
+      : var_matrix_vari(x->rows_, x->cols_),
+        x_(x),
+        dfx_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            x->size())) {
+    const Eigen::Index size = x_->size();
+    for (Eigen::Index i = 0; i < size; ++i) {
+      vals_[i] = F::fun(x_->vals_[i]);
+    }
+    for (Eigen::Index i = 0; i < size; ++i) {
+      dfx_[i] = apply_scalar_unary_derivative<F>::apply(x_->vals_[i], vals_[i]);
+    }
+  }
+
+  virtual void chain() {
+    x_->adj().array()
+        += adj().array()
+           * Eigen::Map<const Eigen::ArrayXXd>(dfx_, rows_, cols_);
+  }
+};
+}  // namespace internal
+
 /**
  * Template specialization to var for vectorizing a unary scalar
  * function.  This is a base scalar specialization.  It applies
@@ -31,6 +145,148 @@ struct apply_scalar_unary<F, var> {
   static inline return_t apply(const var& x) { return F::fun(x); }
 };
 
+/**
+ * Template specialization for vectorized functions applying to
+ * Eigen matrices of var. If F has a derivative the whole matrix is
+ * handled by a single vari, otherwise F is applied elementwise.
+ *
+ * @tparam F Type of function to apply.
+ * @tparam T Type of argument to which function is applied.
+ */
+template <typename F, typename T>
+struct apply_scalar_unary<F, T, require_eigen_vt<is_var, T>> {
+  /**
+   * Return type, a plain matrix of var.
+   */
+  using return_t = plain_type_t<T>;
+
+  /**
+   * Apply the function specified by F to the specified matrix with
+   * a single vari.
+   *
+   * @param x Matrix to which operation is applied.
+   * @return Componentwise application of the function specified
+   * by F to the specified matrix.
+   */
+  template <typename G = F, require_t<apply_scalar_unary_derivative<G>>...>
+  static inline return_t apply(const T& x) {
+    return_t fx(x.rows(), x.cols());
+    if (x.size() == 0) {
+      return fx;
+    }
+    vari** x_vi
+        = ChainableStack::instance_->memalloc_.alloc_array<vari*>(x.size());
+    Eigen::Map<matrix_vi>(x_vi, x.rows(), x.cols()) = x.vi();
+    auto* vi = new internal::apply_scalar_unary_vari<F>(x.size(), x_vi);
+    for (Eigen::Index i = 0; i < fx.size(); ++i) {
+      fx.coeffRef(i).vi_ = vi->fx_vi_[i];
+    }
+    return fx;
+  }
+
+  /**
+   * Apply the function specified by F to each coefficient of the
+   * specified matrix.
+   *
+   * @param x Matrix to which operation is applied.
+   * @return Componentwise application of the function specified
+   * by F to the specified matrix.
+   */
+  template <typename G = F, require_not_t<apply_scalar_unary_derivative<G>>...>
+  static inline return_t apply(const T& x) {
+    return x.unaryExpr([](const var& x) { return F::fun(x); });
+  }
+};
+
+/**
+ * Template specialization for vectorized functions applying to
+ * standard vectors of var. If F has a derivative the whole vector
+ * is handled by a single vari, otherwise F is applied elementwise.
+ *
+ * @tparam F Type of function to apply.
+ */
+template <typename F>
+struct apply_scalar_unary<F, std::vector<var>> {
+  /**
+   * Return type, a standard vector of var.
+   */
+  using return_t = std::vector<var>;
+
+  /**
+   * Apply the function specified by F to the specified vector with
+   * a single vari.
+   *
+   * @param x Argument container.
+   * @return Elementwise application of F to the elements of the
+   * container.
+   */
+  template <typename G = F, require_t<apply_scalar_unary_derivative<G>>...>
+  static inline return_t apply(const std::vector<var>& x) {
+    return_t fx(x.size());
+    if (x.empty()) {
+      return fx;
+    }
+    vari** x_vi
+        = ChainableStack::instance_->memalloc_.alloc_array<vari*>(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      x_vi[i] = x[i].vi_;
+    }
+    auto* vi = new internal::apply_scalar_unary_vari<F>(x.size(), x_vi);
+    for (size_t i = 0; i < x.size(); ++i) {
+      fx[i].vi_ = vi->fx_vi_[i];
+    }
+    return fx;
+  }
+
+  /**
+   * Apply the function specified by F to each element of the
+   * specified vector.
+   *
+   * @param x Argument container.
+   * @return Elementwise application of F to the elements of the
+   * container.
+   */
+  template <typename G = F, require_not_t<apply_scalar_unary_derivative<G>>...>
+  static inline return_t apply(const std::vector<var>& x) {
+    return_t fx(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      fx[i] = F::fun(x[i]);
+    }
+    return fx;
+  }
+};
+
+/**
+ * Template specialization for vectorized functions applying to
+ * struct-of-arrays matrices. Only functions with a derivative can be
+ * applied to a <code>var_matrix</code>.
+ *
+ * @tparam F Type of function to apply.
+ */
+template <typename F>
+struct apply_scalar_unary<F, var_matrix> {
+  static_assert(apply_scalar_unary_derivative<F>::value,
+                "apply_scalar_unary_derivative must be specialized for F "
+                "to apply F to a var_matrix");
+
+  /**
+   * Return type, a <code>var_matrix</code>.
+   */
+  using return_t = var_matrix;
+
+  /**
+   * Apply the function specified by F to the specified matrix.
+   *
+   * @param x Matrix to which operation is applied.
+   * @return Componentwise application of the function specified
+   * by F to the specified matrix.
+   */
+  static inline return_t apply(const var_matrix& x) {
+    return var_matrix(
+        new internal::apply_scalar_unary_var_matrix_vari<F>(x.vi_));
+  }
+};
+
 }  // namespace math
 }  // namespace stan
 #endif
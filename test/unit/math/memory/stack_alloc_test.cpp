@@ -119,3 +119,130 @@ TEST(stack_alloc, in_stack_second_block) {
   EXPECT_FALSE(allocator.in_stack(x));
   EXPECT_FALSE(allocator.in_stack(y));
 }
+
+TEST(stack_alloc, policy_growth) {
+  stan::math::stack_alloc_policy policy;
+  policy.initial_nbytes = 1024;
+  policy.growth_factor = 1.5;
+  stan::math::stack_alloc allocator(policy);
+  EXPECT_EQ(1024, allocator.bytes_reserved());
+  allocator.alloc(1000);
+  allocator.alloc(1000);
+  EXPECT_EQ(1024 + 1536, allocator.bytes_reserved());
+  allocator.alloc(1500);
+  EXPECT_EQ(1024 + 1536 + 2304, allocator.bytes_reserved());
+}
+
+TEST(stack_alloc, policy_errors) {
+  stan::math::stack_alloc_policy policy;
+  policy.growth_factor = 0.5;
+  EXPECT_THROW(stan::math::stack_alloc{policy}, std::invalid_argument);
+  policy = stan::math::stack_alloc_policy();
+  policy.array_alignment = 24;
+  EXPECT_THROW(stan::math::stack_alloc{policy}, std::invalid_argument);
+  policy = stan::math::stack_alloc_policy();
+  policy.initial_nbytes = 0;
+  EXPECT_THROW(stan::math::stack_alloc{policy}, std::invalid_argument);
+}
+
+TEST(stack_alloc, array_alignment) {
+  stan::math::stack_alloc_policy policy;
+  policy.initial_nbytes = 256;
+  policy.array_alignment = 64;
+  stan::math::stack_alloc allocator(policy);
+  for (int n = 1; n < 100; ++n) {
+    allocator.alloc(n % 7 + 1);
+    double* x = allocator.alloc_array<double>(n);
+    EXPECT_TRUE(stan::math::is_aligned(x, 64U));
+    for (int i = 0; i < n; ++i)
+      x[i] = i;
+    EXPECT_TRUE(allocator.in_stack(x + n - 1));
+  }
+}
+
+TEST(stack_alloc, max_nbytes) {
+  stan::math::stack_alloc_policy policy;
+  policy.initial_nbytes = 1024;
+  policy.max_nbytes = 4096;
+  stan::math::stack_alloc allocator(policy);
+  allocator.alloc(1000);
+  allocator.alloc(2500);
+  EXPECT_EQ(1024 + 2500, allocator.bytes_reserved());
+  // the growth is clipped to the remaining bytes
+  allocator.alloc(500);
+  EXPECT_EQ(4096, allocator.bytes_reserved());
+  EXPECT_THROW(allocator.alloc(2000), std::runtime_error);
+  allocator.recover_all();
+  EXPECT_NO_THROW(allocator.alloc(2000));
+}
+
+TEST(stack_alloc, max_nbytes_alloc_after_throw) {
+  stan::math::stack_alloc_policy policy;
+  policy.initial_nbytes = 1024;
+  policy.max_nbytes = 4096;
+  policy.array_alignment = 64;
+  stan::math::stack_alloc allocator(policy);
+  allocator.alloc(1000);
+  allocator.alloc(2500);
+  allocator.alloc(500);
+  size_t used = allocator.bytes_used();
+  EXPECT_THROW(allocator.alloc(2000), std::runtime_error);
+  EXPECT_THROW(allocator.alloc_array<double>(250), std::runtime_error);
+  EXPECT_EQ(used, allocator.bytes_used());
+  EXPECT_EQ(4096, allocator.bytes_allocated());
+
+  // the remainder of the last block is still available
+  char* x = static_cast<char*>(allocator.alloc(40));
+  EXPECT_TRUE(allocator.in_stack(x + 39));
+  EXPECT_EQ(used + 40, allocator.bytes_used());
+  EXPECT_THROW(allocator.alloc(100), std::runtime_error);
+  EXPECT_EQ(used + 40, allocator.bytes_used());
+
+  allocator.recover_all();
+  EXPECT_EQ(0, allocator.bytes_used());
+  double* y = allocator.alloc_array<double>(250);
+  EXPECT_TRUE(stan::math::is_aligned(y, 64U));
+  EXPECT_TRUE(allocator.in_stack(y + 249));
+}
+
+TEST(stack_alloc, trim) {
+  stan::math::stack_alloc_policy policy;
+  policy.initial_nbytes = 1024;
+  stan::math::stack_alloc allocator(policy);
+  // one large iteration
+  for (int i = 0; i < 20; ++i)
+    allocator.alloc(1000);
+  allocator.recover_all();
+  size_t reserved_large = allocator.bytes_reserved();
+  allocator.trim();
+  EXPECT_EQ(reserved_large, allocator.bytes_reserved());
+
+  // followed by small iterations
+  for (int k = 0; k < 3; ++k) {
+    allocator.alloc(1000);
+    allocator.alloc(1000);
+    allocator.recover_all();
+  }
+  allocator.trim();
+  EXPECT_EQ(1024 + 2048, allocator.bytes_reserved());
+  allocator.alloc(1000);
+  allocator.alloc(1000);
+  EXPECT_EQ(1024 + 2048, allocator.bytes_reserved());
+}
+
+TEST(stack_alloc, mmap_blocks) {
+  stan::math::stack_alloc_policy policy;
+  policy.initial_nbytes = 1 << 12;
+  policy.mmap_threshold = 1 << 16;
+  policy.madvise_hugepage = true;
+  stan::math::stack_alloc allocator(policy);
+  for (int i = 0; i < 100; ++i) {
+    char* x = static_cast<char*>(allocator.alloc(1 << 14));
+    x[0] = 1;
+    x[(1 << 14) - 1] = 2;
+    EXPECT_TRUE(allocator.in_stack(x));
+  }
+  EXPECT_LE(100 * (1 << 14), allocator.bytes_reserved());
+  allocator.free_all();
+  EXPECT_EQ(1 << 12, allocator.bytes_reserved());
+}
@@ -0,0 +1,38 @@
+#include <test/unit/math/test_ad.hpp>
+
+TEST(MathMixMatFun, hmm_marginal) {
+  // the transition matrix and the initial distribution are the softmax
+  // of the rows of Gamma and of rho
+  auto f = [](const auto& log_omegas, const auto& Gamma, const auto& rho) {
+    using T_Gamma = typename std::decay_t<decltype(Gamma)>::Scalar;
+    Eigen::Matrix<T_Gamma, Eigen::Dynamic, Eigen::Dynamic> Gamma_simplex(
+        Gamma.rows(), Gamma.cols());
+    for (int i = 0; i < Gamma.rows(); ++i) {
+      Gamma_simplex.row(i) = stan::math::softmax(
+          Eigen::Matrix<T_Gamma, Eigen::Dynamic, 1>(Gamma.row(i).transpose()));
+    }
+    return stan::math::hmm_marginal(log_omegas, Gamma_simplex,
+                                    stan::math::softmax(rho));
+  };
+
+  stan::test::ad_tolerances tols;
+  tols.hessian_hessian_ = 2e-2;
+  tols.hessian_fvar_hessian_ = 2e-2;
+
+  Eigen::MatrixXd log_omegas(2, 1);
+  log_omegas << -1.2, -0.3;
+  Eigen::MatrixXd Gamma(2, 2);
+  Gamma << 0.3, -0.5, 1.1, 0.2;
+  Eigen::VectorXd rho(2);
+  rho << -0.4, 0.6;
+  stan::test::expect_ad(tols, f, log_omegas, Gamma, rho);
+
+  Eigen::MatrixXd log_omegas2(3, 4);
+  log_omegas2 << -1.2, -0.3, -4.1, -2.2, -0.5, -2.6, -1.1, -0.4, -3.0, -1.4,
+      -0.2, -1.9;
+  Eigen::MatrixXd Gamma2(3, 3);
+  Gamma2 << 0.3, -0.5, 1.1, 0.2, 0.9, -1.3, -0.1, 0.4, 0.7;
+  Eigen::VectorXd rho2(3);
+  rho2 << -0.4, 0.6, 0.1;
+  stan::test::expect_ad(tols, f, log_omegas2, Gamma2, rho2);
+}
@@ -0,0 +1,65 @@
+#include <stan/math/mix.hpp>
+#include <test/unit/math/rev/functor/util_algebra_solver.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(AgradMixAlgebraSolver, forward_jacobian_vector) {
+  const int N = 5;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(N);
+  Eigen::VectorXd y(2);
+  y << 1.0, -0.5;
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+
+  Eigen::VectorXd u(N);
+  u << 0.3, -0.2, 1.1, 0.5, -0.7;
+  Eigen::VectorXd v(N);
+  v << 1.0, 2.0, -1.0, 0.5, 0.25;
+  Eigen::VectorXd Jv(N);
+  stan::math::kinsol_forward_jacobian_vector()(tridiagonal_eq_functor(), x, y,
+                                               dat, dat_int, 0, u.data(),
+                                               v.data(), Jv.data());
+
+  for (int i = 0; i < N; ++i) {
+    double expected = (3 + 0.3 * u(i) * u(i)) * v(i);
+    if (i > 0) {
+      expected -= v(i - 1);
+    }
+    if (i < N - 1) {
+      expected -= v(i + 1);
+    }
+    EXPECT_FLOAT_EQ(expected, Jv(i));
+  }
+}
+
+TEST(AgradMixAlgebraSolver, newton_gmres_forward_jacobian_vector) {
+  using stan::math::kinsol_linear_solver;
+  using stan::math::var;
+  const int N = 20;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(N);
+  Eigen::VectorXd y(2);
+  y << 1.0, -0.5;
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+
+  Eigen::VectorXd theta = stan::math::algebra_solver_newton(
+      tridiagonal_eq_functor(), x, y, dat, dat_int, 0, 1e-10, 1e-12);
+  Eigen::VectorXd theta_gmres = stan::math::algebra_solver_newton(
+      tridiagonal_eq_functor(), x, y, dat, dat_int, 0, 1e-10, 1e-12, 200,
+      kinsol_linear_solver::gmres(10),
+      stan::math::kinsol_forward_jacobian_vector());
+  for (int i = 0; i < N; ++i) {
+    EXPECT_NEAR(theta(i), theta_gmres(i), 1e-8);
+  }
+
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y_var = y;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> theta_var
+      = stan::math::algebra_solver_newton(
+          tridiagonal_eq_functor(), x, y_var, dat, dat_int, 0, 1e-10, 1e-12,
+          200, kinsol_linear_solver::gmres(10),
+          stan::math::kinsol_forward_jacobian_vector());
+  for (int i = 0; i < N; ++i) {
+    EXPECT_NEAR(theta(i), theta_var(i).val(), 1e-8);
+  }
+  stan::math::recover_memory();
+}
@@ -0,0 +1,81 @@
+#include <stan/math/mix.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/harmonic_oscillator.hpp>
+#include <test/unit/math/prim/functor/lorenz.hpp>
+#include <vector>
+
+template <typename T_initial, typename T_param>
+void expect_forward_coupled_system(const std::vector<T_initial>& y0,
+                                   const std::vector<T_param>& theta) {
+  lorenz_ode_fun f;
+  auto f_fwd = stan::math::forward_sensitivity(f);
+  std::vector<double> x;
+  std::vector<int> x_int;
+
+  stan::math::coupled_ode_system<lorenz_ode_fun, T_initial, T_param> system(
+      f, y0, theta, x, x_int, nullptr);
+  stan::math::coupled_ode_system<decltype(f_fwd), T_initial, T_param>
+      system_fwd(f_fwd, y0, theta, x, x_int, nullptr);
+
+  ASSERT_EQ(system.size(), system_fwd.size());
+  std::vector<double> z0 = system.initial_state();
+  std::vector<double> z0_fwd = system_fwd.initial_state();
+  for (size_t i = 0; i < z0.size(); ++i) {
+    EXPECT_FLOAT_EQ(z0[i], z0_fwd[i]);
+  }
+
+  std::vector<double> z(system.size());
+  for (size_t i = 0; i < z.size(); ++i) {
+    z[i] = std::sin(i + 0.5);
+  }
+  std::vector<double> dz_dt(system.size());
+  std::vector<double> dz_dt_fwd(system.size());
+  system(z, dz_dt, 0.5);
+  system_fwd(z, dz_dt_fwd, 0.5);
+  for (size_t i = 0; i < z.size(); ++i) {
+    EXPECT_FLOAT_EQ(dz_dt[i], dz_dt_fwd[i]);
+  }
+}
+
+TEST(MixFunctor, coupled_ode_system_forward_sensitivity) {
+  using stan::math::var;
+  std::vector<double> y0{10.0, -1.0, 3.0};
+  std::vector<double> theta{10.0, 28.0, 8.0 / 3.0};
+  std::vector<var> y0_v(y0.begin(), y0.end());
+  std::vector<var> theta_v(theta.begin(), theta.end());
+
+  expect_forward_coupled_system(y0, theta_v);
+  expect_forward_coupled_system(y0_v, theta);
+  expect_forward_coupled_system(y0_v, theta_v);
+  stan::math::recover_memory();
+}
+
+TEST(MixFunctor, integrate_ode_rk45_forward_sensitivity) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<double> ts{0.5, 1.0, 2.0};
+
+  std::vector<std::vector<double>> grads;
+  for (int fwd = 0; fwd < 2; ++fwd) {
+    std::vector<var> y0{1.0, 0.5};
+    std::vector<var> theta{0.15};
+    std::vector<std::vector<var>> y
+        = fwd ? stan::math::integrate_ode_rk45(
+                    stan::math::forward_sensitivity(f), y0, 0.0, ts, theta, x,
+                    x_int)
+              : stan::math::integrate_ode_rk45(f, y0, 0.0, ts, theta, x,
+                                               x_int);
+    var lp = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+      lp += (i + 1) * y[i][0] - y[i][1];
+    }
+    lp.grad();
+    grads.push_back({lp.val(), y0[0].adj(), y0[1].adj(), theta[0].adj()});
+    stan::math::recover_memory();
+  }
+  for (size_t i = 0; i < grads[0].size(); ++i) {
+    EXPECT_NEAR(grads[0][i], grads[1][i], 1e-6);
+  }
+}
@@ -48,3 +48,55 @@ TEST(MathMixMatFunctor, FiniteDiffGradientAuto) {
   w << 1, 2, 3, 4, 5;
   expect_match_autodiff(log_fun, w);
 }
+
+TEST(MathMixMatFunctor, FiniteDiffGradientAutoForward) {
+  using stan::math::finite_diff_stencil;
+  auto f = [](const auto& x) {
+    return stan::math::sum(stan::math::log(x)) + x(0) * x(1) * x(2);
+  };
+  Eigen::VectorXd x(6);
+  x << 1, 2, 3, 4, 5, 1e5;
+  double fx;
+  Eigen::VectorXd grad_fx;
+  stan::math::gradient(f, x, fx, grad_fx);
+
+  // reuses f(x) and evaluates f once per dimension
+  int evals = 0;
+  auto f_count = [&](const Eigen::VectorXd& y) {
+    ++evals;
+    return f(y);
+  };
+  double fx_fd;
+  Eigen::VectorXd grad_fd;
+  stan::math::finite_diff_gradient_auto(f_count, x, fx_fd, grad_fd,
+                                        finite_diff_stencil::forward);
+  EXPECT_EQ(7, evals);
+  EXPECT_FLOAT_EQ(fx, fx_fd);
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(grad_fx(i), grad_fd(i), 1e-6 * (1 + std::fabs(grad_fx(i))));
+  }
+}
+
+// the stencil is only evaluated in parallel whenever threading is used
+#ifdef STAN_THREADS
+TEST(MathMixMatFunctor, FiniteDiffGradientAutoParallel) {
+  using stan::math::finite_diff_stencil;
+  auto f = [](const auto& x) {
+    return stan::math::sum(stan::math::log(x)) + x(0) * x(1) * x(2);
+  };
+  Eigen::VectorXd x(6);
+  x << 1, 2, 3, 4, 5, 1e5;
+  double fx_fd;
+  for (auto stencil :
+       {finite_diff_stencil::central, finite_diff_stencil::forward}) {
+    Eigen::VectorXd grad_serial;
+    Eigen::VectorXd grad_parallel;
+    stan::math::finite_diff_gradient_auto(f, x, fx_fd, grad_serial, stencil);
+    stan::math::finite_diff_gradient_auto(f, x, fx_fd, grad_parallel, stencil,
+                                          true);
+    for (int i = 0; i < x.size(); ++i) {
+      EXPECT_FLOAT_EQ(grad_serial(i), grad_parallel(i));
+    }
+  }
+}
+#endif
@@ -55,3 +55,65 @@ TEST(MixMatFunctor, FiniteDiffHessianAuto) {
   w << 1, 2, 3, 4, 5;
   test_hessian_finite_diff("log_fun({1, 2, 3, 4, 5})", log_fun, w);
 }
+
+TEST(MixMatFunctor, FiniteDiffHessianAutoForward) {
+  using stan::math::finite_diff_stencil;
+  auto f = [](const auto& x) {
+    return stan::math::sum(stan::math::log(x)) + x(0) * x(1) * x(2)
+           + stan::math::exp(x(3) / x(4));
+  };
+  Eigen::VectorXd x(5);
+  x << 1, 2, 3, 4, 5;
+  double fx_ad;
+  Eigen::VectorXd grad_ad;
+  Eigen::MatrixXd hess_ad;
+  stan::math::hessian(f, x, fx_ad, grad_ad, hess_ad);
+
+  // 1 + 2 d + d (d - 1) / 2 evaluations
+  int evals = 0;
+  auto f_count = [&](const Eigen::VectorXd& y) {
+    ++evals;
+    return f(y);
+  };
+  double fx;
+  Eigen::VectorXd grad_fx;
+  Eigen::MatrixXd hess_fx;
+  stan::math::finite_diff_hessian_auto(f_count, x, fx, grad_fx, hess_fx,
+                                       finite_diff_stencil::forward);
+  EXPECT_EQ(21, evals);
+  EXPECT_FLOAT_EQ(fx_ad, fx);
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(grad_ad(i), grad_fx(i), 1e-8);
+    for (int j = 0; j < x.size(); ++j) {
+      EXPECT_NEAR(hess_ad(i, j), hess_fx(i, j), 1e-4);
+      EXPECT_EQ(hess_fx(i, j), hess_fx(j, i));
+    }
+  }
+}
+
+// the stencil is only evaluated in parallel whenever threading is used
+#ifdef STAN_THREADS
+TEST(MixMatFunctor, FiniteDiffHessianAutoParallel) {
+  using stan::math::finite_diff_stencil;
+  auto f = [](const auto& x) {
+    return stan::math::sum(stan::math::log(x)) + x(0) * x(1) * x(2)
+           + stan::math::exp(x(3) / x(4));
+  };
+  Eigen::VectorXd x(5);
+  x << 1, 2, 3, 4, 5;
+  double fx;
+  Eigen::VectorXd grad_fx;
+  for (auto stencil :
+       {finite_diff_stencil::central, finite_diff_stencil::forward}) {
+    Eigen::MatrixXd hess_serial;
+    Eigen::MatrixXd hess_parallel;
+    stan::math::finite_diff_hessian_auto(f, x, fx, grad_fx, hess_serial,
+                                         stencil);
+    stan::math::finite_diff_hessian_auto(f, x, fx, grad_fx, hess_parallel,
+                                         stencil, true);
+    for (int i = 0; i < hess_serial.size(); ++i) {
+      EXPECT_FLOAT_EQ(hess_serial(i), hess_parallel(i));
+    }
+  }
+}
+#endif
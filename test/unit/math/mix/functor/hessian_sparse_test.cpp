@@ -0,0 +1,77 @@
+#include <stan/math/mix.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// chain of coupled terms with a tridiagonal Hessian
+struct tridiagonal_fun {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T y = 0;
+    for (int i = 0; i < x.size(); ++i) {
+      y += stan::math::exp(x(i)) * (i + 1);
+    }
+    for (int i = 1; i < x.size(); ++i) {
+      y += x(i - 1) * x(i) * x(i);
+    }
+    return y;
+  }
+};
+}  // namespace
+
+TEST(MixFunctor, hessianColoring) {
+  const int N = 10;
+  std::vector<Eigen::Triplet<double>> entries;
+  for (int i = 1; i < N; ++i) {
+    entries.emplace_back(i, i - 1, 1.0);
+  }
+  Eigen::SparseMatrix<double> pattern(N, N);
+  pattern.setFromTriplets(entries.begin(), entries.end());
+
+  Eigen::SparseMatrix<double> S
+      = stan::math::internal::hessian_pattern(pattern);
+  EXPECT_EQ(3 * N - 2, S.nonZeros());
+  std::vector<int> color = stan::math::internal::hessian_coloring(S);
+  ASSERT_EQ(N, color.size());
+  for (int j = 0; j < N; ++j) {
+    EXPECT_EQ(j % 3, color[j]);
+  }
+}
+
+TEST(MixFunctor, hessianSparse) {
+  tridiagonal_fun f;
+  const int N = 12;
+  Eigen::VectorXd x(N);
+  for (int i = 0; i < N; ++i) {
+    x(i) = std::sin(i + 1.0);
+  }
+  std::vector<Eigen::Triplet<double>> entries;
+  for (int i = 1; i < N; ++i) {
+    entries.emplace_back(i - 1, i, 1.0);
+  }
+  Eigen::SparseMatrix<double> pattern(N, N);
+  pattern.setFromTriplets(entries.begin(), entries.end());
+
+  double fx;
+  Eigen::VectorXd grad;
+  Eigen::MatrixXd H;
+  stan::math::hessian(f, x, fx, grad, H);
+
+  double fx_sparse;
+  Eigen::VectorXd grad_sparse;
+  Eigen::SparseMatrix<double> H_sparse;
+  stan::math::hessian_sparse(f, x, pattern, fx_sparse, grad_sparse, H_sparse);
+  EXPECT_FLOAT_EQ(fx, fx_sparse);
+  Eigen::MatrixXd H_dense = H_sparse;
+  for (int i = 0; i < N; ++i) {
+    EXPECT_FLOAT_EQ(grad(i), grad_sparse(i));
+    for (int j = 0; j < N; ++j) {
+      EXPECT_FLOAT_EQ(H(i, j), H_dense(i, j));
+    }
+  }
+
+  EXPECT_THROW(stan::math::hessian_sparse(f, x.head(N - 1), pattern, fx, grad,
+                                          H_sparse),
+               std::invalid_argument);
+}
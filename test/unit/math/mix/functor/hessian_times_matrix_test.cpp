@@ -0,0 +1,75 @@
+#include <stan/math/mix.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+// chain of coupled terms with a tridiagonal Hessian
+struct tridiagonal_fun {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T y = 0;
+    for (int i = 0; i < x.size(); ++i) {
+      y += stan::math::exp(x(i)) * (i + 1);
+    }
+    for (int i = 1; i < x.size(); ++i) {
+      y += x(i - 1) * x(i) * x(i);
+    }
+    return y;
+  }
+};
+}  // namespace
+
+TEST(MixFunctor, hessianTimesMatrix) {
+  tridiagonal_fun f;
+  Eigen::VectorXd x(5);
+  x << 0.1, -0.3, 0.7, 1.2, -2.0;
+  Eigen::MatrixXd V(5, 3);
+  V << 1, 0, 2, -1, 1, 0, 0.5, 0, 1, 0, 2, 0, 3, 0, -1;
+
+  double fx;
+  Eigen::VectorXd grad;
+  Eigen::MatrixXd H;
+  stan::math::hessian(f, x, fx, grad, H);
+
+  double fx_V;
+  Eigen::VectorXd grad_V;
+  Eigen::MatrixXd HV;
+  stan::math::hessian_times_matrix(f, x, V, fx_V, grad_V, HV, 2);
+  EXPECT_FLOAT_EQ(fx, fx_V);
+  ASSERT_EQ(5, grad_V.size());
+  ASSERT_EQ(5, HV.rows());
+  ASSERT_EQ(3, HV.cols());
+  Eigen::MatrixXd HV_expected = H * V;
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FLOAT_EQ(grad(i), grad_V(i));
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_FLOAT_EQ(HV_expected(i, j), HV(i, j));
+    }
+  }
+
+  // one evaluation per column, including the value and the gradient
+  std::atomic<int> evals{0};
+  auto f_count = [&](const Eigen::Matrix<stan::math::fvar<stan::math::var>,
+                                         Eigen::Dynamic, 1>& y) {
+    ++evals;
+    return f(y);
+  };
+  stan::math::hessian_times_matrix(f_count, x, V, fx_V, grad_V, HV);
+  EXPECT_EQ(3, evals);
+  EXPECT_FLOAT_EQ(fx, fx_V);
+  EXPECT_FLOAT_EQ(grad(4), grad_V(4));
+
+  stan::math::hessian_times_matrix(f, x, Eigen::MatrixXd(5, 0), fx_V, grad_V,
+                                   HV);
+  EXPECT_FLOAT_EQ(fx, fx_V);
+  EXPECT_FLOAT_EQ(grad(2), grad_V(2));
+  EXPECT_EQ(0, HV.cols());
+
+  EXPECT_THROW(
+      stan::math::hessian_times_matrix(f, x, V.topRows(4), fx, grad, HV),
+      std::invalid_argument);
+  EXPECT_THROW(stan::math::hessian_times_matrix(f, x, V, fx, grad, HV, 0),
+               std::domain_error);
+  EXPECT_TRUE(stan::math::empty_nested());
+}
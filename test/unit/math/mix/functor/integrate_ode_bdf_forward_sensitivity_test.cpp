@@ -0,0 +1,34 @@
+#include <stan/math/mix.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/harmonic_oscillator.hpp>
+#include <vector>
+
+TEST(MixFunctor, integrate_ode_bdf_forward_sensitivity) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<double> ts{0.5, 1.0, 2.0};
+
+  std::vector<std::vector<double>> grads;
+  for (int fwd = 0; fwd < 2; ++fwd) {
+    std::vector<var> y0{1.0, 0.5};
+    std::vector<var> theta{0.15};
+    std::vector<std::vector<var>> y
+        = fwd ? stan::math::integrate_ode_bdf(
+                    stan::math::forward_sensitivity(f), y0, 0.0, ts, theta, x,
+                    x_int, nullptr, 1e-10, 1e-10)
+              : stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta, x, x_int,
+                                              nullptr, 1e-10, 1e-10);
+    var lp = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+      lp += (i + 1) * y[i][0] - y[i][1];
+    }
+    lp.grad();
+    grads.push_back({lp.val(), y0[0].adj(), y0[1].adj(), theta[0].adj()});
+    stan::math::recover_memory();
+  }
+  for (size_t i = 0; i < grads[0].size(); ++i) {
+    EXPECT_NEAR(grads[0][i], grads[1][i], 1e-6);
+  }
+}
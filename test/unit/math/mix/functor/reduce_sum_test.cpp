@@ -0,0 +1,66 @@
+#include <stan/math/mix.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+struct cubic_sum_lpdf {
+  template <typename T1, typename T2>
+  inline stan::return_type_t<T1, T2> operator()(
+      const std::vector<T1>& x_slice, size_t start, size_t end,
+      std::ostream* msgs, const T2& theta) const {
+    stan::return_type_t<T1, T2> lp = 0;
+    for (size_t i = 0; i < x_slice.size(); ++i)
+      lp += theta * x_slice[i] * x_slice[i] * x_slice[i];
+    return lp;
+  }
+};
+
+// sum of theta * x_i^3 over all but the last element x_N = theta
+struct reduce_sum_fun {
+  int grainsize;
+
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    const std::vector<T> x_vec(x.data(), x.data() + x.size() - 1);
+    return stan::math::reduce_sum(cubic_sum_lpdf(), x_vec, grainsize,
+                                  nullptr, x(x.size() - 1));
+  }
+};
+}  // namespace
+
+TEST(MixFunctor, reduce_sum_threadable) {
+  using stan::math::fvar;
+  using stan::math::internal::reduce_sum_threadable;
+  using stan::math::var;
+  EXPECT_TRUE(reduce_sum_threadable<double>::value);
+  EXPECT_TRUE(reduce_sum_threadable<fvar<double>>::value);
+  EXPECT_TRUE(reduce_sum_threadable<fvar<fvar<double>>>::value);
+  EXPECT_FALSE(reduce_sum_threadable<fvar<var>>::value);
+  EXPECT_FALSE(reduce_sum_threadable<fvar<fvar<var>>>::value);
+}
+
+TEST(MixFunctor, reduce_sum_hessian) {
+  const int N = 50;
+  Eigen::VectorXd x(N + 1);
+  for (int i = 0; i < N; ++i)
+    x(i) = std::sin(i);
+  x(N) = 0.7;
+
+  Eigen::MatrixXd H_expected = Eigen::MatrixXd::Zero(N + 1, N + 1);
+  for (int i = 0; i < N; ++i) {
+    H_expected(i, i) = 6 * x(N) * x(i);
+    H_expected(i, N) = 3 * x(i) * x(i);
+    H_expected(N, i) = H_expected(i, N);
+  }
+
+  for (int grainsize : {1, 7, N}) {
+    double fx;
+    Eigen::VectorXd grad;
+    Eigen::MatrixXd H;
+    stan::math::hessian(reduce_sum_fun{grainsize}, x, fx, grad, H);
+    EXPECT_FLOAT_EQ(x(N) * x.head(N).array().cube().sum(), fx);
+    for (int i = 0; i <= N; ++i)
+      for (int j = 0; j <= N; ++j)
+        EXPECT_NEAR(H_expected(i, j), H(i, j), 1e-12);
+  }
+}
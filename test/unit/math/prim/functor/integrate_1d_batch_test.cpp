@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <stan/math/prim/functor/integrate_1d_batch.hpp>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+std::ostringstream *msgs = nullptr;
+
+// exp(-theta[0] * x^2) x^x_i[0], counting its batches
+struct gaussian_moment_batch {
+  int *batches;
+  int *abscissae;
+
+  Eigen::VectorXd operator()(const Eigen::VectorXd &x,
+                             const Eigen::VectorXd &xc,
+                             const std::vector<double> &theta,
+                             const std::vector<double> &x_r,
+                             const std::vector<int> &x_i,
+                             std::ostream *msgs) const {
+    ++*batches;
+    *abscissae += x.size();
+    return ((-theta[0] * x.array().square()).exp()
+            * x.array().pow(x_i[0]))
+        .matrix();
+  }
+};
+
+// 1 / sqrt(xc) near the upper limit and 1 / sqrt(1 - x) elsewhere, such
+// that the integral is only accurate if xc is b - x
+struct endpoint_batch {
+  Eigen::VectorXd operator()(const Eigen::VectorXd &x,
+                             const Eigen::VectorXd &xc,
+                             const std::vector<double> &theta,
+                             const std::vector<double> &x_r,
+                             const std::vector<int> &x_i,
+                             std::ostream *msgs) const {
+    Eigen::VectorXd y(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      y(i) = 1 / std::sqrt(x(i) > 0.5 ? xc(i) : 1 - x(i));
+    }
+    return y;
+  }
+};
+
+struct wrong_size_batch {
+  Eigen::VectorXd operator()(const Eigen::VectorXd &x,
+                             const Eigen::VectorXd &xc,
+                             const std::vector<double> &theta,
+                             const std::vector<double> &x_r,
+                             const std::vector<int> &x_i,
+                             std::ostream *msgs) const {
+    return Eigen::VectorXd::Ones(x.size() - 1);
+  }
+};
+}  // namespace
+
+TEST(StanMath_integrate_1d_batch, gauss_kronrod) {
+  using stan::math::INFTY;
+  using stan::math::integrate_1d_batch;
+  int batches = 0;
+  int abscissae = 0;
+  gaussian_moment_batch f{&batches, &abscissae};
+  std::vector<double> theta = {0.5};
+  std::vector<double> x_r;
+
+  EXPECT_NEAR(std::sqrt(2 * stan::math::pi()),
+              integrate_1d_batch(f, -INFTY, INFTY, theta, x_r, {0}, msgs),
+              1e-8);
+  EXPECT_NEAR(1.0, integrate_1d_batch(f, 0, INFTY, theta, x_r, {1}, msgs),
+              1e-8);
+  EXPECT_NEAR(-1.0, integrate_1d_batch(f, -INFTY, 0, theta, x_r, {1}, msgs),
+              1e-8);
+  EXPECT_NEAR(-std::exp(-0.5),
+              integrate_1d_batch(f, -INFTY, -1, theta, x_r, {1}, msgs), 1e-8);
+  EXPECT_EQ(21 * batches, abscissae);
+
+  // a smooth integrand on a finite interval takes a single batch
+  batches = 0;
+  EXPECT_NEAR(1 - std::exp(-0.5),
+              integrate_1d_batch(f, 0, 1, theta, x_r, {1}, msgs), 1e-12);
+  EXPECT_EQ(1, batches);
+
+  EXPECT_NEAR(2.0, integrate_1d_batch(endpoint_batch(), 0, 1, theta, x_r, {},
+                                      msgs, 1e-8),
+              1e-7);
+}
+
+TEST(StanMath_integrate_1d_batch, fixed_rules) {
+  using stan::math::INFTY;
+  using stan::math::integrate_1d_batch;
+  using stan::math::integrate_1d_rule;
+  int batches = 0;
+  int abscissae = 0;
+  gaussian_moment_batch f{&batches, &abscissae};
+  std::vector<double> x_r;
+
+  // exact for a polynomial of degree 2n - 1
+  EXPECT_NEAR(std::pow(2.0, 20) / 20 - 1.0 / 20,
+              integrate_1d_batch(f, -1, 2, {0.0}, x_r, {19}, msgs, 1e-8,
+                                 integrate_1d_rule::gauss_legendre(10)),
+              1e-6);
+  EXPECT_EQ(1, batches);
+  EXPECT_EQ(10, abscissae);
+
+  // exact for exp(-x^2) times a polynomial of degree 2n - 1
+  integrate_1d_rule hermite = integrate_1d_rule::gauss_hermite(20);
+  EXPECT_EQ(20U, hermite.nodes().size());
+  EXPECT_NEAR(3 * std::sqrt(stan::math::pi()) / 4,
+              integrate_1d_batch(f, -INFTY, INFTY, {1.0}, x_r, {4}, msgs,
+                                 1e-8, hermite),
+              1e-12);
+  EXPECT_NEAR(std::sqrt(2 * stan::math::pi()),
+              integrate_1d_batch(f, -INFTY, INFTY, {0.5}, x_r, {0}, msgs,
+                                 1e-8, integrate_1d_rule::gauss_hermite(60)),
+              1e-6);
+}
+
+TEST(StanMath_integrate_1d_batch, errors) {
+  using stan::math::INFTY;
+  using stan::math::integrate_1d_batch;
+  using stan::math::integrate_1d_rule;
+  int batches = 0;
+  int abscissae = 0;
+  gaussian_moment_batch f{&batches, &abscissae};
+  std::vector<double> x_r;
+
+  EXPECT_THROW(integrate_1d_rule::gauss_legendre(0), std::domain_error);
+  EXPECT_THROW(integrate_1d_rule::gauss_kronrod(0), std::domain_error);
+  EXPECT_THROW(integrate_1d_batch(f, 0, INFTY, {1.0}, x_r, {0}, msgs, 1e-8,
+                                  integrate_1d_rule::gauss_legendre(5)),
+               std::invalid_argument);
+  EXPECT_THROW(integrate_1d_batch(f, 0, 1, {1.0}, x_r, {0}, msgs, 1e-8,
+                                  integrate_1d_rule::gauss_hermite(5)),
+               std::invalid_argument);
+  EXPECT_THROW(integrate_1d_batch(f, 1, 0, {1.0}, x_r, {0}, msgs),
+               std::domain_error);
+  EXPECT_THROW(integrate_1d_batch(wrong_size_batch(), 0, 1, {1.0}, x_r, {0},
+                                  msgs),
+               std::invalid_argument);
+  EXPECT_THROW(integrate_1d_batch(endpoint_batch(), 0, 1, {}, x_r, {}, msgs,
+                                  1e-8, integrate_1d_rule::gauss_kronrod(2)),
+               std::domain_error);
+  EXPECT_FLOAT_EQ(0.0, integrate_1d_batch(f, 1, 1, {1.0}, x_r, {0}, msgs));
+}
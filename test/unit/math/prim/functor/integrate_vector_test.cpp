@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <stan/math/prim/functor/integrate_vector.hpp>
+#include <stan/math/prim/scal/fun/constants.hpp>
+#include <cmath>
+#include <limits>
+
+namespace {
+// exp(-x^2) with its first two moments, integrated on the same nodes
+Eigen::VectorXd gaussian_moments(double x, double xc) {
+  Eigen::VectorXd y(3);
+  y << std::exp(-x * x), x * std::exp(-x * x), x * x * std::exp(-x * x);
+  return y;
+}
+}  // namespace
+
+TEST(StanMath_integrate_vector, finite) {
+  auto f = [](double x, double xc) {
+    Eigen::VectorXd y(3);
+    y << 1.0, x, std::sqrt(x);
+    return y;
+  };
+  Eigen::VectorXd Q = stan::math::integrate_vector(f, 0.0, 2.0, 1e-8, 3);
+  EXPECT_NEAR(2.0, Q(0), 1e-12);
+  EXPECT_NEAR(2.0, Q(1), 1e-12);
+  EXPECT_NEAR(2.0 / 3.0 * std::pow(2.0, 1.5), Q(2), 1e-10);
+}
+
+TEST(StanMath_integrate_vector, endpoint_complement) {
+  // xc is the distance to the nearest limit, negative towards a
+  auto f = [](double x, double xc) {
+    Eigen::VectorXd y(2);
+    y << std::pow(x > 0.5 ? xc : 1 - x, -0.5), (x < 0.5 ? xc < 0 : xc > 0);
+    return y;
+  };
+  Eigen::VectorXd Q = stan::math::integrate_vector(f, 0.0, 1.0, 1e-8, 2);
+  EXPECT_NEAR(2.0, Q(0), 1e-8);
+  EXPECT_FLOAT_EQ(1.0, Q(1));
+}
+
+TEST(StanMath_integrate_vector, zero_crossing_and_infinite_limits) {
+  const double inf = std::numeric_limits<double>::infinity();
+  const double sqrt_pi = std::sqrt(stan::math::pi());
+  Eigen::VectorXd Q
+      = stan::math::integrate_vector(gaussian_moments, -inf, inf, 1e-8, 3);
+  EXPECT_NEAR(sqrt_pi, Q(0), 1e-8);
+  EXPECT_NEAR(0.0, Q(1), 1e-8);
+  EXPECT_NEAR(0.5 * sqrt_pi, Q(2), 1e-8);
+
+  Q = stan::math::integrate_vector(gaussian_moments, 0.0, inf, 1e-8, 3);
+  EXPECT_NEAR(0.5 * sqrt_pi, Q(0), 1e-8);
+  EXPECT_NEAR(0.5, Q(1), 1e-8);
+
+  Q = stan::math::integrate_vector(gaussian_moments, -inf, 0.0, 1e-8, 3);
+  EXPECT_NEAR(0.5 * sqrt_pi, Q(0), 1e-8);
+  EXPECT_NEAR(-0.5, Q(1), 1e-8);
+
+  Q = stan::math::integrate_vector(gaussian_moments, -inf, -1.0, 1e-8, 3);
+  EXPECT_NEAR(0.5 * sqrt_pi * std::erfc(1.0), Q(0), 1e-8);
+  EXPECT_NEAR(-0.5 * std::exp(-1.0), Q(1), 1e-8);
+
+  Q = stan::math::integrate_vector(gaussian_moments, -1.0, inf, 1e-8, 3);
+  EXPECT_NEAR(0.5 * sqrt_pi * std::erfc(-1.0), Q(0), 1e-8);
+  EXPECT_NEAR(0.5 * std::exp(-1.0), Q(1), 1e-8);
+
+  Q = stan::math::integrate_vector(gaussian_moments, -1.0, 2.0, 1e-8, 3);
+  EXPECT_NEAR(0.5 * sqrt_pi * (std::erf(2.0) + std::erf(1.0)), Q(0), 1e-8);
+  EXPECT_NEAR(0.5 * (std::exp(-1.0) - std::exp(-4.0)), Q(1), 1e-8);
+}
+
+TEST(StanMath_integrate_vector, singular) {
+  auto f = [](double x, double xc) {
+    Eigen::VectorXd y(1);
+    y << 1 / x;
+    return y;
+  };
+  EXPECT_THROW(stan::math::integrate_vector(
+                   f, -std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::infinity(), 1e-8, 1),
+               std::domain_error);
+}
@@ -0,0 +1,67 @@
+#include <stan/math/prim/mat.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+struct count_lpdf {
+  template <typename T>
+  inline T operator()(const std::vector<T>& sub_slice, size_t start,
+                      size_t end, std::ostream* msgs,
+                      const std::vector<int>& idata) const {
+    T sum = 0;
+    for (size_t i = 0; i < sub_slice.size(); ++i)
+      sum += sub_slice[i] * idata[start + i];
+    return sum;
+  }
+};
+
+struct slice_bounds {
+  inline double operator()(const std::vector<int>& sub_slice, size_t start,
+                           size_t end, std::ostream* msgs) const {
+    EXPECT_EQ(sub_slice.size(), end - start);
+    double sum = 0;
+    for (size_t i = start; i < end; ++i)
+      sum += sub_slice[i - start] - static_cast<int>(i);
+    return sum;
+  }
+};
+}  // namespace
+
+TEST(StanMathPrimFunctor, reduce_sum_value) {
+  std::vector<double> data(1000);
+  std::vector<int> idata(1000);
+  double expected = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = 0.5 * i;
+    idata[i] = i % 7;
+    expected += data[i] * idata[i];
+  }
+  for (int grainsize : {1, 10, 1000, 5000}) {
+    EXPECT_FLOAT_EQ(expected, stan::math::reduce_sum(count_lpdf(), data,
+                                                     grainsize, nullptr,
+                                                     idata));
+  }
+}
+
+TEST(StanMathPrimFunctor, reduce_sum_slices) {
+  std::vector<int> data(100);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = i;
+  EXPECT_FLOAT_EQ(0.0,
+                  stan::math::reduce_sum(slice_bounds(), data, 3, nullptr));
+}
+
+TEST(StanMathPrimFunctor, reduce_sum_empty) {
+  std::vector<double> data;
+  std::vector<int> idata;
+  EXPECT_FLOAT_EQ(0.0, stan::math::reduce_sum(count_lpdf(), data, 1, nullptr,
+                                              idata));
+}
+
+TEST(StanMathPrimFunctor, reduce_sum_grainsize) {
+  std::vector<double> data(10, 1.0);
+  std::vector<int> idata(10, 1);
+  EXPECT_THROW(stan::math::reduce_sum(count_lpdf(), data, 0, nullptr, idata),
+               std::domain_error);
+}
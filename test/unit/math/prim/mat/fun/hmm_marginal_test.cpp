@@ -0,0 +1,117 @@
+#include <stan/math/prim/mat.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+// log marginal density summing over all sequences of hidden states
+double hmm_marginal_brute_force(const Eigen::MatrixXd& log_omegas,
+                                const Eigen::MatrixXd& Gamma,
+                                const Eigen::VectorXd& rho) {
+  const int K = log_omegas.rows();
+  const int N = log_omegas.cols();
+  std::vector<int> z(N, 0);
+  double marginal = 0;
+  while (true) {
+    double p = rho(z[0]) * std::exp(log_omegas(z[0], 0));
+    for (int n = 1; n < N; ++n) {
+      p *= Gamma(z[n - 1], z[n]) * std::exp(log_omegas(z[n], n));
+    }
+    marginal += p;
+    int n = 0;
+    while (n < N && ++z[n] == K) {
+      z[n++] = 0;
+    }
+    if (n == N) {
+      break;
+    }
+  }
+  return std::log(marginal);
+}
+
+Eigen::MatrixXd hmm_Gamma() {
+  Eigen::MatrixXd Gamma(3, 3);
+  Gamma << 0.8, 0.15, 0.05, 0.2, 0.5, 0.3, 0.1, 0.1, 0.8;
+  return Gamma;
+}
+
+Eigen::VectorXd hmm_rho() {
+  Eigen::VectorXd rho(3);
+  rho << 0.3, 0.6, 0.1;
+  return rho;
+}
+}  // namespace
+
+TEST(MathMatrixPrimMat, hmm_marginal) {
+  using stan::math::hmm_marginal;
+  Eigen::MatrixXd log_omegas(3, 5);
+  log_omegas << -1.2, -0.3, -4.1, -2.2, -0.7, -0.5, -2.6, -1.1, -0.4, -3.3,
+      -3.0, -1.4, -0.2, -1.9, -1.0;
+
+  EXPECT_FLOAT_EQ(hmm_marginal_brute_force(log_omegas, hmm_Gamma(), hmm_rho()),
+                  hmm_marginal(log_omegas, hmm_Gamma(), hmm_rho()));
+
+  // a single observation is a mixture
+  Eigen::MatrixXd log_omega = log_omegas.leftCols(1);
+  EXPECT_FLOAT_EQ(stan::math::log_mix(hmm_rho(), log_omega.col(0)),
+                  hmm_marginal(log_omega, hmm_Gamma(), hmm_rho()));
+
+  // impossible observations
+  log_omegas.row(0).setConstant(-std::numeric_limits<double>::infinity());
+  log_omegas(1, 2) = -std::numeric_limits<double>::infinity();
+  log_omegas(2, 2) = -std::numeric_limits<double>::infinity();
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(),
+            hmm_marginal(log_omegas, hmm_Gamma(), hmm_rho()));
+}
+
+TEST(MathMatrixPrimMat, hmm_marginal_scaling) {
+  using stan::math::hmm_marginal;
+  // log densities far below the range of doubles, on a long series
+  const int N = 10000;
+  Eigen::MatrixXd log_omegas(3, N);
+  for (int n = 0; n < N; ++n) {
+    log_omegas.col(n) << -1000 - n % 3, -1001 + n % 2, -1002;
+  }
+  const double lp = hmm_marginal(log_omegas, hmm_Gamma(), hmm_rho());
+  EXPECT_TRUE(std::isfinite(lp));
+  EXPECT_FLOAT_EQ(lp + 1000.0 * N,
+                  hmm_marginal(
+                      (log_omegas.array() + 1000).matrix().eval(),
+                      hmm_Gamma(), hmm_rho()));
+}
+
+TEST(MathMatrixPrimMat, hmm_marginal_exceptions) {
+  using stan::math::hmm_marginal;
+  Eigen::MatrixXd log_omegas = Eigen::MatrixXd::Zero(3, 4);
+  Eigen::MatrixXd Gamma = hmm_Gamma();
+  Eigen::VectorXd rho = hmm_rho();
+  EXPECT_NO_THROW(hmm_marginal(log_omegas, Gamma, rho));
+
+  EXPECT_THROW(hmm_marginal(Eigen::MatrixXd(3, 0), Gamma, rho),
+               std::invalid_argument);
+  EXPECT_THROW(hmm_marginal(Eigen::MatrixXd(Eigen::MatrixXd::Zero(2, 4)), Gamma,
+                            rho),
+               std::invalid_argument);
+  EXPECT_THROW(hmm_marginal(log_omegas, Gamma, Eigen::VectorXd(rho.head(2))),
+               std::invalid_argument);
+  EXPECT_THROW(hmm_marginal(log_omegas, Eigen::MatrixXd(Gamma.leftCols(2)),
+                            rho),
+               std::invalid_argument);
+
+  log_omegas(1, 2) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_THROW(hmm_marginal(log_omegas, Gamma, rho), std::domain_error);
+  log_omegas(1, 2) = std::numeric_limits<double>::infinity();
+  EXPECT_THROW(hmm_marginal(log_omegas, Gamma, rho), std::domain_error);
+  log_omegas(1, 2) = -std::numeric_limits<double>::infinity();
+  EXPECT_NO_THROW(hmm_marginal(log_omegas, Gamma, rho));
+  log_omegas(1, 2) = 0;
+
+  Gamma(1, 1) = 0.6;
+  EXPECT_THROW(hmm_marginal(log_omegas, Gamma, rho), std::domain_error);
+  Gamma(1, 1) = 0.5;
+
+  rho(0) = -0.3;
+  rho(1) = 1.2;
+  EXPECT_THROW(hmm_marginal(log_omegas, Gamma, rho), std::domain_error);
+}
@@ -0,0 +1,68 @@
+#include <stan/math/prim/mat.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/math/distributions.hpp>
+#include <vector>
+
+TEST(ProbDistributionsHmmLatent, rng) {
+  using stan::math::hmm_latent_rng;
+  boost::random::mt19937 rng;
+  Eigen::MatrixXd Gamma(2, 2);
+  Gamma << 0.7, 0.3, 0.4, 0.6;
+  Eigen::VectorXd rho(2);
+  rho << 0.5, 0.5;
+
+  // observations which identify the states
+  Eigen::MatrixXd log_omegas(2, 4);
+  log_omegas << 0, -100, -100, 0, -100, 0, 0, -100;
+  std::vector<int> states = hmm_latent_rng(log_omegas, Gamma, rho, rng);
+  std::vector<int> expected = {1, 2, 2, 1};
+  EXPECT_EQ(expected, states);
+
+  Eigen::MatrixXd log_omega(2, 1);
+  log_omega << 0, 0;
+  EXPECT_THROW(hmm_latent_rng(Eigen::MatrixXd(2, 0), Gamma, rho, rng),
+               std::invalid_argument);
+  log_omega(1, 0) = std::numeric_limits<double>::infinity();
+  EXPECT_THROW(hmm_latent_rng(log_omega, Gamma, rho, rng), std::domain_error);
+  log_omega(1, 0) = 0;
+  rho << 0.5, 0.6;
+  EXPECT_THROW(hmm_latent_rng(log_omega, Gamma, rho, rng), std::domain_error);
+}
+
+TEST(ProbDistributionsHmmLatent, chiSquareGoodnessFitTest) {
+  using stan::math::hmm_latent_rng;
+  boost::random::mt19937 rng;
+  Eigen::MatrixXd Gamma(2, 2);
+  Gamma << 0.7, 0.3, 0.4, 0.6;
+  Eigen::VectorXd rho(2);
+  rho << 0.2, 0.8;
+  Eigen::MatrixXd log_omegas(2, 2);
+  log_omegas << -0.5, -2.0, -1.5, -0.3;
+
+  // joint posterior of the two states
+  Eigen::MatrixXd joint(2, 2);
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      joint(i, j) = rho(i) * std::exp(log_omegas(i, 0)) * Gamma(i, j)
+                    * std::exp(log_omegas(j, 1));
+    }
+  }
+  joint /= joint.sum();
+
+  int N = 10000;
+  int K = 4;
+  boost::math::chi_squared mydist(K - 1);
+  int bin[4] = {0, 0, 0, 0};
+  for (int n = 0; n < N; ++n) {
+    std::vector<int> states = hmm_latent_rng(log_omegas, Gamma, rho, rng);
+    ++bin[2 * (states[0] - 1) + states[1] - 1];
+  }
+
+  double chi = 0;
+  for (int k = 0; k < K; ++k) {
+    double expect = N * joint(k / 2, k % 2);
+    chi += (bin[k] - expect) * (bin[k] - expect) / expect;
+  }
+  EXPECT_TRUE(chi < quantile(complement(mydist, 1e-6)));
+}
@@ -0,0 +1,64 @@
+#include <stan/math/rev/core.hpp>
+#include <gtest/gtest.h>
+
+TEST(ad_tape_observer, reuse_tapes) {
+  using stan::math::ChainableStack;
+  ChainableStack::AutodiffStackStorage* main_ad_stack
+      = ChainableStack::instance_;
+
+  // the current thread has a tape already
+  stan::math::ad_tape_observer observer;
+  EXPECT_EQ(0, observer.tapes_created());
+  EXPECT_EQ(main_ad_stack, ChainableStack::instance_);
+
+  // emulate a worker without a tape entering and leaving repeatedly
+  ChainableStack::instance_ = nullptr;
+  observer.on_scheduler_entry(true);
+  ChainableStack::AutodiffStackStorage* worker_ad_stack
+      = ChainableStack::instance_;
+  ASSERT_TRUE(worker_ad_stack);
+  EXPECT_EQ(1, observer.tapes_created());
+
+  stan::math::var x = 2.0;
+  stan::math::var y = x * x;
+  EXPECT_EQ(2, worker_ad_stack->var_stack_.size());
+  EXPECT_LT(0, worker_ad_stack->memalloc_.bytes_allocated());
+  size_t allocated = worker_ad_stack->memalloc_.bytes_allocated();
+
+  observer.on_scheduler_exit(true);
+  EXPECT_FALSE(ChainableStack::instance_);
+  EXPECT_EQ(1, observer.tapes_idle());
+  EXPECT_EQ(0, worker_ad_stack->var_stack_.size());
+  EXPECT_EQ(0, worker_ad_stack->var_nochain_stack_.size());
+
+  for (int i = 0; i < 10; ++i) {
+    observer.on_scheduler_entry(true);
+    EXPECT_EQ(worker_ad_stack, ChainableStack::instance_);
+    EXPECT_EQ(allocated, worker_ad_stack->memalloc_.bytes_allocated());
+    observer.on_scheduler_exit(true);
+  }
+  EXPECT_EQ(1, observer.tapes_created());
+  EXPECT_EQ(10, observer.tapes_reused());
+
+  ChainableStack::instance_ = main_ad_stack;
+}
+
+TEST(ad_tape_observer, keep_tape_of_master) {
+  using stan::math::ChainableStack;
+  ChainableStack::AutodiffStackStorage* main_ad_stack
+      = ChainableStack::instance_;
+  stan::math::ad_tape_observer observer;
+
+  ChainableStack::instance_ = nullptr;
+  observer.on_scheduler_entry(false);
+  ChainableStack::AutodiffStackStorage* master_ad_stack
+      = ChainableStack::instance_;
+  ASSERT_TRUE(master_ad_stack);
+
+  // a master thread keeps its tape when leaving the scheduler
+  observer.on_scheduler_exit(false);
+  EXPECT_EQ(master_ad_stack, ChainableStack::instance_);
+  EXPECT_EQ(0, observer.tapes_idle());
+
+  ChainableStack::instance_ = main_ad_stack;
+}
@@ -0,0 +1,136 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+stan::math::profile_info& get_info(stan::math::profile_map& profiles,
+                                   const std::string& name) {
+  return profiles[stan::math::profile_key(name, std::this_thread::get_id())];
+}
+}  // namespace
+
+TEST(AgradRevProfiling, var_region) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+
+  var x = 2.0;
+  var y = 3.0;
+  var z;
+  {
+    profile<var> p("body", profiles);
+    z = exp(x) * log(y) + x * y;
+  }
+  stan::math::profile_info& info = get_info(profiles, "body");
+  EXPECT_EQ(1U, info.get_num_fwd_AD_passes());
+  EXPECT_EQ(0U, info.get_num_no_AD_fwd_passes());
+  EXPECT_EQ(0U, info.get_num_rev_passes());
+  // exp, log, two multiplications and the addition
+  EXPECT_EQ(5U, info.get_chain_stack_used());
+  EXPECT_EQ(0U, info.get_nochain_stack_used());
+  EXPECT_GT(info.get_bytes_allocated(), 0U);
+  EXPECT_GE(info.get_fwd_time(), 0.0);
+
+  z.grad();
+  EXPECT_EQ(1U, info.get_num_rev_passes());
+  EXPECT_GE(info.get_rev_time(), 0.0);
+  EXPECT_FLOAT_EQ(std::exp(2.0) * std::log(3.0) + 3.0, x.adj());
+  EXPECT_FLOAT_EQ(std::exp(2.0) / 3.0 + 2.0, y.adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevProfiling, double_region) {
+  using stan::math::profile;
+  stan::math::profile_map profiles;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  for (int i = 0; i < 3; ++i) {
+    profile<double> p("body", profiles);
+  }
+  stan::math::profile_info& info = get_info(profiles, "body");
+  EXPECT_EQ(3U, info.get_num_no_AD_fwd_passes());
+  EXPECT_EQ(0U, info.get_num_fwd_AD_passes());
+  EXPECT_EQ(0U, info.get_chain_stack_used());
+  EXPECT_EQ(stack_size,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(AgradRevProfiling, nested_regions) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  var x = 1.5;
+  var z;
+  {
+    profile<var> outer("outer", profiles);
+    var a = sin(x);
+    {
+      profile<var> inner("inner", profiles);
+      z = a * cos(x);
+    }
+  }
+  z.grad();
+  EXPECT_EQ(2U, get_info(profiles, "inner").get_chain_stack_used());
+  // sin plus the inner region and the two markers delimiting it
+  EXPECT_EQ(5U, get_info(profiles, "outer").get_chain_stack_used());
+  EXPECT_EQ(1U, get_info(profiles, "inner").get_num_rev_passes());
+  EXPECT_EQ(1U, get_info(profiles, "outer").get_num_rev_passes());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevProfiling, already_started) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  profile<var> p("body", profiles);
+  EXPECT_THROW(profile<var>("body", profiles), std::runtime_error);
+  EXPECT_NO_THROW(profile<var>("other", profiles));
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevProfiling, write_csv_json) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  var x = 2.0;
+  {
+    profile<var> p("lik\"e", profiles);
+    var y = x * x;
+  }
+  std::stringstream csv;
+  stan::math::write_profile_csv(csv, profiles);
+  std::string header;
+  std::getline(csv, header);
+  EXPECT_EQ(
+      "name,thread_id,total_time,forward_time,reverse_time,chain_stack,"
+      "no_chain_stack,autodiff_calls,no_autodiff_calls,reverse_calls,"
+      "bytes_allocated",
+      header);
+  std::string row;
+  std::getline(csv, row);
+  EXPECT_EQ(0U, row.find("\"lik\"\"e\","));
+
+  std::stringstream json;
+  stan::math::write_profile_json(json, profiles);
+  EXPECT_NE(std::string::npos, json.str().find("\"name\": \"lik\\\"e\""));
+  EXPECT_NE(std::string::npos, json.str().find("\"chain_stack\": 1"));
+
+  std::stringstream empty;
+  stan::math::write_profile_json(empty, stan::math::profile_map());
+  EXPECT_EQ("[]\n", empty.str());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevProfiling, write_json_control_characters) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  { profile<var> p("a\tb\nc\rd\x01g\x1f", profiles); }
+  std::stringstream json;
+  stan::math::write_profile_json(json, profiles);
+  EXPECT_NE(std::string::npos,
+            json.str().find("\"name\": \"a\\tb\\nc\\rd\\u0001g\\u001f\""));
+  EXPECT_EQ(std::string::npos, json.str().find('\t'));
+  stan::math::recover_memory();
+}
@@ -0,0 +1,140 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/rev/util.hpp>
+
+#define EXPECT_MATRIX_FLOAT_EQ(A, B)         \
+  {                                          \
+    Eigen::MatrixXd a_eval = A;              \
+    Eigen::MatrixXd b_eval = B;              \
+    EXPECT_EQ(a_eval.rows(), b_eval.rows()); \
+    EXPECT_EQ(a_eval.cols(), b_eval.cols()); \
+    for (int i = 0; i < a_eval.size(); i++)  \
+      EXPECT_FLOAT_EQ(a_eval(i), b_eval(i)); \
+  }
+
+TEST(AgradRevVarMatrix, construct_double) {
+  using stan::math::var_matrix;
+  Eigen::MatrixXd x(2, 3);
+  x << 1, 2, 3, 4, 5, 6;
+  size_t nochain_before
+      = stan::math::ChainableStack::instance_->var_nochain_stack_.size();
+  size_t stack_before
+      = stan::math::ChainableStack::instance_->var_stack_.size();
+  var_matrix m(x);
+  EXPECT_EQ(2, m.rows());
+  EXPECT_EQ(3, m.cols());
+  EXPECT_EQ(6, m.size());
+  EXPECT_FALSE(m.is_uninitialized());
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_FLOAT_EQ(x(i), m.val()(i));
+    EXPECT_FLOAT_EQ(0.0, m.adj()(i));
+  }
+  // a single node for the whole matrix, not placed on the chain stack
+  EXPECT_EQ(nochain_before + 1,
+            stan::math::ChainableStack::instance_->var_nochain_stack_.size());
+  EXPECT_EQ(stack_before,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVarMatrix, uninitialized) {
+  stan::math::var_matrix m;
+  EXPECT_TRUE(m.is_uninitialized());
+}
+
+TEST(AgradRevVarMatrix, coeff) {
+  using stan::math::var;
+  using stan::math::var_matrix;
+  Eigen::MatrixXd x(2, 2);
+  x << 1, 2, 3, 4;
+  var_matrix m(x);
+  var f = m(0, 1) * m(1, 0) + m(3);
+  EXPECT_FLOAT_EQ(2.0 * 3.0 + 4.0, f.val());
+  f.grad();
+  EXPECT_FLOAT_EQ(0.0, m.adj()(0, 0));
+  EXPECT_FLOAT_EQ(3.0, m.adj()(0, 1));
+  EXPECT_FLOAT_EQ(2.0, m.adj()(1, 0));
+  EXPECT_FLOAT_EQ(1.0, m.adj()(1, 1));
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVarMatrix, set_zero_all_adjoints) {
+  using stan::math::var;
+  using stan::math::var_matrix;
+  Eigen::MatrixXd x(2, 2);
+  x << 1, 2, 3, 4;
+  var_matrix m(x);
+  var f = stan::math::sum(m);
+  f.grad();
+  for (int i = 0; i < m.size(); ++i) {
+    EXPECT_FLOAT_EQ(1.0, m.adj()(i));
+  }
+  stan::math::set_zero_all_adjoints();
+  for (int i = 0; i < m.size(); ++i) {
+    EXPECT_FLOAT_EQ(0.0, m.adj()(i));
+  }
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVarMatrix, nested) {
+  using stan::math::var;
+  using stan::math::var_matrix;
+  Eigen::MatrixXd x(2, 2);
+  x << 1, 2, 3, 4;
+  var_matrix m(x);
+  stan::math::start_nested();
+  var f = stan::math::sum(m);
+  f.grad();
+  EXPECT_FLOAT_EQ(1.0, m.adj()(1, 1));
+  stan::math::recover_memory_nested();
+  EXPECT_FLOAT_EQ(1.0, m.adj()(1, 1));
+  EXPECT_FLOAT_EQ(2.0, m.val()(0, 1));
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVarMatrix, to_from_var_matrix) {
+  using stan::math::from_var_matrix;
+  using stan::math::matrix_v;
+  using stan::math::to_var_matrix;
+  using stan::math::var;
+  using stan::math::var_matrix;
+  matrix_v a(2, 3);
+  a << 1, 2, 3, 4, 5, 6;
+  var_matrix m = to_var_matrix(a);
+  EXPECT_MATRIX_FLOAT_EQ(a.val(), m.val());
+  matrix_v b = from_var_matrix(m);
+  EXPECT_MATRIX_FLOAT_EQ(a.val(), b.val());
+  var f = b(0, 0) * 2.0 + b(1, 2) * b(1, 2);
+  f.grad();
+  EXPECT_FLOAT_EQ(2.0, m.adj()(0, 0));
+  EXPECT_FLOAT_EQ(12.0, m.adj()(1, 2));
+  EXPECT_FLOAT_EQ(2.0, a(0, 0).adj());
+  EXPECT_FLOAT_EQ(12.0, a(1, 2).adj());
+  EXPECT_FLOAT_EQ(0.0, a(1, 1).adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVarMatrix, to_var_matrix_double) {
+  Eigen::Matrix<double, -1, 1> x(3);
+  x << 1, 2, 3;
+  stan::math::var_matrix m = stan::math::to_var_matrix(x);
+  EXPECT_EQ(3, m.rows());
+  EXPECT_EQ(1, m.cols());
+  EXPECT_MATRIX_FLOAT_EQ(x, m.val());
+  EXPECT_MATRIX_FLOAT_EQ(x, stan::math::value_of(m));
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVarMatrix, sum) {
+  using stan::math::matrix_v;
+  using stan::math::var;
+  matrix_v a(2, 2);
+  a << 1, 2, 3, 4;
+  var f = stan::math::sum(stan::math::to_var_matrix(a));
+  EXPECT_FLOAT_EQ(10.0, f.val());
+  f.grad();
+  for (int i = 0; i < a.size(); ++i) {
+    EXPECT_FLOAT_EQ(1.0, a(i).adj());
+  }
+  stan::math::recover_memory();
+}
@@ -0,0 +1,50 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/rev/fun/util_var_matrix.hpp>
+#include <vector>
+
+TEST(AgradRevMatrix, add_var_matrix) {
+  using stan::math::matrix_v;
+  using stan::math::var_matrix;
+  Eigen::MatrixXd A(2, 3);
+  A << 1, -2, 3.5, 4, -0.5, 6;
+  Eigen::MatrixXd B(2, 3);
+  B << 0.1, 2, -3, 4, 5, 6;
+  test::expect_var_matrix_matches(
+      [](const std::vector<matrix_v>& x) {
+        return stan::math::add(x[0], x[1]);
+      },
+      [](const std::vector<var_matrix>& x) {
+        return stan::math::add(x[0], x[1]);
+      },
+      {A, B});
+  test::expect_var_matrix_matches(
+      [&](const std::vector<matrix_v>& x) {
+        return stan::math::add(x[0], B);
+      },
+      [&](const std::vector<var_matrix>& x) {
+        return stan::math::add(x[0], B);
+      },
+      {A});
+  test::expect_var_matrix_matches(
+      [&](const std::vector<matrix_v>& x) {
+        return stan::math::add(A, x[0]);
+      },
+      [&](const std::vector<var_matrix>& x) {
+        return stan::math::add(A, x[0]);
+      },
+      {B});
+}
+
+TEST(AgradRevMatrix, add_var_matrix_exception) {
+  Eigen::MatrixXd A(2, 3);
+  A.setOnes();
+  Eigen::MatrixXd B(3, 2);
+  B.setOnes();
+  stan::math::var_matrix Av(A);
+  stan::math::var_matrix Bv(B);
+  EXPECT_THROW(stan::math::add(Av, Bv), std::invalid_argument);
+  EXPECT_THROW(stan::math::add(Av, B), std::invalid_argument);
+  EXPECT_THROW(stan::math::add(A, Bv), std::invalid_argument);
+  stan::math::recover_memory();
+}
@@ -0,0 +1,58 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/rev/fun/util_var_matrix.hpp>
+#include <vector>
+
+namespace {
+Eigen::MatrixXd spd_matrix(int K) {
+  Eigen::MatrixXd X(K, K);
+  for (int j = 0; j < K; ++j) {
+    for (int i = 0; i < K; ++i) {
+      X(i, j) = std::sin(1.0 + i + 3.0 * j);
+    }
+  }
+  return X * X.transpose() + K * Eigen::MatrixXd::Identity(K, K);
+}
+}  // namespace
+
+TEST(AgradRevMatrix, cholesky_decompose_var_matrix_small) {
+  using stan::math::matrix_v;
+  using stan::math::var_matrix;
+  test::expect_var_matrix_matches(
+      [](const std::vector<matrix_v>& x) {
+        return stan::math::cholesky_decompose(x[0]);
+      },
+      [](const std::vector<var_matrix>& x) {
+        return stan::math::cholesky_decompose(x[0]);
+      },
+      {spd_matrix(5)});
+}
+
+TEST(AgradRevMatrix, cholesky_decompose_var_matrix_blocked) {
+  using stan::math::matrix_v;
+  using stan::math::var_matrix;
+  test::expect_var_matrix_matches(
+      [](const std::vector<matrix_v>& x) {
+        return stan::math::cholesky_decompose(x[0]);
+      },
+      [](const std::vector<var_matrix>& x) {
+        return stan::math::cholesky_decompose(x[0]);
+      },
+      {spd_matrix(50)});
+}
+
+TEST(AgradRevMatrix, cholesky_decompose_var_matrix_exception) {
+  Eigen::MatrixXd A(2, 3);
+  A.setOnes();
+  EXPECT_THROW(stan::math::cholesky_decompose(stan::math::var_matrix(A)),
+               std::invalid_argument);
+  Eigen::MatrixXd B(2, 2);
+  B << 1, 2, 3, 4;
+  EXPECT_THROW(stan::math::cholesky_decompose(stan::math::var_matrix(B)),
+               std::domain_error);
+  Eigen::MatrixXd C(2, 2);
+  C << 1, 2, 2, 1;
+  EXPECT_THROW(stan::math::cholesky_decompose(stan::math::var_matrix(C)),
+               std::domain_error);
+  stan::math::recover_memory();
+}
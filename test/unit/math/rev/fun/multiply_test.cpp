@@ -1,6 +1,7 @@
 #include <stan/math/rev.hpp>
 #include <gtest/gtest.h>
 #include <test/unit/math/rev/fun/util.hpp>
+#include <test/unit/math/rev/fun/util_var_matrix.hpp>
 #include <test/unit/math/rev/util.hpp>
 
 #ifdef STAN_OPENCL
@@ -107,3 +108,46 @@ TEST(AgradRevMatrix, multiply_val_dv_cl) {
 }
 
 #endif
+
+TEST(AgradRevMatrix, multiply_var_matrix) {
+  using stan::math::matrix_v;
+  using stan::math::var_matrix;
+  Eigen::MatrixXd A(3, 2);
+  A << 1, -2, 3.5, 4, -0.5, 6;
+  Eigen::MatrixXd B(2, 4);
+  B << 0.1, 2, -3, 4, 5, 6, 7, -8;
+  test::expect_var_matrix_matches(
+      [](const std::vector<matrix_v>& x) {
+        return stan::math::multiply(x[0], x[1]);
+      },
+      [](const std::vector<var_matrix>& x) {
+        return stan::math::multiply(x[0], x[1]);
+      },
+      {A, B});
+  test::expect_var_matrix_matches(
+      [&](const std::vector<matrix_v>& x) {
+        return stan::math::multiply(x[0], B);
+      },
+      [&](const std::vector<var_matrix>& x) {
+        return stan::math::multiply(x[0], B);
+      },
+      {A});
+  test::expect_var_matrix_matches(
+      [&](const std::vector<matrix_v>& x) {
+        return stan::math::multiply(A, x[0]);
+      },
+      [&](const std::vector<var_matrix>& x) {
+        return stan::math::multiply(A, x[0]);
+      },
+      {B});
+}
+
+TEST(AgradRevMatrix, multiply_var_matrix_exception) {
+  Eigen::MatrixXd A(3, 2);
+  A.setOnes();
+  stan::math::var_matrix Av(A);
+  EXPECT_THROW(stan::math::multiply(Av, Av), std::invalid_argument);
+  EXPECT_THROW(stan::math::multiply(Av, A), std::invalid_argument);
+  EXPECT_THROW(stan::math::multiply(A, Av), std::invalid_argument);
+  stan::math::recover_memory();
+}
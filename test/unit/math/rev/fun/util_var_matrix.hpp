@@ -0,0 +1,74 @@
+#ifndef TEST_UNIT_MATH_REV_FUN_UTIL_VAR_MATRIX_HPP
+#define TEST_UNIT_MATH_REV_FUN_UTIL_VAR_MATRIX_HPP
+
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace test {
+
+/**
+ * Weighted sum of the coefficients of y with weights 1, 2, ..., so
+ * that every coefficient receives a distinct adjoint.
+ */
+inline stan::math::var weighted_sum(const stan::math::matrix_v& y) {
+  stan::math::var lp = 0;
+  for (int i = 0; i < y.size(); ++i) {
+    lp += (i + 1.0) * y(i);
+  }
+  return lp;
+}
+
+/**
+ * Check that a function of struct-of-arrays matrices returns the same
+ * values and input adjoints as the corresponding function of
+ * matrices of var.
+ *
+ * @tparam F_v functor from std::vector<matrix_v> to matrix_v
+ * @tparam F_vm functor from std::vector<var_matrix> to var_matrix
+ * @param f_v reference implementation
+ * @param f_vm struct-of-arrays implementation
+ * @param xs input values
+ */
+template <typename F_v, typename F_vm>
+void expect_var_matrix_matches(const F_v& f_v, const F_vm& f_vm,
+                               const std::vector<Eigen::MatrixXd>& xs) {
+  using stan::math::from_var_matrix;
+  using stan::math::matrix_v;
+  using stan::math::var_matrix;
+
+  std::vector<matrix_v> xs_v;
+  for (const auto& x : xs) {
+    xs_v.push_back(stan::math::to_var(x));
+  }
+  matrix_v y_v = f_v(xs_v);
+  weighted_sum(y_v).grad();
+  Eigen::MatrixXd y_expected = y_v.val();
+  std::vector<Eigen::MatrixXd> adj_expected;
+  for (const auto& x : xs_v) {
+    adj_expected.push_back(x.adj());
+  }
+  stan::math::recover_memory();
+
+  std::vector<var_matrix> xs_vm;
+  for (const auto& x : xs) {
+    xs_vm.push_back(var_matrix(x));
+  }
+  var_matrix y_vm = f_vm(xs_vm);
+  ASSERT_EQ(y_expected.rows(), y_vm.rows());
+  ASSERT_EQ(y_expected.cols(), y_vm.cols());
+  for (int i = 0; i < y_expected.size(); ++i) {
+    EXPECT_NEAR(y_expected(i), y_vm.val()(i), 1e-9) << "value " << i;
+  }
+  weighted_sum(from_var_matrix(y_vm)).grad();
+  for (size_t n = 0; n < xs.size(); ++n) {
+    for (int i = 0; i < xs[n].size(); ++i) {
+      EXPECT_NEAR(adj_expected[n](i), xs_vm[n].adj()(i), 1e-8)
+          << "argument " << n << ", adjoint " << i;
+    }
+  }
+  stan::math::recover_memory();
+}
+
+}  // namespace test
+#endif
@@ -5,10 +5,12 @@
 #include <test/unit/math/rev/functor/util_algebra_solver.hpp>
 #include <test/unit/util.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string>
+#include <utility>
 
 // Every test exists in four verions for the cases
 // where y (the auxiliary parameters) are passed as
@@ -363,9 +365,135 @@ TEST(MathMatrixRevMat, system_functor_constructor) {
 
   EXPECT_EQ(fs.f_, f);
 }
+
+// linear system A x = y whose Jacobian wrt to x needs row pivoting
+struct pivoting_eq_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* pstream__) const {
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(3);
+    z(0) = x(1) - y(0);
+    z(1) = 2 * x(0) + x(2) - y(1) * y(1);
+    z(2) = x(0) + x(1) + 3 * x(2) - y(2);
+    return z;
+  }
+};
+
+TEST(MathMatrixRevMat, algebra_solver_adjoint_pivoting) {
+  using stan::math::var;
+  Eigen::MatrixXd A(3, 3);
+  A << 0, 1, 0, 2, 0, 1, 1, 1, 3;
+  Eigen::VectorXd c(3);
+  c << 0.5, -1.5, 2.0;
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+
+  for (int solver = 0; solver < 2; ++solver) {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y(3);
+    y << 1.0, 2.0, -1.0;
+    Eigen::VectorXd x0 = Eigen::VectorXd::Zero(3);
+    Eigen::Matrix<var, Eigen::Dynamic, 1> x
+        = solver == 0 ? stan::math::algebra_solver_powell(pivoting_eq_functor(),
+                                                          x0, y, dat, dat_int)
+                      : stan::math::algebra_solver_newton(pivoting_eq_functor(),
+                                                          x0, y, dat, dat_int);
+    var lp = stan::math::dot_product(c, x);
+    lp.grad();
+
+    // d(c^T x)/dy = diag(1, 2 y_1, 1) A^-T c
+    Eigen::VectorXd w = A.transpose().lu().solve(c);
+    EXPECT_FLOAT_EQ(w(0), y(0).adj());
+    EXPECT_FLOAT_EQ(2 * y(1).val() * w(1), y(1).adj());
+    EXPECT_FLOAT_EQ(w(2), y(2).adj());
+    stan::math::recover_memory();
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Tests for newton solver.
 
+TEST(MathMatrixRevMat, newton_linear_solvers) {
+  using stan::math::kinsol_linear_solver;
+  using stan::math::ode_jacobian_structure;
+  using stan::math::var;
+  const int N = 12;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(N);
+  Eigen::VectorXd y(2);
+  y << 1.0, -0.5;
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+  std::vector<std::pair<int, int>> nonzeros;
+  for (int i = 0; i < N; ++i) {
+    for (int j = std::max(0, i - 1); j <= std::min(N - 1, i + 1); ++j) {
+      nonzeros.emplace_back(i, j);
+    }
+  }
+
+  Eigen::VectorXd theta = stan::math::algebra_solver_newton(
+      tridiagonal_eq_functor(), x, y, dat, dat_int, 0, 1e-10, 1e-12);
+  Eigen::VectorXd residual
+      = tridiagonal_eq_functor()(theta, y, dat, dat_int, 0);
+  EXPECT_LT(residual.norm(), 1e-10);
+
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y_ref = y;
+  stan::math::sum(stan::math::algebra_solver_newton(
+                      tridiagonal_eq_functor(), x, y_ref, dat, dat_int, 0,
+                      1e-10, 1e-12))
+      .grad();
+  Eigen::VectorXd y_adj(y.size());
+  for (int k = 0; k < y.size(); ++k) {
+    y_adj(k) = y_ref(k).adj();
+  }
+  stan::math::recover_memory();
+
+  std::vector<kinsol_linear_solver> solvers{
+      kinsol_linear_solver::structured(ode_jacobian_structure::banded(1, 1)),
+      kinsol_linear_solver::structured(
+          ode_jacobian_structure::sparse(nonzeros)),
+      kinsol_linear_solver::detected(), kinsol_linear_solver::gmres(N)};
+  for (const auto& solver : solvers) {
+    Eigen::VectorXd theta_solver = stan::math::algebra_solver_newton(
+        tridiagonal_eq_functor(), x, y, dat, dat_int, 0, 1e-10, 1e-12, 200,
+        solver);
+    for (int i = 0; i < N; ++i) {
+      EXPECT_NEAR(theta(i), theta_solver(i), 1e-8);
+    }
+
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_var = y;
+    Eigen::Matrix<var, Eigen::Dynamic, 1> theta_var
+        = stan::math::algebra_solver_newton(tridiagonal_eq_functor(), x, y_var,
+                                            dat, dat_int, 0, 1e-10, 1e-12, 200,
+                                            solver);
+    stan::math::sum(theta_var).grad();
+    for (int k = 0; k < y.size(); ++k) {
+      EXPECT_NEAR(y_adj(k), y_var(k).adj(), 1e-8);
+    }
+    stan::math::recover_memory();
+  }
+}
+
+TEST(MathMatrixRevMat, newton_detected_sparsity) {
+  const int N = 7;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(N);
+  Eigen::VectorXd y = Eigen::VectorXd::Ones(1);
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+  stan::math::ode_jacobian_structure structure
+      = stan::math::internal::kinsol_jacobian_sparsity(
+          tridiagonal_eq_functor(), x, y, dat, dat_int, 0);
+  EXPECT_EQ(1, structure.lower_bandwidth(N));
+  EXPECT_EQ(1, structure.upper_bandwidth(N));
+  std::vector<std::vector<int>> col_rows = structure.column_rows(N);
+  for (int j = 0; j < N; ++j) {
+    EXPECT_EQ((j > 0) + 1 + (j < N - 1), col_rows[j].size());
+  }
+  std::vector<int> colors = structure.row_colors(N);
+  EXPECT_EQ(2, *std::max_element(colors.begin(), colors.end()));
+}
+
 TEST_F(algebra_solver_simple_eq_test, newton) {
   using stan::math::var;
   bool is_newton = true;
@@ -0,0 +1,146 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/**
+ * Autoregressive recursion over a segment of a time series, returning
+ * the state after the segment.
+ */
+struct ar_segment {
+  template <typename T1, typename T2>
+  inline Eigen::Matrix<stan::return_type_t<T1, T2>, -1, 1> operator()(
+      std::ostream* msgs, const Eigen::Matrix<T1, -1, 1>& state,
+      const T2& rho, int steps) const {
+    Eigen::Matrix<stan::return_type_t<T1, T2>, -1, 1> x = state;
+    for (int t = 0; t < steps; ++t) {
+      x = rho * stan::math::sin(x);
+    }
+    return x;
+  }
+};
+
+struct segment_lp {
+  template <typename T1, typename T2>
+  inline stan::return_type_t<T1, T2> operator()(
+      std::ostream* msgs, const std::vector<T1>& y, const T2& mu) const {
+    stan::return_type_t<T1, T2> lp = 0;
+    for (size_t i = 0; i < y.size(); ++i)
+      lp += stan::math::normal_lpdf(y[i], mu, 1.0);
+    return lp;
+  }
+};
+
+struct nested_segment_lp {
+  template <typename T1, typename T2>
+  inline stan::return_type_t<T1, T2> operator()(
+      std::ostream* msgs, const std::vector<T1>& y, const T2& mu) const {
+    return stan::math::checkpoint(segment_lp(), msgs, y, mu)
+           + stan::math::checkpoint(segment_lp(), msgs, y, 2 * mu);
+  }
+};
+
+struct throwing_segment {
+  template <typename T>
+  inline T operator()(std::ostream* msgs, const T& x) const {
+    if (x > 1)
+      throw std::domain_error("bad x");
+    return x * x;
+  }
+};
+
+template <typename F>
+Eigen::Matrix<stan::math::var, -1, 1> run_ar(const F& segment,
+                                             const Eigen::VectorXd& x0,
+                                             stan::math::var& rho) {
+  Eigen::Matrix<stan::math::var, -1, 1> x = x0;
+  for (int s = 0; s < 4; ++s)
+    x = segment(x, rho);
+  return x;
+}
+}  // namespace
+
+TEST(StanMathRevFunctor, checkpoint_prim) {
+  std::vector<double> y{0.1, -0.4, 1.2};
+  EXPECT_FLOAT_EQ(segment_lp()(nullptr, y, 0.3),
+                  stan::math::checkpoint(segment_lp(), nullptr, y, 0.3));
+}
+
+TEST(StanMathRevFunctor, checkpoint_gradient_matches_taped) {
+  using stan::math::var;
+  Eigen::VectorXd x0(3);
+  x0 << 0.2, -0.7, 1.1;
+
+  var rho = 0.9;
+  Eigen::Matrix<var, -1, 1> x = run_ar(
+      [&](const Eigen::Matrix<var, -1, 1>& x, const var& rho) {
+        return ar_segment()(nullptr, x, rho, 5);
+      },
+      x0, rho);
+  var lp = stan::math::dot_self(x);
+  lp.grad();
+  double lp_expected = lp.val();
+  double rho_adj_expected = rho.adj();
+  stan::math::recover_memory();
+
+  rho = 0.9;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  x = run_ar(
+      [&](const Eigen::Matrix<var, -1, 1>& x, const var& rho) {
+        return stan::math::checkpoint(ar_segment(), nullptr, x, rho, 5);
+      },
+      x0, rho);
+  // the initial state and one vari per segment
+  EXPECT_EQ(stack_size + 3 + 4,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  lp = stan::math::dot_self(x);
+  lp.grad();
+  EXPECT_FLOAT_EQ(lp_expected, lp.val());
+  EXPECT_FLOAT_EQ(rho_adj_expected, rho.adj());
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, checkpoint_scalar_and_data) {
+  using stan::math::var;
+  std::vector<var> y{0.1, -0.4, 1.2};
+  var mu = 0.5;
+  var lp = stan::math::checkpoint(segment_lp(), nullptr, y, mu);
+  lp.grad();
+  EXPECT_FLOAT_EQ(segment_lp()(nullptr, std::vector<double>{0.1, -0.4, 1.2},
+                               0.5),
+                  lp.val());
+  for (size_t i = 0; i < y.size(); ++i)
+    EXPECT_FLOAT_EQ(0.5 - y[i].val(), y[i].adj());
+  EXPECT_FLOAT_EQ(0.1 - 0.4 + 1.2 - 3 * 0.5, mu.adj());
+  stan::math::recover_memory();
+
+  std::vector<double> y_d{0.1, -0.4, 1.2};
+  mu = 0.5;
+  lp = stan::math::checkpoint(segment_lp(), nullptr, y_d, mu);
+  lp.grad();
+  EXPECT_FLOAT_EQ(0.1 - 0.4 + 1.2 - 3 * 0.5, mu.adj());
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, checkpoint_nested) {
+  using stan::math::var;
+  std::vector<var> y{0.1, -0.4, 1.2};
+  var mu = 0.3;
+  var lp = stan::math::checkpoint(nested_segment_lp(), nullptr, y, mu);
+  lp.grad();
+  double sum_y = 0.1 - 0.4 + 1.2;
+  EXPECT_FLOAT_EQ((sum_y - 3 * 0.3) + 2 * (sum_y - 3 * 0.6), mu.adj());
+  for (size_t i = 0; i < y.size(); ++i)
+    EXPECT_FLOAT_EQ((0.3 - y[i].val()) + (0.6 - y[i].val()), y[i].adj());
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, checkpoint_throw) {
+  using stan::math::var;
+  var x = 2;
+  EXPECT_THROW(stan::math::checkpoint(throwing_segment(), nullptr, x),
+               std::domain_error);
+  stan::math::recover_memory();
+}
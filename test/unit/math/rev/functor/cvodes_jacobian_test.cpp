@@ -0,0 +1,188 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * Reaction-diffusion chain with a tridiagonal Jacobian.
+ */
+struct diffusion_chain_fun {
+  template <typename T0, typename T1, typename T2>
+  inline std::vector<typename stan::return_type<T1, T2>::type> operator()(
+      const T0& t_in, const std::vector<T1>& y,
+      const std::vector<T2>& theta, const std::vector<double>& x,
+      const std::vector<int>& x_int, std::ostream* msgs) const {
+    const size_t N = y.size();
+    std::vector<typename stan::return_type<T1, T2>::type> dydt(N);
+    for (size_t i = 0; i < N; ++i) {
+      const T1 left = i > 0 ? y[i - 1] : T1(0);
+      const T1 right = i + 1 < N ? y[i + 1] : T1(0);
+      dydt[i] = theta[0] * (left - 2 * y[i] + right) - theta[1] * y[i] * y[i];
+    }
+    return dydt;
+  }
+};
+
+struct diffusion_chain_jacobian {
+  Eigen::SparseMatrix<double> operator()(
+      double t, const std::vector<double>& y, const std::vector<double>& theta,
+      const std::vector<double>& x, const std::vector<int>& x_int,
+      std::ostream* msgs) const {
+    const int N = y.size();
+    Eigen::SparseMatrix<double> J(N, N);
+    for (int i = 0; i < N; ++i) {
+      if (i > 0)
+        J.insert(i, i - 1) = theta[0];
+      J.insert(i, i) = -2 * theta[0] - 2 * theta[1] * y[i];
+      if (i + 1 < N)
+        J.insert(i, i + 1) = theta[0];
+    }
+    return J;
+  }
+};
+
+std::vector<std::pair<int, int>> tridiagonal_pattern(int N) {
+  std::vector<std::pair<int, int>> nz;
+  for (int i = 0; i < N; ++i) {
+    for (int j = std::max(0, i - 1); j <= std::min(N - 1, i + 1); ++j)
+      nz.emplace_back(i, j);
+  }
+  return nz;
+}
+
+void expect_valid_coloring(const std::vector<std::pair<int, int>>& nz,
+                           const std::vector<int>& colors) {
+  for (const auto& a : nz)
+    for (const auto& b : nz)
+      if (a.second == b.second && a.first != b.first)
+        EXPECT_NE(colors[a.first], colors[b.first]);
+}
+
+Eigen::MatrixXd jacobian_of(const stan::math::ode_jacobian_structure& s,
+                            const std::vector<double>& y,
+                            const std::vector<double>& theta) {
+  using stan::math::internal::cvodes_autodiff_jacobian;
+  const int N = y.size();
+  SUNMatrix J = stan::math::internal::cvodes_jacobian_matrix(s, N);
+  cvodes_autodiff_jacobian(diffusion_chain_fun(), 0.0, y, theta, {}, {},
+                           nullptr, s, s.row_colors(N), s.column_rows(N), J);
+  Eigen::MatrixXd Jd = Eigen::MatrixXd::Zero(N, N);
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      if (SUNMatGetID(J) == SUNMATRIX_BAND) {
+        if (j - i <= s.upper_bandwidth(N) && i - j <= s.lower_bandwidth(N))
+          Jd(i, j) = SM_ELEMENT_B(J, i, j);
+      } else {
+        Jd(i, j) = SM_ELEMENT_D(J, i, j);
+      }
+    }
+  }
+  SUNMatDestroy(J);
+  return Jd;
+}
+}  // namespace
+
+TEST(StanMathCvodesJacobian, row_colors) {
+  using stan::math::ode_jacobian_structure;
+  std::vector<int> dense = ode_jacobian_structure().row_colors(4);
+  EXPECT_EQ(3, *std::max_element(dense.begin(), dense.end()));
+
+  std::vector<int> banded = ode_jacobian_structure::banded(1, 1).row_colors(10);
+  EXPECT_EQ(2, *std::max_element(banded.begin(), banded.end()));
+  expect_valid_coloring(tridiagonal_pattern(10), banded);
+
+  std::vector<std::pair<int, int>> nz = tridiagonal_pattern(10);
+  // couple the first and last state, which breaks the band
+  nz.emplace_back(0, 9);
+  nz.emplace_back(9, 0);
+  ode_jacobian_structure sparse = ode_jacobian_structure::sparse(nz);
+  std::vector<int> colors = sparse.row_colors(10);
+  expect_valid_coloring(nz, colors);
+  EXPECT_LE(*std::max_element(colors.begin(), colors.end()), 4);
+  EXPECT_FALSE(sparse.use_band_solver(10));
+}
+
+TEST(StanMathCvodesJacobian, errors) {
+  using stan::math::ode_jacobian_structure;
+  EXPECT_THROW(ode_jacobian_structure::banded(-1, 0), std::domain_error);
+  EXPECT_THROW(ode_jacobian_structure::sparse({{0, -1}}), std::domain_error);
+  EXPECT_THROW(ode_jacobian_structure::sparse({{0, 5}}).row_colors(5),
+               std::domain_error);
+}
+
+TEST(StanMathCvodesJacobian, colored_sweeps) {
+  using stan::math::ode_jacobian_structure;
+  const int N = 12;
+  std::vector<double> y(N);
+  for (int i = 0; i < N; ++i)
+    y[i] = 0.1 * (i + 1);
+  std::vector<double> theta{0.7, 1.3};
+
+  Eigen::MatrixXd J_dense = jacobian_of(ode_jacobian_structure(), y, theta);
+  Eigen::MatrixXd J_band
+      = jacobian_of(ode_jacobian_structure::banded(1, 1), y, theta);
+  Eigen::MatrixXd J_sparse = jacobian_of(
+      ode_jacobian_structure::sparse(tridiagonal_pattern(N)), y, theta);
+  Eigen::MatrixXd J_analytic
+      = diffusion_chain_jacobian()(0.0, y, theta, {}, {}, nullptr);
+
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      EXPECT_FLOAT_EQ(J_analytic(i, j), J_dense(i, j));
+      EXPECT_FLOAT_EQ(J_analytic(i, j), J_band(i, j));
+      EXPECT_FLOAT_EQ(J_analytic(i, j), J_sparse(i, j));
+    }
+  }
+}
+
+TEST(StanMathCvodesJacobian, integrate_ode_bdf) {
+  using stan::math::ode_jacobian_structure;
+  using stan::math::var;
+  const int N = 30;
+  std::vector<double> y0(N, 0.0);
+  y0[N / 2] = 1.0;
+  std::vector<double> ts{0.5, 1.0, 2.0};
+  std::vector<double> x;
+  std::vector<int> x_int;
+  diffusion_chain_fun f;
+
+  auto solve = [&](int mode, std::vector<double>& grad) {
+    std::vector<var> theta{0.7, 1.3};
+    std::vector<std::vector<var>> y;
+    if (mode == 0) {
+      y = stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta, x, x_int);
+    } else if (mode == 1) {
+      y = stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta, x, x_int,
+                                        nullptr, 1e-10, 1e-10, 1e8,
+                                        ode_jacobian_structure::banded(1, 1));
+    } else {
+      y = stan::math::integrate_ode_bdf(
+          f, y0, 0.0, ts, theta, x, x_int, nullptr, 1e-10, 1e-10, 1e8,
+          ode_jacobian_structure::sparse(tridiagonal_pattern(N)),
+          diffusion_chain_jacobian());
+    }
+    std::vector<double> vals;
+    for (auto& y_n : y)
+      for (auto& y_ni : y_n)
+        vals.push_back(y_ni.val());
+    y[2][N / 2 + 1].grad();
+    grad = {theta[0].adj(), theta[1].adj()};
+    stan::math::recover_memory();
+    return vals;
+  };
+
+  std::vector<double> g_dense, g_band, g_analytic;
+  std::vector<double> y_dense = solve(0, g_dense);
+  std::vector<double> y_band = solve(1, g_band);
+  std::vector<double> y_analytic = solve(2, g_analytic);
+  for (size_t k = 0; k < y_dense.size(); ++k) {
+    EXPECT_NEAR(y_dense[k], y_band[k], 1e-8);
+    EXPECT_NEAR(y_dense[k], y_analytic[k], 1e-8);
+  }
+  for (size_t k = 0; k < g_dense.size(); ++k) {
+    EXPECT_NEAR(g_dense[k], g_band[k], 1e-7);
+    EXPECT_NEAR(g_dense[k], g_analytic[k], 1e-7);
+  }
+}
@@ -0,0 +1,131 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/harmonic_oscillator.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+std::vector<double> gradient(stan::math::var y,
+                             const std::vector<stan::math::var>& y0,
+                             const std::vector<stan::math::var>& theta) {
+  stan::math::set_zero_all_adjoints();
+  y.grad();
+  std::vector<double> g;
+  for (const auto& v : y0)
+    g.push_back(v.adj());
+  for (const auto& v : theta)
+    g.push_back(v.adj());
+  return g;
+}
+}  // namespace
+
+TEST(StanMathRevFunctor, cvodes_session_continue) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<var> y0{1.0, 0.5};
+  std::vector<var> theta{0.15};
+
+  std::vector<std::vector<var>> y_ref = stan::math::integrate_ode_bdf(
+      f, y0, 0.0, std::vector<double>{1.0, 2.0, 3.0}, theta, x, x_int);
+
+  stan::math::ode_bdf_session<harm_osc_ode_fun, var, var> session(
+      f, y0, 0.0, theta, x, x_int);
+  std::vector<std::vector<var>> y1
+      = session.integrate(std::vector<double>{1.0, 2.0});
+  std::vector<std::vector<var>> y2
+      = session.integrate(std::vector<double>{3.0});
+  EXPECT_FLOAT_EQ(3.0, session.time());
+  ASSERT_EQ(2, y1.size());
+  ASSERT_EQ(1, y2.size());
+  y1.push_back(y2[0]);
+
+  for (size_t n = 0; n < 3; ++n) {
+    for (size_t i = 0; i < 2; ++i) {
+      EXPECT_NEAR(y_ref[n][i].val(), y1[n][i].val(), 1e-7);
+      std::vector<double> g_ref = gradient(y_ref[n][i], y0, theta);
+      std::vector<double> g = gradient(y1[n][i], y0, theta);
+      for (size_t k = 0; k < g.size(); ++k)
+        EXPECT_NEAR(g_ref[k], g[k], 1e-6);
+    }
+  }
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, cvodes_session_dosing) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<var> y0{1.0, 0.5};
+  // the second parameter is the amount of the dose at t = 2
+  std::vector<var> theta{0.15, 0.7};
+
+  std::vector<std::vector<var>> y_ref = stan::math::integrate_ode_bdf(
+      f, y0, 0.0, std::vector<double>{2.0}, theta, x, x_int);
+  std::vector<var> y_dose{y_ref[0][0] + 0.3, y_ref[0][1] + 2 * theta[1]};
+  y_ref = stan::math::integrate_ode_bdf(f, y_dose, 2.0,
+                                        std::vector<double>{3.0, 4.0}, theta,
+                                        x, x_int);
+  std::vector<var> y_set{y_ref[1][0], 0.25};
+  std::vector<std::vector<var>> y_ref2 = stan::math::integrate_ode_bdf(
+      f, y_set, 4.0, std::vector<double>{5.0}, theta, x, x_int);
+  y_ref.push_back(y_ref2[0]);
+
+  stan::math::ode_adams_session<harm_osc_ode_fun, var, var> session(
+      f, y0, 0.0, theta, x, x_int);
+  session.integrate(std::vector<double>{2.0});
+  session.add_to_state(0, 0.3);
+  session.add_parameter_to_state(1, 1, 2.0);
+  std::vector<std::vector<var>> y
+      = session.integrate(std::vector<double>{3.0, 4.0});
+  session.set_state(1, 0.25);
+  y.push_back(session.integrate(std::vector<double>{5.0})[0]);
+
+  for (size_t n = 0; n < 3; ++n) {
+    for (size_t i = 0; i < 2; ++i) {
+      EXPECT_NEAR(y_ref[n][i].val(), y[n][i].val(), 1e-7);
+      std::vector<double> g_ref = gradient(y_ref[n][i], y0, theta);
+      std::vector<double> g = gradient(y[n][i], y0, theta);
+      for (size_t k = 0; k < g.size(); ++k)
+        EXPECT_NEAR(g_ref[k], g[k], 1e-6);
+    }
+  }
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, cvodes_session_data) {
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<double> y0{1.0, 0.5};
+  std::vector<double> theta{0.15};
+
+  stan::math::ode_bdf_session<harm_osc_ode_fun, double, double> session(
+      f, y0, 0.0, theta, x, x_int);
+  session.integrate(std::vector<double>{1.0});
+  session.add_to_state(1, 1.0);
+  std::vector<std::vector<double>> y
+      = session.integrate(std::vector<double>{2.0});
+
+  std::vector<std::vector<double>> y_ref = stan::math::integrate_ode_bdf(
+      f, y0, 0.0, std::vector<double>{1.0}, theta, x, x_int);
+  y_ref[0][1] += 1.0;
+  y_ref = stan::math::integrate_ode_bdf(f, y_ref[0], 1.0,
+                                        std::vector<double>{2.0}, theta, x,
+                                        x_int);
+  EXPECT_NEAR(y_ref[0][0], y[0][0], 1e-7);
+  EXPECT_NEAR(y_ref[0][1], y[0][1], 1e-7);
+
+  EXPECT_THROW(session.integrate(std::vector<double>{1.5}),
+               std::domain_error);
+  EXPECT_THROW(session.add_to_state(2, 1.0), std::domain_error);
+  EXPECT_THROW(session.add_parameter_to_state(0, 1), std::domain_error);
+  EXPECT_THROW((stan::math::ode_bdf_session<harm_osc_ode_fun, double, double>(
+                   f, y0, 0.0, theta, x, x_int, nullptr, -1)),
+               std::invalid_argument);
+  EXPECT_THROW((stan::math::ode_bdf_session<harm_osc_ode_fun, double, double>(
+                   f, std::vector<double>(), 0.0, theta, x, x_int)),
+               std::invalid_argument);
+}
@@ -0,0 +1,51 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace {
+// log density of a correlated bivariate normal plus a quartic term
+struct quartic_functor {
+  template <typename T>
+  T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    return -0.5 * (x(0) * x(0) - x(0) * x(1) + 2 * x(1) * x(1))
+           + x(2) * x(2) * x(2) * x(2) / 12 + x(0) * x(2);
+  }
+};
+}  // namespace
+
+TEST(RevFunctor, finite_diff_hessian_auto) {
+  using stan::math::finite_diff_stencil;
+  Eigen::VectorXd x(3);
+  x << 0.5, -1.5, 2;
+  Eigen::MatrixXd hess_expected(3, 3);
+  hess_expected << -1, 0.5, 1, 0.5, -2, 0, 1, 0, x(2) * x(2);
+  // the gradients are only computed in parallel whenever threading is
+  // used
+#ifdef STAN_THREADS
+  const std::vector<bool> parallel_modes{false, true};
+#else
+  const std::vector<bool> parallel_modes{false};
+#endif
+
+  for (auto stencil :
+       {finite_diff_stencil::central, finite_diff_stencil::forward}) {
+    for (bool parallel : parallel_modes) {
+      double fx;
+      Eigen::VectorXd grad_fx;
+      Eigen::MatrixXd hess_fx;
+      stan::math::internal::finite_diff_hessian_auto(
+          quartic_functor(), x, fx, grad_fx, hess_fx, stencil, parallel);
+      EXPECT_FLOAT_EQ(quartic_functor()(x), fx);
+      EXPECT_FLOAT_EQ(-0.5 * (2 * x(0) - x(1)) + x(2), grad_fx(0));
+      const double tolerance
+          = stencil == finite_diff_stencil::central ? 1e-8 : 1e-6;
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          EXPECT_NEAR(hess_expected(i, j), hess_fx(i, j), tolerance);
+          EXPECT_EQ(hess_fx(i, j), hess_fx(j, i));
+        }
+      }
+    }
+  }
+}
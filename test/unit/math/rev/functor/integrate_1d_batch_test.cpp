@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <stan/math.hpp>
+#include <test/unit/math/rev/fun/util.hpp>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace {
+std::ostringstream *msgs = nullptr;
+
+// unnormalized normal density with mean theta[0] and standard deviation
+// theta[1], counting its batches
+struct normal_kernel_batch {
+  int *batches;
+
+  template <typename T>
+  Eigen::Matrix<T, Eigen::Dynamic, 1> operator()(
+      const Eigen::VectorXd &x, const Eigen::VectorXd &xc,
+      const std::vector<T> &theta, const std::vector<double> &x_r,
+      const std::vector<int> &x_i, std::ostream *msgs) const {
+    ++*batches;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      y(i) = exp(-0.5 * stan::math::square((x(i) - theta[0]) / theta[1]));
+    }
+    return y;
+  }
+};
+
+// theta[1] * x + sqrt(theta[0])^2, whose gradient is NaN for
+// theta[0] = 0
+struct nan_gradient_batch {
+  template <typename T>
+  Eigen::Matrix<T, Eigen::Dynamic, 1> operator()(
+      const Eigen::VectorXd &x, const Eigen::VectorXd &xc,
+      const std::vector<T> &theta, const std::vector<double> &x_r,
+      const std::vector<int> &x_i, std::ostream *msgs) const {
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      y(i) = theta[1] * x(i) + sqrt(theta[0]) * sqrt(theta[0]);
+    }
+    return y;
+  }
+};
+}  // namespace
+
+TEST(StanAgradRevIntegrate1dBatch, gauss_kronrod_gradient) {
+  using stan::math::INFTY;
+  using stan::math::integrate_1d_batch;
+  using stan::math::var;
+  int batches = 0;
+  normal_kernel_batch f{&batches};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  std::vector<var> theta = {0.3, 1.5};
+  var I = integrate_1d_batch(f, -INFTY, INFTY, theta, x_r, x_i, msgs, 1e-10);
+  EXPECT_NEAR(1.5 * std::sqrt(2 * stan::math::pi()), I.val(), 1e-9);
+  I.grad();
+  EXPECT_NEAR(0.0, theta[0].adj(), 1e-9);
+  EXPECT_NEAR(std::sqrt(2 * stan::math::pi()), theta[1].adj(), 1e-9);
+  stan::math::recover_memory();
+
+  // the gradient of a smooth integral takes a single batch, followed by
+  // the integrand at both limits
+  batches = 0;
+  theta = {0.3, 1.5};
+  var a = 0.5;
+  var b = 1.0;
+  I = integrate_1d_batch(f, a, b, theta, x_r, x_i, msgs);
+  EXPECT_EQ(3, batches);
+  double I_d = integrate_1d_batch(f, 0.5, 1.0, stan::math::value_of(theta),
+                                  x_r, x_i, msgs);
+  EXPECT_FLOAT_EQ(I_d, I.val());
+  I.grad();
+  const double eps = 1e-6;
+  EXPECT_NEAR((integrate_1d_batch(f, 0.5, 1.0, {0.3 + eps, 1.5}, x_r, x_i,
+                                  msgs)
+               - integrate_1d_batch(f, 0.5, 1.0, {0.3 - eps, 1.5}, x_r, x_i,
+                                    msgs))
+                  / (2 * eps),
+              theta[0].adj(), 1e-7);
+  EXPECT_NEAR(-std::exp(-0.5 * 0.04 / 2.25), a.adj(), 1e-12);
+  EXPECT_NEAR(std::exp(-0.5 * 0.49 / 2.25), b.adj(), 1e-12);
+  stan::math::recover_memory();
+}
+
+TEST(StanAgradRevIntegrate1dBatch, fixed_rule_gradient) {
+  using stan::math::INFTY;
+  using stan::math::integrate_1d_batch;
+  using stan::math::integrate_1d_rule;
+  using stan::math::var;
+  int batches = 0;
+  normal_kernel_batch f{&batches};
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+  const integrate_1d_rule hermite = integrate_1d_rule::gauss_hermite(30);
+
+  std::vector<var> theta = {0.3, 0.8};
+  var I = integrate_1d_batch(f, -INFTY, INFTY, theta, x_r, x_i, msgs, 1e-8,
+                             hermite);
+  EXPECT_EQ(1, batches);
+  EXPECT_NEAR(0.8 * std::sqrt(2 * stan::math::pi()), I.val(), 1e-8);
+  I.grad();
+  EXPECT_NEAR(0.0, theta[0].adj(), 1e-8);
+  EXPECT_NEAR(std::sqrt(2 * stan::math::pi()), theta[1].adj(), 1e-8);
+  stan::math::recover_memory();
+
+  theta = {0.3, 0.8};
+  I = integrate_1d_batch(f, -1, 1, theta, x_r, x_i, msgs, 1e-8,
+                         integrate_1d_rule::gauss_legendre(20));
+  var I_gk = integrate_1d_batch(f, -1, 1, theta, x_r, x_i, msgs);
+  EXPECT_NEAR(I_gk.val(), I.val(), 1e-10);
+  std::vector<double> g;
+  std::vector<double> g_gk;
+  std::vector<stan::math::var> theta_vec(theta);
+  I.grad(theta_vec, g);
+  stan::math::set_zero_all_adjoints();
+  I_gk.grad(theta_vec, g_gk);
+  EXPECT_NEAR(g_gk[0], g[0], 1e-10);
+  EXPECT_NEAR(g_gk[1], g[1], 1e-10);
+  stan::math::recover_memory();
+}
+
+TEST(StanAgradRevIntegrate1dBatch, nan_gradient) {
+  using stan::math::integrate_1d_batch;
+  using stan::math::integrate_1d_rule;
+  using stan::math::var;
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+
+  // NaN gradients are zero where the function is zero
+  std::vector<var> theta = {0.0, 0.0};
+  var I = integrate_1d_batch(nan_gradient_batch(), 0, 1, theta, x_r, x_i,
+                             msgs, 1e-8, integrate_1d_rule::gauss_legendre(5));
+  EXPECT_FLOAT_EQ(0.0, I.val());
+  I.grad();
+  EXPECT_FLOAT_EQ(0.0, theta[0].adj());
+  EXPECT_FLOAT_EQ(0.5, theta[1].adj());
+  stan::math::recover_memory();
+
+  theta = {0.0, 2.0};
+  EXPECT_THROW(integrate_1d_batch(nan_gradient_batch(), 0, 1, theta, x_r, x_i,
+                                  msgs),
+               std::domain_error);
+  stan::math::recover_memory();
+}
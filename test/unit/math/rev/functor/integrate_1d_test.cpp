@@ -893,3 +893,60 @@ TEST(StanMath_integrate_1d_rev, TestWeibull) {
   EXPECT_FLOAT_EQ(1, 1 + g[0]);
   EXPECT_FLOAT_EQ(1, 1 + g[1]);
 }
+
+struct polynomial_counter {
+  int *value_calls;
+  int *var_calls;
+  inline double operator()(const double &x, const double &xc,
+                           const std::vector<double> &theta,
+                           const std::vector<double> &x_r,
+                           const std::vector<int> &x_i,
+                           std::ostream *msgs) const {
+    ++*value_calls;
+    double y = 0;
+    for (size_t i = 0; i < theta.size(); ++i)
+      y += theta[i] * std::pow(x, i);
+    return y;
+  }
+  inline stan::math::var operator()(
+      const double &x, const double &xc,
+      const std::vector<stan::math::var> &theta,
+      const std::vector<double> &x_r, const std::vector<int> &x_i,
+      std::ostream *msgs) const {
+    ++*var_calls;
+    stan::math::var y = 0;
+    for (size_t i = 0; i < theta.size(); ++i)
+      y += theta[i] * std::pow(x, i);
+    return y;
+  }
+};
+
+TEST(StanMath_integrate_1d_rev, TestDerivativesSinglePass) {
+  using stan::math::var;
+  // the integral and all partials are integrated together, with one
+  // evaluation of the integrand per node
+  const size_t M = 20;
+  int value_calls = 0;
+  int var_calls = 0;
+  polynomial_counter f{&value_calls, &var_calls};
+  std::vector<var> theta(M);
+  double expected = 0;
+  for (size_t i = 0; i < M; ++i) {
+    theta[i] = 1.0 / (i + 1);
+    expected += 1.0 / ((i + 1) * (i + 1));
+  }
+  var I = stan::math::integrate_1d(f, 0.0, 1.0, theta, {}, {}, msgs, 1e-8);
+  I.grad();
+  EXPECT_NEAR(expected, I.val(), 1e-8);
+  for (size_t i = 0; i < M; ++i) {
+    EXPECT_NEAR(1.0 / (i + 1), theta[i].adj(), 1e-8);
+  }
+  EXPECT_EQ(0, value_calls);
+
+  int single_calls = 0;
+  polynomial_counter g{&value_calls, &single_calls};
+  std::vector<var> theta_1 = {1.0};
+  stan::math::integrate_1d(g, 0.0, 1.0, theta_1, {}, {}, msgs, 1e-8);
+  EXPECT_LT(var_calls, 4 * single_calls);
+  stan::math::recover_memory();
+}
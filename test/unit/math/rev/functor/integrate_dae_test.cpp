@@ -134,3 +134,225 @@ TEST_F(StanIntegrateDAETest, inconsistent_ic_error) {
       integrate_dae(f, yy0, yp0, t0, ts, theta_var, x_r, x_i, 1e-5, 1e-12),
       std::domain_error, "DAE residual at t0");
 }
+
+// method of lines discretization of u_t = theta[0] u_xx - theta[1] u
+// with the algebraic boundary conditions u_0 = u_1 / 2 and u_{N-1} = 0
+struct heat_dae {
+  template <typename T0, typename TYY, typename TYP, typename TPAR>
+  inline std::vector<typename stan::return_type<TYY, TYP, TPAR>::type>
+  operator()(const T0& t_in, const std::vector<TYY>& yy,
+             const std::vector<TYP>& yp, const std::vector<TPAR>& theta,
+             const std::vector<double>& x_r, const std::vector<int>& x_i,
+             std::ostream* msgs) const {
+    const size_t N = yy.size();
+    std::vector<typename stan::return_type<TYY, TYP, TPAR>::type> res(N);
+    res[0] = yy[0] - 0.5 * yy[1];
+    for (size_t i = 1; i < N - 1; ++i) {
+      res[i] = yp[i] - theta[0] * (yy[i - 1] - 2 * yy[i] + yy[i + 1])
+               + theta[1] * yy[i];
+    }
+    res[N - 1] = yy[N - 1];
+    return res;
+  }
+};
+
+struct StanIntegrateDAEHeatTest : public ::testing::Test {
+  heat_dae f;
+  std::vector<double> yy0;
+  std::vector<double> yp0;
+  std::vector<double> theta;
+  std::vector<double> x_r;
+  std::vector<int> x_i;
+  std::vector<double> ts;
+
+  void SetUp() { stan::math::recover_memory(); }
+
+  StanIntegrateDAEHeatTest() : theta{2.0, 0.3}, ts{0.1, 0.5, 1.0} {
+    const size_t N = 20;
+    yy0.resize(N);
+    for (size_t i = 1; i < N - 1; ++i) {
+      yy0[i] = std::sin(stan::math::pi() * i / (N - 1));
+    }
+    yy0[0] = 0.5 * yy0[1];
+    yy0[N - 1] = 0.0;
+    std::vector<double> res
+        = f(0.0, yy0, std::vector<double>(N, 0.0), theta, x_r, x_i, 0);
+    yp0.resize(N);
+    for (size_t i = 0; i < N; ++i) {
+      yp0[i] = i == 0 || i == N - 1 ? 0.0 : -res[i];
+    }
+  }
+};
+
+TEST_F(StanIntegrateDAEHeatTest, banded_and_sparse_solvers) {
+  using stan::math::integrate_dae;
+  using stan::math::ode_jacobian_structure;
+  using stan::math::to_var;
+  using stan::math::var;
+  const size_t N = yy0.size();
+
+  std::vector<std::pair<int, int>> nonzeros;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = (i > 0 ? i - 1 : 0); j < std::min(N, i + 2); ++j) {
+      nonzeros.emplace_back(i, j);
+    }
+  }
+  std::vector<std::vector<double> > yy_dense
+      = integrate_dae(f, yy0, yp0, 0.0, ts, theta, x_r, x_i, 1e-8, 1e-10);
+  std::vector<std::vector<double> > yy_band
+      = integrate_dae(f, yy0, yp0, 0.0, ts, theta, x_r, x_i, 1e-8, 1e-10, 500,
+                      nullptr, ode_jacobian_structure::banded(1, 1));
+  std::vector<std::vector<double> > yy_sparse
+      = integrate_dae(f, yy0, yp0, 0.0, ts, theta, x_r, x_i, 1e-8, 1e-10, 500,
+                      nullptr, ode_jacobian_structure::sparse(nonzeros));
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (size_t i = 0; i < N; ++i) {
+      EXPECT_NEAR(yy_dense[n][i], yy_band[n][i], 1e-7);
+      EXPECT_NEAR(yy_dense[n][i], yy_sparse[n][i], 1e-7);
+    }
+  }
+
+  std::vector<var> theta_var = to_var(theta);
+  std::vector<std::vector<var> > yy
+      = integrate_dae(f, yy0, yp0, 0.0, ts, theta_var, x_r, x_i, 1e-8, 1e-10,
+                      500, nullptr, ode_jacobian_structure::banded(1, 1));
+  std::vector<double> g;
+  yy[2][5].grad(theta_var, g);
+  const double h = 1e-5;
+  const std::vector<double> theta1{theta[0] - h, theta[1]};
+  const std::vector<double> theta2{theta[0] + h, theta[1]};
+  const std::vector<int> eq_id(N, 1);
+  stan::math::idas_integrator solver(1e-10, 1e-12, 1000);
+  stan::math::idas_forward_system<heat_dae, double, double, double> dae1(
+      f, eq_id, yy0, yp0, theta1, x_r, x_i, nullptr),
+      dae2(f, eq_id, yy0, yp0, theta2, x_r, x_i, nullptr);
+  const double fd = (solver.integrate(dae2, 0.0, ts)[2][5]
+                     - solver.integrate(dae1, 0.0, ts)[2][5])
+                    / (2 * h);
+  EXPECT_NEAR(fd, g[0], 1e-6);
+}
+
+TEST_F(StanIntegrateDAEHeatTest, adjoint_sensitivity) {
+  using stan::math::idas_adjoint_options;
+  using stan::math::integrate_dae;
+  using stan::math::ode_jacobian_structure;
+  using stan::math::to_var;
+  using stan::math::value_of;
+  using stan::math::var;
+  const size_t N = yy0.size();
+  const idas_adjoint_options options;
+
+  std::vector<var> theta_fwd = to_var(theta);
+  std::vector<std::vector<var> > yy_fwd = integrate_dae(
+      f, yy0, yp0, 0.0, ts, theta_fwd, x_r, x_i, 1e-10, 1e-12);
+  var lp_fwd = 0;
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (size_t i = 0; i < N; ++i) {
+      lp_fwd += (n + 1.0) * (i + 1.0) / N * yy_fwd[n][i];
+    }
+  }
+  std::vector<double> g_fwd;
+  lp_fwd.grad(theta_fwd, g_fwd);
+
+  for (const auto& structure :
+       {ode_jacobian_structure(), ode_jacobian_structure::banded(1, 1)}) {
+    std::vector<var> theta_adj = to_var(theta);
+    std::vector<std::vector<var> > yy_adj
+        = integrate_dae(f, yy0, yp0, 0.0, ts, theta_adj, x_r, x_i, 1e-10,
+                        1e-12, 500, nullptr, options, structure);
+    var lp_adj = 0;
+    for (size_t n = 0; n < ts.size(); ++n) {
+      for (size_t i = 0; i < N; ++i) {
+        EXPECT_NEAR(value_of(yy_fwd[n][i]), value_of(yy_adj[n][i]), 1e-8);
+        lp_adj += (n + 1.0) * (i + 1.0) / N * yy_adj[n][i];
+      }
+    }
+    std::vector<double> g_adj;
+    stan::math::set_zero_all_adjoints();
+    lp_adj.grad(theta_adj, g_adj);
+    EXPECT_NEAR(g_fwd[0], g_adj[0], 1e-6);
+    EXPECT_NEAR(g_fwd[1], g_adj[1], 1e-6);
+  }
+
+  std::vector<std::vector<double> > yy_d
+      = integrate_dae(f, yy0, yp0, 0.0, ts, theta, x_r, x_i, 1e-10, 1e-12,
+                      500, nullptr, options);
+  EXPECT_NEAR(value_of(yy_fwd[2][5]), yy_d[2][5], 1e-8);
+}
+
+TEST_F(StanIntegrateDAETest, adjoint_sensitivity_theta) {
+  using stan::math::idas_adjoint_options;
+  using stan::math::integrate_dae;
+  using stan::math::to_var;
+  using stan::math::value_of;
+  using stan::math::var;
+
+  std::vector<var> theta_fwd = to_var(theta);
+  std::vector<std::vector<var> > yy_fwd = integrate_dae(
+      f, yy0, yp0, t0, ts, theta_fwd, x_r, x_i, 1e-8, 1e-14, 10000);
+  idas_adjoint_options options;
+  options.absolute_tolerance_backward = 1e-14;
+  options.absolute_tolerance_quadrature = 1e-16;
+  std::vector<var> theta_adj = to_var(theta);
+  std::vector<std::vector<var> > yy_adj
+      = integrate_dae(f, yy0, yp0, t0, ts, theta_adj, x_r, x_i, 1e-8, 1e-14,
+                      10000, msgs, options);
+
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_NEAR(value_of(yy_fwd[n][i]), value_of(yy_adj[n][i]), 1e-7);
+    }
+  }
+  std::vector<double> g_fwd;
+  std::vector<double> g_adj;
+  for (size_t i = 0; i < 3; ++i) {
+    stan::math::set_zero_all_adjoints();
+    yy_fwd[3][i].grad(theta_fwd, g_fwd);
+    stan::math::set_zero_all_adjoints();
+    yy_adj[3][i].grad(theta_adj, g_adj);
+    for (size_t j = 0; j < 3; ++j) {
+      EXPECT_NEAR(g_fwd[j], g_adj[j], 1e-5 * std::fabs(g_fwd[j]));
+    }
+  }
+
+  options.steps_between_checkpoints = 0;
+  EXPECT_THROW(integrate_dae(f, yy0, yp0, t0, ts, theta_adj, x_r, x_i, 1e-8,
+                             1e-14, 10000, msgs, options),
+               std::domain_error);
+}
+
+TEST_F(StanIntegrateDAETest, adjoint_full_stack_during_chain) {
+  using stan::math::idas_adjoint_options;
+  using stan::math::integrate_dae;
+  using stan::math::to_var;
+  using stan::math::var;
+
+  std::vector<var> theta_adj = to_var(theta);
+  std::vector<std::vector<var> > yy_adj
+      = integrate_dae(f, yy0, yp0, t0, ts, theta_adj, x_r, x_i, 1e-8, 1e-14,
+                      10000, msgs, idas_adjoint_options());
+  var lp = yy_adj[1][0] + yy_adj[3][2];
+
+  // the nested sweeps of the backward problem must not push onto the
+  // stack the reverse pass iterates over, which has no spare capacity
+  auto& var_stack = stan::math::ChainableStack::instance_->var_stack_;
+  var_stack.shrink_to_fit();
+  const size_t capacity = var_stack.capacity();
+  lp.grad();
+  EXPECT_EQ(capacity, var_stack.capacity());
+  std::vector<double> g_adj(3);
+  for (size_t j = 0; j < 3; ++j) {
+    g_adj[j] = theta_adj[j].adj();
+  }
+  stan::math::recover_memory();
+
+  std::vector<var> theta_fwd = to_var(theta);
+  std::vector<std::vector<var> > yy_fwd = integrate_dae(
+      f, yy0, yp0, t0, ts, theta_fwd, x_r, x_i, 1e-8, 1e-14, 10000);
+  (yy_fwd[1][0] + yy_fwd[3][2]).grad();
+  for (size_t j = 0; j < 3; ++j) {
+    EXPECT_NEAR(theta_fwd[j].adj(), g_adj[j],
+                1e-5 * std::fabs(theta_fwd[j].adj()));
+  }
+  stan::math::recover_memory();
+}
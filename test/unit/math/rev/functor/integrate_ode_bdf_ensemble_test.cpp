@@ -0,0 +1,84 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/harmonic_oscillator.hpp>
+#include <stdexcept>
+#include <vector>
+
+TEST(StanMathRevFunctor, integrate_ode_bdf_ensemble) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  const size_t K = 4;
+
+  std::vector<std::vector<var>> y0s;
+  std::vector<std::vector<var>> thetas;
+  std::vector<std::vector<double>> tss;
+  for (size_t k = 0; k < K; ++k) {
+    y0s.push_back({1.0 + 0.1 * k, -0.5 * k});
+    thetas.push_back({0.1 + 0.05 * k});
+    std::vector<double> ts;
+    for (size_t n = 0; n <= k; ++n) {
+      ts.push_back(0.5 + n);
+    }
+    tss.push_back(ts);
+  }
+
+  std::vector<std::vector<std::vector<var>>> ys
+      = stan::math::integrate_ode_bdf_ensemble(f, y0s, 0.0, tss, thetas, x,
+                                               x_int);
+  ASSERT_EQ(K, ys.size());
+
+  for (size_t k = 0; k < K; ++k) {
+    ASSERT_EQ(tss[k].size(), ys[k].size());
+    std::vector<std::vector<var>> y = stan::math::integrate_ode_bdf(
+        f, y0s[k], 0.0, tss[k], thetas[k], x, x_int);
+    for (size_t n = 0; n < tss[k].size(); ++n) {
+      for (size_t i = 0; i < 2; ++i) {
+        EXPECT_FLOAT_EQ(y[n][i].val(), ys[k][n][i].val());
+
+        stan::math::set_zero_all_adjoints();
+        ys[k][n][i].grad();
+        std::vector<double> g{y0s[k][0].adj(), y0s[k][1].adj(),
+                              thetas[k][0].adj()};
+        stan::math::set_zero_all_adjoints();
+        y[n][i].grad();
+        EXPECT_FLOAT_EQ(y0s[k][0].adj(), g[0]);
+        EXPECT_FLOAT_EQ(y0s[k][1].adj(), g[1]);
+        EXPECT_FLOAT_EQ(thetas[k][0].adj(), g[2]);
+      }
+    }
+  }
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, integrate_ode_bdf_ensemble_data) {
+  harm_osc_ode_fun f;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<std::vector<double>> y0s{{1.0, 0.0}, {0.5, 0.5}};
+  std::vector<std::vector<double>> thetas{{0.15}, {0.3}};
+  std::vector<std::vector<double>> tss{{1.0, 2.0}, {3.0}};
+
+  std::vector<std::vector<std::vector<double>>> ys
+      = stan::math::integrate_ode_adams_ensemble(f, y0s, 0.0, tss, thetas, x,
+                                                 x_int);
+  for (size_t k = 0; k < 2; ++k) {
+    std::vector<std::vector<double>> y = stan::math::integrate_ode_adams(
+        f, y0s[k], 0.0, tss[k], thetas[k], x, x_int);
+    ASSERT_EQ(y.size(), ys[k].size());
+    for (size_t n = 0; n < y.size(); ++n) {
+      EXPECT_FLOAT_EQ(y[n][0], ys[k][n][0]);
+      EXPECT_FLOAT_EQ(y[n][1], ys[k][n][1]);
+    }
+  }
+
+  tss.pop_back();
+  EXPECT_THROW(stan::math::integrate_ode_bdf_ensemble(f, y0s, 0.0, tss, thetas,
+                                                      x, x_int),
+               std::invalid_argument);
+  tss.push_back({-1.0});
+  EXPECT_THROW(stan::math::integrate_ode_bdf_ensemble(f, y0s, 0.0, tss, thetas,
+                                                      x, x_int),
+               std::domain_error);
+}
@@ -0,0 +1,202 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/harmonic_oscillator.hpp>
+#include <test/unit/math/prim/functor/lorenz.hpp>
+#include <vector>
+
+namespace {
+
+/**
+ * Gradients of a weighted sum of all ODE outputs wrt y0, theta, t0
+ * and ts, computed either with forward or adjoint sensitivities.
+ */
+template <int Lmm, typename F>
+std::vector<double> ode_gradient(const F& f, const std::vector<double>& y0,
+                                 double t0, const std::vector<double>& ts,
+                                 const std::vector<double>& theta,
+                                 bool adjoint) {
+  using stan::math::var;
+  std::vector<var> y0_v(y0.begin(), y0.end());
+  std::vector<var> theta_v(theta.begin(), theta.end());
+  std::vector<var> ts_v(ts.begin(), ts.end());
+  var t0_v = t0;
+  std::vector<double> x;
+  std::vector<int> x_int;
+
+  stan::math::cvodes_integrator<Lmm> integrator;
+  std::vector<std::vector<var>> y;
+  if (adjoint) {
+    y = integrator.integrate_adjoint(f, y0_v, t0_v, ts_v, theta_v, x, x_int,
+                                     nullptr, 1e-10, 1e-10, 1e8,
+                                     stan::math::cvodes_adjoint_options());
+  } else {
+    y = integrator.integrate(f, y0_v, t0_v, ts_v, theta_v, x, x_int, nullptr,
+                             1e-10, 1e-10, 1e8);
+  }
+
+  var lp = 0;
+  for (size_t n = 0; n < y.size(); ++n) {
+    for (size_t i = 0; i < y[n].size(); ++i) {
+      lp += (1.0 + 0.1 * n + 0.5 * i) * y[n][i];
+    }
+  }
+  lp.grad();
+
+  std::vector<double> g;
+  for (auto& v : y0_v)
+    g.push_back(v.adj());
+  for (auto& v : theta_v)
+    g.push_back(v.adj());
+  g.push_back(t0_v.adj());
+  for (auto& v : ts_v)
+    g.push_back(v.adj());
+  stan::math::recover_memory();
+  return g;
+}
+
+template <int Lmm, typename F>
+void expect_adjoint_matches_forward(const F& f, const std::vector<double>& y0,
+                                    double t0, const std::vector<double>& ts,
+                                    const std::vector<double>& theta,
+                                    double tol) {
+  std::vector<double> g_fwd = ode_gradient<Lmm>(f, y0, t0, ts, theta, false);
+  std::vector<double> g_adj = ode_gradient<Lmm>(f, y0, t0, ts, theta, true);
+  ASSERT_EQ(g_fwd.size(), g_adj.size());
+  // the forward sensitivities do not propagate to t0, which for an
+  // autonomous system is the negative sum of the gradients wrt ts
+  const size_t t0_index = y0.size() + theta.size();
+  double sum_ts = 0;
+  for (size_t k = 0; k < g_fwd.size(); ++k) {
+    if (k == t0_index)
+      continue;
+    EXPECT_NEAR(g_fwd[k], g_adj[k], tol * (1.0 + std::fabs(g_fwd[k])))
+        << "gradient element " << k;
+    if (k > t0_index)
+      sum_ts += g_adj[k];
+  }
+  EXPECT_NEAR(-sum_ts, g_adj[t0_index], tol * (1.0 + std::fabs(sum_ts)));
+}
+}  // namespace
+
+TEST(StanMathOdeIntegrateODEAdjoint, harmonic_oscillator_bdf) {
+  harm_osc_ode_fun f;
+  std::vector<double> ts;
+  for (int i = 0; i < 10; ++i)
+    ts.push_back(0.5 * (i + 1));
+  expect_adjoint_matches_forward<CV_BDF>(f, {1.0, 0.0}, 0.0, ts, {0.15},
+                                         1e-6);
+}
+
+TEST(StanMathOdeIntegrateODEAdjoint, harmonic_oscillator_adams) {
+  harm_osc_ode_fun f;
+  std::vector<double> ts;
+  for (int i = 0; i < 10; ++i)
+    ts.push_back(0.5 * (i + 1));
+  expect_adjoint_matches_forward<CV_ADAMS>(f, {1.0, 0.0}, 0.0, ts, {0.15},
+                                           1e-6);
+}
+
+TEST(StanMathOdeIntegrateODEAdjoint, lorenz_bdf) {
+  lorenz_ode_fun f;
+  std::vector<double> ts{0.1, 0.2, 0.5, 1.0};
+  expect_adjoint_matches_forward<CV_BDF>(f, {10.0, 1.0, 1.0}, 0.0, ts,
+                                         {10.0, 28.0, 8.0 / 3.0}, 1e-5);
+}
+
+TEST(StanMathOdeIntegrateODEAdjoint, repeated_grad) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<var> theta_v{0.15};
+  std::vector<double> y0{1.0, 0.0};
+  std::vector<double> ts{1.0, 2.0};
+  std::vector<double> x;
+  std::vector<int> x_int;
+
+  std::vector<std::vector<var>> y = stan::math::integrate_ode_bdf(
+      f, y0, 0.0, ts, theta_v, x, x_int, nullptr, 1e-10, 1e-10, 1e8,
+      stan::math::cvodes_adjoint_options());
+  y[1][0].grad();
+  double g1 = theta_v[0].adj();
+  stan::math::set_zero_all_adjoints();
+  y[1][0].grad();
+  EXPECT_FLOAT_EQ(g1, theta_v[0].adj());
+
+  std::vector<std::vector<var>> y_fwd
+      = stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta_v, x, x_int);
+  stan::math::set_zero_all_adjoints();
+  y_fwd[1][0].grad();
+  EXPECT_NEAR(g1, theta_v[0].adj(), 1e-6);
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOdeIntegrateODEAdjoint, full_stack_during_chain) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<var> theta_v{0.15};
+  std::vector<double> y0{1.0, 0.0};
+  std::vector<double> ts{1.0, 2.0};
+  std::vector<double> x;
+  std::vector<int> x_int;
+
+  std::vector<std::vector<var>> y = stan::math::integrate_ode_bdf(
+      f, y0, 0.0, ts, theta_v, x, x_int, nullptr, 1e-10, 1e-10, 1e8,
+      stan::math::cvodes_adjoint_options());
+  var lp = y[0][0] + y[1][1];
+
+  // the nested sweeps of the backward problem must not push onto the
+  // stack the reverse pass iterates over, which has no spare capacity
+  auto& var_stack = stan::math::ChainableStack::instance_->var_stack_;
+  var_stack.shrink_to_fit();
+  const size_t capacity = var_stack.capacity();
+  lp.grad();
+  EXPECT_EQ(capacity, var_stack.capacity());
+  const double g = theta_v[0].adj();
+  stan::math::recover_memory();
+
+  theta_v = {0.15};
+  std::vector<std::vector<var>> y_fwd
+      = stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta_v, x, x_int);
+  (y_fwd[0][0] + y_fwd[1][1]).grad();
+  EXPECT_NEAR(theta_v[0].adj(), g, 1e-6);
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOdeIntegrateODEAdjoint, data_only) {
+  harm_osc_ode_fun f;
+  std::vector<double> y0{1.0, 0.0};
+  std::vector<double> theta{0.15};
+  std::vector<double> ts{1.0, 2.0};
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<std::vector<double>> y_adj = stan::math::integrate_ode_bdf(
+      f, y0, 0.0, ts, theta, x, x_int, nullptr, 1e-10, 1e-10, 1e8,
+      stan::math::cvodes_adjoint_options());
+  std::vector<std::vector<double>> y
+      = stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta, x, x_int);
+  for (size_t n = 0; n < ts.size(); ++n)
+    for (size_t i = 0; i < y0.size(); ++i)
+      EXPECT_FLOAT_EQ(y[n][i], y_adj[n][i]);
+}
+
+TEST(StanMathOdeIntegrateODEAdjoint, bad_options) {
+  using stan::math::var;
+  harm_osc_ode_fun f;
+  std::vector<var> theta_v{0.15};
+  std::vector<double> y0{1.0, 0.0};
+  std::vector<double> ts{1.0, 2.0};
+  std::vector<double> x;
+  std::vector<int> x_int;
+  stan::math::cvodes_adjoint_options options;
+  options.absolute_tolerance_backward = -1;
+  EXPECT_THROW(stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta_v, x, x_int,
+                                             nullptr, 1e-10, 1e-10, 1e8,
+                                             options),
+               std::domain_error);
+  options = stan::math::cvodes_adjoint_options();
+  options.steps_between_checkpoints = 0;
+  EXPECT_THROW(stan::math::integrate_ode_bdf(f, y0, 0.0, ts, theta_v, x, x_int,
+                                             nullptr, 1e-10, 1e-10, 1e8,
+                                             options),
+               std::domain_error);
+  stan::math::recover_memory();
+}
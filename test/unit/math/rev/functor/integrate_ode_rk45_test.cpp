@@ -267,3 +267,48 @@ TEST(StanAgradRevOde_integrate_ode_rk45, t0_as_param_AD) {
   res = integrate_ode_rk45(ode, y0v, t0v, ts, thetav, x, x_int);
   test_ad();
 }
+
+TEST(StanAgradRevOde_integrate_ode_rk45, options) {
+  using stan::math::var;
+  harm_osc_ode_fun harm_osc;
+  std::vector<double> x;
+  std::vector<int> x_int;
+  std::vector<var> y0{1.0, 0.5};
+  std::vector<var> theta{0.15};
+  std::vector<double> ts;
+  for (int i = 0; i < 50; i++)
+    ts.push_back(0.1 * (i + 1));
+
+  std::vector<std::vector<var>> y_ref = stan::math::integrate_ode_rk45(
+      harm_osc, y0, 0.0, ts, theta, x, x_int, 0, 1e-10, 1e-10, 1e6);
+
+  stan::math::ode_rk45_options options;
+  options.error_control_states_only = true;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  std::vector<std::vector<var>> y = stan::math::integrate_ode_rk45(
+      harm_osc, y0, 0.0, ts, theta, x, x_int, 0, 1e-10, 1e-10, 1e6, options);
+  // one vari on the stack per output time
+  EXPECT_EQ(stack_size + ts.size(),
+            stan::math::ChainableStack::instance_->var_stack_.size());
+
+  for (size_t n = 0; n < ts.size(); ++n) {
+    for (size_t i = 0; i < 2; ++i) {
+      EXPECT_NEAR(y_ref[n][i].val(), y[n][i].val(), 1e-7);
+      stan::math::set_zero_all_adjoints();
+      y_ref[n][i].grad();
+      std::vector<double> g_ref{y0[0].adj(), y0[1].adj(), theta[0].adj()};
+      stan::math::set_zero_all_adjoints();
+      y[n][i].grad();
+      EXPECT_NEAR(g_ref[0], y0[0].adj(), 1e-6);
+      EXPECT_NEAR(g_ref[1], y0[1].adj(), 1e-6);
+      EXPECT_NEAR(g_ref[2], theta[0].adj(), 1e-6);
+    }
+  }
+
+  options.error_control_states_only = false;
+  options.initial_step_size = 1e-3;
+  y = stan::math::integrate_ode_rk45(harm_osc, y0, 0.0, ts, theta, x, x_int,
+                                     0, 1e-10, 1e-10, 1e6, options);
+  EXPECT_NEAR(y_ref.back()[0].val(), y.back()[0].val(), 1e-7);
+  stan::math::recover_memory();
+}
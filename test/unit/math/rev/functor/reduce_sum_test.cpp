@@ -0,0 +1,138 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+/**
+ * Normal log density with a group specific location, summed over a
+ * slice of the observations.
+ */
+struct grouped_normal_lpdf {
+  template <typename T1, typename T2, typename T3>
+  inline stan::return_type_t<T1, T2, T3> operator()(
+      const std::vector<T1>& y_slice, size_t start, size_t end,
+      std::ostream* msgs, const std::vector<int>& group,
+      const std::vector<T2>& mu, const T3& sigma) const {
+    stan::return_type_t<T1, T2, T3> lp = 0;
+    for (size_t i = 0; i < y_slice.size(); ++i)
+      lp += stan::math::normal_lpdf(y_slice[i], mu[group[start + i]], sigma);
+    return lp;
+  }
+};
+
+struct eigen_shared_lpdf {
+  template <typename T1, typename T2>
+  inline stan::return_type_t<T1, T2> operator()(
+      const std::vector<T1>& x_slice, size_t start, size_t end,
+      std::ostream* msgs, const Eigen::Matrix<T2, -1, 1>& beta) const {
+    stan::return_type_t<T1, T2> lp = 0;
+    for (size_t i = 0; i < x_slice.size(); ++i)
+      lp += stan::math::dot_product(x_slice[i], beta);
+    return lp;
+  }
+};
+
+struct throwing_lpdf {
+  template <typename T>
+  inline T operator()(const std::vector<T>& slice, size_t start, size_t end,
+                      std::ostream* msgs) const {
+    for (size_t i = 0; i < slice.size(); ++i)
+      if (start + i == 5)
+        throw std::domain_error("bad element");
+    return stan::math::sum(slice);
+  }
+};
+}  // namespace
+
+TEST(StanMathRevFunctor, reduce_sum_gradients) {
+  using stan::math::var;
+  const int N = 200;
+  std::vector<double> y_d(N);
+  std::vector<int> group(N);
+  for (int i = 0; i < N; ++i) {
+    y_d[i] = std::sin(i);
+    group[i] = i % 4;
+  }
+
+  for (int grainsize : {1, 7, N}) {
+    std::vector<var> y(y_d.begin(), y_d.end());
+    std::vector<var> mu{-0.5, 0.0, 0.3, 1.0};
+    var sigma = 1.3;
+    var lp = stan::math::reduce_sum(grouped_normal_lpdf(), y, grainsize,
+                                    nullptr, group, mu, sigma);
+
+    std::vector<var> y_ref(y_d.begin(), y_d.end());
+    std::vector<var> mu_ref{-0.5, 0.0, 0.3, 1.0};
+    var sigma_ref = 1.3;
+    var lp_ref = grouped_normal_lpdf()(y_ref, 0, N, nullptr, group, mu_ref,
+                                       sigma_ref);
+    EXPECT_FLOAT_EQ(lp_ref.val(), lp.val());
+
+    std::vector<var> x(y);
+    x.insert(x.end(), mu.begin(), mu.end());
+    x.push_back(sigma);
+    std::vector<var> x_ref(y_ref);
+    x_ref.insert(x_ref.end(), mu_ref.begin(), mu_ref.end());
+    x_ref.push_back(sigma_ref);
+
+    std::vector<double> g, g_ref;
+    lp.grad(x, g);
+    stan::math::set_zero_all_adjoints();
+    lp_ref.grad(x_ref, g_ref);
+    ASSERT_EQ(g_ref.size(), g.size());
+    for (size_t k = 0; k < g.size(); ++k)
+      EXPECT_FLOAT_EQ(g_ref[k], g[k]);
+    stan::math::recover_memory();
+  }
+}
+
+TEST(StanMathRevFunctor, reduce_sum_data_sliced) {
+  using stan::math::var;
+  std::vector<Eigen::VectorXd> x(50, Eigen::VectorXd::Zero(3));
+  for (size_t i = 0; i < x.size(); ++i)
+    x[i] << 1.0, i, 0.1 * i * i;
+  Eigen::Matrix<var, -1, 1> beta(3);
+  beta << 0.5, -1.0, 2.0;
+
+  var lp = stan::math::reduce_sum(eigen_shared_lpdf(), x, 4, nullptr, beta);
+  lp.grad();
+  Eigen::VectorXd expected = Eigen::VectorXd::Zero(3);
+  for (const auto& x_i : x)
+    expected += x_i;
+  for (int k = 0; k < 3; ++k)
+    EXPECT_FLOAT_EQ(expected(k), beta(k).adj());
+  EXPECT_FLOAT_EQ(expected.dot(stan::math::value_of(beta)), lp.val());
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, reduce_sum_nested_vectors) {
+  using stan::math::var;
+  std::vector<std::vector<var>> y{{1.0, 2.0}, {3.0}, {}, {4.0, 5.0, 6.0}};
+  struct {
+    var operator()(const std::vector<std::vector<var>>& slice, size_t start,
+                   size_t end, std::ostream* msgs) const {
+      var sum = 0;
+      for (const auto& y_i : slice)
+        for (const auto& y_ij : y_i)
+          sum += y_ij * y_ij;
+      return sum;
+    }
+  } sum_squares;
+  var lp = stan::math::reduce_sum(sum_squares, y, 1, nullptr);
+  lp.grad();
+  EXPECT_FLOAT_EQ(91.0, lp.val());
+  for (const auto& y_i : y)
+    for (const auto& y_ij : y_i)
+      EXPECT_FLOAT_EQ(2 * y_ij.val(), y_ij.adj());
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRevFunctor, reduce_sum_throws) {
+  using stan::math::var;
+  std::vector<var> y(10, 1.0);
+  EXPECT_THROW(stan::math::reduce_sum(throwing_lpdf(), y, 2, nullptr),
+               std::domain_error);
+  EXPECT_TRUE(stan::math::empty_nested());
+  stan::math::recover_memory();
+}
@@ -118,6 +118,30 @@ struct degenerate_eq_functor {
   }
 };
 
+// Tridiagonal system of any size: each equation couples one unknown
+// to its neighbors, with a unique root.
+struct tridiagonal_eq_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* pstream__) const {
+    const int N = x.size();
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(N);
+    for (int i = 0; i < N; ++i) {
+      z(i) = 3 * x(i) + 0.1 * x(i) * x(i) * x(i) - y(i % y.size());
+      if (i > 0) {
+        z(i) -= x(i - 1);
+      }
+      if (i < N - 1) {
+        z(i) -= x(i + 1);
+      }
+    }
+    return z;
+  }
+};
+
 /* template code for running tests in the prim and rev regime */
 
 template <typename F, typename T>
@@ -0,0 +1,191 @@
+#include <stan/math.hpp>
+#include <test/unit/math/rev/util.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+Eigen::MatrixXd dlm_y() {
+  Eigen::MatrixXd y(3, 10);
+  y << 4.05787944965558, 2.129936403626, 4.7831157467878, -3.24787355040931,
+      3.29106435886992, -5.3704927108258, -0.816249625704044, 1.48037050701867,
+      -2.68345235365616, 2.44624163805141, 0.409922815875619, 4.24853291677921,
+      3.29113479311716, -0.49506486892086, -2.23350858809309, -1.47295668380559,
+      2.32945737887854, 4.81422683437484, -3.30712917135304, -4.86150232097887,
+      -1.27602161517314, -1.15325860784026, -1.20424472088483,
+      -2.53407127990878, -1.0641380744013, -2.38506878287814, 0.690976145192563,
+      -3.25066033978687, 1.32299515908216, 0.746844140961399;
+  return y;
+}
+
+// F, G, m0, the lower triangles of W and C0 and the diagonal and two
+// off-diagonal elements of V of the model with three observations and
+// two states, followed by y
+Eigen::VectorXd dlm_args() {
+  Eigen::VectorXd x(53);
+  x.head(23) << 0.585528817843856, 0.709466017509524, -0.109303314681054,
+      -0.453497173462763, 0.605887455840394, -1.81795596770373,
+      0.520216457554957, 0.816899839520583, -0.750531994502331,
+      -0.886357521243213, -0.892071328367409, 3.74785137677115,
+      2.24277594357501, -1.65863136283477, 6.69010664813895, 82.1224673418328,
+      0.3, 56.0195157304406, 7.19105866377728, 3.27048576782842,
+      5.86564522448303, -0.311731853764732, 0.457616661474554;
+  Eigen::MatrixXd y = dlm_y();
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      x(23 + 10 * i + j) = y(i, j);
+    }
+  }
+  return x;
+}
+
+template <typename T>
+Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> symmetric(const T& a,
+                                                           const T& b,
+                                                           const T& c) {
+  Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> S(2, 2);
+  S << a, b, b, c;
+  return S;
+}
+
+struct gaussian_dlm_obs_fun {
+  bool sequential;
+  double steady_state_tol;
+
+  template <typename T>
+  T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> y(3, 10);
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 10; ++j) {
+        y(i, j) = x(23 + 10 * i + j);
+      }
+    }
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> F(2, 3);
+    F << x(0), x(1), x(2), x(3), x(4), x(5);
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> G(2, 2);
+    G << x(6), x(7), x(8), x(9);
+    Eigen::Matrix<T, Eigen::Dynamic, 1> m0(2);
+    m0 << x(10), x(11);
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> W
+        = symmetric(x(12), x(13), x(14));
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> C0
+        = symmetric(x(15), x(16), x(17));
+    if (sequential) {
+      Eigen::Matrix<T, Eigen::Dynamic, 1> V = x.segment(18, 3);
+      return stan::math::gaussian_dlm_obs_lpdf(y, F, G, V, W, m0, C0,
+                                               steady_state_tol);
+    }
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> V(3, 3);
+    V << x(18), x(21), 4.87333111936296, x(21), x(19), x(22),
+        4.87333111936296, x(22), x(20);
+    return stan::math::gaussian_dlm_obs_lpdf(y, F, G, V, W, m0, C0,
+                                             steady_state_tol);
+  }
+};
+
+void expect_gradient_matches_finite_diff(const gaussian_dlm_obs_fun& f,
+                                         const Eigen::VectorXd& x) {
+  double fx;
+  Eigen::VectorXd grad;
+  double fx_fd;
+  Eigen::VectorXd grad_fd;
+  stan::math::gradient(f, x, fx, grad);
+  stan::math::finite_diff_gradient(f, x, fx_fd, grad_fd);
+
+  EXPECT_FLOAT_EQ(fx_fd, fx);
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(grad_fd(i), grad(i), 1e-7);
+  }
+}
+}  // namespace
+
+TEST(ProbDistributionsGaussianDLM, adjoint_gradients) {
+  const Eigen::VectorXd x = dlm_args();
+  expect_gradient_matches_finite_diff(gaussian_dlm_obs_fun{false, 0}, x);
+  expect_gradient_matches_finite_diff(gaussian_dlm_obs_fun{true, 0}, x);
+}
+
+TEST(ProbDistributionsGaussianDLM, adjoint_gradients_subset) {
+  using stan::math::var;
+  const Eigen::VectorXd x = dlm_args();
+  double fx;
+  Eigen::VectorXd grad;
+  stan::math::gradient(gaussian_dlm_obs_fun{false, 0}, x, fx, grad);
+
+  // only G and W are parameters
+  Eigen::MatrixXd F(2, 3);
+  F << x(0), x(1), x(2), x(3), x(4), x(5);
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> G(2, 2);
+  G << x(6), x(7), x(8), x(9);
+  Eigen::VectorXd m0(2);
+  m0 << x(10), x(11);
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> W
+      = symmetric<var>(x(12), x(13), x(14));
+  Eigen::MatrixXd C0 = symmetric(x(15), x(16), x(17));
+  Eigen::MatrixXd V(3, 3);
+  V << x(18), x(21), 4.87333111936296, x(21), x(19), x(22),
+      4.87333111936296, x(22), x(20);
+
+  var lp = stan::math::gaussian_dlm_obs_lpdf(dlm_y(), F, G, V, W, m0, C0);
+  EXPECT_FLOAT_EQ(fx, lp.val());
+  lp.grad();
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FLOAT_EQ(grad(6 + i), G(i / 2, i % 2).adj());
+  }
+  EXPECT_FLOAT_EQ(grad(12), W(0, 0).adj());
+  EXPECT_FLOAT_EQ(grad(13), W(0, 1).adj());
+  EXPECT_FLOAT_EQ(grad(14), W(1, 1).adj());
+  stan::math::recover_memory();
+}
+
+TEST(ProbDistributionsGaussianDLM, steady_state) {
+  // a long series of the model with a single state, whose filtered
+  // covariance converges after a few steps
+  Eigen::VectorXd x(10);
+  x << 0.585528817843856, 0.9, 2.25500747900521, 0.461487989960454,
+      11.5829455171551, 65.2373490156606, 0, 0, 0, 0;
+  const int T = 200;
+  auto f = [&](double tol) {
+    return [=](const auto& x) {
+      using T_x = typename std::decay_t<decltype(x)>::Scalar;
+      Eigen::Matrix<T_x, Eigen::Dynamic, Eigen::Dynamic> y(1, T);
+      for (int t = 0; t < T; ++t) {
+        y(0, t) = x(6 + t % 4) + std::sin(t);
+      }
+      Eigen::Matrix<T_x, Eigen::Dynamic, Eigen::Dynamic> F(1, 1);
+      Eigen::Matrix<T_x, Eigen::Dynamic, Eigen::Dynamic> G(1, 1);
+      Eigen::Matrix<T_x, Eigen::Dynamic, Eigen::Dynamic> V(1, 1);
+      Eigen::Matrix<T_x, Eigen::Dynamic, Eigen::Dynamic> W(1, 1);
+      Eigen::Matrix<T_x, Eigen::Dynamic, 1> m0(1);
+      Eigen::Matrix<T_x, Eigen::Dynamic, Eigen::Dynamic> C0(1, 1);
+      F << x(0);
+      G << x(1);
+      V << x(2);
+      W << x(3);
+      m0 << x(4);
+      C0 << x(5);
+      return stan::math::gaussian_dlm_obs_lpdf(y, F, G, V, W, m0, C0, tol);
+    };
+  };
+
+  double fx;
+  Eigen::VectorXd grad;
+  double fx_ss;
+  Eigen::VectorXd grad_ss;
+  stan::math::gradient(f(0), x, fx, grad);
+  stan::math::gradient(f(1e-10), x, fx_ss, grad_ss);
+  EXPECT_NEAR(fx, fx_ss, 1e-7);
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(grad(i), grad_ss(i), 1e-6);
+  }
+
+  // the gradient of the steady state approximation is exact
+  double fx_fd;
+  Eigen::VectorXd grad_fd;
+  stan::math::gradient(f(1e-4), x, fx_ss, grad_ss);
+  stan::math::finite_diff_gradient(f(1e-4), x, fx_fd, grad_fd);
+  EXPECT_FLOAT_EQ(fx_fd, fx_ss);
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(grad_fd(i), grad_ss(i), 1e-7);
+  }
+
+  EXPECT_THROW(f(-1)(x), std::domain_error);
+}
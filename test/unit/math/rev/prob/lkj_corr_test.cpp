@@ -98,3 +98,53 @@ TEST(ProbDistributionsLkjCorrCholesky, gradients) {
   test_grad_eq(grad_1, grad_ad_1);
   EXPECT_FLOAT_EQ(fx, fx_ad);
 }
+
+namespace {
+// the lower triangle of a covariance matrix with vector location and
+// scale of the lognormal priors and the shape; the correlation matrix
+// is y rescaled to unit diagonal
+struct lkj_lower_fun {
+  bool corr;
+
+  template <typename T>
+  T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> y(3, 3);
+    int pos = 0;
+    for (int j = 0; j < 3; ++j) {
+      for (int i = j; i < 3; ++i) {
+        y(i, j) = x(pos);
+        y(j, i) = x(pos);
+        ++pos;
+      }
+    }
+    if (corr) {
+      Eigen::Matrix<T, Eigen::Dynamic, 1> inv_sd
+          = stan::math::inv_sqrt(y.diagonal());
+      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> y_corr
+          = inv_sd.asDiagonal() * y * inv_sd.asDiagonal();
+      return stan::math::lkj_corr_lpdf(y_corr, x(12));
+    }
+    return stan::math::lkj_cov_lpdf(y, Eigen::Matrix<T, -1, 1>(x.segment(6, 3)),
+                                    Eigen::Matrix<T, -1, 1>(x.segment(9, 3)),
+                                    x(12));
+  }
+};
+}  // namespace
+
+TEST(ProbDistributionsLkjCov, closed_form_gradients) {
+  Eigen::VectorXd x(13);
+  x << 4.5, 1.2, -0.7, 3.1, 0.4, 2.2, 0.3, -0.2, 0.5, 1.1, 0.8, 1.6, 2.5;
+
+  double fx;
+  Eigen::VectorXd grad;
+  double fx_fd;
+  Eigen::VectorXd grad_fd;
+  for (bool corr : {false, true}) {
+    stan::math::gradient(lkj_lower_fun{corr}, x, fx, grad);
+    stan::math::finite_diff_gradient(lkj_lower_fun{corr}, x, fx_fd, grad_fd);
+    EXPECT_FLOAT_EQ(fx_fd, fx);
+    for (int i = 0; i < x.size(); ++i) {
+      EXPECT_NEAR(grad_fd(i), grad(i), 1e-8);
+    }
+  }
+}
@@ -101,3 +101,43 @@ TEST(Wishart, check_varis_on_stack) {
   test::check_varis_on_stack(stan::math::wishart_log<true>(W, to_var(nu), S));
   test::check_varis_on_stack(stan::math::wishart_log<true>(W, nu, to_var(S)));
 }
+
+namespace {
+// the lower triangles of W and S and the degrees of freedom, with the
+// upper triangles left at values that must not be read
+struct wishart_lower_fun {
+  template <typename T>
+  T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> W(3, 3);
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> S(3, 3);
+    W.setConstant(-100);
+    S.setConstant(100);
+    int pos = 0;
+    for (int j = 0; j < 3; ++j) {
+      for (int i = j; i < 3; ++i) {
+        W(i, j) = x(pos);
+        S(i, j) = x(pos + 7);
+        ++pos;
+      }
+    }
+    return stan::math::wishart_lpdf(W, x(6), S);
+  }
+};
+}  // namespace
+
+TEST(Wishart, closed_form_gradients) {
+  Eigen::VectorXd x(13);
+  x << 4.5, 1.2, -0.7, 3.1, 0.4, 2.2, 5.3, 2.9, 0.6, 0.3, 1.8, -0.2, 1.1;
+
+  double fx;
+  Eigen::VectorXd grad;
+  double fx_fd;
+  Eigen::VectorXd grad_fd;
+  stan::math::gradient(wishart_lower_fun(), x, fx, grad);
+  stan::math::finite_diff_gradient(wishart_lower_fun(), x, fx_fd, grad_fd);
+
+  EXPECT_FLOAT_EQ(fx_fd, fx);
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(grad_fd(i), grad(i), 1e-8);
+  }
+}
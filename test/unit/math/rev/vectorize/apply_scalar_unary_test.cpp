@@ -0,0 +1,98 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+TEST(AgradRevVectorize, single_vari_std_vector) {
+  using stan::math::var;
+  std::vector<var> x{0.5, 1.5, 2.5};
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  std::vector<var> y = stan::math::exp(x);
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  ASSERT_EQ(3U, y.size());
+
+  var lp = 0;
+  for (size_t i = 0; i < y.size(); ++i) {
+    EXPECT_FLOAT_EQ(std::exp(x[i].val()), y[i].val());
+    lp += (i + 1.0) * y[i];
+  }
+  lp.grad();
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_FLOAT_EQ((i + 1.0) * std::exp(x[i].val()), x[i].adj());
+  }
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVectorize, single_vari_eigen) {
+  using stan::math::var;
+  Eigen::Matrix<var, -1, -1> x(2, 2);
+  x << 0.2, 0.4, 0.6, 0.8;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  Eigen::Matrix<var, -1, -1> y = stan::math::inv_logit(x);
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+
+  var lp = stan::math::sum(y) + stan::math::sum(stan::math::lgamma(x));
+  lp.grad();
+  for (int i = 0; i < x.size(); ++i) {
+    double p = stan::math::inv_logit(x(i).val());
+    EXPECT_FLOAT_EQ(p, y(i).val());
+    EXPECT_FLOAT_EQ(p * (1 - p) + stan::math::digamma(x(i).val()),
+                    x(i).adj());
+  }
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVectorize, eigen_expression) {
+  using stan::math::var;
+  Eigen::Matrix<var, -1, 1> x(3);
+  x << 1.0, 2.0, 3.0;
+  Eigen::Matrix<var, -1, 1> y = stan::math::log(x * 2.0);
+  var lp = stan::math::sum(y);
+  lp.grad();
+  for (int i = 0; i < x.size(); ++i) {
+    EXPECT_FLOAT_EQ(std::log(2.0 * x(i).val()), y(i).val());
+    EXPECT_FLOAT_EQ(1.0 / x(i).val(), x(i).adj());
+  }
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVectorize, without_derivative) {
+  using stan::math::var;
+  std::vector<var> x{0.5, 1.5};
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  std::vector<var> y = stan::math::atan(x);
+  EXPECT_EQ(stack_size + 2,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  var lp = y[0] + y[1];
+  lp.grad();
+  EXPECT_FLOAT_EQ(1 / (1 + 0.25), x[0].adj());
+  EXPECT_FLOAT_EQ(1 / (1 + 2.25), x[1].adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevVectorize, empty) {
+  using stan::math::var;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  EXPECT_EQ(0U, stan::math::exp(std::vector<var>()).size());
+  EXPECT_EQ(0, stan::math::exp(Eigen::Matrix<var, -1, 1>()).size());
+  EXPECT_EQ(stack_size,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(AgradRevVectorize, var_matrix) {
+  using stan::math::var;
+  using stan::math::var_matrix;
+  Eigen::MatrixXd x_val(2, 3);
+  x_val << 0.1, 0.2, 0.3, 0.4, 0.5, 0.6;
+  var_matrix x(x_val);
+  var_matrix y = stan::math::sqrt(x);
+  var lp = stan::math::sum(y);
+  lp.grad();
+  for (int i = 0; i < x_val.size(); ++i) {
+    EXPECT_FLOAT_EQ(std::sqrt(x_val(i)), y.val()(i));
+    EXPECT_FLOAT_EQ(0.5 / std::sqrt(x_val(i)), x.adj()(i));
+  }
+  stan::math::recover_memory();
+}